@@ -21,6 +21,9 @@ let package = Package(
     products:
     [
         .library(name:"BXMediaBrowser", targets:["BXMediaBrowser"]),
+        .library(name:"BXMediaBrowserCore", targets:["BXMediaBrowserCore"]),
+        .executable(name:"BXMediaBrowserBenchmarks", targets:["BXMediaBrowserBenchmarks"]),
+        .executable(name:"BXMediaBrowserScanner", targets:["BXMediaBrowserScanner"]),
     ],
     
 	// Dependencies declare other packages that this package depends on
@@ -37,7 +40,21 @@ let package = Package(
 
     targets:
     [
-        .target(name:"BXMediaBrowser", dependencies:["BXSwiftUtils","BXSwiftUI"]),
+        .target(name:"BXMediaBrowserCore", dependencies:[]),
+        .target(name:"BXMediaBrowser", dependencies:["BXMediaBrowserCore","BXSwiftUtils","BXSwiftUI"]),
+        .target(name:"BXMediaBrowserFixtures", dependencies:["BXMediaBrowser"]),
+        .executableTarget(name:"BXMediaBrowserBenchmarks", dependencies:["BXMediaBrowser","BXMediaBrowserFixtures"]),
+        .executableTarget(name:"BXMediaBrowserScanner", dependencies:["BXMediaBrowser","BXMediaBrowserFixtures"]),
+        .testTarget(name:"BXMediaBrowserCoreTests", dependencies:["BXMediaBrowserCore"]),
         .testTarget(name:"BXMediaBrowserTests", dependencies:["BXMediaBrowser"]),
     ]
 )
+
+// BXMediaBrowserCore only depends on Foundation. On Linux the package is reduced to this target and its tests, since
+// everything else needs SwiftUI, AppKit or UIKit.
+
+#if os(Linux)
+package.products = package.products.filter { $0.name == "BXMediaBrowserCore" }
+package.dependencies = []
+package.targets = package.targets.filter { $0.name == "BXMediaBrowserCore" || $0.name == "BXMediaBrowserCoreTests" }
+#endif
@@ -0,0 +1,591 @@
+//----------------------------------------------------------------------------------------------------------------------
+//
+//  Copyright ©2026 Peter Baumgartner. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//----------------------------------------------------------------------------------------------------------------------
+
+
+import BXSwiftUtils
+import Foundation
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+extension StatisticsController
+{
+	/// The Journal persists rating and useCount values incrementally. Every change is appended to a small journal
+	/// file, which is periodically compacted into a binary snapshot. The identifiers are distributed over several
+	/// shards, which are only read from disk when one of their identifiers is accessed for the first time.
+	///
+	/// Changes are buffered in memory and written to disk after flushInterval, so a crash loses at most the
+	/// changes of that interval.
+	///
+	/// Values are keyed by IdentifierHandle, so loading a shard interns all of its identifiers in the shared
+	/// IdentifierTable, where they stay for the lifetime of the process.
+
+	public final class Journal
+	{
+		/// The kind of value that is stored for an identifier
+
+		public enum Kind : UInt8
+		{
+			case rating = 1
+			case useCount = 2
+		}
+
+		/// The directory that contains the snapshot and journal files of all shards
+
+		public let directoryURL:URL
+
+		/// The number of shards. Changing this value invalidates existing files, so it is stored in the directory name.
+
+		public let shardCount:Int
+
+		/// Buffered changes are written to disk after this many seconds
+
+		public var flushInterval:Double = 1.0
+
+		/// A shard is compacted into a new snapshot once its journal contains this many records
+
+		public var compactionThreshold = 512
+
+		/// The in-memory state of all shards
+
+		private var shards:[Shard]
+
+		/// This lock is used to ensure thread-safe access to the shards
+
+		private let lock = NSLock()
+
+		/// All file access is serialized on this queue
+
+		private let queue = DispatchQueue(label:"com.boinx.BXMediaBrowser.StatisticsController.journal")
+
+		/// Set to true while a flush is pending on the queue
+
+		private var isFlushScheduled = false
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+		/// The stored values for a single identifier
+
+		struct Values
+		{
+			var rating:Int32 = 0
+			var useCount:Int32 = 0
+
+			var isEmpty:Bool { rating == 0 && useCount == 0 }
+
+			subscript(kind:Kind) -> Int32
+			{
+				get { kind == .rating ? rating : useCount }
+				set { if kind == .rating { rating = newValue } else { useCount = newValue } }
+			}
+		}
+
+		/// The in-memory state of a shard. The values are nil until the shard has been loaded from disk.
+
+		final class Shard
+		{
+			var values:[IdentifierHandle:Values]? = nil
+			var pendingRecords = Data()
+			var journalRecordCount = 0
+		}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+		// MARK: - Setup
+
+		/// Creates a Journal that stores its files in the specified directory
+
+		public init(directoryURL:URL, shardCount:Int = 64)
+		{
+			self.shardCount = max(1,shardCount)
+			self.directoryURL = directoryURL.appendingPathComponent("shards-\(self.shardCount)", isDirectory:true)
+			self.shards = (0 ..< self.shardCount).map { _ in Shard() }
+
+			try? FileManager.default.createDirectory(at:self.directoryURL, withIntermediateDirectories:true, attributes:nil)
+		}
+
+		/// The default location is inside the Application Support folder of the host application
+
+		public static var defaultDirectoryURL:URL
+		{
+			let appSupportURL = FileManager.default.urls(for:.applicationSupportDirectory, in:.userDomainMask).first ?? FileManager.default.temporaryDirectory
+			let bundleIdentifier = Bundle.main.bundleIdentifier ?? "BXMediaBrowser"
+
+			return appSupportURL
+				.appendingPathComponent(bundleIdentifier, isDirectory:true)
+				.appendingPathComponent("BXMediaBrowser.Statistics", isDirectory:true)
+		}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+		// MARK: - Accessing
+
+		/// Returns the stored value for the specified IdentifierHandle
+
+		public func value(_ kind:Kind, for handle:IdentifierHandle) -> Int
+		{
+			let index = self.shardIndex(for:handle)
+
+			lock.lock()
+			defer { lock.unlock() }
+
+			let values = self.loadedValues(ofShard:index)
+			return Int(values[handle]?[kind] ?? 0)
+		}
+
+		/// Returns the stored value for the specified identifier. Loading the shard interns all of its identifiers,
+		/// so if the identifier is still unknown afterwards, no value is stored and it doesn't need to be interned.
+
+		public func value(_ kind:Kind, for identifier:String) -> Int
+		{
+			let index = Int(IdentifierTable.stableHash(for:identifier) % UInt64(shardCount))
+
+			lock.lock()
+			defer { lock.unlock() }
+
+			let values = self.loadedValues(ofShard:index)
+			guard let handle = IdentifierTable.shared.existingHandle(for:identifier) else { return 0 }
+			return Int(values[handle]?[kind] ?? 0)
+		}
+
+		/// Stores a new value for the specified IdentifierHandle. This is an O(1) operation - the change is appended
+		/// to an in-memory buffer and written to the journal file after flushInterval.
+
+		public func setValue(_ value:Int, _ kind:Kind, for handle:IdentifierHandle)
+		{
+			self.update(kind, for:handle) { _ in Int32(clamping:value) }
+		}
+
+		/// Increments the value for the specified IdentifierHandle and returns the new value. Reading and writing
+		/// happens while holding the lock, so concurrent increments are never lost.
+
+		@discardableResult public func increment(_ kind:Kind, by delta:Int = 1, for handle:IdentifierHandle) -> Int
+		{
+			Int(self.update(kind, for:handle) { Int32(clamping:Int($0) + delta) })
+		}
+
+		/// Replaces the value for the specified IdentifierHandle with the result of the transform closure, which
+		/// receives the old value. Returns the new value.
+
+		@discardableResult private func update(_ kind:Kind, for handle:IdentifierHandle, _ transform:(Int32)->Int32) -> Int32
+		{
+			let index = self.shardIndex(for:handle)
+
+			lock.lock()
+
+			// Mutate the shard dictionary in place, so that no copy-on-write is triggered
+
+			let shard = self.shards[index]
+			var entry = self.loadedValues(ofShard:index)[handle] ?? Values()
+			let value = transform(entry[kind])
+
+			guard let record = Self.journalRecord(kind:kind, value:value, identifier:handle.identifier) else
+			{
+				lock.unlock()
+				return entry[kind]
+			}
+
+			entry[kind] = value
+			shard.values?[handle] = entry.isEmpty ? nil : entry
+			shard.pendingRecords.append(record)
+
+			let needsScheduling = !isFlushScheduled
+			self.isFlushScheduled = true
+
+			lock.unlock()
+
+			if needsScheduling
+			{
+				queue.asyncAfter(deadline:.now() + flushInterval)
+				{
+					[weak self] in self?._flush()
+				}
+			}
+
+			return value
+		}
+
+		/// Stores a new value for the specified identifier
+
+		public func setValue(_ value:Int, _ kind:Kind, for identifier:String)
+		{
+			self.setValue(value, kind, for:IdentifierTable.shared.handle(for:identifier))
+		}
+
+		/// Returns all stored values of the specified kind. Please note that this loads all shards from disk.
+
+		public func allValues(_ kind:Kind) -> [String:Int]
+		{
+			lock.lock()
+			defer { lock.unlock() }
+
+			var result:[String:Int] = [:]
+
+			for index in 0 ..< shardCount
+			{
+				for (handle,values) in self.loadedValues(ofShard:index) where values[kind] != 0
+				{
+					result[handle.identifier] = Int(values[kind])
+				}
+			}
+
+			return result
+		}
+
+		/// Copies the ratings that older versions stored in UserDefaults to this Journal. This is only done once,
+		/// the UserDefaults entry is removed afterwards.
+
+		public func importLegacyRatings(from defaults:UserDefaults, forKey key:String)
+		{
+			guard let ratings = defaults.dictionary(forKey:key) as? [String:Int] else { return }
+
+			for (identifier,rating) in ratings where rating > 0
+			{
+				self.setValue(rating, .rating, for:identifier)
+			}
+
+			self.synchronize()
+			defaults.removeObject(forKey:key)
+		}
+
+		/// Returns true if no values have been stored yet
+
+		public var isEmpty:Bool
+		{
+			let fileURLs = (try? FileManager.default.contentsOfDirectory(at:directoryURL, includingPropertiesForKeys:nil)) ?? []
+			return fileURLs.isEmpty
+		}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+		// MARK: - Writing
+
+		/// Writes all buffered changes to disk immediately. Call this function before the application terminates.
+
+		public func synchronize()
+		{
+			queue.sync { self._flush() }
+		}
+
+		/// Appends buffered records to the journal files and compacts shards whose journal has grown too large
+
+		private func _flush()
+		{
+			var appends:[(Int,Data)] = []
+			var snapshots:[(Int,[IdentifierHandle:Values])] = []
+			var recordCount = 0
+			let start = Metrics.now
+
+			// Grab the buffered changes while holding the lock, but perform the actual file access without it
+
+			lock.lock()
+
+			self.isFlushScheduled = false
+
+			for (index,shard) in shards.enumerated() where !shard.pendingRecords.isEmpty
+			{
+				let records = shard.pendingRecords
+				shard.pendingRecords = Data()
+				let count = Self.recordCount(in:records)
+				shard.journalRecordCount += count
+				recordCount += count
+
+				if shard.journalRecordCount >= compactionThreshold, let values = shard.values
+				{
+					shard.journalRecordCount = 0
+					snapshots.append((index,values))
+				}
+				else
+				{
+					appends.append((index,records))
+				}
+			}
+
+			lock.unlock()
+
+			guard recordCount > 0 else { return }
+			defer { Metrics.shared.histogram(.statisticsJournalFlushLatency).record(since:start) }
+			Metrics.shared.counter(.statisticsJournalRecords).increment(by:Int64(recordCount))
+
+			// Append new records to the journals
+
+			for (index,records) in appends
+			{
+				self.append(records, toJournalOfShard:index)
+			}
+
+			// Compact shards by writing a new snapshot and then discarding the journal. If the app crashes in between,
+			// then the journal is simply replayed on top of the new snapshot, which yields the same result.
+
+			for (index,values) in snapshots
+			{
+				do
+				{
+					try Self.snapshotData(for:values).write(to:self.snapshotURL(forShard:index), options:.atomic)
+					try? FileManager.default.removeItem(at:self.journalURL(forShard:index))
+				}
+				catch
+				{
+					BXMediaBrowser.log.error {"\(Self.self).\(#function) ERROR \(error)"}
+				}
+			}
+		}
+
+		/// Appends the specified records to the journal file of a shard
+
+		private func append(_ records:Data, toJournalOfShard index:Int)
+		{
+			let url = self.journalURL(forShard:index)
+
+			if !FileManager.default.fileExists(atPath:url.path)
+			{
+				FileManager.default.createFile(atPath:url.path, contents:nil, attributes:nil)
+			}
+
+			guard let handle = try? FileHandle(forWritingTo:url) else
+			{
+				BXMediaBrowser.log.error {"\(Self.self).\(#function) ERROR cannot open \(url.path)"}
+				return
+			}
+
+			handle.seekToEndOfFile()
+			handle.write(records)
+			handle.synchronizeFile()
+			handle.closeFile()
+		}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+		// MARK: - Loading
+
+		/// Returns the values of the specified shard, loading it from disk if necessary. Must be called while holding the lock.
+
+		private func loadedValues(ofShard index:Int) -> [IdentifierHandle:Values]
+		{
+			let shard = self.shards[index]
+
+			if let values = shard.values
+			{
+				return values
+			}
+
+			var values:[IdentifierHandle:Values] = [:]
+
+			if let data = try? Data(contentsOf:self.snapshotURL(forShard:index))
+			{
+				Self.readSnapshot(data, into:&values)
+			}
+
+			if let data = try? Data(contentsOf:self.journalURL(forShard:index))
+			{
+				shard.journalRecordCount = Self.replayJournal(data, into:&values)
+			}
+
+			shard.values = values
+			return values
+		}
+
+		/// Distributes identifiers evenly across the shards. The stable hash of the handle is used, because
+		/// String.hashValue is not stable across launches.
+
+		func shardIndex(for handle:IdentifierHandle) -> Int
+		{
+			Int(handle.stableHash % UInt64(shardCount))
+		}
+
+		private func snapshotURL(forShard index:Int) -> URL
+		{
+			directoryURL.appendingPathComponent("\(index).snapshot")
+		}
+
+		private func journalURL(forShard index:Int) -> URL
+		{
+			directoryURL.appendingPathComponent("\(index).journal")
+		}
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+// MARK: - File Format
+
+// A snapshot starts with a 4 byte magic, followed by records of [UInt16 length][UTF8 identifier][Int32 rating][Int32 useCount].
+// A journal consists of records of [UInt8 kind][Int32 value][UInt16 length][UTF8 identifier]. All integers are little endian.
+// An incomplete record at the end of a journal (e.g. after a crash during writing) is ignored.
+
+extension StatisticsController.Journal
+{
+	static let snapshotMagic = Data("BXS1".utf8)
+
+	/// Returns the encoded journal record for a single change, or nil if the identifier is too long
+
+	static func journalRecord(kind:Kind, value:Int32, identifier:String) -> Data?
+	{
+		let bytes = Array(identifier.utf8)
+		guard bytes.count <= Int(UInt16.max) else { return nil }
+
+		var data = Data(capacity:7 + bytes.count)
+		data.append(kind.rawValue)
+		data.appendLittleEndian(value)
+		data.appendLittleEndian(UInt16(bytes.count))
+		data.append(contentsOf:bytes)
+		return data
+	}
+
+	/// Returns the number of records in an encoded chunk of journal data
+
+	static func recordCount(in data:Data) -> Int
+	{
+		var reader = Reader(data)
+		var count = 0
+
+		while reader.skipJournalRecord()
+		{
+			count += 1
+		}
+
+		return count
+	}
+
+	/// Applies all records of a journal to the specified values and returns the number of applied records
+
+	@discardableResult static func replayJournal(_ data:Data, into values:inout [IdentifierHandle:Values]) -> Int
+	{
+		var reader = Reader(data)
+		var count = 0
+
+		while let rawKind:UInt8 = reader.read(), let value:Int32 = reader.read(), let identifier = reader.readString()
+		{
+			guard let kind = Kind(rawValue:rawKind) else { break }
+			let handle = IdentifierTable.shared.handle(for:identifier)
+			var entry = values[handle] ?? Values()
+			entry[kind] = value
+			values[handle] = entry.isEmpty ? nil : entry
+			count += 1
+		}
+
+		return count
+	}
+
+	/// Encodes the specified values as a snapshot
+
+	static func snapshotData(for values:[IdentifierHandle:Values]) -> Data
+	{
+		var data = Data()
+		data.append(snapshotMagic)
+
+		for (handle,entry) in values where !entry.isEmpty
+		{
+			let bytes = Array(handle.identifier.utf8)
+			guard bytes.count <= Int(UInt16.max) else { continue }
+			data.appendLittleEndian(UInt16(bytes.count))
+			data.append(contentsOf:bytes)
+			data.appendLittleEndian(entry.rating)
+			data.appendLittleEndian(entry.useCount)
+		}
+
+		return data
+	}
+
+	/// Decodes a snapshot into the specified values
+
+	static func readSnapshot(_ data:Data, into values:inout [IdentifierHandle:Values])
+	{
+		guard data.starts(with:snapshotMagic) else { return }
+		var reader = Reader(data.dropFirst(snapshotMagic.count))
+
+		while let identifier = reader.readString(), let rating:Int32 = reader.read(), let useCount:Int32 = reader.read()
+		{
+			values[IdentifierTable.shared.handle(for:identifier)] = Values(rating:rating, useCount:useCount)
+		}
+	}
+
+	/// A minimal cursor for reading little endian integers and strings from Data
+
+	struct Reader
+	{
+		private let data:Data
+		private var offset:Int
+
+		init(_ data:Data)
+		{
+			self.data = data
+			self.offset = data.startIndex
+		}
+
+		mutating func read<T:FixedWidthInteger>() -> T?
+		{
+			let size = MemoryLayout<T>.size
+			guard offset + size <= data.endIndex else { return nil }
+			var value:T = 0
+			_ = withUnsafeMutableBytes(of:&value) { data.copyBytes(to:$0, from:offset ..< offset+size) }
+			offset += size
+			return T(littleEndian:value)
+		}
+
+		mutating func readString() -> String?
+		{
+			guard let length:UInt16 = self.read() else { return nil }
+			let end = offset + Int(length)
+			guard end <= data.endIndex else { return nil }
+			let string = String(decoding:data[offset ..< end], as:UTF8.self)
+			offset = end
+			return string
+		}
+
+		mutating func skipJournalRecord() -> Bool
+		{
+			guard let _:UInt8 = self.read(), let _:Int32 = self.read(), let _ = self.readString() else { return false }
+			return true
+		}
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+extension Data
+{
+	mutating func appendLittleEndian<T:FixedWidthInteger>(_ value:T)
+	{
+		Swift.withUnsafeBytes(of:value.littleEndian) { self.append(contentsOf:$0) }
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
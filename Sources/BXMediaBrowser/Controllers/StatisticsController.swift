@@ -62,10 +62,19 @@ public class StatisticsController : ObservableObject
 //----------------------------------------------------------------------------------------------------------------------
 
 	
-	/// Storage for rating statistics
+	/// Storage for rating statistics, if the host application supplied its own loadRatingHandler and saveRatingHandler
 	
 	private var _rating:[String:Int] = [:]
 
+	/// Thread-safe access to _rating, since ratings are also read by background loading Tasks during sorting and filtering
+	
+	private let lock = NSLock()
+	
+	/// By default ratings and useCounts are stored incrementally in this Journal, so that no work has to be done
+	/// at quit time and at most one flushInterval worth of changes can get lost in case of a crash.
+	
+	public let journal = Journal(directoryURL:Journal.defaultDirectoryURL)
+
 	/// This notification is sent when a ratings value was changed.
 	///
 	/// The BXMediaBrowser.Object is stored in notification.object.
@@ -74,24 +83,47 @@ public class StatisticsController : ObservableObject
 
 	/// An externally supplied handler that loads rating statistics from storage.
 	///
-	/// The default implementation uses UserDefaults, but a client application can store
-	/// this information elsewhere, e.g. in a document file.
+	/// By default this handler is nil and ratings are stored in the Journal. A client application can supply
+	/// this handler to store this information elsewhere, e.g. in a document file. Both loadRatingHandler and
+	/// saveRatingHandler must be set, otherwise the Journal is still used.
 	
-	public var loadRatingHandler:()->[String:Int] =
+	public var loadRatingHandler:(()->[String:Int])? = nil
 	{
-		UserDefaults.standard.dictionary(forKey:"BXMediaBrowser-rating") as? [String:Int] ?? [:]
+		didSet { self.loadRatings() }
 	}
 	
 	/// An externally supplied handler that saves rating statistics to storage.
 	///
-	/// The default implementation uses UserDefaults, but a client application can store
-	/// this information elsewhere, e.g. in a document file.
+	/// By default this handler is nil and ratings are stored in the Journal. A client application can supply
+	/// this handler to store this information elsewhere, e.g. in a document file. Both loadRatingHandler and
+	/// saveRatingHandler must be set, otherwise the Journal is still used.
 	
-	public var saveRatingHandler:([String:Int])->Void =
+	public var saveRatingHandler:(([String:Int])->Void)? = nil
+	
+	/// Returns true if the ratings are managed by externally supplied handlers instead of the Journal. Setting
+	/// only one of the handlers is a programming error, since ratings would silently end up in the Journal.
+	
+	private var usesRatingHandlers:Bool
 	{
-		UserDefaults.standard.set($0, forKey:"BXMediaBrowser-rating")
+		let hasLoadRatingHandler = loadRatingHandler != nil
+		let hasSaveRatingHandler = saveRatingHandler != nil
+		assert(hasLoadRatingHandler == hasSaveRatingHandler, "\(Self.self) requires both loadRatingHandler and saveRatingHandler to be set")
+		return hasLoadRatingHandler && hasSaveRatingHandler
 	}
 	
+	/// The key under which ratings were stored in UserDefaults before the Journal was introduced
+	
+	private static let legacyRatingKey = "BXMediaBrowser-rating"
+	
+	/// Set to false once the legacy ratings have been imported (or when it turned out that this is not needed)
+	
+	private var needsLegacyImport = true
+	
+	/// This lock makes sure that the legacy ratings are only imported once, and that nobody reads from the
+	/// Journal while the import is in progress
+	
+	private let legacyImportLock = NSLock()
+	
 
 //----------------------------------------------------------------------------------------------------------------------
 
@@ -103,17 +135,51 @@ public class StatisticsController : ObservableObject
 	
 	public static let didChangeNotification = Notification.Name("BXMediaBrowser.StatisticsController.didChange")
 	
+	/// This notification is sent (from the main thread) once per coalescingInterval with a ChangeSet in notification.object.
+	/// It collects all didChangeNotifications of that interval, so that Containers can update their sort order in one go.
+	
+	public static let didChangeStatisticsNotification = Notification.Name("BXMediaBrowser.StatisticsController.didChangeStatistics")
+	
+	/// A ChangeSet contains the identifiers of all Objects whose statistics changed during the coalescing interval
+	
+	public struct ChangeSet
+	{
+		/// The identifiers of the changed Objects
+		
+		public var identifiers:Set<String> = []
+		
+		/// Set to true if all Objects were changed at once (didChangeNotification with a nil object)
+		
+		public var containsAll = false
+		
+		public var isEmpty:Bool
+		{
+			identifiers.isEmpty && !containsAll
+		}
+	}
+	
+	/// Changes are collected for this many seconds before a didChangeStatisticsNotification is sent
+	
+	public var coalescingInterval:Double = 0.3
+	
+	/// The changes that were collected since the last didChangeStatisticsNotification
+	
+	private var pendingChangeSet = ChangeSet()
+	
 		
 //----------------------------------------------------------------------------------------------------------------------
 
 
 	private init()
 	{
-		// On startup load the previous statistics
+		// Collect changes - including those announced by the host application - into coalesced ChangeSets
 		
-		self.loadRatings()
+		self.observers += NotificationCenter.default.publisher(for:Self.didChangeNotification, object:nil).sink
+		{
+			[weak self] notification in self?.addToChangeSet(notification.object as? String)
+		}
 		
-		// When quitting save the current statistics
+		// When quitting write any buffered changes to disk
 		
 		#if os(macOS)
 		
@@ -124,13 +190,68 @@ public class StatisticsController : ObservableObject
 		
 		#else
 
-		#warning("TODO: implement")
+		self.observers += NotificationCenter.default.publisher(for:UIApplication.willTerminateNotification, object:nil).sink
+		{
+			[weak self] _ in self?.saveRatings()
+		}
 		
 		#endif
 	}
 	
 
 
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	// MARK: - Change Sets
+	
+	
+	/// Adds the specified identifier to the pending ChangeSet. A nil identifier means that all Objects have changed.
+	
+	private func addToChangeSet(_ identifier:String?)
+	{
+		lock.lock()
+		
+		let needsScheduling = pendingChangeSet.isEmpty
+		
+		if let identifier = identifier
+		{
+			self.pendingChangeSet.identifiers.insert(identifier)
+		}
+		else
+		{
+			self.pendingChangeSet.containsAll = true
+		}
+		
+		lock.unlock()
+		
+		if needsScheduling
+		{
+			DispatchQueue.main.asyncAfter(deadline:.now() + coalescingInterval)
+			{
+				[weak self] in self?.sendChangeSet()
+			}
+		}
+	}
+	
+	/// Sends the pending ChangeSet to all interested Containers
+	
+	private func sendChangeSet()
+	{
+		lock.lock()
+		let changeSet = self.pendingChangeSet
+		self.pendingChangeSet = ChangeSet()
+		lock.unlock()
+		
+		guard !changeSet.isEmpty else { return }
+		
+		Metrics.shared.counter(.statisticsChangeSets).increment()
+		Metrics.shared.counter(.statisticsChangedObjects).increment(by:Int64(changeSet.identifiers.count))
+		
+		NotificationCenter.default.post(name:Self.didChangeStatisticsNotification, object:changeSet)
+	}
+	
+	
 //----------------------------------------------------------------------------------------------------------------------
 
 
@@ -139,16 +260,56 @@ public class StatisticsController : ObservableObject
 	
 	public func useCount(for object:Object) -> Int
 	{
-		self.useCount(for:object.identifier)
+		if let useCountDataSource = self.useCountDataSource
+		{
+			return useCountDataSource.useCount(for:object.identifier)
+		}
+		
+		return self.journal.value(.useCount, for:object.handle)
 	}
 	
+	/// Returns the useCount for the specified Object.Record, e.g. when sorting a lazy ObjectList
+	
+	public func useCount(for record:Object.Record) -> Int
+	{
+		if let useCountDataSource = self.useCountDataSource
+		{
+			return useCountDataSource.useCount(for:record.identifier)
+		}
+		
+		return self.journal.value(.useCount, for:record.handle)
+	}
+	
+	/// Returns the useCount for the specified Object identifier. If the host application has supplied a
+	/// useCountDataSource it will be asked, otherwise the value is read from the Journal.
+	
 	public func useCount(for identifier:String) -> Int
 	{
-		self.useCountDataSource?.useCount(for:identifier) ?? 0
+		if let useCountDataSource = self.useCountDataSource
+		{
+			return useCountDataSource.useCount(for:identifier)
+		}
+		
+		return self.journal.value(.useCount, for:identifier)
 	}
 
 	public weak var useCountDataSource:UseCountDataSource? = nil
 	
+	/// Increments the useCount for the specified Object. This is called when an Object was dragged to the host
+	/// application. It is only relevant if the host application does not supply its own useCountDataSource.
+	
+	public func incrementUseCount(for object:Object, sendNotifications:Bool = true)
+	{
+		guard self.useCountDataSource == nil else { return }
+		
+		self.journal.increment(.useCount, for:object.handle)
+		
+		if sendNotifications
+		{
+			NotificationCenter.default.post(name: Self.didChangeNotification, object:object.identifier)
+		}
+	}
+	
 	
 //----------------------------------------------------------------------------------------------------------------------
 
@@ -156,18 +317,49 @@ public class StatisticsController : ObservableObject
 	// MARK: - Rating
 	
 	
-	/// Loads statistics from storage
+	/// Loads statistics from storage. When using the Journal this is a no-op, because its shards are loaded lazily.
 	
 	public func loadRatings()
 	{
-		self._rating = self.loadRatingHandler()
+		guard let loadRatingHandler = self.loadRatingHandler else { return }
+		let ratings = loadRatingHandler()
+		
+		lock.lock()
+		self._rating = ratings
+		lock.unlock()
 	}
 
-	/// Saves statistics to storage
+	/// Saves statistics to storage. When using the Journal this only writes buffered changes to disk.
 	
 	public func saveRatings()
 	{
-		self.saveRatingHandler(_rating)
+		if usesRatingHandlers, let saveRatingHandler = self.saveRatingHandler
+		{
+			lock.lock()
+			let ratings = self._rating
+			lock.unlock()
+			
+			saveRatingHandler(ratings)
+		}
+		
+		self.journal.synchronize()
+	}
+	
+	/// Copies the ratings that older versions stored in UserDefaults to the Journal. This happens when ratings
+	/// are accessed for the first time (and not at init time), because the host application can only supply its
+	/// rating handlers after the shared instance was created. If it does, then the ratings are not stored in the
+	/// Journal and the UserDefaults entry is left alone.
+	
+	private func importLegacyRatingsIfNeeded()
+	{
+		legacyImportLock.lock()
+		defer { legacyImportLock.unlock() }
+		
+		guard needsLegacyImport else { return }
+		self.needsLegacyImport = false
+		
+		guard !usesRatingHandlers else { return }
+		self.journal.importLegacyRatings(from:.standard, forKey:Self.legacyRatingKey)
 	}
 	
 	
@@ -178,13 +370,18 @@ public class StatisticsController : ObservableObject
 	
 	public func setRating(_ rating:Int, for object:Object, sendNotifications:Bool = true)
 	{
-		if rating > 0
+		let rating = max(0,rating)
+		
+		if usesRatingHandlers
 		{
-			self._rating[object.identifier] = rating
+			lock.lock()
+			self._rating[object.identifier] = rating > 0 ? rating : nil
+			lock.unlock()
 		}
 		else
 		{
-			self._rating[object.identifier] = nil
+			self.importLegacyRatingsIfNeeded()
+			self.journal.setValue(rating, .rating, for:object.handle)
 		}
 		
 		if sendNotifications
@@ -202,14 +399,41 @@ public class StatisticsController : ObservableObject
 	
 	public func rating(for object:Object) -> Int
 	{
-		max(0, self.rating(for:object.identifier))
+		if usesRatingHandlers
+		{
+			return max(0, self.rating(for:object.identifier))
+		}
+		
+		self.importLegacyRatingsIfNeeded()
+		return max(0, self.journal.value(.rating, for:object.handle))
+	}
+	
+	/// Returns the rating for the specified Object.Record, e.g. when filtering or sorting a lazy ObjectList
+	
+	public func rating(for record:Object.Record) -> Int
+	{
+		if usesRatingHandlers
+		{
+			return max(0, self.rating(for:record.identifier))
+		}
+		
+		self.importLegacyRatingsIfNeeded()
+		return max(0, self.journal.value(.rating, for:record.handle))
 	}
 	
 	/// Returns the rating for the specified Object identifier
 	
 	public func rating(for identifier:String) -> Int
 	{
-		self._rating[identifier] ?? 0
+		if usesRatingHandlers
+		{
+			lock.lock()
+			defer { lock.unlock() }
+			return self._rating[identifier] ?? 0
+		}
+		
+		self.importLegacyRatingsIfNeeded()
+		return self.journal.value(.rating, for:identifier)
 	}
 
 }
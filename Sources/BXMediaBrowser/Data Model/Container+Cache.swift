@@ -45,7 +45,7 @@ extension Container
 			
 			await MainActor.run
 			{
-				self.objects.forEach { $0.purge() }
+				self.objects.materializedObjects.forEach { $0.purge() }
 				self.purgeTask = nil
 			}
 		}
@@ -0,0 +1,85 @@
+//----------------------------------------------------------------------------------------------------------------------
+//
+//  Copyright ©2026 Peter Baumgartner. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//----------------------------------------------------------------------------------------------------------------------
+
+
+import Foundation
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+// MARK: - Near Duplicates
+
+extension Container
+{
+	/// Returns groups of near duplicate Objects in this Container, e.g. bursts of nearly identical frames. Objects
+	/// whose thumbnails have not been analyzed yet are not considered.
+	
+	@MainActor public func duplicateGroups(maxDistance:Int = 3) -> [[Object]]
+	{
+		let store = PixelAnalysis.Store.shared
+		let objects = self.objects
+		var positions:[String:Int] = [:]
+		
+		// Only look at the Records, so that just the members of the resulting groups need to be materialized
+		
+		let entries:[(String,UInt64)] = objects.indices.compactMap
+		{
+			i in
+			let identifier = objects.record(at:i).identifier
+			guard let hash = store.analysis(for:identifier)?.perceptualHash else { return nil }
+			positions[identifier] = i
+			return (identifier,hash)
+		}
+		
+		let index = PerceptualHashIndex(entries)
+		
+		return index.duplicateGroups(maxDistance:maxDistance).map
+		{
+			$0.compactMap { positions[$0].map { objects[$0] } }
+		}
+	}
+	
+	/// Returns the Objects in this Container that look similar to the specified Object, ordered by similarity
+	
+	@MainActor public func objects(similarTo object:Object, maxDistance:Int = 8) -> [Object]
+	{
+		let index = PixelAnalysis.Store.shared.perceptualHashIndex
+		let matches = index.similar(to:object.identifier, maxDistance:maxDistance)
+		guard !matches.isEmpty else { return [] }
+		
+		let objects = self.objects
+		let positions = Dictionary(objects.handles.enumerated().map { ($1,$0) }, uniquingKeysWith:{ a,_ in a })
+		
+		return matches.compactMap
+		{
+			match in
+			guard let handle = IdentifierTable.shared.existingHandle(for:match.identifier) else { return nil }
+			return positions[handle].map { objects[$0] }
+		}
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
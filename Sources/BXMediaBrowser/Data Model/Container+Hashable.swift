@@ -27,12 +27,12 @@ extension Container : Hashable
 {
 	public func hash(into hasher:inout Hasher)
 	{
-		hasher.combine(identifier)
+		hasher.combine(handle)
 	}
 	
 	public static func ==(lhs:Container, rhs:Container) -> Bool
 	{
-		lhs.identifier == rhs.identifier
+		lhs.handle == rhs.handle
 	}
 
 	
@@ -41,6 +41,19 @@ extension Container : Hashable
 		let address = Unmanaged.passUnretained(self).toOpaque()
 		return "\(identifier) (\(address))"
 	}
+	
+	/// Returns true if a newly loaded Container describes the same thing as this instance, so that this instance
+	/// can be kept when the parent Container is reloaded. If the data cannot be compared, a Container is never
+	/// considered equivalent, because it might have been loaded with different information.
+	
+	func isEquivalent(to other:Container) -> Bool
+	{
+		guard type(of:self) == type(of:other) else { return false }
+		guard self.handle == other.handle else { return false }
+		guard self.name == other.name && self.icon == other.icon else { return false }
+		guard let data = self.data as? AnyHashable, let otherData = other.data as? AnyHashable else { return false }
+		return data == otherData
+	}
 }
 
 
@@ -41,9 +41,9 @@ extension Container
 		
 		public let loadHandler:LoadHandler
 	
-		/// A Container has an array of (sub) Containers and an array of Objects
-		
-		public typealias Contents = ([Container],[Object])
+		/// A Container has an array of (sub) Containers and a list of Objects
+
+		public typealias Contents = ([Container],ObjectList)
 		
 		/// The LoadHandler is a pure function closure that returns the Contents of a Container
 		
@@ -63,7 +63,15 @@ extension Container
 		{
 			try await Tasks.canContinue()
 			
-			return try await self.loadHandler(identifier,data,filter,library)
+			let source = Metrics.source(for:identifier)
+			let active = Metrics.shared.gauge(.containerLoadsActive, source:source)
+			active.increment()
+			defer { active.decrement() }
+			
+			return try await Metrics.shared.time(.containerLoadLatency, failures:.containerLoadFailures, source:source)
+			{
+				try await self.loadHandler(identifier,data,filter,library)
+			}
 		}
 	}
 }
@@ -24,6 +24,7 @@
 
 
 import BXSwiftUtils
+import Combine
 import SwiftUI
 
 
@@ -43,6 +44,10 @@ open class Container : ObservableObject, Identifiable, StateSaving, BXSignpostMi
 	
 	public let identifier:String
 	
+	/// The interned handle for the identifier. Use it for fast identity checks, hashing and dictionary keys.
+	
+	public let handle:IdentifierHandle
+	
 	/// An SFSymbol name for the container icon
 	
 	public let icon:String?
@@ -73,9 +78,15 @@ open class Container : ObservableObject, Identifiable, StateSaving, BXSignpostMi
 	
 	@MainActor @Published public private(set) var containers:[Container] = []
 	
-	/// The list of MediaObjects in this container
+	/// The list of MediaObjects in this container. Depending on the Source, the Objects may only be materialized
+	/// when they are accessed, so use the count, Records or handles of the list where possible.
+	
+	@MainActor @Published public private(set) var objects:ObjectList = []
 	
-	@MainActor @Published public private(set) var objects:[Object] = []
+	/// This publisher fires whenever the objects list is modified in place (e.g. when Objects are resorted after a
+	/// rating change), so that views can update right away instead of waiting for a debounced objects update.
+	
+	public let objectChangesPublisher = PassthroughSubject<Void,Never>()
 	
 	/// The number of MediaObjects in this container. This property can be accessed outside the main thread, but its value might not be current.
 	
@@ -100,6 +111,16 @@ open class Container : ObservableObject, Identifiable, StateSaving, BXSignpostMi
 		didSet { updateChildVisibility() }
 	}
 	
+	/// Expands or collapses this Container on behalf of the user. Unlike setting isExpanded directly, which also
+	/// happens when restoring the state or replaying a session, this records the change in the browsing session.
+	
+	public func setExpandedByUser(_ isExpanded:Bool)
+	{
+		guard isExpanded != self.isExpanded else { return }
+		self.isExpanded = isExpanded
+		library?.sessionRecorder?.recordExpansion(of:self)
+	}
+	
 	/// Returns true if this container is currently visible, i.e. its parent is expanded.
 	
 	@Published public var isVisible = false
@@ -108,6 +129,14 @@ open class Container : ObservableObject, Identifiable, StateSaving, BXSignpostMi
 	
 	private var loadTask:Task<Void,Never>? = nil
 	
+	/// The priority class of the current (or last) load. Speculative loads by the Preloader run at .indexing priority.
+	
+	public private(set) var loadPriority:Tasks.Priority = .contents
+	
+	/// The priority class for the next call of load(with:in:), which is reset to .contents afterwards
+	
+	private var requestedLoadPriority:Tasks.Priority? = nil
+	
 	/// This task is used to only show the loading spinner if loading takes a while
 	
 //	private var spinnerTask:Task<Void,Never>? = nil
@@ -116,6 +145,19 @@ open class Container : ObservableObject, Identifiable, StateSaving, BXSignpostMi
 	
 	internal var purgeTask:Task<Void,Never>? = nil
 	
+	/// Identifiers of Objects whose thumbnail colors became known and need to be checked against the color filter
+	
+	private var pendingColorFilterIdentifiers:Set<String> = []
+	
+	/// The number of Objects whose thumbnails have not been analyzed yet. As long as this is greater than 0, the
+	/// color filter is only partially applied, since unanalyzed Objects are included until their colors are known.
+	
+	@MainActor @Published public private(set) var unanalyzedObjectCount = 0
+	
+	/// The Task that analyzes the thumbnails of unanalyzed Objects while the color filter is active
+	
+	private var colorAnalysisTask:Task<Void,Never>? = nil
+	
 	/// An optional helper that can copy dropped file to this Container
 	
 	#if os(macOS)
@@ -140,6 +182,7 @@ open class Container : ObservableObject, Identifiable, StateSaving, BXSignpostMi
 
 		self.library = library
 		self.identifier = identifier
+		self.handle = IdentifierTable.shared.handle(for:identifier)
 		self.icon = icon
 		self.name = name
 		self.data = data
@@ -173,31 +216,20 @@ open class Container : ObservableObject, Identifiable, StateSaving, BXSignpostMi
 				[weak self] _ in
 				guard let self = self else { return }
 				guard self.isSelected else { return }
+				self.library?.sessionRecorder?.recordFilter(of:self)
 				self.load(in:library)
 			}
 
-		// If this container is set to sort by rating and an Object rating has changed, then also reload
+		// If ratings or useCounts have changed, then reposition the affected Objects instead of reloading everything.
+		// StatisticsController coalesces changes, so rating many Objects in quick succession results in a single update.
 		
-		self.observers += NotificationCenter.default.publisher(for:StatisticsController.ratingNotification, object:nil)
-			.debounce(for:1.0, scheduler:RunLoop.main)
-			.sink
-			{
-				[weak self] _ in
-				guard let self = self else { return }
-				guard self.isSelected else { return }
-				guard self.filter.sortType == .rating else { return }
-				self.load(in:library)
-			}
-			
-		self.observers += NotificationCenter.default.publisher(for:StatisticsController.didChangeNotification, object:nil)
-			.debounce(for:1.0, scheduler:RunLoop.main)
+		self.observers += NotificationCenter.default.publisher(for:StatisticsController.didChangeStatisticsNotification, object:nil)
+			.compactMap { $0.object as? StatisticsController.ChangeSet }
+			.receive(on:RunLoop.main)
 			.sink
 			{
-				[weak self] _ in
-				guard let self = self else { return }
-				guard self.isSelected else { return }
-				guard self.filter.sortType == .useCount else { return }
-				self.load(in:library)
+				[weak self] changeSet in
+				self?.applyStatisticsChanges(changeSet)
 			}
 	}
 	
@@ -230,6 +262,10 @@ open class Container : ObservableObject, Identifiable, StateSaving, BXSignpostMi
 		self.loadTask?.cancel()
 		self.loadTask = nil
 		
+		let priority = self.requestedLoadPriority ?? .contents
+		self.requestedLoadPriority = nil
+		self.loadPriority = priority
+		
 		// Show spinning wheel after 0.15s
 		
 //		let spinnerTask = Task
@@ -248,46 +284,49 @@ open class Container : ObservableObject, Identifiable, StateSaving, BXSignpostMi
 		{
 			do
 			{
-				try await Tasks.canContinue()
+				try await Tasks.canContinue(priority)
 				
 				BXMediaBrowser.logDataModel.debug {"\(Self.self).\(#function) \(identifier)"}
 
 				let token = self.beginSignpost(in:"Container","load")
-				defer { self.endSignpost(with:token, in:"Container","load") }
+				let span = TraceRecorder.begin("Container","load",["identifier":identifier])
+				defer { self.endSignpost(with:token, in:"Container","load"); TraceRecorder.end(span) }
 		
-				// Show spinning wheel
+				// Show spinning wheel. If this Container was selected at the end of the previous session, then
+				// display the Objects from the StartupSnapshot until the real Objects have been loaded.
 				
 				await MainActor.run
 				{
 					self.isLoading = true
+					
+					if self.objects.isEmpty, let placeholders = self.library?.startupSnapshot?.placeholderObjects(for:self, in:library)
+					{
+						self.objects = ObjectList(placeholders)
+						self.objectCount = placeholders.count
+					}
 				}
 				
 				// Get new list of (sub)containers and objects
 				
 				let (containers,objects) = try await self.loader.contents(with:data, filter:filter, in:library)
 				let containerNames = containers.map { $0.name }.joined(separator:", ")
-				let objectNames = objects.map { $0.name }.joined(separator:", ")
+				let objectNames = objects.indices.map { objects.record(at:$0).name }.joined(separator:", ")
 				BXMediaBrowser.logDataModel.verbose {"    containers = \(containerNames)"}
 				BXMediaBrowser.logDataModel.verbose {"    objects = \(objectNames)"}
 				
 				// Remove duplicate objects - NSDiffableDataSource that is being used with the NSCollectionView
-				// throws a hissy fit (and exceptions) when encountering duplicate identifiers.
+				// throws a hissy fit (and exceptions) when encountering duplicate identifiers. The color filter is
+				// applied here for all Sources, since it only needs the persisted PixelAnalysis of each thumbnail.
+				// Both only look at the Records, so no Objects are materialized here.
 				
-				let uniqueObjects = objects.removingDuplicates()
+				let uniqueObjects = objects.removingDuplicateHandles().filter(records:
 				{
-					$0.identifier
-				}
+					filter.matchesColor(of:$0.identifier)
+				})
 				
 				// Link the objects
 				
-				var prev:Object? = nil
-				
-				for object in uniqueObjects
-				{
-					prev?.next = object
-					object.next = nil
-					prev = object
-				}
+				uniqueObjects.link()
 				
 				// Check if this container should be expanded
 				
@@ -301,7 +340,18 @@ open class Container : ObservableObject, Identifiable, StateSaving, BXSignpostMi
 				
 				await MainActor.run
 				{
-					self.containers = containers
+					// Keep the existing instances of subcontainers that did not change, so that the views observing
+					// them are not rebuilt and their state survives reloading this Container
+					
+					let batch = ListDiff.batch(from:self.containers, to:containers, identifiedBy:{ $0.handle }, isUpdated:{ !$0.isEquivalent(to:$1) })
+					let mergedContainers = batch.applied(to:self.containers, new:containers)
+					let newInstances = Set(containers.map { ObjectIdentifier($0) })
+					
+					if !self.containers.elementsEqual(mergedContainers, by:===)
+					{
+						self.containers = mergedContainers
+					}
+					
 					self.objects = uniqueObjects
 					self.objectCount = uniqueObjects.count
 					self.isExpanded = isExpanded
@@ -311,18 +361,27 @@ open class Container : ObservableObject, Identifiable, StateSaving, BXSignpostMi
 						self.library?.selection.loadCount += 1
 					}
 
-					// Restore isExpanded state of containers
+					// Restore isExpanded state of new containers. Kept containers that are expanded are reloaded,
+					// just like their replacements would have been loaded.
 					
-					for container in containers
+					for container in mergedContainers
 					{
-						let state = containerState?[container.stateKey] as? [String:Any]
-						let isExpanded = state?[container.isExpandedKey] as? Bool ?? false
-						if isExpanded { container.load(with:state, in:library) }
+						if newInstances.contains(ObjectIdentifier(container))
+						{
+							let state = containerState?[container.stateKey] as? [String:Any] ?? library?.restoredState(forKey:container.stateStoreKey)
+							let isExpanded = state?[container.isExpandedKey] as? Bool ?? false
+							if isExpanded { container.load(with:state, in:library) }
+						}
+						else if container.isExpanded
+						{
+							container.load(in:library)
+						}
 					}
 					
 					self.isLoaded = true
 					self.isLoading = false
 					self.loadTask = nil
+					self.analyzeColorsIfNeeded()
 				}
 			}
 			catch let error
@@ -331,18 +390,46 @@ open class Container : ObservableObject, Identifiable, StateSaving, BXSignpostMi
 				{
 					self.isLoading = false
 					self.isLoaded = false
+					
+					// The placeholders from the StartupSnapshot are only valid until the real load has finished. They
+					// are never handed out again, so don't leave them behind if the load failed or was cancelled.
+					
+					if Library.StartupSnapshot.containsPlaceholders(self.objects)
+					{
+						self.objects = []
+						self.objectCount = 0
+					}
 				}
 				
 				if let error = error as? Container.Error, error == .loadContentsCancelled
 				{
 					BXMediaBrowser.logDataModel.warning {"\(Self.self).\(#function) ERROR \(error)"}
 				}
+				else if error is CancellationError
+				{
+					BXMediaBrowser.logDataModel.warning {"\(Self.self).\(#function) ERROR \(error)"}
+				}
 				else
 				{
 					BXMediaBrowser.logDataModel.error {"\(Self.self).\(#function) ERROR \(error)"}
 				}
 			}
 		}
+		
+		// Speculative loads belong to the Preloader. Loading the selected Container (e.g. the next page of a paged
+		// Container) is cancelled when a different Container is selected.
+		
+		if let task = self.loadTask
+		{
+			if priority == .indexing
+			{
+				library?.preloader?.cancellationScope.attach(task)
+			}
+			else if self.isSelected
+			{
+				library?.selection.cancellationScope.attach(task)
+			}
+		}
 	}
 	
 	
@@ -370,7 +457,9 @@ open class Container : ObservableObject, Identifiable, StateSaving, BXSignpostMi
 		{
 			await MainActor.run
 			{
+				let removedContainers = self.containers.filter { $0.identifier == identifier }
 				self.containers = self.containers.filter { $0.identifier != identifier }
+				removedContainers.forEach { self.library?.removeState(of:$0) }
 			}
 		}
 	}
@@ -382,6 +471,27 @@ open class Container : ObservableObject, Identifiable, StateSaving, BXSignpostMi
 	{
 		self.isLoaded = false
 	}
+
+
+	/// Loads the contents at the specified priority class. Subclasses that override load(with:in:) are still called.
+	
+	func load(in library:Library?, priority:Tasks.Priority)
+	{
+		self.requestedLoadPriority = priority
+		self.load(in:library)
+	}
+
+
+	/// Cancels loading that is still in progress, e.g. a speculative load by the Preloader that is no longer needed
+
+	@MainActor func cancelLoading()
+	{
+		guard let task = self.loadTask else { return }
+
+		task.cancel()
+		self.loadTask = nil
+		self.isLoading = false
+	}
 	
 	
 	/// If the container caches any expensive data, calling this function will discard any cached data
@@ -428,8 +538,7 @@ open class Container : ObservableObject, Identifiable, StateSaving, BXSignpostMi
 	
 	public func state() async -> [String:Any]
 	{
-		var state:[String:Any] = [:]
-		state[isExpandedKey] = self.isExpanded
+		var state = await self.ownState()
 
 		let containers = await self.containers
 
@@ -443,6 +552,13 @@ open class Container : ObservableObject, Identifiable, StateSaving, BXSignpostMi
 		return state
 	}
 
+	/// Returns the state of this Container only, without the state of its subcontainers
+	
+	public func ownState() async -> [String:Any]
+	{
+		[isExpandedKey:self.isExpanded]
+	}
+
 	/// The key for the state dictionary of this Container
 	
 	internal var stateKey:String
@@ -516,6 +632,218 @@ open class Container : ObservableObject, Identifiable, StateSaving, BXSignpostMi
 	}
 	
 	
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	// MARK: - Statistics
+	
+	/// Updates the objects array after ratings or useCounts have changed. If the Objects are sorted by rating
+	/// or useCount the affected Objects are moved to their new positions. If the rating filter is active, Objects
+	/// that no longer qualify are removed, and Objects that start to qualify are added by reloading.
+	
+	@MainActor func applyStatisticsChanges(_ changeSet:StatisticsController.ChangeSet)
+	{
+		guard self.isLoaded && !self.isLoading else { return }
+		
+		let sortType = self.filter.sortType
+		let isSortedByStatistics = sortType == .rating || sortType == .useCount
+		let minRating = self.filter.rating
+		guard isSortedByStatistics || minRating > 0 else { return }
+
+		// If everything changed at once, then we have to start from scratch
+		
+		if changeSet.containsAll
+		{
+			if self.isSelected { self.load(in:library) }
+			return
+		}
+		
+		// Otherwise only touch the changed Objects
+		
+		let token = self.beginSignpost(in:"Container","applyStatisticsChanges")
+		let span = TraceRecorder.begin("Container","applyStatisticsChanges",["identifier":identifier, "changes":String(changeSet.identifiers.count)])
+		defer { self.endSignpost(with:token, in:"Container","applyStatisticsChanges"); TraceRecorder.end(span) }
+
+		var objects = self.objects
+		
+		// Objects that were excluded by the rating filter are not in the list at all. If one of them qualifies
+		// now, then the Container has to be loaded again to include it.
+		
+		if minRating > 0 && self.isSelected
+		{
+			let handles = Set(objects.handles)
+			
+			let hasNewlyIncludedObjects = changeSet.identifiers.contains
+			{
+				identifier in
+				let handle = IdentifierTable.shared.existingHandle(for:identifier)
+				let isListed = handle.map { handles.contains($0) } ?? false
+				return !isListed && StatisticsController.shared.rating(for:identifier) >= minRating
+			}
+			
+			if hasNewlyIncludedObjects
+			{
+				self.load(in:library)
+				return
+			}
+		}
+		
+		let didChange = objects.reposition(
+			changeSet.identifiers,
+			comparator: isSortedByStatistics ? self.filter.objectComparator : nil,
+			isIncluded: { minRating == 0 || StatisticsController.shared.rating(for:$0) >= minRating })
+			
+		guard didChange else { return }
+		
+		objects.link()
+		self.objects = objects
+		self.objectCount = objects.count
+		self.objectChangesPublisher.send()
+	}
+	
+	
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	/// While the color filter is active, the thumbnails of all Objects that have not been analyzed yet are loaded in
+	/// the background, so that the filter result becomes complete without the user having to scroll through the
+	/// whole Container. Objects that turn out not to match are then removed by applyColorFilter(). Records whose
+	/// Objects have not been created yet are analyzed by loadThumbnail(for:), so a lazy ObjectList stays lazy.
+	
+	@MainActor func analyzeColorsIfNeeded()
+	{
+		self.colorAnalysisTask?.cancel()
+		self.colorAnalysisTask = nil
+		self.unanalyzedObjectCount = 0
+		
+		guard self.filter.color != nil else { return }
+		
+		let store = PixelAnalysis.Store.shared
+		let objects = self.objects
+		let positions = objects.indices.filter { store.analysis(for:objects.record(at:$0).identifier) == nil }
+		guard !positions.isEmpty else { return }
+		
+		self.unanalyzedObjectCount = positions.count
+		
+		let task = Task
+		{
+			[weak self] in
+			
+			for position in positions
+			{
+				// Analysis has lower priority than anything the user is waiting for
+				
+				do { try await Tasks.canContinue(.indexing) } catch { return }
+				
+				let record = objects.record(at:position)
+				
+				if let object = objects.materializedObject(at:position)
+				{
+					_ = try? await object.loader.thumbnailImage
+					
+					// Do not keep thumbnails in memory that are not displayed
+					
+					let isDisplayed = await MainActor.run { object.thumbnailImage != nil }
+					if !isDisplayed { await object.loader.purge() }
+				}
+				else if let image = try? await self?.loadThumbnail(for:record)
+				{
+					Self.analyze(image, for:record.identifier)
+				}
+				
+				guard !Task.isCancelled else { return }
+				
+				await MainActor.run
+				{
+					guard let self = self else { return }
+					self.unanalyzedObjectCount = max(0, self.unanalyzedObjectCount-1)
+					self.setNeedsApplyColorFilter(to:record.identifier)
+				}
+			}
+		}
+		
+		self.colorAnalysisTask = task
+		
+		// Analysis is cancelled when a different Container is selected
+		
+		if self.isSelected
+		{
+			library?.selection.cancellationScope.attach(task)
+		}
+	}
+	
+	
+	/// Loads the thumbnail of a Record without creating its Object, so that its colors can be analyzed. The default
+	/// implementation returns nil, i.e. the Record is skipped. Containers with lazy ObjectLists should override it.
+	
+	func loadThumbnail(for record:Object.Record) async throws -> CGImage?
+	{
+		nil
+	}
+	
+	
+	/// Stores the PixelAnalysis of a thumbnail that was loaded by loadThumbnail(for:), unless a loadThumbnailHandler
+	/// already stored it while validating the thumbnail
+	
+	private static func analyze(_ image:CGImage, for identifier:String)
+	{
+		let store = PixelAnalysis.Store.shared
+		guard store.analysis(for:identifier)?.perceptualHash == nil else { return }
+		guard let analysis = PixelAnalysis(image) else { return }
+		store.setAnalysis(analysis, for:identifier)
+	}
+	
+	
+	/// Schedules a check whether the specified Object still qualifies for the color filter. Checks are coalesced,
+	/// since many thumbnails finish loading in quick succession while scrolling.
+	
+	@MainActor func setNeedsApplyColorFilter(to object:Object)
+	{
+		self.setNeedsApplyColorFilter(to:object.identifier)
+	}
+	
+	/// Same as above, but for an Object that may not have been created
+	
+	@MainActor func setNeedsApplyColorFilter(to identifier:String)
+	{
+		guard self.filter.color != nil else { return }
+		
+		let isScheduled = !pendingColorFilterIdentifiers.isEmpty
+		self.pendingColorFilterIdentifiers.insert(identifier)
+		guard !isScheduled else { return }
+		
+		DispatchQueue.main.async
+		{
+			[weak self] in self?.applyColorFilter()
+		}
+	}
+	
+	/// Removes the Objects that turned out not to match the color filter after their thumbnails were analyzed
+	
+	@MainActor func applyColorFilter()
+	{
+		let identifiers = self.pendingColorFilterIdentifiers
+		self.pendingColorFilterIdentifiers = []
+		
+		guard self.isLoaded && !self.isLoading else { return }
+		
+		let filter = self.filter
+		var objects = self.objects
+		
+		let didChange = objects.reposition(
+			identifiers,
+			comparator: nil,
+			isIncluded: { filter.matchesColor(of:$0.identifier) })
+			
+		guard didChange else { return }
+		
+		objects.link()
+		self.objects = objects
+		self.objectCount = objects.count
+		self.objectChangesPublisher.send()
+	}
+	
+	
 //----------------------------------------------------------------------------------------------------------------------
 
 
@@ -0,0 +1,665 @@
+//----------------------------------------------------------------------------------------------------------------------
+//
+//  Copyright ©2026 Peter Baumgartner. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//----------------------------------------------------------------------------------------------------------------------
+
+
+import Combine
+import Foundation
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+extension Library
+{
+	/// The Preloader learns how the user navigates between Containers and speculatively loads the Containers that
+	/// are most likely to be selected next, so that selecting them doesn't start from a cold state.
+	///
+	/// Three patterns are taken into account: the frequencies of transitions between Containers, walking sibling
+	/// Containers in order, and returning to recently selected Containers. Preloading is strictly budgeted. It only
+	/// starts once the selected Container has finished loading, loads one Container at a time, spends at most a
+	/// fraction of the wall clock time (dutyCycle) on loading, is parked while the .indexing priority class is
+	/// suspended (see Tasks), and is cancelled as soon as the user selects a different Container.
+
+	public final class Preloader
+	{
+		/// The maximum number of Containers that are preloaded after each selection
+
+		public var maxPredictions = 2
+
+		/// Containers with a lower score (0...1) are not preloaded
+
+		public var minimumScore = 0.25
+
+		/// The number of thumbnails (i.e. the first screen) that are preloaded for each Container. Set to 0 to only
+		/// load the contents.
+
+		public var thumbnailCount = 0
+
+		/// Preloading starts after the selected Container has finished loading and this delay has passed
+
+		public var idleDelay:TimeInterval = 0.5
+
+		/// The maximum fraction of wall clock time that is spent on preloading. After a preload took t seconds,
+		/// the Preloader pauses for t * (1/dutyCycle - 1) seconds.
+
+		public var dutyCycle = 0.25
+
+		/// The file that persists the learned navigation model. If nil, the model only lives in memory.
+
+		public let fileURL:URL?
+
+		/// The learned navigation model
+
+		public private(set) var model = Model()
+
+		/// The Library whose selection is observed
+
+		private weak var library:Library? = nil
+
+		/// The identifier of the previously selected Container
+
+		private var previousIdentifier:String? = nil
+
+		/// The currently running preload Task
+
+		private var task:Task<Void,Never>? = nil
+
+		/// Speculative loads are attached to this scope instead of the scope of the selected Container, so that they
+		/// are only cancelled when the Preloader decides so. This property can be read from any thread.
+
+		public var cancellationScope:CancellationScope
+		{
+			lock.lock()
+			defer { lock.unlock() }
+			return _cancellationScope
+		}
+
+		private var _cancellationScope = CancellationScope(name:"Preloader")
+
+		/// This lock is used to ensure thread-safe access to the cancellationScope
+
+		private let lock = NSLock()
+
+		/// Containers that were loaded speculatively and haven't been selected yet
+
+		private var preloadedContainers:[IdentifierHandle:Container] = [:]
+
+		/// Invalidates preloaded Containers when their Filter changes
+
+		private var filterObservers:[IdentifierHandle:AnyCancellable] = [:]
+
+		/// References to subscriptions
+
+		private var observers:[Any] = []
+
+		/// Writing is performed on this queue
+
+		private let queue = DispatchQueue(label:"com.boinx.BXMediaBrowser.Library.Preloader")
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+		/// Creates a Preloader. If a fileURL is specified, the learned model is read from and saved to this file.
+
+		public init(fileURL:URL? = nil)
+		{
+			self.fileURL = fileURL
+
+			if let fileURL = fileURL, let data = try? Data(contentsOf:fileURL), let model = try? JSONDecoder().decode(Model.self, from:data)
+			{
+				self.model = model
+			}
+		}
+
+		/// The default location is next to the file of the StateStore
+
+		public static func defaultFileURL(for library:Library) -> URL
+		{
+			StateStore.defaultFileURL(for:library)
+				.deletingPathExtension()
+				.appendingPathExtension("navigation")
+		}
+
+		/// Starts observing the selection of the specified Library
+
+		func observe(_ library:Library)
+		{
+			self.library = library
+			self.observers = []
+
+			self.observers += library.selection.$container
+				.filter { !($0 is StartupSnapshot.PlaceholderContainer) }
+				.removeDuplicates { $0 === $1 }
+				.sink
+				{
+					[weak self] container in
+
+					Task
+					{
+						@MainActor in self?.didSelect(container)
+					}
+				}
+		}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+		// MARK: - Learning
+
+		/// Learns from the new selection and starts preloading the most likely next Containers
+
+		@MainActor func didSelect(_ container:Container?)
+		{
+			self.task?.cancel()
+			self.task = nil
+
+			lock.lock()
+			let previousScope = _cancellationScope
+			_cancellationScope = CancellationScope(name:"Preloader")
+			lock.unlock()
+
+			previousScope.cancel()
+
+			// Abort speculative loads that were not needed after all
+
+			for (handle,preloaded) in preloadedContainers where preloaded !== container && preloaded.isLoading
+			{
+				preloaded.cancelLoading()
+				preloadedContainers[handle] = nil
+				filterObservers[handle] = nil
+			}
+
+			guard let container = container else { return }
+
+			// Count the hits, i.e. selected Containers that were already loaded by the Preloader
+
+			let source = Metrics.source(for:container.identifier)
+
+			if preloadedContainers.removeValue(forKey:container.handle) != nil
+			{
+				filterObservers[container.handle] = nil
+				Metrics.shared.counter(.containerPreloadHits, source:source).increment()
+				
+				// If the speculative load is still running, restart it at the priority of a regular load, since
+				// the user is waiting for it now
+				
+				if container.isLoading && container.loadPriority == .indexing
+				{
+					container.load(in:library)
+				}
+			}
+
+			// Update the model
+
+			let siblings = self.siblings(of:container)?.map { $0.identifier } ?? []
+			let isSiblingStep = previousIdentifier.map { siblings.contains($0) } ?? false
+			model.learn(from:previousIdentifier, to:container.identifier, isSiblingStep:isSiblingStep)
+
+			let previousIdentifier = self.previousIdentifier
+			self.previousIdentifier = container.identifier
+			self.save()
+
+			// Start preloading
+
+			let predictions = model.predictions(for:container.identifier, previous:previousIdentifier, siblings:siblings)
+				.filter { $0.score >= minimumScore }
+				.prefix(maxPredictions)
+
+			guard !predictions.isEmpty else { return }
+
+			self.task = Task
+			{
+				@MainActor in
+				await self.preload(predictions.map { $0.identifier }, after:container)
+			}
+		}
+
+
+		/// Writes the model to the file
+
+		private func save()
+		{
+			guard let fileURL = fileURL else { return }
+			let model = self.model
+
+			queue.async
+			{
+				do
+				{
+					try JSONEncoder().encode(model).write(to:fileURL, options:.atomic)
+				}
+				catch
+				{
+					BXMediaBrowser.logDataModel.error {"\(Self.self).\(#function) ERROR \(error)"}
+				}
+			}
+		}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+		// MARK: - Preloading
+
+		/// Loads the specified Containers one after the other, once the selected Container has finished loading
+
+		@MainActor private func preload(_ identifiers:[String], after selectedContainer:Container) async
+		{
+			do
+			{
+				try await Task.sleep(nanoseconds:UInt64(idleDelay * 1_000_000_000))
+				
+				try await Waiter(Publishers.CombineLatest(selectedContainer.$isLoaded, selectedContainer.$isLoading)
+					.filter { isLoaded,isLoading in isLoaded && !isLoading })
+					.wait(timeout:30)
+
+				for identifier in identifiers
+				{
+					guard let container = self.loadedContainer(with:identifier) else { continue }
+					guard !container.isLoaded && !container.isLoading else { continue }
+
+					try await Tasks.canContinue(.indexing)
+					try Task.checkCancellation()
+
+					BXMediaBrowser.logDataModel.debug {"\(Self.self).\(#function) \(identifier)"}
+
+					let span = TraceRecorder.begin("Library","preload",["identifier":identifier])
+					defer { TraceRecorder.end(span) }
+					let start = DispatchTime.now().uptimeNanoseconds
+
+					// Load the contents
+
+					self.preloadedContainers[container.handle] = container
+					self.observeFilter(of:container)
+					Metrics.shared.counter(.containerPreloads, source:Metrics.source(for:identifier)).increment()
+
+					// Subscribe before loading starts, so that the end of loading cannot be missed. Speculative loading
+					// runs at .indexing priority, so that it yields to everything the user is waiting for.
+
+					let didLoad = Waiter(container.$isLoading.drop { !$0 }.filter { !$0 })
+					container.load(in:library, priority:.indexing)
+					try await didLoad.wait(timeout:30)
+
+					// Load the first screen of thumbnails. They are purged again after a while if the Container
+					// doesn't get selected.
+
+					if thumbnailCount > 0 && container.isLoaded
+					{
+						let objects = container.objects
+						let count = min(thumbnailCount, objects.count)
+
+						for i in 0 ..< count
+						{
+							try await Tasks.canContinue(.indexing)
+							try Task.checkCancellation()
+							_ = try? await objects[i].loader.thumbnailImage
+						}
+
+						if !container.isSelected
+						{
+							container.purgeCachedDataOfObjects(after:60)
+						}
+					}
+
+					// Stay within the budget
+
+					let elapsed = Double(DispatchTime.now().uptimeNanoseconds - start) / 1_000_000_000
+					let pause = elapsed * (1.0 / max(dutyCycle,0.01) - 1.0)
+					try await Task.sleep(nanoseconds:UInt64(pause * 1_000_000_000))
+				}
+			}
+			catch
+			{
+				// Cancelled because a different Container was selected
+			}
+		}
+
+
+		/// A preloaded Container is reset to the unloaded state when its Filter changes, so that it will be loaded
+		/// with the new Filter when it gets selected.
+
+		@MainActor private func observeFilter(of container:Container)
+		{
+			let handle = container.handle
+
+			filterObservers[handle] = container.filter.objectWillChange.sink
+			{
+				[weak self, weak container] _ in
+
+				Task
+				{
+					@MainActor in
+
+					guard let self = self, let container = container else { return }
+					guard self.preloadedContainers[handle] === container else { return }
+					guard !container.isSelected else { return }
+
+					container.cancelLoading()
+					container.invalidateLoaded()
+					self.preloadedContainers[handle] = nil
+					self.filterObservers[handle] = nil
+				}
+			}
+		}
+
+
+		/// A Waiter suspends the calling Task until a publisher sends its first value. The subscription is made when
+		/// the Waiter is created, so that values that are sent before wait() is called are not missed.
+
+		final class Waiter
+		{
+			private var subscription:AnyCancellable? = nil
+			private var continuation:CheckedContinuation<Void,Error>? = nil
+			private var result:Result<Void,Error>? = nil
+			private let lock = NSLock()
+
+			init<P:Publisher>(_ publisher:P) where P.Failure == Never
+			{
+				let subscription = publisher.first().sink
+				{
+					[weak self] _ in self?.finish(with:.success(()))
+				}
+
+				lock.lock()
+				if result == nil { self.subscription = subscription }
+				lock.unlock()
+			}
+
+			/// Returns once the publisher has sent a value or the timeout has expired. Throws a CancellationError if
+			/// the Task was cancelled.
+
+			func wait(timeout:TimeInterval) async throws
+			{
+				let timeoutTask = Task
+				{
+					[weak self] in
+					try await Task.sleep(nanoseconds:UInt64(timeout * 1_000_000_000))
+					self?.finish(with:.success(()))
+				}
+
+				defer { timeoutTask.cancel() }
+
+				try await withTaskCancellationHandler(
+					handler:
+					{
+						self.finish(with:.failure(CancellationError()))
+					},
+					operation:
+					{
+						try await withCheckedThrowingContinuation
+						{
+							(continuation:CheckedContinuation<Void,Error>) in
+
+							lock.lock()
+
+							if let result = self.result
+							{
+								lock.unlock()
+								continuation.resume(with:result)
+							}
+							else
+							{
+								self.continuation = continuation
+								lock.unlock()
+							}
+						}
+					})
+			}
+
+			/// Stores the result and resumes the waiting Task. Only the first call has an effect.
+
+			private func finish(with result:Result<Void,Error>)
+			{
+				lock.lock()
+
+				guard self.result == nil else
+				{
+					lock.unlock()
+					return
+				}
+
+				self.result = result
+				let continuation = self.continuation
+				let subscription = self.subscription
+				self.continuation = nil
+				self.subscription = nil
+
+				lock.unlock()
+
+				subscription?.cancel()
+				continuation?.resume(with:result)
+			}
+		}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+		// MARK: - Lookup
+
+		/// Returns the Containers that share the parent of the specified Container (including the Container itself),
+		/// or nil if the Container is not part of the loaded tree.
+
+		@MainActor func siblings(of container:Container) -> [Container]?
+		{
+			guard let library = library else { return nil }
+			var parents:[[Container]] = library.sections.flatMap { $0.sources }.map { $0.containers }
+
+			while !parents.isEmpty
+			{
+				if let siblings = parents.first(where:{ siblings in siblings.contains { $0 === container } })
+				{
+					return siblings
+				}
+
+				parents = parents.flatMap { $0 }.map { $0.containers }.filter { !$0.isEmpty }
+			}
+
+			return nil
+		}
+
+		/// Searches the loaded tree for the Container with the specified identifier
+
+		@MainActor func loadedContainer(with identifier:String) -> Container?
+		{
+			guard let library = library else { return nil }
+			let handle = IdentifierTable.shared.handle(for:identifier)
+			var containers = library.sections.flatMap { $0.sources }.flatMap { $0.containers }
+
+			while !containers.isEmpty
+			{
+				if let container = containers.first(where:{ $0.handle == handle })
+				{
+					return container
+				}
+
+				containers = containers.flatMap { $0.containers }
+			}
+
+			return nil
+		}
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+extension Library.Preloader
+{
+	/// The Model contains the learned navigation statistics. It only works with Container identifiers, so that it
+	/// can be persisted and tested without a Library.
+
+	public struct Model : Codable
+	{
+		/// A Container that is likely to be selected next
+
+		public struct Prediction : Equatable
+		{
+			public let identifier:String
+			public let score:Double
+		}
+
+		/// The weighted number of transitions from one Container (key) to another (key of the inner dictionary)
+
+		public private(set) var transitions:[String:[String:Double]] = [:]
+
+		/// The weighted number of all transitions
+
+		public private(set) var transitionCount:Double = 0
+
+		/// The weighted number of transitions to a sibling of the previous Container
+
+		public private(set) var siblingStepCount:Double = 0
+
+		/// The weighted number of transitions to a recently selected Container
+
+		public private(set) var returnCount:Double = 0
+
+		/// The most recently selected Containers, the newest one last
+
+		public private(set) var recentIdentifiers:[String] = []
+
+		/// The number of recently selected Containers that are remembered
+
+		static let maxRecentCount = 8
+
+		/// The maximum number of destinations that are remembered for each Container
+
+		static let maxDestinationCount = 16
+
+		/// Once the weights of a Container exceed this value, they are halved, so that newer habits win over old ones
+
+		static let maxWeight = 32.0
+
+		public init()
+		{
+
+		}
+
+
+		/// Records a transition from the previous to the current Container
+
+		public mutating func learn(from previous:String?, to current:String, isSiblingStep:Bool)
+		{
+			if let previous = previous, previous != current
+			{
+				// Transition frequencies
+
+				var destinations = transitions[previous] ?? [:]
+				destinations[current, default:0] += 1
+
+				if destinations.values.reduce(0,+) > Self.maxWeight
+				{
+					destinations = destinations.mapValues { $0 * 0.5 }.filter { $0.value >= 0.25 }
+				}
+
+				if destinations.count > Self.maxDestinationCount
+				{
+					let weakest = destinations.min { $0.value < $1.value }!.key
+					destinations[weakest] = nil
+				}
+
+				transitions[previous] = destinations
+
+				// Global rates of sibling steps and returns
+
+				transitionCount += 1
+				if isSiblingStep { siblingStepCount += 1 }
+				if recentIdentifiers.contains(current) { returnCount += 1 }
+
+				if transitionCount > Self.maxWeight * 4
+				{
+					transitionCount *= 0.5
+					siblingStepCount *= 0.5
+					returnCount *= 0.5
+				}
+			}
+
+			recentIdentifiers.removeAll { $0 == current }
+			recentIdentifiers.append(current)
+
+			if recentIdentifiers.count > Self.maxRecentCount
+			{
+				recentIdentifiers.removeFirst(recentIdentifiers.count - Self.maxRecentCount)
+			}
+		}
+
+
+		/// Returns the Containers that are most likely to be selected after the current one, sorted by descending
+		/// score. The siblings contain the identifiers of the current Container and its siblings in display order.
+
+		public func predictions(for current:String, previous:String?, siblings:[String]) -> [Prediction]
+		{
+			var scores:[String:Double] = [:]
+
+			// Transition frequencies. The confidence grows with the number of observed transitions.
+
+			if let destinations = transitions[current]
+			{
+				let sum = destinations.values.reduce(0,+)
+				let confidence = sum / (sum + 1)
+
+				for (identifier,weight) in destinations
+				{
+					scores[identifier, default:0] += weight / sum * confidence
+				}
+			}
+
+			// The next sibling in the direction of the last sibling step
+
+			if let index = siblings.firstIndex(of:current)
+			{
+				let siblingRate = (siblingStepCount + 0.5) / (transitionCount + 1)
+				let isWalkingBackwards = previous != nil && index+1 < siblings.count && siblings[index+1] == previous
+				let next = isWalkingBackwards ? index-1 : index+1
+
+				if next >= 0 && next < siblings.count
+				{
+					scores[siblings[next], default:0] += siblingRate
+				}
+			}
+
+			// Recently selected Containers, the most recent ones first
+
+			let returnRate = (returnCount + 0.25) / (transitionCount + 1)
+
+			for (rank,identifier) in recentIdentifiers.reversed().filter({ $0 != current }).enumerated()
+			{
+				scores[identifier, default:0] += returnRate / Double(rank + 1)
+			}
+
+			scores[current] = nil
+
+			return scores
+				.map { Prediction(identifier:$0.key, score:min($0.value,1)) }
+				.sorted { $0.score > $1.score || $0.score == $1.score && $0.identifier < $1.identifier }
+		}
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
@@ -48,6 +48,34 @@ extension Library
 		/// This property is incremented whenever the currently selected Container is loaded
 		
 		@Published public var loadCount = 0
+		
+		/// Work that is started on behalf of the selected Container (e.g. loading thumbnails) is attached to this
+		/// scope. It is cancelled when a different Container is selected. This property can be read from any thread.
+		
+		public var cancellationScope:CancellationScope
+		{
+			lock.lock()
+			defer { lock.unlock() }
+			return _cancellationScope
+		}
+		
+		private var _cancellationScope = CancellationScope(name:"")
+		
+		/// This lock is used to ensure thread-safe access to the cancellationScope
+		
+		private let lock = NSLock()
+		
+		/// Cancels the work of the previously selected Container and starts a new scope for the specified Container
+		
+		func replaceCancellationScope(for container:Container?)
+		{
+			lock.lock()
+			let previousScope = _cancellationScope
+			_cancellationScope = CancellationScope(name:container?.identifier ?? "")
+			lock.unlock()
+			
+			previousScope.cancel()
+		}
 	}
 }
 
@@ -0,0 +1,293 @@
+//----------------------------------------------------------------------------------------------------------------------
+//
+//  Copyright ©2026 Peter Baumgartner. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//----------------------------------------------------------------------------------------------------------------------
+
+
+import Foundation
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+extension Library
+{
+	/// A Session is a list of library-level user actions with their timestamps. It can be written to a file by the
+	/// SessionRecorder and replayed later by the SessionReplayer, e.g. to reproduce a performance regression.
+
+	public struct Session : Codable
+	{
+		/// The kind of action that was performed by the user
+
+		public enum Action : String, Codable
+		{
+			case select
+			case expand
+			case collapse
+			case filter
+			case visibleRange
+			case drag
+		}
+
+		/// A single recorded action. Depending on the action, only some of the optional properties are used.
+
+		public struct Step : Codable
+		{
+			/// Seconds since the start of the recording
+
+			public var time:TimeInterval
+
+			/// The kind of action
+
+			public var action:Action
+
+			/// The identifier of the Container that the action applies to. This is nil when the selection was cleared.
+
+			public var container:String?
+
+			/// The Filter settings after a filter change
+
+			public var searchString:String? = nil
+			public var rating:Int? = nil
+			public var color:PixelAnalysis.ColorTag? = nil
+			public var sortType:Object.Filter.SortType? = nil
+			public var sortDirection:Object.Filter.SortDirection? = nil
+
+			/// The indexes of the Objects that were visible in the ObjectCollectionView
+
+			public var range:ClosedRange<Int>? = nil
+
+			/// The identifiers of the Objects that were dragged
+
+			public var objects:[String]? = nil
+		}
+
+		/// The version of the file format
+
+		public var version = 1
+
+		/// The date when the recording was started
+
+		public var date = Date()
+
+		/// The identifier of the Library that was recorded
+
+		public var library:String
+
+		/// The recorded actions in chronological order
+
+		public var steps:[Step] = []
+
+		/// Creates an empty Session
+
+		public init(library:String)
+		{
+			self.library = library
+		}
+
+		/// Loads a Session from a JSON file
+
+		public init(contentsOf url:URL) throws
+		{
+			let decoder = JSONDecoder()
+			decoder.dateDecodingStrategy = .iso8601
+			self = try decoder.decode(Session.self, from:Data(contentsOf:url))
+		}
+
+		/// Writes this Session as JSON file
+
+		public func write(to url:URL) throws
+		{
+			let encoder = JSONEncoder()
+			encoder.dateEncodingStrategy = .iso8601
+			encoder.outputFormatting = [.prettyPrinted,.sortedKeys]
+			try encoder.encode(self).write(to:url, options:.atomic)
+		}
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+extension Library
+{
+	/// The SessionRecorder logs library-level user actions (selecting, expanding and collapsing Containers, changing
+	/// the Filter, scrolling and dragging) with their timestamps. Assign an instance to Library.sessionRecorder to
+	/// start recording, and set it to nil again to stop recording.
+	///
+	/// The Session file is written shortly after each action, so that it is still available when the host
+	/// application crashes or is terminated.
+
+	public final class SessionRecorder
+	{
+		/// The file that the Session is written to
+
+		public let fileURL:URL
+
+		/// The recorded Session
+
+		private var _session:Session
+
+		/// The uptime when recording was started
+
+		private let startTime = DispatchTime.now().uptimeNanoseconds
+
+		/// Set to true when the Session has changed and needs to be written to the file
+
+		private var needsSave = false
+
+		/// This lock is used to ensure thread-safe access to the properties above
+
+		private let lock = NSLock()
+
+		/// Writing is performed on this queue
+
+		private let queue = DispatchQueue(label:"com.boinx.BXMediaBrowser.Library.SessionRecorder")
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+		/// Creates a SessionRecorder for the specified Library that writes to the file at the specified URL
+
+		public init(for library:Library, fileURL:URL)
+		{
+			self.fileURL = fileURL
+			self._session = Session(library:library.identifier)
+		}
+
+		/// Returns a copy of the recorded Session
+
+		public var session:Session
+		{
+			lock.lock()
+			defer { lock.unlock() }
+			return _session
+		}
+
+		/// Appends an action to the Session
+
+		public func record(_ action:Session.Action, container:String?, _ configure:((inout Session.Step)->Void)? = nil)
+		{
+			let time = Double(DispatchTime.now().uptimeNanoseconds - startTime) / 1_000_000_000
+			var step = Session.Step(time:time, action:action, container:container)
+			configure?(&step)
+
+			BXMediaBrowser.logDataModel.verbose {"\(Self.self).\(#function) \(action) \(container ?? "nil")"}
+
+			lock.lock()
+			_session.steps.append(step)
+			let isSaveScheduled = needsSave
+			needsSave = true
+			lock.unlock()
+
+			// Coalesce quick successions of actions into a single write
+
+			if !isSaveScheduled
+			{
+				queue.asyncAfter(deadline:.now() + 1.0)
+				{
+					self.save()
+				}
+			}
+		}
+
+		/// Writes the Session file immediately
+
+		public func save()
+		{
+			lock.lock()
+			let session = _session
+			needsSave = false
+			lock.unlock()
+
+			do
+			{
+				try session.write(to:fileURL)
+			}
+			catch
+			{
+				BXMediaBrowser.logDataModel.error {"\(Self.self).\(#function) ERROR \(error)"}
+			}
+		}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+		// MARK: - Actions
+
+		/// Records the selection of a Container
+
+		public func recordSelection(of container:Container?)
+		{
+			self.record(.select, container:container?.identifier)
+		}
+
+		/// Records expanding or collapsing a Container
+
+		public func recordExpansion(of container:Container)
+		{
+			self.record(container.isExpanded ? .expand : .collapse, container:container.identifier)
+		}
+
+		/// Records the current Filter settings of a Container
+
+		public func recordFilter(of container:Container)
+		{
+			let filter = container.filter
+
+			self.record(.filter, container:container.identifier)
+			{
+				$0.searchString = filter.searchString
+				$0.rating = filter.rating
+				$0.color = filter.color
+				$0.sortType = filter.sortType
+				$0.sortDirection = filter.sortDirection
+			}
+		}
+
+		/// Records the range of Objects that are visible in the ObjectCollectionView
+
+		public func recordVisibleRange(_ range:ClosedRange<Int>, in container:Container)
+		{
+			self.record(.visibleRange, container:container.identifier)
+			{
+				$0.range = range
+			}
+		}
+
+		/// Records dragging Objects out of a Container
+
+		public func recordDrag(of objects:[Object], from container:Container)
+		{
+			self.record(.drag, container:container.identifier)
+			{
+				$0.objects = objects.map { $0.identifier }
+			}
+		}
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,420 @@
+//----------------------------------------------------------------------------------------------------------------------
+//
+//  Copyright ©2026 Peter Baumgartner. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//----------------------------------------------------------------------------------------------------------------------
+
+
+import Foundation
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+extension Library
+{
+	/// The SessionReplayer drives a Library through the steps of a recorded Session without any user interface and
+	/// measures the latency of each step. It uses the same Library, Container and Object APIs as the views do, so
+	/// a Session that was recorded against fixture folders can be replayed in tests or benchmarks to detect
+	/// performance regressions.
+	///
+	/// The latency of a step is the time until its visible result is available:
+	///
+	/// - select: The selected Container has been loaded (immediately if it was loaded before)
+	/// - expand: The expanded Container has been loaded (immediately if it was loaded before)
+	/// - filter: The selected Container has been reloaded. This includes the debounce interval of the Filter observer.
+	/// - visibleRange: The thumbnails and metadata of all visible Objects have been loaded
+	/// - drag: The local files of all dragged Objects are available (which may include a download)
+
+	@MainActor public final class SessionReplayer
+	{
+		/// The Library that is driven by this SessionReplayer
+
+		public let library:Library
+
+		/// A step fails if its result is not available within this time
+
+		public var timeout:TimeInterval = 30.0
+
+		/// If true, the pauses between the recorded steps are kept. Otherwise the steps are replayed back to back.
+
+		public var preservesPauses = false
+
+		/// The errors that can occur while replaying a Session
+
+		public enum Error : Swift.Error, CustomStringConvertible
+		{
+			case containerNotFound(String)
+			case objectNotFound(String)
+			case timeout
+
+			public var description:String
+			{
+				switch self
+				{
+					case .containerNotFound(let identifier): return "Container not found: \(identifier)"
+					case .objectNotFound(let identifier): return "Object not found: \(identifier)"
+					case .timeout: return "Timeout"
+				}
+			}
+		}
+
+		/// Creates a SessionReplayer for the specified Library. The Library should already contain its Sections and
+		/// Sources, but doesn't need to be loaded.
+
+		public init(library:Library)
+		{
+			self.library = library
+		}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+		// MARK: - Report
+
+		/// A Report contains the measured latency of each replayed step
+
+		public struct Report : Codable, CustomStringConvertible
+		{
+			public struct Result : Codable
+			{
+				public var index:Int
+				public var action:Session.Action
+				public var container:String?
+				public var latency:TimeInterval
+				public var error:String?
+			}
+
+			public var results:[Result] = []
+
+			/// The total time of all steps in seconds
+
+			public var totalLatency:TimeInterval
+			{
+				results.reduce(0) { $0 + $1.latency }
+			}
+
+			/// The number of steps that failed
+
+			public var failureCount:Int
+			{
+				results.filter { $0.error != nil }.count
+			}
+
+			/// Returns a human readable table of all steps
+
+			public var description:String
+			{
+				var lines = results.map
+				{
+					let latency = String(format:"%9.2fms", $0.latency * 1000)
+					let error = $0.error.map { "  ERROR \($0)" } ?? ""
+					return "\(String(format:"%4d",$0.index))  \($0.action.rawValue.padding(toLength:12, withPad:" ", startingAt:0)) \(latency)  \($0.container ?? "nil")\(error)"
+				}
+
+				lines.append(String(format:"total %.2fms, %d failures", totalLatency * 1000, failureCount))
+				return lines.joined(separator:"\n")
+			}
+		}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+		// MARK: - Replaying
+
+		/// Replays all steps of the specified Session and returns the latency of each step. Failing steps are
+		/// reported, but do not stop the replay.
+
+		public func replay(_ session:Session) async throws -> Report
+		{
+			var report = Report()
+			var previousTime:TimeInterval = 0
+
+			for (index,step) in session.steps.enumerated()
+			{
+				try Task.checkCancellation()
+
+				if preservesPauses, step.time > previousTime
+				{
+					try await Task.sleep(nanoseconds:UInt64((step.time - previousTime) * 1_000_000_000))
+				}
+
+				previousTime = step.time
+
+				let span = TraceRecorder.begin("Library","replay",["action":step.action.rawValue])
+				let start = DispatchTime.now().uptimeNanoseconds
+				var error:String? = nil
+
+				do
+				{
+					try await self.perform(step)
+				}
+				catch let e
+				{
+					error = String(describing:e)
+					BXMediaBrowser.logDataModel.error {"\(Self.self).\(#function) ERROR step \(index) \(step.action): \(e)"}
+				}
+
+				let latency = Double(DispatchTime.now().uptimeNanoseconds - start) / 1_000_000_000
+				TraceRecorder.end(span)
+
+				report.results.append(Report.Result(index:index, action:step.action, container:step.container, latency:latency, error:error))
+			}
+
+			return report
+		}
+
+		/// Performs a single step and returns once its result is available
+
+		func perform(_ step:Session.Step) async throws
+		{
+			// Clearing the selection doesn't need a Container
+
+			guard let identifier = step.container else
+			{
+				library.selectedContainer = nil
+				return
+			}
+
+			let container = try await self.container(with:identifier)
+
+			switch step.action
+			{
+				case .select:
+
+					try await self.select(container)
+
+				case .expand:
+
+					container.isExpanded = true
+
+					if !container.isLoaded && !container.isLoading
+					{
+						container.load(in:library)
+					}
+
+					try await self.wait { container.isLoaded && !container.isLoading }
+
+				case .collapse:
+
+					container.isExpanded = false
+
+				case .filter:
+
+					try await self.select(container)
+					try await self.applyFilter(of:step, to:container)
+
+				case .visibleRange:
+
+					guard let range = step.range else { return }
+					let objects = container.objects
+					guard !objects.isEmpty else { return }
+					let indexes = range.clamped(to:0 ... objects.count-1)
+					try await self.load(indexes.map { objects[$0] })
+
+				case .drag:
+
+					let objects = try (step.objects ?? []).map { try self.object(with:$0, in:container) }
+
+					for object in objects
+					{
+						_ = try await object.localFileURL
+					}
+			}
+		}
+
+
+		/// Selects the specified Container and waits until it has been loaded
+
+		func select(_ container:Container) async throws
+		{
+			guard library.selectedContainer !== container || !container.isLoaded else { return }
+
+			library.selectedContainer = container
+
+			if !container.isLoaded
+			{
+				if !container.isLoading { container.load(in:library) }
+				try await self.wait { container.isLoaded && !container.isLoading }
+			}
+		}
+
+
+		/// Applies the recorded Filter settings to the Container and waits until it has been reloaded by the Filter
+		/// observer. If the settings didn't change, then nothing will be reloaded.
+
+		func applyFilter(of step:Session.Step, to container:Container) async throws
+		{
+			let filter = container.filter
+			let loadCount = library.selection.loadCount
+			var isChanged = false
+
+			if let searchString = step.searchString, searchString != filter.searchString
+			{
+				filter.searchString = searchString
+				isChanged = true
+			}
+
+			if let rating = step.rating, rating != filter.rating
+			{
+				filter.rating = rating
+				isChanged = true
+			}
+
+			if step.color != filter.color
+			{
+				filter.color = step.color
+				isChanged = true
+			}
+
+			if let sortType = step.sortType, sortType != filter.sortType
+			{
+				filter.sortType = sortType
+				isChanged = true
+			}
+
+			if let sortDirection = step.sortDirection, sortDirection != filter.sortDirection
+			{
+				filter.sortDirection = sortDirection
+				isChanged = true
+			}
+
+			guard isChanged else { return }
+
+			try await self.wait { self.library.selection.loadCount > loadCount && !container.isLoading }
+		}
+
+
+		/// Loads the thumbnails and metadata of the specified Objects concurrently, just like the cells of the
+		/// ObjectCollectionView would do. Objects that cannot be loaded are skipped.
+
+		func load(_ objects:[Object]) async throws
+		{
+			await withTaskGroup(of:Void.self)
+			{
+				group in
+
+				for object in objects
+				{
+					let loader = object.loader
+
+					group.addTask
+					{
+						_ = try? await loader.thumbnailImage
+						_ = try? await loader.metadata
+					}
+				}
+			}
+
+			// Update the Objects themselves. The loader has cached the results, so this is quick.
+
+			for object in objects
+			{
+				object.load()
+			}
+		}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+		// MARK: - Lookup
+
+		/// Returns the Container with the specified identifier. Sources that have not been loaded yet are loaded
+		/// until the Container is found.
+
+		func container(with identifier:String) async throws -> Container
+		{
+			if let container = self.loadedContainer(with:identifier)
+			{
+				return container
+			}
+
+			let sources = library.sections
+				.flatMap { $0.sources }
+				.filter { !$0.isLoaded }
+
+			for source in sources
+			{
+				if !source.isLoading { source.load(in:library) }
+				try await self.wait { source.isLoaded && !source.isLoading }
+
+				if let container = self.loadedContainer(with:identifier)
+				{
+					return container
+				}
+			}
+
+			throw Error.containerNotFound(identifier)
+		}
+
+		/// Searches the currently loaded Container tree for the specified identifier
+
+		func loadedContainer(with identifier:String) -> Container?
+		{
+			var containers = library.sections.flatMap { $0.sources }.flatMap { $0.containers }
+
+			while !containers.isEmpty
+			{
+				if let container = containers.first(where:{ $0.identifier == identifier })
+				{
+					return container
+				}
+
+				containers = containers.flatMap { $0.containers }
+			}
+
+			return nil
+		}
+
+		/// Returns the Object with the specified identifier in the Container. Only the Object itself is materialized.
+
+		func object(with identifier:String, in container:Container) throws -> Object
+		{
+			let objects = container.objects
+
+			guard let index = objects.indices.first(where:{ objects.record(at:$0).identifier == identifier }) else
+			{
+				throw Error.objectNotFound(identifier)
+			}
+
+			return objects[index]
+		}
+
+		/// Polls the condition until it becomes true or the timeout expires
+
+		func wait(until condition:@MainActor ()->Bool) async throws
+		{
+			let deadline = DispatchTime.now().uptimeNanoseconds + UInt64(timeout * 1_000_000_000)
+
+			while !condition()
+			{
+				guard DispatchTime.now().uptimeNanoseconds < deadline else { throw Error.timeout }
+				try await Task.sleep(nanoseconds:2_000_000)
+			}
+		}
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,460 @@
+//----------------------------------------------------------------------------------------------------------------------
+//
+//  Copyright ©2026 Peter Baumgartner. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//----------------------------------------------------------------------------------------------------------------------
+
+
+import BXSwiftUtils
+import Combine
+import CoreGraphics
+import ImageIO
+import Foundation
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+extension Library
+{
+	/// The StartupSnapshot records the first screen of Objects of the selected Container, including their thumbnails.
+	/// On the next launch the selected Container displays these placeholder Objects immediately, while the real
+	/// contents are loaded in the background. Once the real load has finished, the placeholders are replaced.
+	///
+	/// The placeholders are listed by a PlaceholderContainer that is selected right away, so they don't have to wait
+	/// until the ancestors of the recorded Container have been loaded. The Container tree itself is not part of the
+	/// snapshot. It is loaded as before, and the real Container takes over once it has been created.
+	
+	public final class StartupSnapshot
+	{
+		/// A record describes a single Object in the snapshot
+		
+		public struct Record
+		{
+			public let identifier:String
+			public let name:String
+			public let thumbnailData:Data?
+		}
+		
+		/// The file that contains the snapshot
+		
+		public let fileURL:URL
+		
+		/// The maximum number of Objects that are recorded. This should roughly correspond to the first screen of the ObjectBrowser.
+		
+		public var maxObjectCount = 60
+		
+		/// The identifier of the Container that was selected when the snapshot was captured
+		
+		public private(set) var selectedContainerIdentifier:String? = nil
+		
+		/// The name of the Container that was selected when the snapshot was captured
+		
+		public private(set) var selectedContainerName:String = ""
+		
+		/// The recorded Objects of the selected Container
+		
+		public private(set) var records:[Record] = []
+		
+		/// The placeholders that are shared by the PlaceholderContainer and the real Container
+		
+		private var placeholders:[Object]? = nil
+		
+		/// Encoded thumbnails are cached, so that they are not encoded again for every capture
+		
+		private var encodedThumbnails:[IdentifierHandle:Data] = [:]
+		
+		/// Set to true once the placeholders have been handed out. The snapshot is only used once per launch.
+		
+		private var isConsumed = false
+		
+		/// This lock is used to ensure thread-safe access to the properties above
+		
+		private let lock = NSLock()
+
+		/// Encoding and writing is performed on this queue
+		
+		private let queue = DispatchQueue(label:"com.boinx.BXMediaBrowser.Library.StartupSnapshot")
+		
+		/// Incrementing this counter will cause a new snapshot to be captured shortly
+		
+		@Published private(set) var requestCounter = 0
+		
+		/// Reference to the Combine debouncing pipeline
+		
+		private var observers:[Any] = []
+		
+		
+//----------------------------------------------------------------------------------------------------------------------
+
+
+		/// Creates a StartupSnapshot for the file at the specified URL and reads its current contents
+		
+		public init(fileURL:URL)
+		{
+			self.fileURL = fileURL
+			self.read()
+		}
+		
+		/// The default location is next to the file of the StateStore
+		
+		public static func defaultFileURL(for library:Library) -> URL
+		{
+			StateStore.defaultFileURL(for:library)
+				.deletingPathExtension()
+				.appendingPathExtension("snapshot")
+		}
+		
+		/// Captures a new snapshot of the selected Container of the specified Library, whenever it was loaded or
+		/// new thumbnails became available. Multiple requests are coalesced.
+		
+		func observe(_ library:Library)
+		{
+			self.observers += library.selection.$loadCount.sink
+			{
+				[weak self] _ in self?.setNeedsCapture()
+			}
+			
+			self.observers += self.$requestCounter
+				.debounce(for:1.0, scheduler:RunLoop.main)
+				.sink
+				{
+					[weak library] _ in
+					
+					Task
+					{
+						@MainActor in
+						guard let library = library else { return }
+						library.startupSnapshot?.capture(library.selectedContainer)
+					}
+				}
+		}
+		
+		/// Requests a new snapshot to be captured shortly
+		
+		public func setNeedsCapture()
+		{
+			self.requestCounter += 1
+		}
+		
+		/// Requests a new snapshot after the thumbnail of the specified Object was loaded. Only Objects on the first
+		/// screen of the selected Container are recorded, so thumbnails of all other Objects are ignored.
+		
+		@MainActor public func setNeedsCapture(for object:Object)
+		{
+			guard !(object is Placeholder) else { return }
+			guard let list = object.library?.selectedContainer?.objects else { return }
+			guard list.indices.prefix(maxObjectCount).contains(where:{ list.handle(at:$0) == object.handle }) else { return }
+			
+			self.setNeedsCapture()
+		}
+		
+		
+//----------------------------------------------------------------------------------------------------------------------
+
+
+		// MARK: - Restoring
+		
+		/// A placeholder displays the recorded thumbnail until the real Objects have been loaded. Downloads are
+		/// forwarded to the real Object.
+		
+		final class Placeholder : Object {}
+		
+		/// A PlaceholderContainer is selected right after launch and lists the placeholders. That way the first screen
+		/// is displayed before the ancestors of the recorded Container have been loaded. It is replaced by the real
+		/// Container, once that has been created and its selection restored.
+		
+		final class PlaceholderContainer : Container {}
+		
+		/// Returns a PlaceholderContainer for the specified Container identifier, if it is the Container that was
+		/// recorded in the snapshot.
+		
+		public func placeholderContainer(for identifier:String, in library:Library) -> Container?
+		{
+			lock.lock()
+			let isAvailable = !isConsumed && identifier == selectedContainerIdentifier && !records.isEmpty
+			let name = selectedContainerName
+			lock.unlock()
+			
+			guard isAvailable else { return nil }
+			
+			return PlaceholderContainer(
+				identifier: identifier,
+				name: name,
+				data: identifier,
+				filter: Object.Filter(),
+				loadHandler: { [weak self] _,_,_,library in ([],ObjectList(self?.sharedPlaceholders(in:library) ?? [])) },
+				in: library)
+		}
+		
+		/// Returns placeholder Objects for the specified Container, if it is the Container that was recorded in the
+		/// snapshot. This function returns nil for all subsequent calls, as the placeholders are only needed once.
+		/// The real Container receives the same placeholders as the PlaceholderContainer, so they don't flicker.
+		
+		public func placeholderObjects(for container:Container, in library:Library?) -> [Object]?
+		{
+			guard !(container is PlaceholderContainer) else { return nil }
+			
+			lock.lock()
+			defer { lock.unlock() }
+			
+			guard !isConsumed else { return nil }
+			guard container.identifier == selectedContainerIdentifier else { return nil }
+			guard !records.isEmpty else { return nil }
+			
+			isConsumed = true
+			
+			let placeholders = self.placeholders ?? self.makePlaceholders(in:library)
+			self.placeholders = nil
+			return placeholders
+		}
+		
+		/// Returns the placeholders for the PlaceholderContainer, without consuming them
+		
+		private func sharedPlaceholders(in library:Library?) -> [Object]
+		{
+			lock.lock()
+			defer { lock.unlock() }
+			
+			guard !isConsumed else { return [] }
+			
+			let placeholders = self.placeholders ?? self.makePlaceholders(in:library)
+			self.placeholders = placeholders
+			return placeholders
+		}
+		
+		/// Creates the placeholder Objects for the recorded Records. Must be called while holding the lock.
+		
+		private func makePlaceholders(in library:Library?) -> [Object]
+		{
+			let containerHandle = IdentifierTable.shared.handle(for:selectedContainerIdentifier ?? "")
+			
+			return records.map
+			{
+				record in
+				
+				let thumbnailData = record.thumbnailData
+				let handle = IdentifierTable.shared.handle(for:record.identifier)
+				
+				return Placeholder(
+					identifier: record.identifier,
+					name: record.name,
+					data: record.identifier,
+					loadThumbnailHandler: { _,_ in try Self.decode(thumbnailData) },
+					loadMetadataHandler: { _,_ in [:] },
+					downloadFileHandler: { [weak library] _,_ in try await Self.resolve(handle, inContainerWith:containerHandle, of:library).localFileURL },
+					in: library)
+			}
+		}
+		
+		/// Returns true if the specified list still contains the placeholders
+		
+		static func containsPlaceholders(_ list:ObjectList) -> Bool
+		{
+			guard !list.isEmpty else { return false }
+			return list.materializedObject(at:0) is Placeholder
+		}
+		
+		/// The maximum time a download of a placeholder waits for the real Container to be selected and loaded
+		
+		static var resolveTimeout:TimeInterval = 60.0
+		
+		/// Waits until the real Container has been selected and loaded, and returns its Object with the specified
+		/// handle. Throws if a different Container is selected or the Object no longer exists.
+		
+		static func resolve(_ handle:IdentifierHandle, inContainerWith containerHandle:IdentifierHandle, of library:Library?) async throws -> Object
+		{
+			guard let library = library else { throw Object.Error.downloadFileFailed }
+			
+			let waiter = await MainActor.run
+			{
+				Preloader.Waiter(library.selection.$container
+					.map
+					{
+						container -> AnyPublisher<Bool,Never> in
+						
+						guard let container = container, container.handle == containerHandle, !(container is PlaceholderContainer) else
+						{
+							return Just(false).eraseToAnyPublisher()
+						}
+						
+						return Publishers.CombineLatest(container.$isLoaded, container.$isLoading)
+							.map { isLoaded,isLoading in isLoaded && !isLoading }
+							.eraseToAnyPublisher()
+					}
+					.switchToLatest()
+					.filter { $0 })
+			}
+			
+			try await waiter.wait(timeout:resolveTimeout)
+			
+			let object = await MainActor.run
+			{
+				() -> Object? in
+				guard let container = library.selectedContainer, container.handle == containerHandle else { return nil }
+				let list = container.objects
+				guard let index = list.firstIndex(of:handle) else { return nil }
+				return list[index]
+			}
+			
+			guard let object = object, !(object is Placeholder) else { throw Object.Error.downloadFileFailed }
+			return object
+		}
+		
+		/// Decodes a thumbnail image that was recorded in the snapshot
+		
+		static func decode(_ data:Data?) throws -> CGImage
+		{
+			guard let data = data else { throw Object.Error.loadThumbnailFailed }
+			guard let source = CGImageSourceCreateWithData(data as CFData,nil) else { throw Object.Error.loadThumbnailFailed }
+			guard let image = CGImageSourceCreateImageAtIndex(source,0,nil) else { throw Object.Error.loadThumbnailFailed }
+			return image
+		}
+
+		/// Reads the snapshot file
+		
+		private func read()
+		{
+			guard let data = try? Data(contentsOf:fileURL) else { return }
+			guard let plist = try? PropertyListSerialization.propertyList(from:data, options:[], format:nil) as? [String:Any] else { return }
+			guard let identifier = plist[Self.selectedContainerIdentifierKey] as? String else { return }
+			guard let objects = plist[Self.objectsKey] as? [[String:Any]] else { return }
+			
+			self.selectedContainerIdentifier = identifier
+			self.selectedContainerName = plist[Self.selectedContainerNameKey] as? String ?? ""
+			
+			self.records = objects.compactMap
+			{
+				guard let identifier = $0[Self.identifierKey] as? String else { return nil }
+				guard let name = $0[Self.nameKey] as? String else { return nil }
+				let thumbnailData = $0[Self.thumbnailKey] as? Data
+				return Record(identifier:identifier, name:name, thumbnailData:thumbnailData)
+			}
+		}
+		
+		
+//----------------------------------------------------------------------------------------------------------------------
+
+
+		// MARK: - Capturing
+		
+		/// Captures the first screen of Objects of the specified Container. Only the (cheap) gathering of Objects
+		/// happens on the main thread, encoding the thumbnails and writing the file is done in the background.
+		
+		@MainActor func capture(_ container:Container?)
+		{
+			guard let container = container else { return }
+			guard container.isLoaded else { return }
+			guard !(container is PlaceholderContainer) else { return }
+			
+			// Only Objects that are currently materialized can have a thumbnail, so there is no need to create any
+			
+			let list = container.objects
+			
+			let objects = list.indices.prefix(maxObjectCount).map
+			{
+				i -> (identifier:String, handle:IdentifierHandle, name:String, thumbnail:CGImage?) in
+				let record = list.record(at:i)
+				return (identifier:record.identifier, handle:record.handle, name:record.name, thumbnail:list.materializedObject(at:i)?.thumbnailImage)
+			}
+			
+			let selectedContainerIdentifier = container.identifier
+			let selectedContainerName = container.name
+			
+			queue.async
+			{
+				self.save(selectedContainerIdentifier:selectedContainerIdentifier, selectedContainerName:selectedContainerName, objects:objects)
+			}
+		}
+		
+		/// Encodes the thumbnails and writes the snapshot file
+		
+		func save(selectedContainerIdentifier:String, selectedContainerName:String = "", objects:[(identifier:String, handle:IdentifierHandle, name:String, thumbnail:CGImage?)])
+		{
+			lock.lock()
+			var encodedThumbnails = self.encodedThumbnails
+			lock.unlock()
+			
+			var records:[Record] = []
+			var usedThumbnails:[IdentifierHandle:Data] = [:]
+			
+			for object in objects
+			{
+				let thumbnailData = encodedThumbnails[object.handle] ?? object.thumbnail.flatMap { Self.encode($0) }
+				usedThumbnails[object.handle] = thumbnailData
+				records += Record(identifier:object.identifier, name:object.name, thumbnailData:thumbnailData)
+			}
+			
+			encodedThumbnails = usedThumbnails
+			
+			lock.lock()
+			self.encodedThumbnails = encodedThumbnails
+			lock.unlock()
+			
+			let plist:[String:Any] =
+			[
+				Self.selectedContainerIdentifierKey : selectedContainerIdentifier,
+				Self.selectedContainerNameKey : selectedContainerName,
+				Self.objectsKey : records.map
+				{
+					var dict:[String:Any] = [:]
+					dict[Self.identifierKey] = $0.identifier
+					dict[Self.nameKey] = $0.name
+					dict[Self.thumbnailKey] = $0.thumbnailData
+					return dict
+				}
+			]
+			
+			do
+			{
+				let folderURL = fileURL.deletingLastPathComponent()
+				try FileManager.default.createDirectory(at:folderURL, withIntermediateDirectories:true, attributes:nil)
+				let data = try PropertyListSerialization.data(fromPropertyList:plist, format:.binary, options:0)
+				try data.write(to:fileURL, options:.atomic)
+			}
+			catch
+			{
+				BXMediaBrowser.logDataModel.error {"\(Self.self).\(#function) ERROR \(error)"}
+			}
+		}
+		
+		/// Encodes a thumbnail image as JPEG
+		
+		static func encode(_ image:CGImage) -> Data?
+		{
+			let data = NSMutableData()
+			guard let destination = CGImageDestinationCreateWithData(data as CFMutableData, "public.jpeg" as CFString, 1, nil) else { return nil }
+			CGImageDestinationAddImage(destination, image, [kCGImageDestinationLossyCompressionQuality:0.7] as CFDictionary)
+			guard CGImageDestinationFinalize(destination) else { return nil }
+			return data as Data
+		}
+		
+		private static var selectedContainerIdentifierKey:String { "selectedContainerIdentifier" }
+		private static var selectedContainerNameKey:String { "selectedContainerName" }
+		private static var objectsKey:String { "objects" }
+		private static var identifierKey:String { "identifier" }
+		private static var nameKey:String { "name" }
+		private static var thumbnailKey:String { "thumbnail" }
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
@@ -46,6 +46,10 @@ extension Library
 		
 		public var restoreSelectedContainerHandler:((Container)->Void)? = nil
 		
+		/// Set to true if all nodes of the tree should be saved, not just the ones that were marked dirty
+		
+		internal var needsFullSave = false
+		
 		/// Incrementing this counter will cause the action closure to be called
 		
 		@Published internal var requestCounter = 0
@@ -83,21 +87,102 @@ extension Library
 	
 	public func setNeedsSaveState()
 	{
+		self.stateSaver.needsFullSave = true
 		self.stateSaver.request()
 	}
 	
-	/// This function gathers the current state of all Containers and persists them to storage (usually NSUserDefaults)
+	/// Marks the state of the specified Section as dirty. Only this Section will be serialized again.
+	
+	public func setNeedsSaveState(for section:Section)
+	{
+		self.setNeedsSaveState(forKey:section.stateStoreKey) { await section.ownState() }
+	}
+	
+	/// Marks the state of the specified Source as dirty. Only this Source will be serialized again.
+	
+	public func setNeedsSaveState(for source:Source)
+	{
+		self.setNeedsSaveState(forKey:source.stateStoreKey) { await source.ownState() }
+	}
+	
+	/// Marks the state of the specified Container as dirty. Only this Container will be serialized again.
+	
+	public func setNeedsSaveState(for container:Container)
+	{
+		self.setNeedsSaveState(forKey:container.stateStoreKey) { await container.ownState() }
+	}
+	
+	/// Marks a single node as dirty. If there is no StateStore, the complete state will be saved instead.
+	
+	private func setNeedsSaveState(forKey key:String, ownState:@escaping ()async->[String:Any])
+	{
+		if let stateStore = self.stateStore
+		{
+			stateStore.setNeedsSave(forKey:key, ownState:ownState)
+		}
+		else
+		{
+			self.stateSaver.needsFullSave = true
+		}
+		
+		self.stateSaver.request()
+	}
+	
+	/// This function gathers the current state of all dirty nodes and persists them to storage. If there is no
+	/// StateStore, then the complete state dictionary is gathered and passed to saveState(_:) instead.
 	
 	internal func asyncSaveState()
 	{
+		let needsFullSave = self.stateSaver.needsFullSave
+		self.stateSaver.needsFullSave = false
+		
 		// Since getting the state is an async function that accesses @MainActor properties,
 		// this work has to be wrapped in a Task.
 	
 		Task
 		{
 			BXMediaBrowser.logDataModel.debug {"\(Self.self).\(#function) \(identifier)"}
-			let state = await self.state()
-			self.saveState(state)
+			
+			if let stateStore = self.stateStore
+			{
+				if needsFullSave
+				{
+					await self.setNeedsSaveStateForAllNodes(in:stateStore)
+				}
+				
+				// The own state of the Library (i.e. the selected Container) is cheap, so it is always included
+				
+				stateStore.setNeedsSave(forKey:stateStoreKey) { await self.ownState() }
+				await stateStore.save()
+			}
+			else
+			{
+				let state = await self.state()
+				self.saveState(state)
+			}
+		}
+	}
+	
+	/// Marks all currently existing nodes of the tree as dirty
+	
+	private func setNeedsSaveStateForAllNodes(in stateStore:StateStore) async
+	{
+		for section in self.sections
+		{
+			stateStore.setNeedsSave(forKey:section.stateStoreKey) { await section.ownState() }
+			
+			for source in section.sources
+			{
+				stateStore.setNeedsSave(forKey:source.stateStoreKey) { await source.ownState() }
+				
+				var containers = await source.containers
+				
+				while let container = containers.popLast()
+				{
+					stateStore.setNeedsSave(forKey:container.stateStoreKey) { await container.ownState() }
+					containers += await container.containers
+				}
+			}
 		}
 	}
 	
@@ -121,6 +206,15 @@ extension Library
 		return state
 	}
 
+	/// Returns the state of this Library only, without the state of its Sections
+	
+	public func ownState() async -> [String:Any]
+	{
+		var state:[String:Any] = [:]
+		state[selectedContainerIdentifierKey] = self.selectedContainer?.identifier
+		return state
+	}
+
 
 	/// This key can be used to safely access state info in dictionaries or UserDefaults
 	
@@ -0,0 +1,346 @@
+//----------------------------------------------------------------------------------------------------------------------
+//
+//  Copyright ©2026 Peter Baumgartner. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//----------------------------------------------------------------------------------------------------------------------
+
+
+import BXSwiftUtils
+import Foundation
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+extension Library
+{
+	/// The StateStore persists the Library state incrementally. Instead of one nested dictionary for the whole tree,
+	/// it keeps a flat table with the serialized own state of each Section, Source and Container. When a node
+	/// changes, only that node is serialized again. The table is written to a dedicated file with atomic replacement.
+	///
+	/// When restoring, nodes look up their own entry lazily when they are created and loaded.
+	
+	public final class StateStore
+	{
+		/// The file that contains the persisted state
+		
+		public let fileURL:URL
+		
+		/// The serialized own state of each node, keyed by node key
+		
+		private var entries:[String:Data] = [:]
+		
+		/// Nodes that need to be serialized again. The closure returns the current own state of a node.
+		
+		private var dirtyNodes:[String:()async->[String:Any]] = [:]
+		
+		/// This lock is used to ensure thread-safe access to entries and dirtyNodes
+		
+		private let lock = NSLock()
+
+		/// All file access is serialized on this queue
+		
+		private let queue = DispatchQueue(label:"com.boinx.BXMediaBrowser.Library.StateStore")
+		
+		
+//----------------------------------------------------------------------------------------------------------------------
+
+
+		/// Creates a StateStore for the file at the specified URL and reads its current contents
+		
+		public init(fileURL:URL)
+		{
+			self.fileURL = fileURL
+			
+			if let data = try? Data(contentsOf:fileURL),
+			   let entries = try? PropertyListSerialization.propertyList(from:data, options:[], format:nil) as? [String:Data]
+			{
+				self.entries = entries
+			}
+		}
+		
+		/// The default location is inside the Application Support folder of the host application
+		
+		public static func defaultFileURL(for library:Library) -> URL
+		{
+			let appSupportURL = FileManager.default.urls(for:.applicationSupportDirectory, in:.userDomainMask).first ?? FileManager.default.temporaryDirectory
+			let bundleIdentifier = Bundle.main.bundleIdentifier ?? "BXMediaBrowser"
+
+			return appSupportURL
+				.appendingPathComponent(bundleIdentifier, isDirectory:true)
+				.appendingPathComponent("BXMediaBrowser.State", isDirectory:true)
+				.appendingPathComponent("\(library.stateKey).plist")
+		}
+		
+		/// Returns true if no state has been persisted yet
+		
+		public var isEmpty:Bool
+		{
+			lock.lock()
+			defer { lock.unlock() }
+			return entries.isEmpty
+		}
+		
+		
+//----------------------------------------------------------------------------------------------------------------------
+
+
+		// MARK: - Restoring
+		
+		/// Returns the persisted own state for the node with the specified key
+		
+		public func state(forKey key:String) -> [String:Any]?
+		{
+			lock.lock()
+			let data = entries[key]
+			lock.unlock()
+			
+			guard let data = data else { return nil }
+			return try? PropertyListSerialization.propertyList(from:data, options:[], format:nil) as? [String:Any]
+		}
+		
+		
+//----------------------------------------------------------------------------------------------------------------------
+
+
+		// MARK: - Saving
+		
+		/// Marks the node with the specified key as dirty. The supplied closure will be called when saving.
+		
+		public func setNeedsSave(forKey key:String, ownState:@escaping ()async->[String:Any])
+		{
+			lock.lock()
+			self.dirtyNodes[key] = ownState
+			lock.unlock()
+		}
+		
+		/// Serializes the own state of all dirty nodes and then writes the table to disk
+		
+		public func save() async
+		{
+			lock.lock()
+			let dirtyNodes = self.dirtyNodes
+			self.dirtyNodes = [:]
+			lock.unlock()
+			
+			guard !dirtyNodes.isEmpty else { return }
+			
+			var changedEntries:[String:Data] = [:]
+			var removedKeys:[String] = []
+			
+			for (key,ownState) in dirtyNodes
+			{
+				let state = await ownState()
+				
+				// A collapsed Container is restored as collapsed without an entry, so the entry isn't needed.
+				// This also keeps entries of Containers that no longer exist from piling up.
+				
+				if Self.isDefaultState(state, forKey:key)
+				{
+					removedKeys.append(key)
+					continue
+				}
+				
+				do
+				{
+					changedEntries[key] = try PropertyListSerialization.data(fromPropertyList:state, format:.binary, options:0)
+				}
+				catch
+				{
+					BXMediaBrowser.logDataModel.error {"\(Self.self).\(#function) ERROR cannot serialize state for \(key): \(error)"}
+				}
+			}
+			
+			lock.lock()
+			self.entries.merge(changedEntries) { $1 }
+			for key in removedKeys { self.entries[key] = nil }
+			self.write(self.entries)
+			lock.unlock()
+		}
+		
+		/// Returns true if the state of a Container equals the state of a newly created Container
+		
+		static func isDefaultState(_ state:[String:Any], forKey key:String) -> Bool
+		{
+			guard key.hasPrefix("container/") else { return false }
+			return state.isEmpty || (state.count == 1 && (state["isExpanded"] as? Bool) == false)
+		}
+		
+		/// Removes the persisted state of the nodes with the specified keys, e.g. when a Container was removed
+		
+		public func removeState(forKeys keys:[String])
+		{
+			lock.lock()
+			
+			var didChange = false
+			
+			for key in keys
+			{
+				self.dirtyNodes[key] = nil
+				if self.entries.removeValue(forKey:key) != nil { didChange = true }
+			}
+			
+			if didChange { self.write(self.entries) }
+			lock.unlock()
+		}
+		
+		/// Waits until all pending writes have finished
+		
+		func synchronize()
+		{
+			queue.sync { }
+		}
+		
+		/// Imports a nested state dictionary, as it was previously saved to the UserDefaults, by splitting it
+		/// into the own state of each node. Nested dictionaries that contain an isExpanded flag are Containers.
+		
+		public func importLegacyState(_ libraryState:[String:Any], for library:Library)
+		{
+			var entries:[String:[String:Any]] = [:]
+			var libraryOwnState = libraryState
+			
+			for section in library.sections
+			{
+				guard let sectionState = libraryOwnState.removeValue(forKey:section.stateKey) as? [String:Any] else { continue }
+				var sectionOwnState = sectionState
+				
+				for source in section.sources
+				{
+					guard let sourceState = sectionOwnState.removeValue(forKey:source.stateKey) as? [String:Any] else { continue }
+					entries[source.stateStoreKey] = Self.split(sourceState, into:&entries)
+				}
+				
+				entries[section.stateStoreKey] = sectionOwnState
+			}
+			
+			entries[library.stateStoreKey] = libraryOwnState
+			
+			lock.lock()
+			
+			for (key,state) in entries
+			{
+				self.entries[key] = try? PropertyListSerialization.data(fromPropertyList:state, format:.binary, options:0)
+			}
+			
+			self.write(self.entries)
+			lock.unlock()
+		}
+		
+		/// Moves the nested Container states into the entries table and returns the remaining own state
+		
+		private static func split(_ state:[String:Any], into entries:inout [String:[String:Any]]) -> [String:Any]
+		{
+			var ownState:[String:Any] = [:]
+			
+			for (key,value) in state
+			{
+				if let containerState = value as? [String:Any], containerState["isExpanded"] != nil
+				{
+					entries["container/\(key)"] = Self.split(containerState, into:&entries)
+				}
+				else
+				{
+					ownState[key] = value
+				}
+			}
+			
+			return ownState
+		}
+		
+		/// Writes the table to disk. The individual entries are already serialized, so only the outer table needs encoding.
+		/// Must be called while holding the lock, so that the writes are queued in the same order as the changes and
+		/// an older table can never overwrite a newer one.
+		
+		private func write(_ entries:[String:Data])
+		{
+			let fileURL = self.fileURL
+			
+			queue.async
+			{
+				do
+				{
+					let folderURL = fileURL.deletingLastPathComponent()
+					try FileManager.default.createDirectory(at:folderURL, withIntermediateDirectories:true, attributes:nil)
+					let data = try PropertyListSerialization.data(fromPropertyList:entries, format:.binary, options:0)
+					try data.write(to:fileURL, options:.atomic)
+				}
+				catch
+				{
+					BXMediaBrowser.logDataModel.error {"\(Self.self).\(#function) ERROR \(error)"}
+				}
+			}
+		}
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+// MARK: - Node Keys
+
+extension Library
+{
+	var stateStoreKey:String { "library" }
+
+	/// Returns the persisted own state of the node with the specified key, if a StateStore is available
+	
+	func restoredState(forKey key:String) -> [String:Any]?
+	{
+		self.stateStore?.state(forKey:key)
+	}
+	
+	/// Removes the persisted state of the specified Container and its subcontainers after it was removed from the tree
+	
+	@MainActor func removeState(of container:Container)
+	{
+		guard let stateStore = self.stateStore else { return }
+		
+		var keys:[String] = []
+		var containers = [container]
+		
+		while let container = containers.popLast()
+		{
+			keys.append(container.stateStoreKey)
+			containers += container.containers
+		}
+		
+		stateStore.removeState(forKeys:keys)
+	}
+}
+
+extension Section
+{
+	var stateStoreKey:String { "section/\(stateKey)" }
+}
+
+extension Source
+{
+	var stateStoreKey:String { "source/\(stateKey)" }
+}
+
+extension Container
+{
+	var stateStoreKey:String { "container/\(stateKey)" }
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
@@ -50,6 +50,18 @@ open class Library : ObservableObject, StateSaving
 		{
 			BXMediaBrowser.logDataModel.debug {"\(Self.self).\(#function) = \(selection.container?.identifier ?? "nil")"}
 
+			// Cancel in-flight work of the previously selected Container, so that it doesn't compete with the new one
+			
+			if newValue !== selection.container
+			{
+				selection.replaceCancellationScope(for:newValue)
+				
+				if !(newValue is StartupSnapshot.PlaceholderContainer)
+				{
+					sessionRecorder?.recordSelection(of:newValue)
+				}
+			}
+			
 			// Request purging of thumbnails of previously selected Container
 			
 			selection.container?.isSelected = false
@@ -83,6 +95,33 @@ open class Library : ObservableObject, StateSaving
 	
 	internal let stateSaver = StateSaver()
 	
+	/// The optional incremental state store that persists the state of individual nodes to a dedicated file. Set
+	/// this property before calling load(with:) to opt in. Once the store contains data, it is authoritative and
+	/// the state passed to load(with:) is ignored. If nil, the complete state dictionary is saved via saveState(_:).
+	
+	public var stateStore:StateStore? = nil
+	
+	/// The StartupSnapshot lets the selected Container display its first screen of Objects immediately after
+	/// launch. Set this property to nil to disable this behavior.
+	
+	public var startupSnapshot:StartupSnapshot? = nil
+	{
+		didSet { startupSnapshot?.observe(self) }
+	}
+	
+	/// If set, user actions like selecting Containers or changing the Filter are recorded, so that they can be
+	/// replayed later with a SessionReplayer.
+	
+	public var sessionRecorder:SessionRecorder? = nil
+	
+	/// If set, the Containers that are most likely to be selected next are loaded in the background. The
+	/// Preloader learns from the navigation history of the user.
+	
+	public var preloader:Preloader? = nil
+	{
+		didSet { preloader?.observe(self) }
+	}
+	
 	
 //----------------------------------------------------------------------------------------------------------------------
 
@@ -101,6 +140,9 @@ open class Library : ObservableObject, StateSaving
 		{
 			[weak self] in self?.asyncSaveState()
 		}
+		
+		self.startupSnapshot = StartupSnapshot(fileURL:StartupSnapshot.defaultFileURL(for:self))
+		self.startupSnapshot?.observe(self)
 	}
 
 
@@ -141,16 +183,42 @@ open class Library : ObservableObject, StateSaving
 	{
 		BXMediaBrowser.logDataModel.verbose {"\(Self.self).\(#function) \(identifier)"}
 
+		// If the state store already contains data, then it is authoritative and the nodes will look up their
+		// own state lazily when they are created. Otherwise the supplied state is imported once (migration).
+		
+		var libraryState = libraryState
+		
+		if let stateStore = self.stateStore
+		{
+			if stateStore.isEmpty, let legacyState = libraryState
+			{
+				stateStore.importLegacyState(legacyState, for:self)
+			}
+			
+			libraryState = stateStore.state(forKey:stateStoreKey)
+		}
+		
 		// Restore the selectedContainer. Please note that loading the library is an async operation.
 		// we do not know when the Container in question will be created. For this reason we will
 		// have to check each newly created Container if it is the one in question.
 		
 		if let identifier = libraryState?[selectedContainerIdentifierKey] as? String
 		{
+			let handle = IdentifierTable.shared.handle(for:identifier)
+			
 			self.stateSaver.restoreSelectedContainerHandler =
 			{
 				[weak self] container in
-				self?.restoreSelectedContainer(container, with:identifier)
+				self?.restoreSelectedContainer(container, with:handle)
+			}
+			
+			// Display the recorded first screen right away, instead of waiting until the ancestors of the
+			// selected Container have been loaded. The real Container replaces it once it has been created.
+			
+			if let placeholderContainer = startupSnapshot?.placeholderContainer(for:identifier, in:self)
+			{
+				self.selectedContainer = placeholderContainer
+				placeholderContainer.load(in:self)
 			}
 		}
 
@@ -187,8 +255,16 @@ open class Library : ObservableObject, StateSaving
 	
 	public func restoreSelectedContainer(_ container:Container, with identifier:String)
 	{
+		self.restoreSelectedContainer(container, with:IdentifierTable.shared.handle(for:identifier))
+	}
+	
+	/// Same as above, but compares interned handles, which is considerably cheaper when called for every newly created Container.
+	
+	public func restoreSelectedContainer(_ container:Container, with handle:IdentifierHandle)
+	{
+		guard container.handle == handle else { return }
 		guard container.library != nil && container.library == self else { return }
-		guard container.identifier == identifier else { return }
+		guard !(container is StartupSnapshot.PlaceholderContainer) else { return }
 		
 		DispatchQueue.main.async
 		{
@@ -47,6 +47,10 @@ extension Object
 
 		@Published public var rating:Int = 0
 
+		/// If set, only Objects whose thumbnails contain a significant amount of this color are displayed
+		
+		@Published public var color:PixelAnalysis.ColorTag? = nil
+
 		/// The kind determines how Objects are sorted
 	
 		@Published public var sortType:SortType = .never
@@ -125,7 +129,8 @@ extension Object
 		open func sort(_ objects:inout [Object])
 		{
 			let token = self.beginSignpost(in:"Object.Filter","sort")
-			defer { self.endSignpost(with:token, in:"Object.Filter","sort") }
+			let span = TraceRecorder.begin("Object.Filter","sort",["sortType":sortType, "count":String(objects.count)])
+			defer { self.endSignpost(with:token, in:"Object.Filter","sort"); TraceRecorder.end(span) }
 			
 			if let comparator = self.objectComparator
 			{
@@ -133,6 +138,38 @@ extension Object
 			}
 		}
 
+		/// A RecordComparator is the equivalent of an ObjectComparator for Object.Records. It allows sorting lazy
+		/// ObjectLists without materializing their Objects.
+		
+		public typealias RecordComparator = (Object.Record,Object.Record) -> Bool
+		
+		/// Returns the RecordComparator for the current sorting parameters, or nil if the sort criteria are not
+		/// available in Records. Subclasses should override this property when their Containers create lazy lists.
+		
+		open var recordComparator : RecordComparator?
+		{
+			return nil
+		}
+		
+		/// Sorts the specified ObjectList according to the current sorting parameters. The RecordComparator is
+		/// preferred, since the ObjectComparator needs to materialize all Objects of a lazy list.
+		
+		open func sort(_ objects:inout ObjectList)
+		{
+			let token = self.beginSignpost(in:"Object.Filter","sort")
+			let span = TraceRecorder.begin("Object.Filter","sort",["sortType":sortType, "count":String(objects.count)])
+			defer { self.endSignpost(with:token, in:"Object.Filter","sort"); TraceRecorder.end(span) }
+			
+			if let comparator = self.recordComparator
+			{
+				objects.sort(records:comparator)
+			}
+			else if let comparator = self.objectComparator
+			{
+				objects.sort(by:comparator)
+			}
+		}
+
 	
 //----------------------------------------------------------------------------------------------------------------------
 
@@ -143,6 +180,7 @@ extension Object
 		{
 			case searchString
 			case rating
+			case color
 			case sortType
 			case sortDirection
 			case sortDirectionByType
@@ -154,6 +192,7 @@ extension Object
 			
 			try container.encode(self.searchString, forKey:.searchString)
 			try container.encode(self.rating, forKey:.rating)
+			try container.encodeIfPresent(self.color, forKey:.color)
 			try container.encode(self.sortType, forKey:.sortType)
 			try container.encode(self._sortDirection, forKey:.sortDirectionByType)
 		}
@@ -164,6 +203,7 @@ extension Object
 			
 			self.searchString  = try container.decodeIfPresent(String.self, forKey:.searchString) ?? ""
 			self.rating  = try container.decodeIfPresent(Int.self, forKey:.rating) ?? 0
+			self.color  = try? container.decodeIfPresent(PixelAnalysis.ColorTag.self, forKey:.color)
 			self.sortType  = try container.decodeIfPresent(SortType.self, forKey:.sortType) ?? .never
 //			self.sortDirection  = try container.decodeIfPresent(SortDirection.self, forKey:.sortDirection) ?? .ascending
 			self._sortDirection  = try container.decodeIfPresent([SortType:SortDirection].self, forKey:.sortDirectionByType) ?? Object.Filter.defaultSortDirections()
@@ -183,7 +223,19 @@ extension Object.Filter
 	
 	public var isFiltering:Bool
 	{
-		self.searchString.count > 0 || self.rating > 0
+		self.searchString.count > 0 || self.rating > 0 || self.color != nil
+	}
+	
+	/// Returns true if the Object with the specified identifier qualifies for the color filter. Objects whose
+	/// thumbnails have not been analyzed yet are included for now, so the result is only partial until
+	/// Container.unanalyzedObjectCount drops to 0. The Container analyzes these thumbnails in the background
+	/// and removes the Objects that turn out not to match.
+	
+	public func matchesColor(of identifier:String) -> Bool
+	{
+		guard let color = self.color else { return true }
+		guard let analysis = PixelAnalysis.Store.shared.analysis(for:identifier) else { return true }
+		return analysis.contains(color)
 	}
 	
 	/// Resets the filter, so that all objects in a Container are displayed again
@@ -192,6 +244,7 @@ extension Object.Filter
 	{
 		self.searchString = ""
 		self.rating = 0
+		self.color = nil
 	}
 }
 
@@ -245,6 +298,21 @@ extension Object.Filter
 		return rating1 < rating2
 	}
 
+	/// Compares Record ratings
+	
+	public static func compareRating(_ record1:Object.Record,_ record2:Object.Record) -> Bool
+	{
+		let rating1 = StatisticsController.shared.rating(for:record1)
+		let rating2 = StatisticsController.shared.rating(for:record2)
+		
+		if rating1 == rating2
+		{
+			return FolderFilter.compareAlphabetical(record1,record2)
+		}
+		
+		return rating1 < rating2
+	}
+
 	/// Sorts Objects by useCount
 	
 	public static func compareUseCount(_ object1:Object,_ object2:Object) -> Bool
@@ -259,6 +327,21 @@ extension Object.Filter
 		
 		return useCount1 < useCount2
 	}
+
+	/// Sorts Records by useCount
+	
+	public static func compareUseCount(_ record1:Object.Record,_ record2:Object.Record) -> Bool
+	{
+		let useCount1 = StatisticsController.shared.useCount(for:record1)
+		let useCount2 = StatisticsController.shared.useCount(for:record2)
+		
+		if useCount1 == useCount2
+		{
+			return FolderFilter.compareAlphabetical(record1,record2)
+		}
+		
+		return useCount1 < useCount2
+	}
 }
 
 
@@ -26,11 +26,12 @@
 extension Object
 {
 	// Provide correct Hashable support based on identifier property. Please note that for NSObject subclasses
-	// overriding hash(into:) doesn'tseem to work.
+	// overriding hash(into:) doesn'tseem to work. The precomputed hash of the interned handle is used, so that
+	// the (long) identifier string doesn't need to be hashed again and again.
 	
 	override public var hash:Int
 	{
-		identifier.hash
+		Int(truncatingIfNeeded:handle.stableHash)
 	}
 
 	// Provide correct Equatable support based on identifier property. Please note that we have to override
@@ -44,7 +45,7 @@ extension Object
 	
 	public static func ==(lhs:Object, rhs:Object) -> Bool
 	{
-		lhs.identifier == rhs.identifier
+		lhs.handle == rhs.handle
 	}
 }
 
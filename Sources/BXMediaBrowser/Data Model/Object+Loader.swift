@@ -42,17 +42,24 @@ extension Object
 
 		private let identifier:String
 		private let data:Any
-		private let loadThumbnailHandler:LoadThumbnailHandler
-		private let loadMetadataHandler:LoadMetadataHandler
-		private let downloadFileHandler:DownloadFileHandler
+		private let handlers:Handlers
+		
+		/// The metrics of this Loader's source. They are looked up when the first event is recorded.
+		
+		private lazy var instruments = Metrics.shared.loaderInstruments(for:Metrics.source(for:identifier))
+	
+		public init(identifier:String, data:Any, handlers:Handlers)
+		{
+			self.identifier = identifier
+			self.data = data
+			self.handlers = handlers
+		}
 	
 		public init(identifier:String, data:Any, loadThumbnailHandler:@escaping LoadThumbnailHandler, loadMetadataHandler:@escaping LoadMetadataHandler, downloadFileHandler:@escaping DownloadFileHandler)
 		{
 			self.identifier = identifier
 			self.data = data
-			self.loadThumbnailHandler = loadThumbnailHandler
-			self.loadMetadataHandler = loadMetadataHandler
-			self.downloadFileHandler = downloadFileHandler
+			self.handlers = Handlers(loadThumbnail:loadThumbnailHandler, loadMetadata:loadMetadataHandler, downloadFile:downloadFileHandler)
 		}
 	
 	
@@ -67,6 +74,16 @@ extension Object
 			self._metadata = nil
 			self._localFileURL = nil
 		}
+		
+		/// Cancels loading the thumbnail and metadata. The next access will start a new loading Task.
+		
+		public func cancel()
+		{
+			self._loadThumbnailTask?.cancel()
+			self._loadThumbnailTask = nil
+			self._loadMetadataTask?.cancel()
+			self._loadMetadataTask = nil
+		}
 	
 	
 //----------------------------------------------------------------------------------------------------------------------
@@ -85,6 +102,7 @@ extension Object
 
 				if let image = self._thumbnailImage
 				{
+					self.instruments.thumbnailCacheHits.increment()
 					return image
 				}
 
@@ -95,17 +113,27 @@ extension Object
 					return try await task.value
 				}
 
-				// If not then create a new download task and wait for its result
+				// If not then create a new download task and wait for its result. The generation identifies this task,
+				// so that it doesn't clear the reference to a newer task that was started after cancelling it.
+
+				self.thumbnailGeneration += 1
+				let generation = self.thumbnailGeneration
 
 				let task = Task<CGImage,Swift.Error>
 				{
-					try await Tasks.canContinue()
+					defer { if self.thumbnailGeneration == generation { self._loadThumbnailTask = nil } }
+
+					try await Tasks.canContinue(.thumbnail)
 					
 					logDataModel.verbose {"Loading thumbnail for \(identifier)"}
 					
-					let image = try await self.loadThumbnailHandler(identifier,data)
+					let image = try await self.instruments.thumbnailLatency.time(failures:self.instruments.thumbnailFailures)
+					{
+						try await self.handlers.loadThumbnail(identifier,data)
+					}
+					
+					self.analyzeIfNeeded(image)
 					self._thumbnailImage = image
-					self._loadThumbnailTask = nil
 					return image
 				}
 
@@ -114,6 +142,18 @@ extension Object
 			}
 		}
 		
+		/// Analyzes the pixels of a newly loaded thumbnail, unless its PixelAnalysis is already known (either from
+		/// a previous session or because the loadThumbnailHandler created it while validating the thumbnail).
+		/// Analyses from older versions without a perceptual hash are replaced.
+		
+		private func analyzeIfNeeded(_ image:CGImage)
+		{
+			let store = PixelAnalysis.Store.shared
+			guard store.analysis(for:identifier)?.perceptualHash == nil else { return }
+			guard let analysis = PixelAnalysis(image) else { return }
+			store.setAnalysis(analysis, for:identifier)
+		}
+		
 		/// Returns true if the thumbnail image is currently being loaded. Can be used to display progress info like a spinning wheel.
 		
 		public var isLoadingThumbnail:Bool { _loadThumbnailTask != nil }
@@ -125,6 +165,10 @@ extension Object
 		/// The currently running download task
 		
 		private var _loadThumbnailTask:Task<CGImage,Swift.Error>? = nil
+		
+		/// Incremented for each new thumbnail task
+		
+		private var thumbnailGeneration = 0
 	
 	
 //----------------------------------------------------------------------------------------------------------------------
@@ -153,17 +197,26 @@ extension Object
 					return try await task.value
 				}
 
-				// If not then create a new download task and wait for its result
+				// If not then create a new download task and wait for its result. As above, the generation keeps a
+				// cancelled task from clearing the reference to its successor.
+				
+				self.metadataGeneration += 1
+				let generation = self.metadataGeneration
 				
 				let task = Task<[String:Any],Swift.Error>
 				{
-					try await Tasks.canContinue()
+					defer { if self.metadataGeneration == generation { self._loadMetadataTask = nil } }
+
+					try await Tasks.canContinue(.metadata)
 
 					logDataModel.verbose {"Loading metadata for \(identifier)"}
 					
-					let metadata:[String:Any] = try await self.loadMetadataHandler(identifier,data)
+					let metadata:[String:Any] = try await self.instruments.metadataLatency.time(failures:self.instruments.metadataFailures)
+					{
+						try await self.handlers.loadMetadata(identifier,data)
+					}
+					
 					self._metadata = metadata
-					self._loadMetadataTask = nil
 					return metadata
 				}
 				
@@ -180,6 +233,10 @@ extension Object
 		
 		private var _loadMetadataTask:Task<[String:Any],Swift.Error>? = nil
 		
+		/// Incremented for each new metadata task
+		
+		private var metadataGeneration = 0
+		
 		/// Returns true if the metadata is currently being loaded. Can be used to display progress info like a spinning wheel.
 		
 		public var isLoadingMetadata:Bool { _loadMetadataTask != nil }
@@ -217,7 +274,11 @@ extension Object
 				{
 					do
 					{
-						let url:URL = try await self.downloadFileHandler(identifier,data)
+						let url:URL = try await self.instruments.downloadLatency.time(failures:self.instruments.downloadFailures)
+						{
+							try await self.handlers.downloadFile(identifier,data)
+						}
+						
 						self._localFileURL = url
 						self._downloadFileTask = nil
 						return url
@@ -246,4 +307,54 @@ extension Object
 }
 
 
+//----------------------------------------------------------------------------------------------------------------------
+
+
+// MARK: - Handlers
+
+extension Object.Loader
+{
+	/// Handlers is the table of functions that load the thumbnail, metadata and file of an Object. Since these
+	/// are the same for all Objects of a class, a single shared table per class is used instead of storing three
+	/// closures (and their contexts) in every Object.
+	
+	public final class Handlers
+	{
+		public let loadThumbnail:LoadThumbnailHandler
+		public let loadMetadata:LoadMetadataHandler
+		public let downloadFile:DownloadFileHandler
+		
+		public init(loadThumbnail:@escaping LoadThumbnailHandler, loadMetadata:@escaping LoadMetadataHandler, downloadFile:@escaping DownloadFileHandler)
+		{
+			self.loadThumbnail = loadThumbnail
+			self.loadMetadata = loadMetadata
+			self.downloadFile = downloadFile
+		}
+		
+		/// Returns the shared Handlers for the specified Object class. The Handlers are created with the supplied
+		/// closure the first time they are requested for a class.
+		
+		public static func shared(for type:Object.Type, _ makeHandlers:()->Handlers) -> Handlers
+		{
+			lock.lock()
+			defer { lock.unlock() }
+			
+			let key = ObjectIdentifier(type)
+			
+			if let handlers = table[key]
+			{
+				return handlers
+			}
+			
+			let handlers = makeHandlers()
+			table[key] = handlers
+			return handlers
+		}
+		
+		private static var table:[ObjectIdentifier:Handlers] = [:]
+		private static let lock = NSLock()
+	}
+}
+
+
 //----------------------------------------------------------------------------------------------------------------------
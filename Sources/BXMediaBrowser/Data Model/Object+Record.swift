@@ -0,0 +1,104 @@
+//----------------------------------------------------------------------------------------------------------------------
+//
+//  Copyright ©2026 Peter Baumgartner. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//----------------------------------------------------------------------------------------------------------------------
+
+
+import Foundation
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+extension Object
+{
+	/// A Record is a compact value type description of an Object. Containers with many Objects (e.g. large folders)
+	/// can store Records in contiguous storage and only create the (much heavier) Object instances for those entries
+	/// that are actually displayed, dragged or asked for their metadata.
+
+	public struct Record
+	{
+		/// The interned handle of the Object identifier
+
+		public let handle:IdentifierHandle
+
+		/// The name of the Object for UI display purposes
+
+		public var name:String
+
+		/// The MediaType determines which Object subclass will be created for this Record
+
+		public var mediaType:MediaType
+
+		/// The file size in bytes, or 0 if unknown
+
+		public var fileSize:Int64
+
+		/// The creation date of the file, if known
+
+		public var creationDate:Date?
+
+		/// The modification date of the file, if known
+
+		public var modificationDate:Date?
+
+		/// The capture date is only available if it was needed for sorting
+
+		public var captureDate:Date?
+
+		/// Creates a new Record
+
+		public init(identifier:String, name:String, mediaType:MediaType, fileSize:Int64 = 0, creationDate:Date? = nil, modificationDate:Date? = nil, captureDate:Date? = nil)
+		{
+			self.handle = IdentifierTable.shared.handle(for:identifier)
+			self.name = name
+			self.mediaType = mediaType
+			self.fileSize = fileSize
+			self.creationDate = creationDate
+			self.modificationDate = modificationDate
+			self.captureDate = captureDate
+		}
+
+		/// Creates a Record that describes an existing Object
+
+		public init(_ object:Object)
+		{
+			self.handle = object.handle
+			self.name = object.name
+			self.mediaType = object.mediaType
+			self.fileSize = 0
+			self.creationDate = nil
+			self.modificationDate = nil
+			self.captureDate = object.captureDate
+		}
+
+		/// The unique identifier of the Object
+
+		public var identifier:String
+		{
+			handle.identifier
+		}
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
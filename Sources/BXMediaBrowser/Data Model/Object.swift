@@ -48,6 +48,10 @@ open class Object : NSObject, ObservableObject, Identifiable, BXSignpostMixin
 	
 	public let identifier:String
 	
+	/// The interned handle for the identifier. Use it for fast identity checks, hashing and dictionary keys.
+	
+	public let handle:IdentifierHandle
+	
 	/// The name of the object for UI display purposes
 	
 	public var name:String
@@ -59,10 +63,87 @@ open class Object : NSObject, ObservableObject, Identifiable, BXSignpostMixin
 	/// This can be any kind of information that subclasses need to their job.
 	
 	public var data:Any
+	{
+		get { _data.value }
+		set { _data = Payload(newValue) }
+	}
+	
+	/// The data is stored as a Payload, which keeps the common kinds of data without bridging or boxing
+	
+	private var _data:Payload
+	
+	/// File URLs and class instances (e.g. ITLibMediaItem or PHAsset) are stored directly. Only other values
+	/// (e.g. the structs of web services) are stored indirectly, so that the Payload stays as small as a reference
+	/// instead of taking the space of an inline existential in every Object.
+	
+	private enum Payload
+	{
+		case url(URL)
+		case object(AnyObject)
+		indirect case value(Any)
+		
+		init(_ value:Any)
+		{
+			if type(of:value) is AnyObject.Type
+			{
+				self = .object(value as AnyObject)
+			}
+			else if let url = value as? URL
+			{
+				self = .url(url)
+			}
+			else
+			{
+				self = .value(value)
+			}
+		}
+		
+		var value:Any
+		{
+			switch self
+			{
+				case .url(let url): return url
+				case .object(let object): return object
+				case .value(let value): return value
+			}
+		}
+	}
 	
-	/// The Loader is responsible for loading the contents of this Object
+	/// The shared table of load functions for this class of Objects
+	
+	private let handlers:Loader.Handlers
+	
+	/// The Loader is responsible for loading the contents of this Object. It is only created when it is needed
+	/// for the first time, since most Objects of a large Container are never loaded.
+	
+	public var loader:Loader
+	{
+		let lock = self.loaderLock
+		lock.lock()
+		defer { lock.unlock() }
+		
+		if let loader = _loader
+		{
+			return loader
+		}
+		
+		let loader = Loader(identifier:identifier, data:data, handlers:handlers)
+		_loader = loader
+		return loader
+	}
+	
+	private var _loader:Loader? = nil
+	
+	/// Creating the Loader is protected by one of several shared locks, so that Objects don't need a lock of their
+	/// own, while creating the Loaders of different Objects on different threads rarely contends for the same lock.
+	
+	private var loaderLock:NSLock
+	{
+		let hash = UInt(bitPattern:ObjectIdentifier(self).hashValue)
+		return Self.loaderLocks[Int((hash >> 4) % UInt(Self.loaderLocks.count))]
+	}
 	
-	public let loader:Loader
+	private static let loaderLocks = (0 ..< 16).map { _ in NSLock() }
 	
 	/// The thumbnail image of this Object
 	
@@ -72,21 +153,53 @@ open class Object : NSObject, ObservableObject, Identifiable, BXSignpostMixin
 	
 	@MainActor @Published public private(set) var metadata:[String:Any]? = nil
 	
+	/// The PixelAnalysis of the thumbnail image, which provides the dominant colors and is used for filtering by color.
+	/// It is only available after the Object was loaded and is kept in the PixelAnalysis.Store, not in the Object.
+	
+	@MainActor public var pixelAnalysis:PixelAnalysis?
+	{
+		hasPixelAnalysis ? PixelAnalysis.Store.shared.analysis(for:identifier) : nil
+	}
+	
 	/// A reference to the next Object according to the current ordering
 	
-	public internal(set) weak var next:Object? = nil
+	public var next:Object?
+	{
+		nextObject ?? materializer?.object(after:self)
+	}
+	
+	/// The successor in an ObjectList that is backed by Objects
+	
+	internal weak var nextObject:Object? = nil
+	
+	/// The Materializer that created this Object, if it belongs to a lazy ObjectList
+	
+	internal weak var materializer:ObjectList.Materializer? = nil
 	
 	/// Returns true if the media file is avaiable on the local device and can be used directly without downloading
 	
-	@Published public internal(set) var isLocallyAvailable:Bool = true
+	public internal(set) var isLocallyAvailable:Bool = true
+	{
+		willSet { if newValue != isLocallyAvailable { self.objectWillChange.send() } }
+	}
 	
 	/// Returns true if the media file is at a remote location, but can be downloaded to the local device
 	
-	@Published public internal(set) var isDownloadable:Bool = false
+	public internal(set) var isDownloadable:Bool = false
+	{
+		willSet { if newValue != isDownloadable { self.objectWillChange.send() } }
+	}
 	
 	/// Returns true if the media is DRM protected
 	
-	@Published public internal(set) var isDRMProtected:Bool = false
+	public internal(set) var isDRMProtected:Bool = false
+	{
+		willSet { if newValue != isDRMProtected { self.objectWillChange.send() } }
+	}
+	
+	/// Set to true once the PixelAnalysis of the thumbnail is known
+	
+	@MainActor private var hasPixelAnalysis:Bool = false
 
 	/// Returns true if this Object can be used. If false it will be grayed out, but still displayed in the browser.
 	
@@ -98,19 +211,34 @@ open class Object : NSObject, ObservableObject, Identifiable, BXSignpostMixin
 
 	// MARK: - Creating
 	
+	/// Creates a new Object with a shared table of load functions. Subclasses should pass the Handlers that
+	/// are returned by Object.Loader.Handlers.shared(for:), so that all instances of a class use the same table.
+	
+	public init(identifier:String, name:String, data:Any, handlers:Object.Loader.Handlers, in library:Library?)
+	{
+		self.library = library
+		self.identifier = identifier
+		self.handle = IdentifierTable.shared.handle(for:identifier)
+		self.name = name
+		self._data = Payload(data)
+		self.handlers = handlers
+	}
+	
+	/// Creates a new Object with individual load functions. This allocates a separate Handlers table for every
+	/// Object, so the initializer above is preferrable for large numbers of Objects.
+	
 	public init(identifier:String, name:String, data:Any, loadThumbnailHandler:@escaping Object.Loader.LoadThumbnailHandler, loadMetadataHandler:@escaping Object.Loader.LoadMetadataHandler, downloadFileHandler:@escaping Object.Loader.DownloadFileHandler, in library:Library?)
 	{
 		self.library = library
 		self.identifier = identifier
+		self.handle = IdentifierTable.shared.handle(for:identifier)
 		self.name = name
-		self.data = data
+		self._data = Payload(data)
 		
-		self.loader = Object.Loader(
-			identifier: identifier,
-			data: data,
-			loadThumbnailHandler: loadThumbnailHandler,
-			loadMetadataHandler: loadMetadataHandler,
-			downloadFileHandler: downloadFileHandler)
+		self.handlers = Object.Loader.Handlers(
+			loadThumbnail: loadThumbnailHandler,
+			loadMetadata: loadMetadataHandler,
+			downloadFile: downloadFileHandler)
 	}
 	
 
@@ -145,25 +273,48 @@ open class Object : NSObject, ObservableObject, Identifiable, BXSignpostMixin
 	{
 //		guard thumbnailImage == nil || metadata == nil else { return }
 		
-		Task
+		let task = Task
 		{
-			try await Tasks.canContinue()
+			try await Tasks.canContinue(.thumbnail)
 			
 			let token = self.beginSignpost(in:"Object","load")
-			defer { self.endSignpost(with:token, in:"Object","load") }
+			let span = TraceRecorder.begin("Object","load",["identifier":self.identifier])
+			defer { self.endSignpost(with:token, in:"Object","load"); TraceRecorder.end(span) }
 
 			let image = try? await self.loader.thumbnailImage
 			let metadata = try? await self.loader.metadata
+			let pixelAnalysis = PixelAnalysis.Store.shared.analysis(for:self.identifier)
 
+			// If loading was cancelled, then keep the current state
+			
+			try Task.checkCancellation()
+			
 			await MainActor.run
 			{
 				self.thumbnailImage = image
 				self.metadata = metadata
 				self.captureDate = metadata?[.captureDateKey] as? Date
+				self.library?.startupSnapshot?.setNeedsCapture(for:self)
+				
+				// The color of the thumbnail is only known now, so it may no longer qualify for the color filter
+				
+				if !self.hasPixelAnalysis && pixelAnalysis != nil
+				{
+					self.objectWillChange.send()
+					self.hasPixelAnalysis = true
+					self.library?.selection.container?.setNeedsApplyColorFilter(to:self)
+				}
 				
 				completionHandler?()
 			}
 		}
+		
+		// Loading is cancelled when a different Container is selected
+		
+		self.library?.selection.cancellationScope.attach(task)
+		{
+			[loader] in Task { await loader.cancel() }
+		}
 	}
 
 
@@ -171,13 +322,21 @@ open class Object : NSObject, ObservableObject, Identifiable, BXSignpostMixin
 	
 	public func purge(_ completionHandler:(()->Void)? = nil)
 	{
+		// If the Loader was never created, then there is nothing to purge
+		
+		let lock = self.loaderLock
+		lock.lock()
+		let loader = _loader
+		lock.unlock()
+		guard let loader = loader else { completionHandler?(); return }
+		
 		Task
 		{
-			let isLoadingThumbnail = await self.loader.isLoadingThumbnail
-			let isLoadingMetadata = await self.loader.isLoadingMetadata
+			let isLoadingThumbnail = await loader.isLoadingThumbnail
+			let isLoadingMetadata = await loader.isLoadingMetadata
 			if isLoadingThumbnail || isLoadingMetadata { return }
 			
-			await self.loader.purge()
+			await loader.purge()
 			
 			await MainActor.run
 			{
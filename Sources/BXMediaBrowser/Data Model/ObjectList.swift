@@ -0,0 +1,627 @@
+//----------------------------------------------------------------------------------------------------------------------
+//
+//  Copyright ©2026 Peter Baumgartner. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//----------------------------------------------------------------------------------------------------------------------
+
+
+import BXSwiftUtils
+import Foundation
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+/// ObjectList is the list of Objects of a Container. It can be backed by an array of Objects, or by contiguous
+/// storage of compact Object.Records. In the latter case the Object instances are only materialized when they are
+/// accessed via the subscript (e.g. for a visible cell, a drag or a metadata request), and they are recycled again
+/// once nobody references them anymore.
+///
+/// Count, Records and handles can always be accessed without materializing any Objects, so views and algorithms
+/// that work on large lists should prefer these accessors over iterating the Objects.
+
+public struct ObjectList : RandomAccessCollection, RangeReplaceableCollection, ExpressibleByArrayLiteral
+{
+	public typealias Element = Object
+	public typealias Index = Int
+
+	/// The storage is either eager (Object instances) or lazy (Records plus the Materializer that creates Objects)
+
+	private enum Storage
+	{
+		case objects([Object])
+		case records(ContiguousArray<Object.Record>,Materializer)
+	}
+
+	private var storage:Storage
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	// MARK: - Creating
+
+	/// Creates an empty list
+
+	public init()
+	{
+		self.storage = .objects([])
+	}
+
+	/// Creates a list that is backed by existing Object instances
+
+	public init(_ objects:[Object])
+	{
+		self.storage = .objects(objects)
+	}
+
+	public init(arrayLiteral objects:Object...)
+	{
+		self.storage = .objects(objects)
+	}
+
+	/// Creates a lazy list for the specified Records. The factory is called whenever an Object needs to be
+	/// materialized for a Record. It may be called from any thread. The list doesn't modify the returned Objects,
+	/// so the factory should copy any properties it needs from the Record (e.g. the capture date).
+
+	public init<S:Sequence>(records:S, factory:@escaping (Object.Record)->Object) where S.Element == Object.Record
+	{
+		self.storage = .records(ContiguousArray(records), Materializer(factory:factory))
+	}
+
+	/// Returns true if Objects are materialized on demand
+
+	public var isLazy:Bool
+	{
+		if case .records = storage { return true }
+		return false
+	}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	// MARK: - Accessing
+
+	public var startIndex:Int
+	{
+		0
+	}
+
+	public var endIndex:Int
+	{
+		switch storage
+		{
+			case .objects(let objects): return objects.count
+			case .records(let records,_): return records.count
+		}
+	}
+
+	/// Returns the Object at the specified position, materializing it if necessary
+
+	public subscript(position:Int) -> Object
+	{
+		switch storage
+		{
+			case .objects(let objects): return objects[position]
+			case .records(let records,let materializer): return materializer.object(for:records[position])
+		}
+	}
+
+	/// Returns the Record at the specified position without materializing the Object
+
+	public func record(at position:Int) -> Object.Record
+	{
+		switch storage
+		{
+			case .objects(let objects): return Object.Record(objects[position])
+			case .records(let records,_): return records[position]
+		}
+	}
+
+	/// Returns the identifier handle at the specified position without materializing the Object
+
+	public func handle(at position:Int) -> IdentifierHandle
+	{
+		switch storage
+		{
+			case .objects(let objects): return objects[position].handle
+			case .records(let records,_): return records[position].handle
+		}
+	}
+
+	/// Returns the identifier handles of all entries without materializing any Objects
+
+	public var handles:[IdentifierHandle]
+	{
+		switch storage
+		{
+			case .objects(let objects): return objects.map { $0.handle }
+			case .records(let records,_): return records.map { $0.handle }
+		}
+	}
+
+	/// Returns the Object at the specified position, but only if it is currently materialized
+
+	public func materializedObject(at position:Int) -> Object?
+	{
+		switch storage
+		{
+			case .objects(let objects): return objects[position]
+			case .records(let records,let materializer): return materializer.existingObject(for:records[position].handle)
+		}
+	}
+
+	/// Returns all Objects that are currently materialized, e.g. to purge their cached data
+
+	public var materializedObjects:[Object]
+	{
+		switch storage
+		{
+			case .objects(let objects): return objects
+			case .records(let records,let materializer): return records.compactMap { materializer.existingObject(for:$0.handle) }
+		}
+	}
+
+	/// Returns the position of the entry with the specified handle
+
+	public func firstIndex(of handle:IdentifierHandle) -> Int?
+	{
+		switch storage
+		{
+			case .objects(let objects): return objects.firstIndex { $0.handle == handle }
+			case .records(let records,_): return records.firstIndex { $0.handle == handle }
+		}
+	}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	// MARK: - Modifying
+
+	/// Replaces a range of entries with Objects. In a lazy list the new Objects are converted to Records, but
+	/// their instances are kept as long as they are referenced elsewhere.
+
+	public mutating func replaceSubrange<C:Collection>(_ subrange:Range<Int>, with newObjects:C) where C.Element == Object
+	{
+		switch storage
+		{
+			case .objects(var objects):
+				self.storage = .objects([])
+				objects.replaceSubrange(subrange, with:newObjects)
+				self.storage = .objects(objects)
+
+			case .records(var records,let materializer):
+				self.storage = .objects([])
+				newObjects.forEach { materializer.adopt($0) }
+				records.replaceSubrange(subrange, with:newObjects.map { Object.Record($0) })
+				self.storage = .records(records,materializer)
+		}
+	}
+
+	/// Returns a list with the entries whose Records satisfy the predicate. No Objects are materialized.
+
+	public func filter(records isIncluded:(Object.Record) throws -> Bool) rethrows -> ObjectList
+	{
+		var list = self
+
+		switch storage
+		{
+			case .objects(let objects):
+				list.storage = .objects(try objects.filter { try isIncluded(Object.Record($0)) })
+
+			case .records(let records,let materializer):
+				list.storage = .records(try records.filter(isIncluded),materializer)
+		}
+
+		return list
+	}
+
+	/// Returns a list where entries with duplicate identifiers are removed, keeping the first occurrence
+
+	public func removingDuplicateHandles() -> ObjectList
+	{
+		var handles = Set<IdentifierHandle>()
+		handles.reserveCapacity(self.count)
+		return self.filter(records:{ handles.insert($0.handle).inserted })
+	}
+
+	/// Sorts the entries by their Records. No Objects are materialized.
+
+	public mutating func sort(records comparator:(Object.Record,Object.Record) -> Bool)
+	{
+		switch storage
+		{
+			case .objects(let objects):
+				let records = objects.map { Object.Record($0) }
+				let order = records.indices.sorted { comparator(records[$0],records[$1]) }
+				self.storage = .objects(order.map { objects[$0] })
+
+			case .records(var records,let materializer):
+				self.storage = .objects([])
+				records.sort(by:comparator)
+				self.storage = .records(records,materializer)
+		}
+	}
+
+	/// Sorts the entries by their Objects. In a lazy list this needs to materialize all Objects temporarily,
+	/// so sort(records:) should be preferred whenever the sort criteria are available in the Records.
+
+	public mutating func sort(by comparator:(Object,Object) -> Bool)
+	{
+		switch storage
+		{
+			case .objects(var objects):
+				self.storage = .objects([])
+				objects.sort(by:comparator)
+				self.storage = .objects(objects)
+
+			case .records(let records,let materializer):
+				let objects = records.map { materializer.object(for:$0) }
+				let order = objects.indices.sorted { comparator(objects[$0],objects[$1]) }
+				self.storage = .records(ContiguousArray(order.map { records[$0] }),materializer)
+		}
+	}
+
+	/// Removes the entry at the specified position and returns it without materializing the Object
+
+	private mutating func removeEntry(at position:Int) -> Entry
+	{
+		switch storage
+		{
+			case .objects(var objects):
+				self.storage = .objects([])
+				let object = objects.remove(at:position)
+				self.storage = .objects(objects)
+				return .object(object)
+
+			case .records(var records,let materializer):
+				self.storage = .objects([])
+				let record = records.remove(at:position)
+				self.storage = .records(records,materializer)
+				return .record(record)
+		}
+	}
+
+	/// Inserts an entry that was previously removed with removeEntry(at:)
+
+	private mutating func insertEntry(_ entry:Entry, at position:Int)
+	{
+		switch (storage,entry)
+		{
+			case (.objects(var objects), .object(let object)):
+				self.storage = .objects([])
+				objects.insert(object, at:position)
+				self.storage = .objects(objects)
+
+			case (.records(var records,let materializer), .record(let record)):
+				self.storage = .objects([])
+				records.insert(record, at:position)
+				self.storage = .records(records,materializer)
+
+			default:
+				assertionFailure("\(Self.self).\(#function) entry does not match storage")
+		}
+	}
+
+	private enum Entry
+	{
+		case object(Object)
+		case record(Object.Record)
+	}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	// MARK: - Comparing
+
+	/// Returns true if the entry at position i of this list is represented by the same Object instance as the
+	/// entry at position j of the other list. For lazy lists this is decided without materializing any Objects.
+
+	public func isSameEntry(at i:Int, as other:ObjectList, at j:Int) -> Bool
+	{
+		switch (storage,other.storage)
+		{
+			case (.objects(let objects1), .objects(let objects2)):
+				return objects1[i] === objects2[j]
+
+			case (.records(let records1,let materializer1), .records(let records2,let materializer2)):
+				return materializer1 === materializer2 && records1[i].handle == records2[j].handle
+
+			default:
+				return false
+		}
+	}
+
+	/// Returns true if both lists contain the same Object instances in the same order
+
+	public func isIdentical(to other:ObjectList) -> Bool
+	{
+		guard self.count == other.count else { return false }
+		return self.indices.allSatisfy { self.isSameEntry(at:$0, as:other, at:$0) }
+	}
+
+	/// Returns the ListDiff.Batch that transforms this list into the other list. Entries are matched by their
+	/// handles, and entries that are represented by different Object instances are reported as updates.
+
+	public func batch(to other:ObjectList) -> ListDiff.Batch
+	{
+		let old = self.indices.map { Position(index:$0, handle:self.handle(at:$0)) }
+		let new = other.indices.map { Position(index:$0, handle:other.handle(at:$0)) }
+
+		return ListDiff.batch(from:old, to:new, identifiedBy:{ $0.handle }, isUpdated:{ !self.isSameEntry(at:$0.index, as:other, at:$1.index) })
+	}
+
+	private struct Position
+	{
+		let index:Int
+		let handle:IdentifierHandle
+	}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	// MARK: - Linking
+
+	/// Updates the successor references, so that Object.next returns the following Object in this list
+
+	public func link()
+	{
+		switch storage
+		{
+			case .objects(let objects):
+				var prev:Object? = nil
+
+				for object in objects
+				{
+					prev?.nextObject = object
+					object.nextObject = nil
+					prev = object
+				}
+
+			case .records(let records,let materializer):
+				materializer.link(records)
+		}
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+// MARK: - Repositioning
+
+extension ObjectList
+{
+	/// Repositions the Objects with the specified identifiers in a list that is already sorted by comparator.
+	///
+	/// The changed Objects are removed and reinserted at the position found by binary search, while all other
+	/// Objects keep their relative order. Objects for which isIncluded returns false are removed for good. If
+	/// comparator is nil, only the removal is performed. Returns true if the list was modified. Only the changed
+	/// Objects and the Objects visited by the binary search are materialized.
+	
+	@discardableResult mutating func reposition(_ identifiers:Set<String>, comparator:Object.Filter.ObjectComparator?, isIncluded:(Object)->Bool) -> Bool
+	{
+		guard !identifiers.isEmpty else { return false }
+		
+		// Find the changed Objects with a single linear pass over the handles
+		
+		var indexes:[Int] = []
+		var displaced:[Object] = []
+		
+		let handles = Set(identifiers.map { IdentifierTable.shared.handle(for:$0) })
+		
+		for i in self.indices where handles.contains(self.handle(at:i))
+		{
+			let object = self[i]
+			let isRemoved = !isIncluded(object)
+			guard isRemoved || comparator != nil else { continue }
+			
+			indexes += i
+			if !isRemoved { displaced += object }
+		}
+		
+		guard !indexes.isEmpty else { return false }
+		
+		// Remove them (back to front so that indexes stay valid). The displaced Objects are kept alive until they
+		// have been reinserted, so that lazy lists return the same instances.
+		
+		let displacedHandles = Set(displaced.map { $0.handle })
+		var entries:[IdentifierHandle:Entry] = [:]
+		
+		for i in indexes.reversed()
+		{
+			let handle = self.handle(at:i)
+			let entry = self.removeEntry(at:i)
+			if displacedHandles.contains(handle) { entries[handle] = entry }
+		}
+		
+		// Reinsert them at their correct positions
+		
+		if let comparator = comparator
+		{
+			for object in displaced
+			{
+				guard let entry = entries[object.handle] else { continue }
+				let i = self.insertionIndex(for:object, comparator:comparator)
+				self.insertEntry(entry, at:i)
+			}
+		}
+		
+		return true
+	}
+	
+	/// Returns the index at which the specified Object needs to be inserted to keep the list sorted (upper bound)
+	
+	func insertionIndex(for object:Object, comparator:Object.Filter.ObjectComparator) -> Int
+	{
+		var lo = 0
+		var hi = self.count
+		
+		while lo < hi
+		{
+			let mid = (lo + hi) / 2
+			
+			if comparator(object,self[mid])
+			{
+				hi = mid
+			}
+			else
+			{
+				lo = mid + 1
+			}
+		}
+		
+		return lo
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+// MARK: - Materializer
+
+extension ObjectList
+{
+	/// The Materializer creates the Objects of a lazy ObjectList. It remembers the materialized instances weakly,
+	/// so that the same instance is returned while it is in use (e.g. by a cell), but it is released once it is
+	/// no longer referenced.
+
+	final class Materializer
+	{
+		/// Creates a new Object for a Record
+
+		private let factory:(Object.Record)->Object
+
+		/// The materialized Objects by handle
+
+		private var objects:[IdentifierHandle:WeakObject] = [:]
+
+		/// Released Objects are removed from the table once it has grown beyond this size
+
+		private var compactionThreshold = 64
+
+		/// The Records of the list that was linked most recently. This is used to find the successor of an Object.
+
+		private var linkedRecords:ContiguousArray<Object.Record> = []
+
+		/// This lock is used to ensure thread-safe access to all properties
+
+		private let lock = NSLock()
+
+		init(factory:@escaping (Object.Record)->Object)
+		{
+			self.factory = factory
+		}
+
+		/// Returns the existing Object for the specified Record, or creates a new one
+
+		func object(for record:Object.Record) -> Object
+		{
+			if let object = self.existingObject(for:record.handle)
+			{
+				return object
+			}
+
+			// Create the Object outside of the lock, as the factory may take other locks (e.g. of the ObjectRegistry).
+			// If another thread was faster, then its Object wins.
+
+			let object = factory(record)
+
+			lock.lock()
+			defer { lock.unlock() }
+
+			if let existing = objects[record.handle]?.object
+			{
+				return existing
+			}
+
+			self._adopt(object)
+			return object
+		}
+
+		/// Returns the Object for the specified handle if it is currently materialized
+
+		func existingObject(for handle:IdentifierHandle) -> Object?
+		{
+			lock.lock()
+			defer { lock.unlock() }
+			return objects[handle]?.object
+		}
+
+		/// Registers an Object that was created elsewhere
+
+		func adopt(_ object:Object)
+		{
+			lock.lock()
+			defer { lock.unlock() }
+			self._adopt(object)
+		}
+
+		private func _adopt(_ object:Object)
+		{
+			object.materializer = self
+			objects[object.handle] = WeakObject(object:object)
+
+			if objects.count > compactionThreshold
+			{
+				objects = objects.filter { $0.value.object != nil }
+				compactionThreshold = max(64, 2 * objects.count)
+			}
+		}
+
+		/// Remembers the order of the list, so that the successor of an Object can be found
+
+		func link(_ records:ContiguousArray<Object.Record>)
+		{
+			lock.lock()
+			defer { lock.unlock() }
+			self.linkedRecords = records
+		}
+
+		/// Returns the successor of the specified Object in the linked list, materializing it if necessary. This
+		/// requires a linear search, but it is only needed occasionally (e.g. to play the next audio file).
+
+		func object(after object:Object) -> Object?
+		{
+			lock.lock()
+			let records = self.linkedRecords
+			lock.unlock()
+
+			guard let i = records.firstIndex(where:{ $0.handle == object.handle }), i+1 < records.count else { return nil }
+			return self.object(for:records[i+1])
+		}
+	}
+
+	/// A weak reference to a materialized Object
+
+	struct WeakObject
+	{
+		weak var object:Object?
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,169 @@
+//----------------------------------------------------------------------------------------------------------------------
+//
+//  Copyright ©2026 Peter Baumgartner. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//----------------------------------------------------------------------------------------------------------------------
+
+
+import Foundation
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+/// The ObjectRegistry lets Containers reuse Object instances across reloads. Without it every load would create new
+/// Objects, discarding their cached thumbnails and metadata, and the identity of the cells displaying them.
+///
+/// Objects are registered by their identifier together with a Version that describes the state of the underlying
+/// item (e.g. file size and modification date, or the etag of a web service asset). A loader gets back the existing
+/// instance only if the Version is unchanged. The registry only holds weak references, so Objects that are no longer
+/// used by any Container or view are still freed.
+
+public final class ObjectRegistry
+{
+	/// The process-wide shared instance
+
+	public static let shared = ObjectRegistry()
+
+	/// The Version describes the state of the item that an Object represents. If the Version changes, a new Object
+	/// is created.
+
+	public struct Version : Hashable
+	{
+		private let stamp:String
+
+		/// Creates a Version for a local file
+
+		public init(fileSize:Int64, modificationDate:Date)
+		{
+			self.stamp = "\(fileSize):\(modificationDate.timeIntervalSinceReferenceDate)"
+		}
+
+		/// Creates a Version for a remote asset, e.g. from an etag or a last updated timestamp
+
+		public init(etag:String)
+		{
+			self.stamp = etag
+		}
+
+		/// Creates a Version for a Record. Returns nil if the Record doesn't contain a modification date, since it
+		/// couldn't be decided whether the item has changed.
+
+		public init?(_ record:Object.Record)
+		{
+			guard let modificationDate = record.modificationDate else { return nil }
+			self.init(fileSize:record.fileSize, modificationDate:modificationDate)
+		}
+	}
+
+	/// A registered Object and the Version it was created for
+
+	private struct Entry
+	{
+		weak var object:Object?
+		let version:Version
+	}
+
+	/// The registered Objects by handle
+
+	private var entries:[IdentifierHandle:Entry] = [:]
+
+	/// Released Objects are removed from the table once it has grown beyond this size
+
+	private var compactionThreshold = 1024
+
+	/// This lock is used to ensure thread-safe access to the table
+
+	private let lock = NSLock()
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	/// Returns the registered Object for the specified handle if its Version and Library match. Otherwise the create
+	/// closure is called and the new Object is registered. If version is nil, a new Object is always created.
+
+	public func object(for handle:IdentifierHandle, version:Version?, in library:Library?, create:()->Object) -> Object
+	{
+		guard let version = version else { return create() }
+
+		if let object = self.existingObject(for:handle, version:version, in:library)
+		{
+			Metrics.shared.counter(.objectRegistryHits).increment()
+			return object
+		}
+
+		// Create the Object outside of the lock, as this may be expensive. If another thread was faster, then its
+		// Object wins, so that there is only a single instance.
+
+		let object = create()
+
+		lock.lock()
+		defer { lock.unlock() }
+
+		if let entry = entries[handle], entry.version == version, let existing = entry.object, existing.library === library
+		{
+			return existing
+		}
+
+		Metrics.shared.counter(.objectRegistryMisses).increment()
+		entries[handle] = Entry(object:object, version:version)
+
+		if entries.count > compactionThreshold
+		{
+			entries = entries.filter { $0.value.object != nil }
+			compactionThreshold = max(1024, 2 * entries.count)
+		}
+
+		return object
+	}
+
+	/// Convenience function for loaders that work with Records
+
+	public func object(for record:Object.Record, in library:Library?, create:(Object.Record)->Object) -> Object
+	{
+		self.object(for:record.handle, version:Version(record), in:library) { create(record) }
+	}
+
+	/// Returns the registered Object for the specified handle if it is still alive and has the same Version
+
+	public func existingObject(for handle:IdentifierHandle, version:Version, in library:Library?) -> Object?
+	{
+		lock.lock()
+		defer { lock.unlock() }
+
+		guard let entry = entries[handle], entry.version == version else { return nil }
+		guard let object = entry.object, object.library === library else { return nil }
+		return object
+	}
+
+	/// Removes the Object with the specified handle, so that it will be created again the next time
+
+	public func invalidate(_ handle:IdentifierHandle)
+	{
+		lock.lock()
+		defer { lock.unlock() }
+		entries[handle] = nil
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
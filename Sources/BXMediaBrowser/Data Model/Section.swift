@@ -84,6 +84,8 @@ open class Section : ObservableObject, Identifiable, StateSaving
 	
 	public func load(with sectionState:[String:Any]? = nil, in library:Library?)
 	{
+		let sectionState = sectionState ?? library?.restoredState(forKey:stateStoreKey)
+		
 		if let isExpanded = sectionState?[isExpandedKey] as? Bool
 		{
 			self.isExpanded = isExpanded
@@ -92,7 +94,7 @@ open class Section : ObservableObject, Identifiable, StateSaving
 		for source in self.sources
 		{
 			let key = source.stateKey
-			let sourceState = sectionState?[key] as? [String:Any]
+			let sourceState = sectionState?[key] as? [String:Any] ?? library?.restoredState(forKey:source.stateStoreKey)
 			source.load(with:sourceState, in:library)
 		}
 	}
@@ -111,8 +113,7 @@ open class Section : ObservableObject, Identifiable, StateSaving
 
 	public func state() async -> [String:Any]
 	{
-		var state:[String:Any] = [:]
-		state[isExpandedKey] = self.isExpanded
+		var state = await self.ownState()
 
 		for source in self.sources
 		{
@@ -124,6 +125,13 @@ open class Section : ObservableObject, Identifiable, StateSaving
 		return state
 	}
 	
+	/// Returns the state of this Section only, without the state of its Sources
+	
+	public func ownState() async -> [String:Any]
+	{
+		[isExpandedKey:self.isExpanded]
+	}
+	
 	internal var stateKey:String
 	{
 		"\(identifier)".replacingOccurrences(of:".", with:"-")
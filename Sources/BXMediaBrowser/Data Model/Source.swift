@@ -150,7 +150,7 @@ open class Source : ObservableObject, Identifiable, StateSaving
 					
 					for container in containers
 					{
-						let containerState = sourceState?[container.stateKey] as? [String:Any] 
+						let containerState = sourceState?[container.stateKey] as? [String:Any] ?? library?.restoredState(forKey:container.stateStoreKey)
 						let isExpanded = containerState?[container.isExpandedKey] as? Bool ?? false
 						
 						if isExpanded
@@ -212,7 +212,9 @@ open class Source : ObservableObject, Identifiable, StateSaving
 			await MainActor.run
 			{
 				self.objectWillChange.send()
+				let removedContainers = self.containers.filter { $0.identifier == identifier }
 				self.containers = self.containers.filter { $0.identifier != identifier }
+				removedContainers.forEach { self.library?.removeState(of:$0) }
 			}
 		}
 	}
@@ -227,9 +229,7 @@ open class Source : ObservableObject, Identifiable, StateSaving
 	
 	public func state() async -> [String:Any]
 	{
-		var state:[String:Any] = [:]
-		
-		self.save(to:&state)
+		var state = await self.ownState()
 		
 		let containers = await self.containers
 
@@ -243,6 +243,16 @@ open class Source : ObservableObject, Identifiable, StateSaving
 		return state
 	}
 	
+	/// Returns the state of this Source only, without the state of its Containers. Subclasses can override
+	/// this function to add additional info (like bookmarks) that is needed to recreate the top-level Containers.
+	
+	open func ownState() async -> [String:Any]
+	{
+		var state:[String:Any] = [:]
+		self.save(to:&state)
+		return state
+	}
+	
 	/// Saves the properties that are relevant to this Source to the supplied state dictionary
 	
 	open func save(to state:inout [String:Any])
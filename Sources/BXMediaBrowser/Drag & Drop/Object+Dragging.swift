@@ -91,9 +91,17 @@ extension Object : NSFilePromiseProviderDelegate
 				catch let error
 				{
 					logDragAndDrop.error {"\(Self.self).\(#function) ERROR \(error)"}
+					return
 				}
 			}
 		}
+		
+		// The Object was imported by the host application, so count it as used
+		
+		await MainActor.run
+		{
+			StatisticsController.shared.incrementUseCount(for:self)
+		}
     }
 }
 
@@ -139,7 +139,7 @@ open class AudioFolderContainer : FolderContainer
 	}
 
 
-	override open class func createObject(for url:URL, filter:FolderFilter, in library:Library?) throws -> Object?
+	override open class func createRecord(for url:URL, filter:FolderFilter) throws -> Object.Record?
 	{
 		if Config.DRMProtectedFile.isVisible == false && url.pathExtension == "m4p"
 		{
@@ -151,6 +151,11 @@ open class AudioFolderContainer : FolderContainer
 			return nil
 		}
 		
+		return Object.Record(url:url, mediaType:.audio)
+	}
+
+	override open class func createObject(for url:URL, filter:FolderFilter, in library:Library?) throws -> Object?
+	{
 		return AudioFile(url:url, in:library)
 	}
 
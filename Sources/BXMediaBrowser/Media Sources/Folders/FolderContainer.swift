@@ -152,10 +152,10 @@ open class FolderContainer : Container
 
 
 	// This container can be expanded if it has subfolders. Since it is fairly expensive to scan a directory just to
-	// find out whether it has any subfolders, we will perform the scanning on a background task. In the meantime we
-	// will return a default value of false (meaning that no disclosure triangle is displayed in the user interface.
-	// Once the result is available, it will be assigned to the published helper property 'hasSubfolders' which will
-	// trigger the UI to be updated automatically.
+	// find out whether it has any subfolders, the SubfolderProbe checks the folders of all visible containers in a
+	// batch on a background thread. In the meantime we will return a default value of false (meaning that no disclosure
+	// triangle is displayed in the user interface. Once the result is available, it will be assigned to the published
+	// helper property 'hasSubfolders' which will trigger the UI to be updated automatically.
 	
 	override open var canExpand: Bool
 	{
@@ -164,13 +164,7 @@ open class FolderContainer : Container
 		if !didScanSubfolders
 		{
 			self.didScanSubfolders = true
-			
-			Task
-			{
-				guard let folderURL = self.folderURL else { return }
-				let result = folderURL.hasSubfolders
-				await MainActor.run { self.hasSubfolders = result }
-			}
+			SubfolderProbe.shared.request(self)
 		}
 
 		return self.hasSubfolders
@@ -178,7 +172,7 @@ open class FolderContainer : Container
 	
 	private var didScanSubfolders = false
 	
-	@MainActor @Published public private(set) var hasSubfolders = false
+	@MainActor @Published public internal(set) var hasSubfolders = false
 
 	
 //----------------------------------------------------------------------------------------------------------------------
@@ -193,7 +187,7 @@ open class FolderContainer : Container
 		FolderSource.log.debug {"\(Self.self).\(#function) \(identifier)"}
 
 		var containers:[Container] = []
-		var objects:[Object] = []
+		var records:[Object.Record] = []
 		
 		// Convert identifier to URL and perform some sanity checks
 		
@@ -239,25 +233,30 @@ open class FolderContainer : Container
 				}
 			}
 			
-			// If a file meets the filter criteria create an Object
+			// If a file meets the filter criteria create a Record. The Object itself is only created when needed.
 			
 			else if let url = Self.filter(url, with:filter)
 			{
-				if let object = try? Self.createObject(for:url, filter:filter, in:library)
+				if var record = try? Self.createRecord(for:url, filter:filter)
 				{
-					if filter.rating == 0 || StatisticsController.shared.rating(for:object) >= filter.rating
+					// Skip Records that couldn't be materialized later, because their identifier isn't a file URL
+					
+					guard (try? FolderSource.url(for:record.identifier)) != nil else
+					{
+						FolderSource.log.error {"\(Self.self).\(#function) skipping \(record.identifier) because it is not a file URL"}
+						continue
+					}
+					
+					if filter.rating == 0 || StatisticsController.shared.rating(for:record) >= filter.rating
 					{
-						objects.append(object)
-
 						// For sorting by capture date we need to make sure a date is available
 						
 						if filter.sortType == .captureDate
 						{
-							let metadata = try? await object.loader.metadata
-							object.captureDate =
-								(metadata?[.captureDateKey] as? Date) ??
-								url.creationDate
+							record.captureDate = await Self.captureDate(for:record, url:url)
 						}
+
+						records.append(record)
 					}
 				}
 			}
@@ -267,6 +266,21 @@ open class FolderContainer : Container
 		
 		guard !Task.isCancelled else { throw Error.loadContentsCancelled }
 
+		// The Objects are only created when they are needed. The capture date is copied while the new Object isn't
+		// shared yet, so it is never modified while other threads may read it.
+		
+		var objects = ObjectList(records:records)
+		{
+			[weak library] record in
+			
+			ObjectRegistry.shared.object(for:record, in:library)
+			{
+				let object = Self.createObject(for:$0, filter:filter, in:library)
+				object.captureDate = object.captureDate ?? $0.captureDate
+				return object
+			}
+		}
+		
 		filter.sort(&objects)
 		
 		// Return contents
@@ -275,6 +289,66 @@ open class FolderContainer : Container
 	}
 	
 	
+	/// Returns the capture date of a file for sorting. The date is read from the metadata only once per Version
+	/// of the file, so reloading a folder or materializing its Objects doesn't read the metadata again.
+	
+	class func captureDate(for record:Object.Record, url:URL) async -> Date?
+	{
+		let version = ObjectRegistry.Version(record)
+		
+		if let version = version, let date = captureDateCache.date(for:record.handle, version:version)
+		{
+			return date
+		}
+		
+		let metadata = try? await Self.objectClass(for:record.mediaType).loadMetadata(for:record.identifier, data:url)
+		let date = (metadata?[.captureDateKey] as? Date) ?? record.creationDate
+		
+		if let version = version, let date = date
+		{
+			captureDateCache.setDate(date, for:record.handle, version:version)
+		}
+		
+		return date
+	}
+	
+	/// Loads the thumbnail of a file for the color analysis, without creating its Object
+	
+	override func loadThumbnail(for record:Object.Record) async throws -> CGImage?
+	{
+		let url = try FolderSource.url(for:record.identifier)
+		return try await Self.objectClass(for:record.mediaType).loadThumbnail(for:record.identifier, data:url)
+	}
+	
+	/// The capture dates that were read for sorting
+	
+	static let captureDateCache = CaptureDateCache()
+	
+	/// A thread-safe table of capture dates by handle. An entry is only valid for the Version of the file it was
+	/// read from. Like the IdentifierTable it grows with the number of distinct files that were sorted by date.
+	
+	final class CaptureDateCache
+	{
+		private var entries:[IdentifierHandle:(version:ObjectRegistry.Version,date:Date)] = [:]
+		private let lock = NSLock()
+		
+		func date(for handle:IdentifierHandle, version:ObjectRegistry.Version) -> Date?
+		{
+			lock.lock()
+			defer { lock.unlock() }
+			guard let entry = entries[handle], entry.version == version else { return nil }
+			return entry.date
+		}
+		
+		func setDate(_ date:Date, for handle:IdentifierHandle, version:ObjectRegistry.Version)
+		{
+			lock.lock()
+			defer { lock.unlock() }
+			entries[handle] = (version,date)
+		}
+	}
+	
+	
 	/// Returns the names of all files inside this folder
 	
 	class func filenames(in folderURL:URL) throws -> [String]
@@ -320,10 +394,53 @@ open class FolderContainer : Container
 	}
 
 
-	/// Creates a Object for the file at the specified URL.
+	/// Creates a Record for the file at the specified URL. The MediaType of the Record determines which Object
+	/// subclass will be created once the Object is needed.
 	///
 	/// Subclasses can override this function to filter out some files.
 	
+	open class func createRecord(for url:URL, filter:FolderFilter) throws -> Object.Record?
+	{
+		// Depending on file UTI create different Object subclass instances
+		
+		if url.isImageFile
+		{
+			return Object.Record(url:url, mediaType:.image)
+		}
+		else if url.isVideoFile
+		{
+			return Object.Record(url:url, mediaType:.video)
+		}
+		else if url.isAudioFile
+		{
+			return Object.Record(url:url, mediaType:.audio)
+		}
+		else
+		{
+			return Object.Record(url:url, mediaType:.other)
+		}
+	}
+
+
+	/// Returns the Object subclass for the specified MediaType
+	
+	open class func objectClass(for mediaType:Object.MediaType) -> FolderObject.Type
+	{
+		switch mediaType
+		{
+			case .image: return ImageFile.self
+			case .video: return VideoFile.self
+			case .audio: return AudioFile.self
+			case .other: return FolderObject.self
+		}
+	}
+
+
+	/// Creates a Object for the file at the specified URL. This function is called when the Object for a Record
+	/// is needed.
+	///
+	/// Subclasses can override this function to create their own Object subclasses.
+	
 	open class func createObject(for url:URL, filter:FolderFilter, in library:Library?) throws -> Object?
 	{
 		// Depending on file UTI create different Object subclass instances
@@ -345,6 +462,29 @@ open class FolderContainer : Container
 			return FolderObject(url:url, in:library)
 		}
 	}
+
+
+	/// Materializes the Object for a Record that was created by createRecord(for:filter:). The Record is already
+	/// part of the list, so if createObject(for:filter:in:) fails, a plain FolderObject is returned instead.
+	
+	public class func createObject(for record:Object.Record, filter:FolderFilter, in library:Library?) -> Object
+	{
+		let url = (try? FolderSource.url(for:record.identifier)) ?? URL(fileURLWithPath:record.identifier)
+		
+		do
+		{
+			if let object = try Self.createObject(for:url, filter:filter, in:library)
+			{
+				return object
+			}
+		}
+		catch
+		{
+			FolderSource.log.error {"\(Self.self).\(#function) ERROR cannot create Object for \(url.path): \(error)"}
+		}
+		
+		return FolderObject(url:url, name:record.name, in:library)
+	}
 	
 	
 	/// If the container caches any expensive data, calling this function will discard any cached data
@@ -74,6 +74,27 @@ open class FolderFilter : Object.Filter
 		return nil
 	}
 
+	/// Returns the RecordComparator for the current sorting parameters. Sorting by duration is not supported by
+	/// Records, since the duration is only known after loading the media file.
+	
+	override open var recordComparator : RecordComparator?
+	{
+		let comparator:RecordComparator
+		
+		switch sortType
+		{
+			case .alphabetical: comparator = Self.compareAlphabetical
+			case .captureDate: comparator = Self.compareCaptureDate
+			case .creationDate: comparator = Self.compareCreationDate
+			case .rating: comparator = Self.compareRating
+			case .useCount: comparator = Self.compareUseCount
+			default: return nil
+		}
+		
+		if sortDirection == .ascending { return comparator }
+		return { !comparator($0,$1) }
+	}
+
 	/// Sorts Objects by captureDate
 	
 	public static func compareCaptureDate(_ object1:Object,_ object2:Object) -> Bool
@@ -103,6 +124,33 @@ open class FolderFilter : Object.Filter
 		return name1.localizedStandardCompare(name2) == .orderedAscending
 	}
 
+	/// Sorts Records by captureDate
+	
+	public static func compareCaptureDate(_ record1:Object.Record,_ record2:Object.Record) -> Bool
+	{
+		guard let date1 = record1.captureDate else { return false }
+		guard let date2 = record2.captureDate else { return false }
+		return date1 < date2
+	}
+
+	/// Sorts Records by creationDate
+	
+	public static func compareCreationDate(_ record1:Object.Record,_ record2:Object.Record) -> Bool
+	{
+		guard let date1 = record1.creationDate else { return false }
+		guard let date2 = record2.creationDate else { return false }
+		return date1 < date2
+	}
+
+	/// Sorts Records alphabetically by filename like the Finder
+	
+	public static func compareAlphabetical(_ record1:Object.Record,_ record2:Object.Record) -> Bool
+	{
+		let name1 = record1.name as NSString
+		let name2 = record2.name
+		return name1.localizedStandardCompare(name2) == .orderedAscending
+	}
+
 	/// Sorts Objects by duration
 	
 	public static func compareDuration(_ object1:Object,_ object2:Object) -> Bool
@@ -47,9 +47,7 @@ open class FolderObject : Object
 			identifier: FolderSource.identifier(for:url),
 			name: name ?? url.lastPathComponent,
 			data: url,
-			loadThumbnailHandler: Self.loadThumbnail,
-			loadMetadataHandler: Self.loadMetadata,
-			downloadFileHandler: Self.downloadFile,
+			handlers: .shared(for:Self.self) { .init(loadThumbnail:Self.loadThumbnail, loadMetadata:Self.loadMetadata, downloadFile:Self.downloadFile) },
 			in: library)
 
 		// File in a Finder folder are always local, non-download
@@ -255,3 +253,25 @@ open class FolderObject : Object
 //----------------------------------------------------------------------------------------------------------------------
 
 
+// MARK: -
+
+extension Object.Record
+{
+	/// Creates a Record for the file at the specified URL. Size and dates are read with a single call.
+	
+	public init(url:URL, mediaType:Object.MediaType)
+	{
+		let values = try? url.resourceValues(forKeys:[.fileSizeKey,.creationDateKey,.contentModificationDateKey])
+		
+		self.init(
+			identifier: FolderSource.identifier(for:url),
+			name: url.lastPathComponent,
+			mediaType: mediaType,
+			fileSize: Int64(values?.fileSize ?? 0),
+			creationDate: values?.creationDate,
+			modificationDate: values?.contentModificationDate)
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
@@ -221,9 +221,9 @@ open class FolderSource : Source, AccessControl
 //----------------------------------------------------------------------------------------------------------------------
 
 
-	override public func state() async -> [String:Any]
+	override public func ownState() async -> [String:Any]
 	{
-		var state = await super.state()
+		var state = await super.ownState()
 		
 		let bookmarks = await self.containers
 			.compactMap { $0 as? FolderContainer }
@@ -69,10 +69,15 @@ open class ImageFolderSource : FolderSource
 
 open class ImageFolderContainer : FolderContainer
 {
-	override open class func createObject(for url:URL, filter:FolderFilter, in library:Library?) throws -> Object?
+	override open class func createRecord(for url:URL, filter:FolderFilter) throws -> Object.Record?
 	{
 		guard url.exists else { throw Object.Error.notFound }
 		guard url.isImageFile || url.isPDFFile else { return nil }
+		return Object.Record(url:url, mediaType:.image)
+	}
+
+	override open class func createObject(for url:URL, filter:FolderFilter, in library:Library?) throws -> Object?
+	{
 		return ImageFile(url:url, in:library)
 	}
 
@@ -97,6 +102,11 @@ open class ImageFolderContainer : FolderContainer
 
 open class ImageFile : FolderObject
 {
+	/// The reader that is used to extract metadata from image files. Set to nil to use ImageIO instead, which
+	/// returns many more properties, but is considerably slower.
+	
+	public static var metadataReader:ImageMetadataReader? = ImageMetadataReader()
+	
 	override nonisolated public var mediaType:MediaType
 	{
 		return .image
@@ -128,7 +138,7 @@ open class ImageFile : FolderObject
 		
 			guard let source = CGImageSourceCreateWithURL(url as CFURL,nil) else { throw Error.loadThumbnailFailed }
 
-			if let thumbnail = CGImageSourceCreateThumbnailAtIndex(source,0,options as CFDictionary), !thumbnail.isAllBlack()
+			if let thumbnail = Self.validated(CGImageSourceCreateThumbnailAtIndex(source,0,options as CFDictionary), for:identifier)
 			{
 				return thumbnail
 			}
@@ -143,7 +153,7 @@ open class ImageFile : FolderObject
 				kCGImageSourceCreateThumbnailWithTransform : kCFBooleanTrue
 			]
 
-			if let thumbnail = CGImageSourceCreateThumbnailAtIndex(source,0,fullImageOptions as CFDictionary), !thumbnail.isAllBlack()
+			if let thumbnail = Self.validated(CGImageSourceCreateThumbnailAtIndex(source,0,fullImageOptions as CFDictionary), for:identifier)
 			{
 				return thumbnail
 			}
@@ -155,6 +165,20 @@ open class ImageFile : FolderObject
 	}
 
 
+	/// Returns the thumbnail if it is usable, or nil if it is all black. The PixelAnalysis that was needed for
+	/// this check is stored right away, so that Object.Loader doesn't have to analyze the thumbnail again.
+	
+	private class func validated(_ thumbnail:CGImage?, for identifier:String) -> CGImage?
+	{
+		guard let thumbnail = thumbnail else { return nil }
+		guard let analysis = PixelAnalysis(thumbnail) else { return thumbnail }
+		guard !analysis.isAllBlack else { return nil }
+		
+		PixelAnalysis.Store.shared.setAnalysis(analysis, for:identifier)
+		return thumbnail
+	}
+
+
 	/// Loads the metadata dictionary for the specified local file URL
 	
 	override open class func loadMetadata(for identifier:String, data:Any) async throws -> [String:Any]
@@ -173,6 +197,14 @@ open class ImageFile : FolderObject
 		let imageInfo = try await url.downloadFromCloudIfNeeded
 		{
 			url in
+			
+			if let reader = Self.metadataReader, let metadata = try? reader.metadata(for:url)
+			{
+				return metadata.dictionary
+			}
+			
+			// Fallback for file formats that are not supported by the ImageMetadataReader
+			
 			guard let source = CGImageSourceCreateWithURL(url as CFURL,nil) else { throw Error.loadMetadataFailed }
 			guard let properties = CGImageSourceCopyPropertiesAtIndex(source,0,nil) else { throw Error.loadMetadataFailed }
 			guard let dict = properties as? [String:Any] else { throw Error.loadMetadataFailed }
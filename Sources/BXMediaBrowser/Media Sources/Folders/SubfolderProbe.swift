@@ -0,0 +1,252 @@
+//----------------------------------------------------------------------------------------------------------------------
+//
+//  Copyright ©2026 Peter Baumgartner. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//----------------------------------------------------------------------------------------------------------------------
+
+
+import BXSwiftUtils
+import Foundation
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+/// The SubfolderProbe finds out whether folders contain any subfolders, so that the disclosure triangle can be shown
+/// in the sidebar before a FolderContainer is loaded.
+///
+/// Requests are collected for a short moment and then probed as a batch on a background thread. The results are
+/// published to all affected FolderContainers at once, so that expanding a folder with hundreds of subfolders only
+/// triggers a single update of the user interface. Probing a folder stops at the first subfolder. If the file system
+/// maintains meaningful link counts for directories, empty folders aren't even opened. Results are cached and are
+/// validated with the modification date of the folder, which changes whenever entries are added, removed or renamed.
+
+final class SubfolderProbe
+{
+	/// Shared instance of this class
+
+	static let shared = SubfolderProbe()
+
+	/// The delay for collecting requests into a batch
+
+	var batchDelay:TimeInterval = 0.02
+
+	/// The FolderContainers that are waiting for the next batch
+
+	@MainActor private var pendingContainers:[FolderContainer] = []
+
+	/// A cached result is only valid as long as the modification date of the folder hasn't changed
+
+	private struct Entry
+	{
+		let modificationDate:timespec
+		let hasSubfolders:Bool
+	}
+
+	/// The cached results, keyed by folder path
+
+	private var cache:[String:Entry] = [:]
+
+	/// The maximum number of cached results. When exceeded the cache starts over.
+
+	private let maxCacheCount = 10_000
+
+	/// This lock is used to ensure thread-safe access to the cache
+
+	private let lock = NSLock()
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	// MARK: - Batching
+
+	/// Requests the hasSubfolders property of the specified FolderContainer to be updated with the next batch
+
+	@MainActor func request(_ container:FolderContainer)
+	{
+		pendingContainers.append(container)
+		guard pendingContainers.count == 1 else { return }
+
+		Task
+		{
+			@MainActor in
+
+			try? await Task.sleep(nanoseconds:UInt64(batchDelay * 1_000_000_000))
+
+			let containers = self.pendingContainers
+			self.pendingContainers = []
+
+			let span = TraceRecorder.begin("FolderContainer","probeSubfolders",["count":"\(containers.count)"])
+			defer { TraceRecorder.end(span) }
+
+			let results = await Task.detached(priority:.utility)
+			{
+				containers.map
+				{
+					container -> Bool in
+					guard let folderURL = container.folderURL else { return false }
+					return self.hasSubfolders(at:folderURL)
+				}
+			}.value
+
+			for (container,hasSubfolders) in zip(containers,results) where container.hasSubfolders != hasSubfolders
+			{
+				container.hasSubfolders = hasSubfolders
+			}
+		}
+	}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	// MARK: - Probing
+
+	/// Returns true if the folder at the specified URL contains at least one subfolder that would be displayed
+	/// in the sidebar, i.e. a readable directory that is neither hidden nor a package.
+
+	func hasSubfolders(at folderURL:URL) -> Bool
+	{
+		let path = folderURL.path
+		var info = stat()
+		guard stat(path, &info) == 0 else { return false }
+
+		let modificationDate = info.st_mtimespec
+
+		if let result = self.cachedResult(for:path, modificationDate:modificationDate)
+		{
+			return result
+		}
+
+		let result:Bool
+
+		if info.st_nlink <= 2 && Self.hasMeaningfulLinkCounts(path)
+		{
+			result = false
+		}
+		else
+		{
+			result = Self.scan(folderURL)
+		}
+
+		self.store(result, for:path, modificationDate:modificationDate)
+		return result
+	}
+
+
+	/// Reads the directory entries until the first subfolder is found
+
+	private static func scan(_ folderURL:URL) -> Bool
+	{
+		let path = folderURL.path
+		guard let directory = opendir(path) else { return false }
+		defer { closedir(directory) }
+
+		while let entry = readdir(directory)
+		{
+			let name = withUnsafeBytes(of:entry.pointee.d_name)
+			{
+				String(decoding:$0.prefix(Int(entry.pointee.d_namlen)), as:UTF8.self)
+			}
+
+			guard !name.hasPrefix(".") else { continue }
+
+			// Most file systems provide the type of the entry, so no additional system call is needed
+
+			var isDirectory = Int32(entry.pointee.d_type) == DT_DIR
+
+			if Int32(entry.pointee.d_type) == DT_UNKNOWN
+			{
+				var info = stat()
+				isDirectory = lstat("\(path)/\(name)", &info) == 0 && (info.st_mode & S_IFMT) == S_IFDIR
+			}
+
+			guard isDirectory else { continue }
+
+			// Only check the expensive properties for actual candidates
+
+			let url = folderURL.appendingPathComponent(name, isDirectory:true)
+			guard url.isReadable else { continue }
+			guard !url.isHidden else { continue }
+			guard !url.isPackage else { continue }
+			return true
+		}
+
+		return false
+	}
+
+
+	/// On traditional Unix file systems the link count of a directory is 2 plus the number of its subdirectories.
+	/// HFS+ and APFS count all entries instead. In both cases a link count of 2 means that there are no subfolders.
+	/// Other file systems (e.g. SMB or FAT volumes) report arbitrary values, so the shortcut isn't used there.
+
+	private static func hasMeaningfulLinkCounts(_ path:String) -> Bool
+	{
+		var info = statfs()
+		guard statfs(path, &info) == 0 else { return false }
+
+		let type = withUnsafeBytes(of:info.f_fstypename)
+		{
+			String(decoding:$0.prefix { $0 != 0 }, as:UTF8.self)
+		}
+
+		return ["apfs","hfs","ufs"].contains(type)
+	}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	// MARK: - Caching
+
+	private func cachedResult(for path:String, modificationDate:timespec) -> Bool?
+	{
+		lock.lock()
+		defer { lock.unlock() }
+
+		guard let entry = cache[path] else { return nil }
+		guard entry.modificationDate.tv_sec == modificationDate.tv_sec else { return nil }
+		guard entry.modificationDate.tv_nsec == modificationDate.tv_nsec else { return nil }
+		return entry.hasSubfolders
+	}
+
+	private func store(_ hasSubfolders:Bool, for path:String, modificationDate:timespec)
+	{
+		lock.lock()
+		defer { lock.unlock() }
+
+		if cache.count >= maxCacheCount { cache.removeAll() }
+		cache[path] = Entry(modificationDate:modificationDate, hasSubfolders:hasSubfolders)
+	}
+
+	/// Discards all cached results
+
+	func purgeCache()
+	{
+		lock.lock()
+		defer { lock.unlock() }
+		cache.removeAll()
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
@@ -68,10 +68,15 @@ open class VideoFolderSource : FolderSource
 
 open class VideoFolderContainer : FolderContainer
 {
-	override open class func createObject(for url:URL, filter:FolderFilter, in library:Library?) throws -> Object?
+	override open class func createRecord(for url:URL, filter:FolderFilter) throws -> Object.Record?
 	{
 		guard url.exists else { throw Object.Error.notFound }
 		guard url.isVideoFile else { return nil }
+		return Object.Record(url:url, mediaType:.video)
+	}
+
+	override open class func createObject(for url:URL, filter:FolderFilter, in library:Library?) throws -> Object?
+	{
 		return VideoFile(url:url, in:library)
 	}
 
@@ -191,7 +191,8 @@ open class LightroomCCContainer : Container, AppLifecycleMixin
 		LightroomCC.log.debug {"\(Self.self).\(#function) \(identifier)"}
 
 		let id = self.beginSignpost(in:"LightroomCCContainer", #function)
-		defer { self.endSignpost(with:id, in:"LightroomCCContainer", #function) }
+		let span = TraceRecorder.begin("LightroomCCContainer", #function, ["identifier":identifier])
+		defer { self.endSignpost(with:id, in:"LightroomCCContainer", #function); TraceRecorder.end(span) }
 
 		// Find our child albums (parent is self) and create a Container for each child
 		
@@ -272,7 +273,7 @@ open class LightroomCCContainer : Container, AppLifecycleMixin
 		
 		// Return contents
 		
-		return (containers,objects)
+		return (containers,ObjectList(objects))
 	}
 
 
@@ -315,7 +316,7 @@ open class LightroomCCContainer : Container, AppLifecycleMixin
 
 			if subtype == "image" && allowImages
 			{
-				let object = LightroomCCImageObject(with:asset, in:library)
+				let object = LightroomCCObject.object(for:asset, in:library) { LightroomCCImageObject(with:asset, in:library) }
 				let id = object.identifier
 				
 				if data.objectMap[id] == nil
@@ -326,7 +327,7 @@ open class LightroomCCContainer : Container, AppLifecycleMixin
 			}
 			else if subtype == "video" && allowVideos
 			{
-				let object = LightroomCCVideoObject(with:asset, in:library)
+				let object = LightroomCCObject.object(for:asset, in:library) { LightroomCCVideoObject(with:asset, in:library) }
 				let id = object.identifier
 				
 				if data.objectMap[id] == nil
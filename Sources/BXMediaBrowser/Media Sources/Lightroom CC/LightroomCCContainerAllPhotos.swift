@@ -172,7 +172,8 @@ open class LightroomCCContainerAllPhotos : Container, AppLifecycleMixin, ScrollT
 		LightroomCC.log.debug {"\(Self.self).\(#function) \(identifier)"}
 
 		let id = self.beginSignpost(in:"LightroomCCContainer", #function)
-		defer { self.endSignpost(with:id, in:"LightroomCCContainer", #function) }
+		let span = TraceRecorder.begin("LightroomCCContainer", #function, ["identifier":identifier])
+		defer { self.endSignpost(with:id, in:"LightroomCCContainer", #function); TraceRecorder.end(span) }
 
 		// When starting out, load first page of assets in this album
 		
@@ -226,7 +227,7 @@ open class LightroomCCContainerAllPhotos : Container, AppLifecycleMixin, ScrollT
 		
 		// Return contents
 		
-		return ([],objects)
+		return ([],ObjectList(objects))
 	}
 
 
@@ -284,7 +285,7 @@ open class LightroomCCContainerAllPhotos : Container, AppLifecycleMixin, ScrollT
 
 			if subtype == "image" && allowImages
 			{
-				let object = LightroomCCImageObject(with:asset, in:library)
+				let object = LightroomCCObject.object(for:asset, in:library) { LightroomCCImageObject(with:asset, in:library) }
 				let id = object.identifier
 				
 				if data.objectMap[id] == nil
@@ -295,7 +296,7 @@ open class LightroomCCContainerAllPhotos : Container, AppLifecycleMixin, ScrollT
 			}
 			else if subtype == "video" && allowVideos
 			{
-				let object = LightroomCCVideoObject(with:asset, in:library)
+				let object = LightroomCCObject.object(for:asset, in:library) { LightroomCCVideoObject(with:asset, in:library) }
 				let id = object.identifier
 				
 				if data.objectMap[id] == nil
@@ -58,9 +58,7 @@ open class LightroomCCObject : Object, AppLifecycleMixin
 			identifier: Self.identifier(for:asset),
 			name: asset.name,
 			data: asset,
-			loadThumbnailHandler: Self.loadThumbnail,
-			loadMetadataHandler: Self.loadMetadata,
-			downloadFileHandler: Self.downloadFile,
+			handlers: .shared(for:Self.self) { .init(loadThumbnail:Self.loadThumbnail, loadMetadata:Self.loadMetadata, downloadFile:Self.downloadFile) },
 			in: library)
 		
 		// If we received a rating from Lightroom, then store it in our database
@@ -85,6 +83,15 @@ open class LightroomCCObject : Object, AppLifecycleMixin
 		"LightroomCC:Asset:\(asset.id)"
 	}
 
+	/// Returns the existing Object for the asset if the asset wasn't updated since that Object was created.
+	/// Otherwise a new Object is created, so that reloading a Container keeps the cached thumbnails and metadata.
+	
+	static func object(for asset:LightroomCC.Asset, in library:Library?, create:()->Object) -> Object
+	{
+		let handle = IdentifierTable.shared.handle(for:Self.identifier(for:asset))
+		return ObjectRegistry.shared.object(for:handle, version:.init(etag:asset.updated), in:library, create:create)
+	}
+
 
 //----------------------------------------------------------------------------------------------------------------------
 
@@ -93,7 +100,7 @@ open class LightroomCCObject : Object, AppLifecycleMixin
 
 	open class func loadThumbnail(for identifier:String, data:Any) async throws -> CGImage
 	{
-		try await Tasks.canContinue()
+		try await Tasks.canContinue(.thumbnail)
 		
 		guard let asset = data as? LightroomCC.Asset else { throw Error.loadThumbnailFailed }
 
@@ -56,7 +56,7 @@ open class LightroomCCVideoObject : LightroomCCObject
 
 	override open class func loadMetadata(for identifier:String, data:Any) async throws -> [String:Any]
 	{
-		try await Tasks.canContinue()
+		try await Tasks.canContinue(.metadata)
 		
 		LightroomCC.log.verbose {"\(Self.self).\(#function) \(identifier)"}
 
@@ -139,7 +139,8 @@ open class LightroomClassicContainer : Container, AppLifecycleMixin
 		LightroomClassic.log.debug {"\(Self.self).\(#function) \(identifier)"}
 
 		let id = self.beginSignpost(in:"LightroomClassicContainer", #function)
-		defer { self.endSignpost(with:id, in:"LightroomClassicContainer", #function) }
+		let span = TraceRecorder.begin("LightroomClassicContainer", #function, ["identifier":identifier])
+		defer { self.endSignpost(with:id, in:"LightroomClassicContainer", #function); TraceRecorder.end(span) }
 
 		var containers:[LightroomClassicContainer] = []
 		var objects:[Object] = []
@@ -220,7 +221,7 @@ open class LightroomClassicContainer : Container, AppLifecycleMixin
 		
 		// Return contents
 		
-		return (containers,objects)
+		return (containers,ObjectList(objects))
 	}
 }
 
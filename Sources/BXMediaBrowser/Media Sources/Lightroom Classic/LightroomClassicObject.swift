@@ -61,9 +61,7 @@ open class LightroomClassicObject : Object, AppLifecycleMixin
 			identifier: Self.identifier(for:imbObject),
 			name: imbObject.name,
 			data: LRCData(imbObject:imbObject, mediaType:mediaType, parserMessenger:parserMessenger),
-			loadThumbnailHandler: Self.loadThumbnail,
-			loadMetadataHandler: Self.loadMetadata,
-			downloadFileHandler: Self.downloadFile,
+			handlers: .shared(for:Self.self) { .init(loadThumbnail:Self.loadThumbnail, loadMetadata:Self.loadMetadata, downloadFile:Self.downloadFile) },
 			in: library)
 	}
 
@@ -80,7 +78,7 @@ open class LightroomClassicObject : Object, AppLifecycleMixin
 
 	open class func loadThumbnail(for identifier:String, data:Any) async throws -> CGImage
 	{
-		try await Tasks.canContinue()
+		try await Tasks.canContinue(.thumbnail)
 		
 		guard let data = data as? LRCData else { throw Error.loadThumbnailFailed }
 		let parserMessenger = data.parserMessenger
@@ -109,7 +107,7 @@ open class LightroomClassicObject : Object, AppLifecycleMixin
 
 	open class func loadMetadata(for identifier:String, data:Any) async throws -> [String:Any]
 	{
-		try await Tasks.canContinue()
+		try await Tasks.canContinue(.metadata)
 		
 		// Load metadata from IMBObject via iMedia framework
 		
@@ -273,9 +273,9 @@ open class LightroomClassicSource : Source, AccessControl
 //----------------------------------------------------------------------------------------------------------------------
 
 
-	override public func state() async -> [String:Any]
+	override public func ownState() async -> [String:Any]
 	{
-		var state = await super.state()
+		var state = await super.ownState()
 		
 		if let bookmark = LightroomClassic.shared.libraryBookmark
 		{
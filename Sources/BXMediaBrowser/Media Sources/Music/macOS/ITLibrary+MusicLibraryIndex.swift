@@ -0,0 +1,101 @@
+//----------------------------------------------------------------------------------------------------------------------
+//
+//  Copyright ©2026 Peter Baumgartner. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//----------------------------------------------------------------------------------------------------------------------
+
+
+#if os(macOS)
+
+import iTunesLibrary
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+/// The MusicLibraryIndex that is used by the MusicSource
+
+public typealias MusicIndex = MusicLibraryIndex<ITLibMediaItem,ITLibPlaylist>
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+extension ITLibMediaItem : MusicLibraryItem
+{
+	public var libraryItemID:UInt64
+	{
+		self.persistentID.uint64Value
+	}
+
+	public var libraryArtistID:UInt64?
+	{
+		self.artist?.persistentID.uint64Value
+	}
+
+	public var libraryArtistName:String?
+	{
+		self.artist?.name
+	}
+
+	public var libraryAlbumID:UInt64
+	{
+		self.album.persistentID.uint64Value
+	}
+
+	public var libraryAlbumTitle:String?
+	{
+		self.album.title
+	}
+
+	public var libraryModifiedDate:Date?
+	{
+		self.modifiedDate
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+extension ITLibPlaylist : MusicLibraryPlaylist
+{
+	public var libraryPlaylistID:UInt64
+	{
+		self.persistentID.uint64Value
+	}
+
+	public var libraryParentID:UInt64?
+	{
+		self.parentID?.uint64Value
+	}
+
+	public var libraryItems:[ITLibMediaItem]
+	{
+		self.items
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+#endif
@@ -0,0 +1,266 @@
+//----------------------------------------------------------------------------------------------------------------------
+//
+//  Copyright ©2026 Peter Baumgartner. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//----------------------------------------------------------------------------------------------------------------------
+
+
+#if os(macOS)
+
+import CoreGraphics
+import CryptoKit
+import Foundation
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+/// MusicArtworkCache shares decoded thumbnails between MusicObjects. All tracks of an album use the same artwork,
+/// so it is decoded only once and the same CGImage instance is returned for every track. Each entry keeps track of
+/// the Objects that use it, and is removed once the last of them has released it. Several Object instances may
+/// share the same owner identifier (e.g. a track that appears in several playlists), so owners are counted per
+/// instance via retain(owner:) and release(owner:).
+
+public final class MusicArtworkCache
+{
+	/// The shared instance that is used by all MusicObjects
+
+	public static let shared = MusicArtworkCache()
+
+	/// The key of an artwork
+
+	public enum Key : Hashable
+	{
+		/// The artwork of an album, identified by its persistent identifier
+
+		case album(UInt64)
+
+		/// Artwork that is identified by a hash of its image data
+
+		case content(Data)
+
+		/// The generic icon for a file type, identified by its UTI
+
+		case type(String)
+	}
+
+	/// A cached image and the identifiers of the Objects that use it
+
+	private struct Entry
+	{
+		let image:CGImage
+		var owners:Set<String>
+	}
+
+	private var entries:[Key:Entry] = [:]
+	private var ownerKeys:[String:Key] = [:]
+	private var ownerCounts:[String:Int] = [:]
+	private let lock = NSLock()
+
+	/// The number of lookups that returned an existing image
+
+	public private(set) var hits = 0
+
+	/// The number of lookups that had to decode an image
+
+	public private(set) var misses = 0
+
+	/// The hit statistics are logged after this number of lookups
+
+	public var reportInterval = 1000
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	// MARK: - Accessing
+
+	/// Returns the key for the artwork of a track. Tracks are keyed by their album, unless the album is unknown
+	/// (persistent identifier 0) or has no title. Unrelated tracks would share a single artwork in that case, so
+	/// the artwork is keyed by a hash of its image data instead. Returns nil if there is no artwork.
+
+	public static func artworkKey(albumID:UInt64, albumTitle:String?, artworkData:() -> Data?) -> Key?
+	{
+		if albumID != 0, let title = albumTitle, !title.isEmpty
+		{
+			return .album(albumID)
+		}
+
+		guard let data = artworkData(), !data.isEmpty else { return nil }
+		return .content(Data(SHA256.hash(data:data)))
+	}
+
+	/// Returns the image for the specified key. If the image is not cached yet, it is created with the supplied
+	/// closure. The owner (usually the identifier of an Object) keeps the image alive until it is released.
+
+	public func image(for key:Key, owner:String, create:() throws -> CGImage) throws -> CGImage
+	{
+		if let image = self.existingImage(for:key, owner:owner)
+		{
+			return image
+		}
+
+		// Decode outside of the lock. If two tracks of the same album miss at the same time, the first image
+		// that is stored wins and the other one is discarded.
+
+		let image = try create()
+
+		lock.lock()
+		defer { lock.unlock() }
+
+		self.removeOwner(owner)
+		var entry = entries[key] ?? Entry(image:image, owners:[])
+		entry.owners.insert(owner)
+		entries[key] = entry
+		ownerKeys[owner] = key
+		return entry.image
+	}
+
+
+	/// Registers an Object instance for the specified owner identifier. Each call must be balanced by a call
+	/// to release(owner:).
+
+	public func retain(owner:String)
+	{
+		lock.lock()
+		defer { lock.unlock() }
+		ownerCounts[owner, default:0] += 1
+	}
+
+	/// Releases an Object instance for the specified owner identifier. The image that is used by the owner is
+	/// released when the last instance is gone. Owners that were never retained are released immediately.
+
+	public func release(owner:String)
+	{
+		lock.lock()
+		defer { lock.unlock() }
+
+		let count = (ownerCounts[owner] ?? 1) - 1
+
+		if count > 0
+		{
+			ownerCounts[owner] = count
+		}
+		else
+		{
+			ownerCounts[owner] = nil
+			self.removeOwner(owner)
+		}
+	}
+
+
+	/// Returns a cached image and registers the owner, or counts a miss
+
+	private func existingImage(for key:Key, owner:String) -> CGImage?
+	{
+		lock.lock()
+		defer { lock.unlock() }
+
+		defer
+		{
+			if (hits + misses) % reportInterval == 0
+			{
+				let statistics = self._statistics
+				MusicSource.log.debug {"\(Self.self) \(statistics)"}
+			}
+		}
+
+		guard var entry = entries[key] else
+		{
+			misses += 1
+			return nil
+		}
+
+		hits += 1
+
+		if ownerKeys[owner] != key
+		{
+			self.removeOwner(owner)
+			entry.owners.insert(owner)
+			entries[key] = entry
+			ownerKeys[owner] = key
+		}
+
+		return entry.image
+	}
+
+
+	/// Removes the owner from its entry and removes the entry when it is no longer used. Must be called with the lock held.
+
+	private func removeOwner(_ owner:String)
+	{
+		guard let key = ownerKeys.removeValue(forKey:owner) else { return }
+
+		entries[key]?.owners.remove(owner)
+
+		if entries[key]?.owners.isEmpty ?? false
+		{
+			entries[key] = nil
+		}
+	}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	// MARK: - Statistics
+
+	/// The fraction of lookups that returned an existing image
+
+	public var hitRate:Double
+	{
+		lock.lock()
+		defer { lock.unlock() }
+		let lookups = hits + misses
+		return lookups > 0 ? Double(hits) / Double(lookups) : 0
+	}
+
+	/// The number of distinct images that are currently cached
+
+	public var count:Int
+	{
+		lock.lock()
+		defer { lock.unlock() }
+		return entries.count
+	}
+
+	/// A summary of the cache usage for logging
+
+	public var statistics:String
+	{
+		lock.lock()
+		defer { lock.unlock() }
+		return _statistics
+	}
+
+	private var _statistics:String
+	{
+		let lookups = hits + misses
+		let rate = lookups > 0 ? 100 * hits / lookups : 0
+		return "hits = \(hits), misses = \(misses), hit rate = \(rate)%, images = \(entries.count), owners = \(ownerKeys.count)"
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+#endif
@@ -34,19 +34,20 @@ import BXSwiftUtils
 
 public class MusicContainer : Container
 {
-	/// The data property is stored via a enum that is carrying associated data
+	/// The data property is stored via a enum that is carrying associated data. All cases share the MusicIndex
+	/// of the library, which provides the pre-grouped tracks.
 	
 	public enum MusicData
 	{
-		case library(allMediaItems:[ITLibMediaItem])
-		case artistFolder(allMediaItems:[ITLibMediaItem])
-		case albumFolder(allMediaItems:[ITLibMediaItem])
-		case genreFolder(allMediaItems:[ITLibMediaItem])
-		case playlistFolder(playlists:[ITLibPlaylist], allPlaylists:[ITLibPlaylist])
-		case artist(artist:ITLibArtist, allMediaItems:[ITLibMediaItem])
-		case album(album:ITLibAlbum, allMediaItems:[ITLibMediaItem])
-		case genre(genre:String, allMediaItems:[ITLibMediaItem])
-		case playlist(playlist:ITLibPlaylist)
+		case library(index:MusicIndex)
+		case artistFolder(index:MusicIndex)
+		case albumFolder(index:MusicIndex)
+		case genreFolder(index:MusicIndex)
+		case playlistFolder(playlists:[ITLibPlaylist], index:MusicIndex)
+		case artist(artist:MusicIndex.Group, index:MusicIndex)
+		case album(album:MusicIndex.Group, index:MusicIndex)
+		case genre(genre:MusicIndex.Group, index:MusicIndex)
+		case playlist(playlist:ITLibPlaylist, index:MusicIndex)
 	}
 
 
@@ -111,9 +112,9 @@ public class MusicContainer : Container
 		{
 			// Loads the objects (tracks) for the top-level "Library"
 			
-			case .library(let allMediaItems):
+			case .library(let index):
 
-				for item in Self.tracks(with:allMediaItems)
+				for item in index.songs
 				{
 					if filter.contains(item)
 					{
@@ -123,61 +124,61 @@ public class MusicContainer : Container
 
 			// Loads the sub-containers for the top-level "Artists" folder
 			
-			case .artistFolder(let allMediaItems):
+			case .artistFolder(let index):
 			
-				for artist in Self.artists(with:allMediaItems)
+				for artist in index.groups(for:.artist)
 				{
 					try await Tasks.canContinue()
 		
 					containers += MusicSource.makeMusicContainer(
 						library:library,
-						identifier:"MusicSource:Artist:\(artist.persistentID)",
+						identifier:"MusicSource:Artist:\(artist.key)",
 						icon:"person",
-						name:artist.name ?? NSLocalizedString("Artist", tableName:"Music", bundle:.BXMediaBrowser, comment:"Container Name"),
-						data:.artist(artist:artist, allMediaItems:allMediaItems),
+						name:artist.name,
+						data:.artist(artist:artist, index:index),
 						filter:filter,
 						allowedSortTypes:[.never,.album,.genre,.duration,.rating])
 				}
 				
 			// Loads the sub-containers for the top-level "Albums" folder
 			
-			case .albumFolder(let allMediaItems):
+			case .albumFolder(let index):
 			
-				for album in Self.albums(with:allMediaItems)
+				for album in index.groups(for:.album)
 				{
 					try await Tasks.canContinue()
 		
 					containers += MusicSource.makeMusicContainer(
 						library:library,
-						identifier:"MusicSource:Album:\(album.persistentID)",
+						identifier:"MusicSource:Album:\(album.key)",
 						icon:"square",
-						name:album.title ?? NSLocalizedString("Album", tableName:"Music", bundle:.BXMediaBrowser, comment:"Container Name"),
-						data:.album(album:album, allMediaItems:allMediaItems),
+						name:album.name,
+						data:.album(album:album, index:index),
 						filter:filter,
 						allowedSortTypes:[.never,.artist,.genre,.duration,.rating])
 				}
 			
 			// Loads the sub-containers for the top-level "Genres" folder
 			
-			case .genreFolder(let allMediaItems):
+			case .genreFolder(let index):
 			
-				for genre in Self.genres(with:allMediaItems)
+				for genre in index.groups(for:.genre)
 				{
 					try await Tasks.canContinue()
 		
 					containers += MusicSource.makeMusicContainer(
 						library:library,
-						identifier:"MusicSource:Genre:\(genre)",
+						identifier:"MusicSource:Genre:\(genre.key)",
 						icon:"music.note",
-						name:genre,
-						data:.genre(genre:genre, allMediaItems:allMediaItems),
+						name:genre.name,
+						data:.genre(genre:genre, index:index),
 						filter:filter,
 						allowedSortTypes:[.never,.artist,.album,.duration,.rating])
 				}
 			
 			// Loads the sub-containers for a playlist folder
 			
-			case .playlistFolder(let playlists, let allPlaylists):
+			case .playlistFolder(let playlists, let index):
 			
 				for playlist in playlists
 				{
@@ -197,22 +198,22 @@ public class MusicContainer : Container
 					
 					if kind == .regular	// Accept regular user playlists
 					{
-						containers += Self.container(for:playlist, filter:filter, in:library)
+						containers += Self.container(for:playlist, index:index, filter:filter, in:library)
 					}
 					else if kind == .smart && distinguishedKind == .kindNone // Accept user smart playlists
 					{
-						containers += Self.container(for:playlist, filter:filter, in:library)
+						containers += Self.container(for:playlist, index:index, filter:filter, in:library)
 					}
 					else if kind == .folder	// Accept sub-folders
 					{
-						let childPlaylists = Self.childPlaylists(for:playlist, allPlaylists:allPlaylists)
+						let childPlaylists = index.childPlaylists(of:playlist.libraryPlaylistID)
 						
 						containers += MusicSource.makeMusicContainer(
 								library:library,
 								identifier:"MusicSource:Playlist:\(playlist.persistentID)",
 								icon:"folder",
 								name:playlist.name,
-								data:.playlistFolder(playlists:childPlaylists, allPlaylists:allPlaylists),
+								data:.playlistFolder(playlists:childPlaylists, index:index),
 								filter:filter,
 								allowedSortTypes:[])
 					}
@@ -220,9 +221,9 @@ public class MusicContainer : Container
 				
 			// Load the objects (tracks) of an artist
 			
-			case .artist(let artist, let allMediaItems):
+			case .artist(let artist, let index):
 			
-				for item in Self.mediaItems(for:artist, allMediaItems:allMediaItems)
+				for item in index.items(in:artist, for:.artist)
 				{
 					if filter.contains(item)
 					{
@@ -232,9 +233,9 @@ public class MusicContainer : Container
 
 			// Load the objects (tracks) of an album
 			
-			case .album(let album, let allMediaItems):
+			case .album(let album, let index):
 			
-				for item in Self.mediaItems(for:album, allMediaItems:allMediaItems)
+				for item in index.items(in:album, for:.album)
 				{
 					if filter.contains(item)
 					{
@@ -242,11 +243,11 @@ public class MusicContainer : Container
 					}
 				}
 
-			// Load the objects (tracks) of an album
+			// Load the objects (tracks) of a genre
 			
-			case .genre(let genre, let allMediaItems):
+			case .genre(let genre, let index):
 			
-				for item in Self.mediaItems(for:genre, allMediaItems:allMediaItems)
+				for item in index.items(in:genre, for:.genre)
 				{
 					if filter.contains(item)
 					{
@@ -256,9 +257,9 @@ public class MusicContainer : Container
 
 			// Load the objects (tracks) of a playlist
 			
-			case .playlist(let playlist):
+			case .playlist(let playlist, let index):
 			
-				for item in playlist.items
+				for item in index.items(in:playlist)
 				{
 					if filter.contains(item)
 					{
@@ -273,7 +274,7 @@ public class MusicContainer : Container
 		
 		// Return contents
 		
-		return (containers,objects)
+		return (containers,ObjectList(objects))
 	}
 
 
@@ -311,7 +312,7 @@ extension MusicContainer
 {
 	/// Creates a Container for the specified playlist
 	
-	class func container(for playlist:ITLibPlaylist, filter:MusicFilter, in library:Library?) -> MusicContainer
+	class func container(for playlist:ITLibPlaylist, index:MusicIndex, filter:MusicFilter, in library:Library?) -> MusicContainer
 	{
 		var icon = "music.note.list"
 		
@@ -327,101 +328,10 @@ extension MusicContainer
 			identifier:"MusicSource:Playlist:\(playlist.persistentID)",
 			icon:icon,
 			name:playlist.name,
-			data:.playlist(playlist:playlist),
+			data:.playlist(playlist:playlist, index:index),
 			filter:filter,
 			allowedSortTypes:[])
 	}
-
-	/// Returns an array of tracks sorted by name
-	
-	class func tracks(with allMediaItems:[ITLibMediaItem]) -> [ITLibMediaItem]
-	{
-		allMediaItems
-			.sorted { $0.title < $1.title }
-	}
-	
-
-	/// Returns a alphabetically sorted array of artists
-	
-	class func artists(with allMediaItems:[ITLibMediaItem]) -> [ITLibArtist]
-	{
-		let tracks = allMediaItems.filter
-		{
-			(track:ITLibMediaItem)->Bool in
-			guard let name = track.artist?.name else { return false }
-			return !name.isEmpty
-		}
-		
-		let tracksByArtist = Dictionary(grouping:tracks, by:{ $0.artist })
-		let artists = tracksByArtist.keys.compactMap { $0 }
-		return artists.sorted { ($0.name ?? "") < ($1.name ?? "") }
-	}
-	
-	
-	/// Returns a alphabetically sorted array of albums
-	
-	class func albums(with allMediaItems:[ITLibMediaItem]) -> [ITLibAlbum]
-	{
-		let tracks = allMediaItems.filter
-		{
-			(track:ITLibMediaItem)->Bool in
-			guard let title = track.album.title else { return false }
-			return !title.isEmpty
-		}
-		
-		let tracksByAlbum = Dictionary(grouping:tracks, by:{ $0.album })
-		let albums = tracksByAlbum.keys
-		return albums.sorted { ($0.title ?? "") < ($1.title ?? "") }
-	}
-	
-	
-	/// Returns a alphabetically sorted array of genres
-	
-	class func genres(with allMediaItems:[ITLibMediaItem]) -> [String]
-	{
-		var tracksByGenre = Dictionary(grouping:allMediaItems, by:{ $0.genre })
-		tracksByGenre[""] = nil
-		let genres = tracksByGenre.keys
-		return genres.sorted { $0 < $1 }
-	}
-	
-	
-	/// Returns an array of tracks for the specified artist
-	
-	class func mediaItems(for artist:ITLibArtist, allMediaItems:[ITLibMediaItem]) -> [ITLibMediaItem]
-	{
-		allMediaItems
-			.filter { $0.artist == artist }
-			.sorted { $0.title < $1.title }
-	}
-	
-	
-	/// Returns an array of tracks for the specified album (pre-sorted by track number)
-	
-	class func mediaItems(for album:ITLibAlbum, allMediaItems:[ITLibMediaItem]) -> [ITLibMediaItem]
-	{
-		allMediaItems
-			.filter { $0.album == album }
-			.sorted { $0.trackNumber < $1.trackNumber }
-	}
-	
-	
-	/// Returns an array of tracks for the specified genre
-	
-	class func mediaItems(for genre:String, allMediaItems:[ITLibMediaItem]) -> [ITLibMediaItem]
-	{
-		allMediaItems
-			.filter { $0.genre == genre }
-	}
-	
-	
-	/// Returns the array of children for the specified playlist - given the flat array of allPlaylists
-	
-	class func childPlaylists(for playlist:ITLibPlaylist, allPlaylists:[ITLibPlaylist]) -> [ITLibPlaylist]
-	{
-		allPlaylists
-			.filter({ $0.parentID == playlist.persistentID })
-    }
 }
 
 
@@ -44,8 +44,18 @@ open class MusicFilter : Object.Filter
 		
 		// Empty search string will accept all items
 		
+		guard !self.searchString.isEmpty else { return true }
+
+		// Look up the item in the pre-folded search text of the library, which is scanned once per search string
+		
+		if let index = MusicSource.index, let isMatching = index.searchText.contains(item.libraryItemID, searchString:self.searchString)
+		{
+			return isMatching
+		}
+		
+		// Items that are not part of the index are checked individually
+		
 		let searchString = self.searchString.lowercased()
-		guard !searchString.isEmpty else { return true }
 
 		// Check item name
 		
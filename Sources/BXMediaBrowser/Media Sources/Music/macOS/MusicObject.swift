@@ -29,6 +29,7 @@ import BXSwiftUtils
 import iTunesLibrary
 import UniformTypeIdentifiers
 import QuickLook
+import ImageIO
 import AppKit
 
 
@@ -50,9 +51,7 @@ public class MusicObject : Object
 			identifier: identifier,
 			name: name,
 			data: item,
-			loadThumbnailHandler: Self.loadThumbnail,
-			loadMetadataHandler: Self.loadMetadata,
-			downloadFileHandler: Self.downloadFile,
+			handlers: .shared(for:Self.self) { .init(loadThumbnail:Self.loadThumbnail, loadMetadata:Self.loadMetadata, downloadFile:Self.downloadFile) },
 			in: library)
 		
 		// Get status for this audio file
@@ -62,6 +61,8 @@ public class MusicObject : Object
 		self.isDownloadable = false
 		self.isEnabled = isLocallyAvailable
 		
+		MusicArtworkCache.shared.retain(owner:identifier)
+		
 		// DRM protected items are disabled (because not usable outside Music.app or QuickTime Player.app)
 		
 		if isDRMProtected && Config.DRMProtectedFile.isEnabled == false
@@ -81,14 +82,21 @@ public class MusicObject : Object
 		
 		self.observers += NotificationCenter.default.publisher(for:MusicApp.didChangeAccessRights, object:nil).sink
 		{
-			_ in
+			[weak self] _ in
 			
 			if let url = item.location, url.isFileURL			// ATTENTION: Do not reuse the existing url, because
 			{													// it has cached its isReadable value. Create a copy
-				self.isEnabled = url.copy.isReadable			// instead to evaluate isReadable anew!
+				self?.isEnabled = url.copy.isReadable			// instead to evaluate isReadable anew!
 			}
 		}
 	}
+	
+	// Release the shared artwork when this instance goes away
+	
+	deinit
+	{
+		MusicArtworkCache.shared.release(owner:identifier)
+	}
 
 	override nonisolated public var mediaType:MediaType
 	{
@@ -99,31 +107,67 @@ public class MusicObject : Object
 //----------------------------------------------------------------------------------------------------------------------
 
 
-	/// Creates a thumbnail image for the ITLibMediaItem
+	/// Creates a thumbnail image for the ITLibMediaItem. All tracks of an album share the same artwork, so it is
+	/// decoded once and shared via the MusicArtworkCache. Tracks without artwork share the icon of their file type.
 	
 	class func loadThumbnail(for identifier:String, data:Any) async throws -> CGImage
 	{
-		try await Tasks.canContinue()
+		try await Tasks.canContinue(.thumbnail)
 		
 		guard let item = data as? ITLibMediaItem else { throw Error.notFound }
+		
+		if item.hasArtworkAvailable, let key = MusicArtworkCache.artworkKey(albumID:item.album.persistentID.uint64Value, albumTitle:item.album.title, artworkData:{ item.artwork?.imageData })
+		{
+			if let thumbnail = try? MusicArtworkCache.shared.image(for:key, owner:identifier, create:{ try Self.decodeArtwork(of:item) })
+			{
+				return thumbnail
+			}
+		}
+		
 		let url = item.location
 		let uti = url?.uti ?? "public.mp3"
 		
-		if #available(macOS 11, *)
+		return try MusicArtworkCache.shared.image(for:.type(uti), owner:identifier)
 		{
-			if let type = UTType(uti)
+			if #available(macOS 11, *)
 			{
-				let image = NSWorkspace.shared.icon(for:type)
-				guard let thumbnail = image.cgImage(forProposedRect:nil, context:nil, hints:nil) else { throw Error.loadThumbnailFailed }
-				return thumbnail
+				if let type = UTType(uti)
+				{
+					let image = NSWorkspace.shared.icon(for:type)
+					guard let thumbnail = image.cgImage(forProposedRect:nil, context:nil, hints:nil) else { throw Error.loadThumbnailFailed }
+					return thumbnail
+				}
 			}
+			
+			guard let url = url else { throw Error.notFound }
+			let image = NSWorkspace.shared.icon(forFile:url.path)
+			guard let thumbnail = image.cgImage(forProposedRect:nil, context:nil, hints:nil) else { throw Error.loadThumbnailFailed }
+			return thumbnail
 		}
+	}
+	
+	
+	/// Decodes the artwork of the ITLibMediaItem at thumbnail size
+	
+	class func decodeArtwork(of item:ITLibMediaItem) throws -> CGImage
+	{
+		guard let data = item.artwork?.imageData else { throw Error.loadThumbnailFailed }
+		guard let source = CGImageSourceCreateWithData(data as CFData, nil) else { throw Error.loadThumbnailFailed }
+		
+		let options:[CFString:Any] =
+		[
+			kCGImageSourceCreateThumbnailFromImageAlways : true,
+			kCGImageSourceCreateThumbnailWithTransform : true,
+			kCGImageSourceThumbnailMaxPixelSize : Self.maxArtworkSize
+		]
 		
-		guard let url = url else { throw Error.notFound }
-		let image = NSWorkspace.shared.icon(forFile:url.path)
-		guard let thumbnail = image.cgImage(forProposedRect:nil, context:nil, hints:nil) else { throw Error.loadThumbnailFailed }
+		guard let thumbnail = CGImageSourceCreateThumbnailAtIndex(source, 0, options as CFDictionary) else { throw Error.loadThumbnailFailed }
 		return thumbnail
 	}
+	
+	/// The maximum size of decoded artwork in pixels
+	
+	static var maxArtworkSize:Int = 640
 
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -133,7 +177,7 @@ public class MusicObject : Object
 	
 	class func loadMetadata(for identifier:String, data:Any) async throws -> [String:Any]
 	{
-		try await Tasks.canContinue()
+		try await Tasks.canContinue(.metadata)
 		
 		guard let item = data as? ITLibMediaItem else { throw Object.Error.loadMetadataFailed }
 		let artist = (item.artist?.name ?? "") as String
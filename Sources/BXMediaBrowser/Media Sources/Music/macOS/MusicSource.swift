@@ -70,6 +70,19 @@ public class MusicSource : Source, AccessControl
 	
 	static var cachedObjects = ThreadsafeDictionary<String,MusicObject>()
 
+	/// The index of the currently loaded library
+	
+	static var index:MusicIndex? = nil
+	
+	/// The fingerprint of the currently loaded library. It is used to detect whether the library has changed.
+	
+	static var fingerprint:MusicLibraryFingerprint? = nil
+	
+	/// The identifiers of the cached Containers that are affected by the last library change. Only these are
+	/// reloaded. A nil value means that all Containers are affected.
+	
+	static var changedContainerIdentifiers:Set<String>? = nil
+
 	/// Internal observers and subscriptions
 	
 	private var observers:[Any] = []
@@ -105,14 +118,16 @@ public class MusicSource : Source, AccessControl
 		
 		Self.library = try? ITLibrary(apiVersion:"1.1", options:.lazyLoadData)
 		Self.allowedMediaKinds = allowedMediaKinds
+		Self.index = nil
+		Self.fingerprint = nil
 		
 		// Store reference to this source
 		
 		MusicApp.shared.source = self
 
 		// Setup observers to detect changes - well not really, since the API doesn't support it. Instead we "fake" it
-		// by simply reloading EVERYTHING when the application is brought to the foreground again. In this scenario we
-		// simply assume that the user went to the Music.app and made some changes.
+		// by checking the library when the application is brought to the foreground again. In this scenario we
+		// assume that the user went to the Music.app and may have made some changes.
 		
 		self.observers += NotificationCenter.default.publisher(for:NSApplication.didBecomeActiveNotification, object:nil).sink
 		{
@@ -126,9 +141,10 @@ public class MusicSource : Source, AccessControl
 
 	// MARK: -
 	
-	/// This function is called the the app is brought to the foreground again in this case the whole
-	/// Source will be reloaded with updated data from the iTunesLibrary framework, while preserving
-	/// the expanded state of each Container.
+	/// This function is called the the app is brought to the foreground again. If the fingerprint of the library
+	/// has changed, the Source will be reloaded with updated data from the iTunesLibrary framework, while preserving
+	/// the expanded state of each Container. Only the Containers that are affected by the changes load their
+	/// contents again.
 	
 	private func reload()
 	{
@@ -143,10 +159,20 @@ public class MusicSource : Source, AccessControl
 			MusicSource.log.debug {"\(Self.self).\(#function) \(Self.identifier)"}
 			
 			// First reload the ITLibrary. Unfortunately this has to be done manually and it is monolithic.
-			// We cannot detect granular changes to individual playlists.
-
-			Self.library?.reloadData()
+			// We cannot detect granular changes to individual playlists, so compare fingerprints instead.
 
+			guard let itLibrary = Self.library else { return }
+			itLibrary.reloadData()
+			
+			let fingerprint = Self.fingerprint
+			Self.updateIndex(with:itLibrary)
+			
+			guard Self.fingerprint != fingerprint else
+			{
+				MusicSource.log.debug {"\(Self.self).\(#function) library is unchanged"}
+				return
+			}
+			
 			// Get the current expanded state of all Containers
 			
 			let state = await self.state()
@@ -174,9 +200,6 @@ public class MusicSource : Source, AccessControl
 		guard let itLibrary = Self.library else { throw Container.Error.loadContentsFailed }
 		guard let filter = filter as? MusicFilter else { throw Container.Error.loadContentsFailed }
 		
-		let allMediaItems = itLibrary.allMediaItems.filter { Self.allowedMediaKinds.contains($0.mediaKind) }
-		let allPlaylists = itLibrary.allPlaylists
-		let topLevelPlaylists = allPlaylists.filter { $0.parentID == nil }
 		var containers:[Container] = []
 		
 		// Restore read access rights to rootFolder (if it has been previously granted by the user)
@@ -193,32 +216,40 @@ public class MusicSource : Source, AccessControl
 			}
 		}
 		
+		// Group the tracks by artist, album, genre and playlist once, so that the Containers don't need to scan
+		// the whole library when they are expanded or loaded
+		
+		try await Tasks.canContinue()
+		
+		let index = Self.index ?? Self.updateIndex(with:itLibrary)
+		let topLevelPlaylists = index.childPlaylists(of:nil)
+		
 		// Create top-level Containers
 		
 		try await Tasks.canContinue()
 		
 		let songs = NSLocalizedString("Songs", tableName:"Music", bundle:.BXMediaBrowser, comment:"Container Name")
-		containers += Self.makeMusicContainer(library:library, identifier:"MusicSource:Songs", icon:"music.note", name:songs, data:MusicContainer.MusicData.library(allMediaItems:allMediaItems), filter:filter, allowedSortTypes:[.never,.artist,.album,.genre,.duration])
+		containers += Self.makeMusicContainer(library:library, identifier:"MusicSource:Songs", icon:"music.note", name:songs, data:MusicContainer.MusicData.library(index:index), filter:filter, allowedSortTypes:[.never,.artist,.album,.genre,.duration])
 
 		try await Tasks.canContinue()
 		
 		let artists = NSLocalizedString("Artists", tableName:"Music", bundle:.BXMediaBrowser, comment:"Container Name")
-		containers += Self.makeMusicContainer(library:library, identifier:"MusicSource:Artists", icon:"music.mic", name:artists, data:MusicContainer.MusicData.artistFolder(allMediaItems:allMediaItems), filter:filter, allowedSortTypes:[.never,.album,.genre,.duration])
+		containers += Self.makeMusicContainer(library:library, identifier:"MusicSource:Artists", icon:"music.mic", name:artists, data:MusicContainer.MusicData.artistFolder(index:index), filter:filter, allowedSortTypes:[.never,.album,.genre,.duration])
 
 		try await Tasks.canContinue()
 		
 		let albums = NSLocalizedString("Albums", tableName:"Music", bundle:.BXMediaBrowser, comment:"Container Name")
-		containers += Self.makeMusicContainer(library:library, identifier:"MusicSource:Albums", icon:"square.stack", name:albums, data:MusicContainer.MusicData.albumFolder(allMediaItems:allMediaItems), filter:filter, allowedSortTypes:[.never,.artist,.genre,.duration])
+		containers += Self.makeMusicContainer(library:library, identifier:"MusicSource:Albums", icon:"square.stack", name:albums, data:MusicContainer.MusicData.albumFolder(index:index), filter:filter, allowedSortTypes:[.never,.artist,.genre,.duration])
 
 		try await Tasks.canContinue()
 		
 		let genres = NSLocalizedString("Genres", tableName:"Music", bundle:.BXMediaBrowser, comment:"Container Name")
-		containers += Self.makeMusicContainer(library:library, identifier:"MusicSource:Genres", icon:"guitars", name:genres, data:MusicContainer.MusicData.genreFolder(allMediaItems:allMediaItems), filter:filter, allowedSortTypes:[.never,.artist,.album,.duration])
+		containers += Self.makeMusicContainer(library:library, identifier:"MusicSource:Genres", icon:"guitars", name:genres, data:MusicContainer.MusicData.genreFolder(index:index), filter:filter, allowedSortTypes:[.never,.artist,.album,.duration])
 
 		try await Tasks.canContinue()
 		
 		let playlists = NSLocalizedString("Playlists", tableName:"Music", bundle:.BXMediaBrowser, comment:"Container Name")
-		containers += Self.makeMusicContainer(library:library, identifier:"MusicSource:Playlists", icon:"music.note.list", name:playlists, data:MusicContainer.MusicData.playlistFolder(playlists:topLevelPlaylists, allPlaylists:allPlaylists), filter:filter, allowedSortTypes:[])
+		containers += Self.makeMusicContainer(library:library, identifier:"MusicSource:Playlists", icon:"music.note.list", name:playlists, data:MusicContainer.MusicData.playlistFolder(playlists:topLevelPlaylists, index:index), filter:filter, allowedSortTypes:[])
 
 		return containers
 	}
@@ -227,7 +258,91 @@ public class MusicSource : Source, AccessControl
 //----------------------------------------------------------------------------------------------------------------------
 
 
+	/// Builds the index for the current state of the library. If the library was indexed before, the changes are
+	/// applied to the caches: modified and removed Objects are evicted and the affected Containers are recorded.
+	
+	@discardableResult class func updateIndex(with itLibrary:ITLibrary) -> MusicIndex
+	{
+		let allMediaItems = itLibrary.allMediaItems.filter { Self.allowedMediaKinds.contains($0.mediaKind) }
+		let allPlaylists = itLibrary.allPlaylists
+		let fingerprint = MusicLibraryFingerprint(items:allMediaItems, playlists:allPlaylists)
+		
+		// Nothing has changed, so the current index can be used as is
+		
+		if let index = Self.index, let oldFingerprint = Self.fingerprint, oldFingerprint == fingerprint
+		{
+			return index
+		}
+		
+		let index = MusicIndex(items:allMediaItems, playlists:allPlaylists)
+		
+		if let oldIndex = Self.index, let oldFingerprint = Self.fingerprint
+		{
+			let changes = fingerprint.changes(since:oldFingerprint)
+			Self.changedContainerIdentifiers = Self.apply(changes, from:oldIndex, to:index)
+			MusicSource.log.debug {"\(Self.self).\(#function) added = \(changes.addedItems.count), removed = \(changes.removedItems.count), modified = \(changes.modifiedItems.count), playlists = \(changes.changedPlaylists.count)"}
+		}
+		else
+		{
+			Self.changedContainerIdentifiers = nil
+		}
+		
+		Self.index = index
+		Self.fingerprint = fingerprint
+		return index
+	}
+
+
+	/// Updates the cached Objects and returns the identifiers of the Containers that need to be reloaded
+	
+	private class func apply(_ changes:MusicLibraryFingerprint.Changes, from oldIndex:MusicIndex, to newIndex:MusicIndex) -> Set<String>
+	{
+		// Removed and modified Objects will be created again when their Containers are reloaded
+		
+		for id in changes.removedItems.union(changes.modifiedItems)
+		{
+			Self.cachedObjects[Self.objectIdentifier(with:id)] = nil
+		}
+		
+		// The top-level Containers list the groups, so they are always affected
+		
+		var identifiers:Set<String> = ["MusicSource:Songs","MusicSource:Artists","MusicSource:Albums","MusicSource:Genres","MusicSource:Playlists"]
+		
+		// Groups that contained the old tracks or contain the new tracks
+		
+		let oldKeys = oldIndex.groupKeys(containing:changes.removedItems.union(changes.modifiedItems))
+		let newKeys = newIndex.groupKeys(containing:changes.addedItems.union(changes.modifiedItems))
+		
+		for keys in [oldKeys,newKeys]
+		{
+			for key in keys[.artist] ?? [] { identifiers.insert("MusicSource:Artist:\(key)") }
+			for key in keys[.album] ?? [] { identifiers.insert("MusicSource:Album:\(key)") }
+			for key in keys[.genre] ?? [] { identifiers.insert("MusicSource:Genre:\(key)") }
+		}
+		
+		// Playlists that changed or contain modified tracks, and the folders they are in
+		
+		let playlistIDs = changes.changedPlaylists.union(newIndex.playlistIDs(containing:changes.modifiedItems))
+		
+		for id in playlistIDs
+		{
+			identifiers.insert("MusicSource:Playlist:\(id)")
+			
+			for index in [oldIndex,newIndex]
+			{
+				if let parentID = index.parentID(of:id)
+				{
+					identifiers.insert("MusicSource:Playlist:\(parentID)")
+				}
+			}
+		}
+		
+		return identifiers
+	}
+
+
 	/// Tries to reuse an existing Container from the cache before creating a new one and storing it in the cache.
+	/// A reused Container only reloads its contents if it is affected by the last library change.
 	
 	class func makeMusicContainer(library:Library?, identifier:String, icon:String?, name:String, data:MusicContainer.MusicData, filter:MusicFilter, allowedSortTypes:[Object.Filter.SortType]) -> MusicContainer
 	{
@@ -239,9 +354,12 @@ public class MusicSource : Source, AccessControl
 			{
 				container.data = data
 
-				Task
+				if Self.changedContainerIdentifiers?.contains(identifier) ?? true
 				{
-					await container.reload()
+					Task
+					{
+						await container.reload()
+					}
 				}
 			}
 			
@@ -295,6 +413,11 @@ public class MusicSource : Source, AccessControl
 		"MusicSource:ITLibMediaItem:\(item.persistentID)"
 	}
 	
+	class func objectIdentifier(with persistentID:UInt64) -> String
+	{
+		"MusicSource:ITLibMediaItem:\(persistentID)"
+	}
+	
 	
 //----------------------------------------------------------------------------------------------------------------------
 
@@ -336,9 +459,9 @@ public class MusicSource : Source, AccessControl
 
 	// MARK: - Persistence
 	
-	override public func state() async -> [String:Any]
+	override public func ownState() async -> [String:Any]
 	{
-		var state = await super.state()
+		var state = await super.ownState()
 		
 		if let url = MusicApp.shared.grantedFolderURL, let bookmark = try? url.bookmarkData()
 		{
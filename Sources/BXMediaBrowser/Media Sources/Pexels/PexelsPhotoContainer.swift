@@ -59,8 +59,8 @@ open class PexelsPhotoContainer : PexelsContainer
 		let containers:[Container] = []
 		var objects:[Object] = []
 		
-		guard let pexelsData = data as? PexelsData else { return (containers,objects) }
-		guard let pexelsFilter = filter as? PexelsFilter else { return (containers,objects) }
+		guard let pexelsData = data as? PexelsData else { return (containers,ObjectList(objects)) }
+		guard let pexelsFilter = filter as? PexelsFilter else { return (containers,ObjectList(objects)) }
 		
 		// If the search string has changed, then clear the results and store the new filter
 		
@@ -102,7 +102,7 @@ open class PexelsPhotoContainer : PexelsContainer
 			StatisticsController.shared.rating(for:$0) >= filter.rating
 		}
 		
-		return (containers,objects)
+		return (containers,ObjectList(objects))
 	}
 	
 	
@@ -53,9 +53,7 @@ open class PexelsPhotoObject : Object
 			identifier: "PexelsSource:Photo:\(photo.id)",
 			name: photo.alt,
 			data: photo,
-			loadThumbnailHandler: Self.loadThumbnail,
-			loadMetadataHandler: Self.loadMetadata,
-			downloadFileHandler: Self.downloadFile,
+			handlers: .shared(for:Self.self) { .init(loadThumbnail:Self.loadThumbnail, loadMetadata:Self.loadMetadata, downloadFile:Self.downloadFile) },
 			in: library)
 	}
 
@@ -61,8 +61,8 @@ open class PexelsVideoContainer : PexelsContainer
 		let containers:[Container] = []
 		var objects:[Object] = []
 		
-		guard let pexelsData = data as? PexelsData else { return (containers,objects) }
-		guard let pexelsFilter = filter as? PexelsFilter else { return (containers,objects) }
+		guard let pexelsData = data as? PexelsData else { return (containers,ObjectList(objects)) }
+		guard let pexelsFilter = filter as? PexelsFilter else { return (containers,ObjectList(objects)) }
 		
 		// If the search string has changed, then clear the results and store the new filter 
 		
@@ -104,7 +104,7 @@ open class PexelsVideoContainer : PexelsContainer
 			StatisticsController.shared.rating(for:$0) >= filter.rating
 		}
 		
-		return (containers,objects)
+		return (containers,ObjectList(objects))
 	}
 	
 	
@@ -56,9 +56,7 @@ open class PexelsVideoObject : Object
 			identifier: "PexelsSource:Video:\(video.id)",
 			name: name,
 			data: video,
-			loadThumbnailHandler: Self.loadThumbnail,
-			loadMetadataHandler: Self.loadMetadata,
-			downloadFileHandler: Self.downloadFile,
+			handlers: .shared(for:Self.self) { .init(loadThumbnail:Self.loadThumbnail, loadMetadata:Self.loadMetadata, downloadFile:Self.downloadFile) },
 			in: library)
 	}
 
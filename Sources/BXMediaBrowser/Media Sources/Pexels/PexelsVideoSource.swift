@@ -171,9 +171,9 @@ open class PexelsVideoSource : Source, AccessControl
 
 	/// Returns the archived filterData of all saved Containers
 	
-	override public func state() async -> [String:Any]
+	override public func ownState() async -> [String:Any]
 	{
-		var state = await super.state()
+		var state = await super.ownState()
 		
 		let savedFilterDatas = await self.containers
 			.compactMap { $0 as? PexelsVideoContainer }
@@ -297,7 +297,7 @@ public class PhotosContainer : Container
 
 		// Return contents of this Container
 		
-		return (containers,objects)
+		return (containers,ObjectList(objects))
 	}
 
 	
@@ -43,9 +43,7 @@ public class PhotosObject : Object
 			identifier: Self.identifier(for:asset),
 			name: "", // asset.originalFilename ?? "", 	// Getting originalFilename is way too expensive at this point!
 			data: asset,
-			loadThumbnailHandler: Self.loadThumbnail,
-			loadMetadataHandler: Self.loadMetadata,
-			downloadFileHandler: Self.downloadFile,
+			handlers: .shared(for:Self.self) { .init(loadThumbnail:Self.loadThumbnail, loadMetadata:Self.loadMetadata, downloadFile:Self.downloadFile) },
 			in:library)
 
 		self.observer.didChangeHandler =
@@ -130,7 +128,7 @@ public class PhotosObject : Object
 	
 	class func loadThumbnail(for identifier:String, data:Any) async throws -> CGImage
 	{
-		try await Tasks.canContinue()
+		try await Tasks.canContinue(.thumbnail)
 		
 		Photos.log.verbose {"\(Self.self).\(#function) \(identifier)"}
 
@@ -189,7 +187,7 @@ public class PhotosObject : Object
 	
 	class func loadMetadata(for identifier:String, data:Any) async throws -> [String:Any]
 	{
-		try await Tasks.canContinue()
+		try await Tasks.canContinue(.metadata)
 		
 		guard let asset = data as? PHAsset else { throw Object.Error.loadMetadataFailed }
 		
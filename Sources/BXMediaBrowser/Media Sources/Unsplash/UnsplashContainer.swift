@@ -177,8 +177,8 @@ open class UnsplashContainer : Container
 		let containers:[Container] = []
 		var objects:[Object] = []
 		
-		guard let unsplashData = data as? UnsplashData else { return (containers,objects) }
-		guard let unsplashFilter = filter as? UnsplashFilter else { return (containers,objects) }
+		guard let unsplashData = data as? UnsplashData else { return (containers,ObjectList(objects)) }
+		guard let unsplashFilter = filter as? UnsplashFilter else { return (containers,ObjectList(objects)) }
 		
 		// If the search string has changed, then clear the results and store the new filter 
 		
@@ -219,7 +219,7 @@ open class UnsplashContainer : Container
 			StatisticsController.shared.rating(for:$0) >= filter.rating
 		}
 
-		return (containers,objects)
+		return (containers,ObjectList(objects))
 	}
 	
 	
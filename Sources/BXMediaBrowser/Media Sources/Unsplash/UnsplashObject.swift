@@ -45,9 +45,7 @@ open class UnsplashObject : Object
 			identifier: "Unsplash:Photo:\(photo.id)",
 			name: name,
 			data: photo,
-			loadThumbnailHandler: Self.loadThumbnail,
-			loadMetadataHandler: Self.loadMetadata,
-			downloadFileHandler: Self.downloadFile,
+			handlers: .shared(for:Self.self) { .init(loadThumbnail:Self.loadThumbnail, loadMetadata:Self.loadMetadata, downloadFile:Self.downloadFile) },
 			in: library)
 	}
 
@@ -51,11 +51,20 @@ public struct ContainerView : View
 		self.container = container
 	}
 	
+	// Expanding or collapsing via the disclosure button is recorded in the browsing session
+	
+	private var isExpanded:Binding<Bool>
+	{
+		Binding(
+			get: { self.container.isExpanded },
+			set: { self.container.setExpandedByUser($0) })
+	}
+	
 	// View
 	
 	public var body: some View
     {
-		return BXDisclosureView(isExpanded:self.$container.isExpanded, spacing:0,
+		return BXDisclosureView(isExpanded:self.isExpanded, spacing:0,
 
 			header:
 			{
@@ -138,11 +147,11 @@ public struct ContainerView : View
 		
 			.onReceive(container.$containers)
 			{
-				_ in library.setNeedsSaveState()
+				_ in library.setNeedsSaveState(for:container)
 			}
 			.onReceive(container.$isExpanded)
 			{
-				_ in library.setNeedsSaveState()
+				_ in library.setNeedsSaveState(for:container)
 			}
     }
     
@@ -163,7 +172,7 @@ extension ContainerView
 		
 		if container.canExpand
 		{
-			CustomDisclosureButton(icon:nil, label:"", isExpanded:self.$container.isExpanded)
+			CustomDisclosureButton(icon:nil, label:"", isExpanded:self.isExpanded)
 				.frame(width:10)
 		}
 		else
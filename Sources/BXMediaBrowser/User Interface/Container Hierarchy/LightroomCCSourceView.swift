@@ -120,11 +120,11 @@ public struct LightroomCCSourceView : View
 		
 			.onReceive(source.$isExpanded)
 			{
-				_ in library.setNeedsSaveState()
+				_ in library.setNeedsSaveState(for:source)
 			}
 			.onReceive(source.$containers)
 			{
-				_ in library.setNeedsSaveState()
+				_ in library.setNeedsSaveState(for:source)
 			}
     }
     
@@ -98,11 +98,11 @@ public struct LightroomClassicSourceView : View
 		
 			.onReceive(source.$isExpanded)
 			{
-				_ in library.setNeedsSaveState()
+				_ in library.setNeedsSaveState(for:source)
 			}
 			.onReceive(source.$containers)
 			{
-				_ in library.setNeedsSaveState()
+				_ in library.setNeedsSaveState(for:source)
 			}
     }
 }
@@ -92,11 +92,11 @@ public struct MusicSourceView : View
 		
 			.onReceive(source.$isExpanded)
 			{
-				_ in library.setNeedsSaveState()
+				_ in library.setNeedsSaveState(for:source)
 			}
 			.onReceive(source.$containers)
 			{
-				_ in library.setNeedsSaveState()
+				_ in library.setNeedsSaveState(for:source)
 			}
     }
     
@@ -109,7 +109,7 @@ public struct MusicSourceView : View
 			BXMenuItemSpec.action(title: NSLocalizedString("Revoke Access", tableName:"Music", bundle:.BXMediaBrowser, comment:"Menu Item"))
 			{
 				musicApp.revokeReadAccessRights()
-				library.setNeedsSaveState()
+				library.setNeedsSaveState(for:source)
 			}
 		]
 		
@@ -200,7 +200,7 @@ public struct MusicAccessAlertView : View
 					if $0
 					{
 						source.load(in:library)
-						library.setNeedsSaveState()
+						library.setNeedsSaveState(for:source)
 					}
 				}
 			}
@@ -100,11 +100,11 @@ public struct PhotosSourceView : View
 		
 			.onReceive(source.$isExpanded)
 			{
-				_ in library.setNeedsSaveState()
+				_ in library.setNeedsSaveState(for:source)
 			}
 			.onReceive(source.$containers)
 			{
-				_ in library.setNeedsSaveState()
+				_ in library.setNeedsSaveState(for:source)
 			}
     }
 }
@@ -114,11 +114,11 @@ public struct SectionView : View
 		
 		.onReceive(section.$sources)
 		{
-			_ in library.setNeedsSaveState()
+			_ in library.setNeedsSaveState(for:section)
 		}
 		.onReceive(section.$isExpanded)
 		{
-			_ in library.setNeedsSaveState()
+			_ in library.setNeedsSaveState(for:section)
 		}
     }
 }
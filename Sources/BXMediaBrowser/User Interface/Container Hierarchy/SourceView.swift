@@ -77,11 +77,11 @@ public struct SourceView : View
 		
 			.onReceive(source.$containers)
 			{
-				_ in library.setNeedsSaveState()
+				_ in library.setNeedsSaveState(for:source)
 			}
 			.onReceive(source.$isExpanded)
 			{
-				_ in library.setNeedsSaveState()
+				_ in library.setNeedsSaveState(for:source)
 			}
     }
 }
@@ -0,0 +1,140 @@
+//----------------------------------------------------------------------------------------------------------------------
+//
+//  Copyright ©2026 Peter Baumgartner. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//----------------------------------------------------------------------------------------------------------------------
+
+
+import BXSwiftUI
+import BXSwiftUtils
+import SwiftUI
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+public struct ColorFilterPopup : View
+{
+	// Model
+	
+	@ObservedObject var selectedContainer:Container
+	@ObservedObject var filter:Object.Filter
+	
+	// View
+	
+	public var body: some View
+    {
+		HStack(spacing:0)
+		{
+			BXImage(systemName:icon)
+				.foregroundColor(filter.color?.swiftUIColor ?? Color.gray)
+			BXImage(systemName:"chevron.down").scaleEffect(0.75)
+		}
+		.id(selectedContainer.identifier)
+		.popupMenu()
+		{
+			colorItems
+		}
+    }
+    
+    var icon:String
+    {
+		guard filter.color != nil else { return "circle" }
+		return isPartial ? "circle.bottomhalf.fill" : "circle.fill"
+    }
+    
+    /// Returns true while the filter result is incomplete because some thumbnails are still being analyzed
+    
+    var isPartial:Bool
+    {
+		filter.color != nil && selectedContainer.unanalyzedObjectCount > 0
+    }
+    
+    var colorItems:[BXMenuItemSpec]
+    {
+		let filterBy = NSLocalizedString("Filter by Color", bundle:.BXMediaBrowser, comment:"Menu Item")
+		let anyColor = NSLocalizedString("Any Color", bundle:.BXMediaBrowser, comment:"Menu Item")
+
+		var items:[BXMenuItemSpec] = [BXMenuItemSpec.section(title:filterBy)]
+		
+		items += BXMenuItemSpec.action(title:anyColor, state:{ self.state(for:nil) })
+		{
+			filter.color = nil
+		}
+		
+		items += BXMenuItemSpec.divider
+
+		items += PixelAnalysis.ColorTag.allCases.map
+		{
+			color in
+			
+			BXMenuItemSpec.action(title:color.localizedName, state:{ self.state(for:color) })
+			{
+				filter.color = color
+			}
+		}
+		
+		if isPartial
+		{
+			let format = NSLocalizedString("Analyzing %d Thumbnails…", bundle:.BXMediaBrowser, comment:"Menu Item")
+			items += BXMenuItemSpec.divider
+			items += BXMenuItemSpec.section(title:String(format:format, selectedContainer.unanalyzedObjectCount))
+		}
+		
+		return items
+    }
+
+    func state(for color:PixelAnalysis.ColorTag?) -> NSControl.StateValue
+    {
+		self.filter.color == color ? .on : .off
+    }
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+extension PixelAnalysis.ColorTag
+{
+	/// Returns a representative color for displaying in the user interface
+	
+	var swiftUIColor:Color
+	{
+		switch self
+		{
+			case .red: return Color(red:0.90, green:0.15, blue:0.15)
+			case .orange: return Color(red:1.00, green:0.55, blue:0.10)
+			case .brown: return Color(red:0.55, green:0.35, blue:0.15)
+			case .yellow: return Color(red:0.95, green:0.85, blue:0.10)
+			case .green: return Color(red:0.20, green:0.70, blue:0.25)
+			case .cyan: return Color(red:0.10, green:0.75, blue:0.85)
+			case .blue: return Color(red:0.15, green:0.35, blue:0.90)
+			case .purple: return Color(red:0.55, green:0.25, blue:0.80)
+			case .pink: return Color(red:0.95, green:0.45, blue:0.70)
+			case .white: return Color(white:0.95)
+			case .gray: return Color(white:0.55)
+			case .black: return Color(white:0.05)
+		}
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
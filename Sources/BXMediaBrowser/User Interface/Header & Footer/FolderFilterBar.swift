@@ -61,6 +61,13 @@ public struct FolderFilterBar : View
 			RatingFilterView(rating:self.$filter.rating)
 				.padding(.leading,-12)
 				
+			if !isAudio
+			{
+				ColorFilterPopup(
+					selectedContainer:selectedContainer,
+					filter:filter)
+			}
+			
 			SortOrderPopup(
 				defaultShapeIcon:defaultShapeIcon,
 				selectedContainer:selectedContainer,
@@ -77,10 +84,14 @@ public struct FolderFilterBar : View
 
 extension FolderFilterBar
 {
+	var isAudio:Bool
+	{
+		selectedContainer.mediaTypes.contains(.audio)
+	}
+	
 	var defaultShapeIcon:String
 	{
-		let isAudio = selectedContainer.mediaTypes.contains(.audio)
-		return isAudio ? "text.justify" : "square.grid.2x2"
+		isAudio ? "text.justify" : "square.grid.2x2"
 	}
 	
     var searchPlaceholder:String
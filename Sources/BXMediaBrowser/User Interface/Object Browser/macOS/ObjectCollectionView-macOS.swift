@@ -146,6 +146,16 @@ public struct ObjectCollectionView<Cell:ObjectCell> : NSViewRepresentable
 				_ in collectionView.reloadMissingThumbnails()
 			}
 
+		// If a session is being recorded, then log which Objects the user has scrolled to
+		
+		collectionView.observers += NotificationCenter.default.publisher(for:NSView.boundsDidChangeNotification, object:scrollView.contentView)
+			.debounce(for: 0.25, scheduler:DispatchQueue.main)
+			.sink
+			{
+				[weak coordinator = context.coordinator] _ in
+				Task { @MainActor in coordinator?.recordVisibleRange() }
+			}
+
 		return scrollView
 	}
 	
@@ -312,25 +322,13 @@ extension ObjectCollectionView
     }
 
 
-	/// Creates a NSCollectionViewDiffableDataSource. The Coordinator will is the owner of the datasource,
-	/// since it also has access to the data model.
+	/// The Coordinator is the dataSource, since it also has access to the data model. It applies changes of the
+	/// data model to the NSCollectionView as incremental batch updates.
 	
     @MainActor private func configureDataSource(for collectionView:NSCollectionView, coordinator:Coordinator)
     {
-		// Setup the cell provider for the dataSource
-		
-        coordinator.dataSource = NSCollectionViewDiffableDataSource<Int,Object>(collectionView:collectionView)
-        {
-			[weak coordinator] (collectionView:NSCollectionView, indexPath:IndexPath, identifier:Object) -> NSCollectionViewItem? in
-			return coordinator?.cell(for:collectionView, indexPath:indexPath, identifier:identifier)
-		}
-
-        // Set initial data
-        
-        var snapshot = NSDiffableDataSourceSnapshot<Int,Object>()
-        snapshot.appendSections([0])
-        snapshot.appendItems([], toSection:0)
-        coordinator.dataSource.apply(snapshot, animatingDifferences:false)
+		coordinator.collectionView = collectionView
+		collectionView.dataSource = coordinator
     }
     
     /// Register the NSViewController class for the current cellType identifier
@@ -402,7 +400,7 @@ extension NSCollectionView
 	
 extension ObjectCollectionView
 {
-	public class Coordinator : NSObject, NSCollectionViewDelegate
+	public class Coordinator : NSObject, NSCollectionViewDelegate, NSCollectionViewDataSource
     {
 		/// The Container is the data model for the NSCollectionView
 		
@@ -435,9 +433,19 @@ extension ObjectCollectionView
 
 		var currentViewSize:CGSize = .zero
 		
-		/// The dataSource accesses the Objects of the Container
+		/// The NSCollectionView that displays the Objects
+		
+		@MainActor weak var collectionView:NSCollectionView? = nil
+		
+		/// The Objects that are currently displayed. This lags behind the Objects of the Container until the
+		/// changes have been applied to the NSCollectionView. Objects of lazy lists are only materialized when
+		/// their cells are requested.
+		
+		@MainActor private(set) var displayedObjects:ObjectList = []
 		
-		var dataSource: NSCollectionViewDiffableDataSource<Int,Object>! = nil
+		/// If a change affects more Objects than this, then the NSCollectionView is reloaded instead of animated
+		
+		static var maxBatchChangeCount:Int { 2000 }
 		
 		/// The number of cells that fit inside a single row
 		
@@ -452,6 +460,7 @@ extension ObjectCollectionView
 		private var layoutObserver:Any? = nil
 		internal var frameObserver:Any? = nil
 		private var dataSourceObserver:Any? = nil
+		private var objectChangesObserver:Any? = nil
 		
 		
 //----------------------------------------------------------------------------------------------------------------------
@@ -509,47 +518,125 @@ extension ObjectCollectionView
 						self?.shouldAnimate = objects.count <= 1000
 						self?._updateDataSource()
 					}
+					
+				self.objectChangesObserver = container.objectChangesPublisher
+					.receive(on:DispatchQueue.main)
+					.sink
+					{
+						[weak self] in
+						self?.applyObjectChanges()
+					}
 			}
 			
 			self._updateDataSource()
 		}
 		
-		/// Updates the dataSource when the data model has been changed
+		/// Applies in place changes (e.g. Objects that were moved after a rating change) right away instead of
+		/// waiting for the debounced objects update, so that the NSCollectionView animates the affected cells.
+		/// The moves are derived from the difference between the displayed and the current Objects.
+		
+		@MainActor func applyObjectChanges()
+		{
+			self.shouldAnimate = true
+			self._updateDataSource()
+		}
+		
+		/// Updates the NSCollectionView when the data model has been changed. The difference between the displayed
+		/// Objects and the Objects of the Container is applied as a batch of deletes, inserts and moves.
 		
 		@MainActor func _updateDataSource()
 		{
-			let objects = self.container?.objects ?? []
+			guard let collectionView = self.collectionView else { return }
 			
-			var snapshot = NSDiffableDataSourceSnapshot<Int,Object>()
-			snapshot.appendSections([0])
-			snapshot.appendItems(objects, toSection:0)
+			let oldObjects = self.displayedObjects
+			let newObjects = self.container?.objects ?? []
 			
-			do
+			// If the NSCollectionView is already up-to-date, then there is nothing to do
+			
+			if oldObjects.isIdentical(to:newObjects)
 			{
-				try NSException.catch
+				return
+			}
+			
+			// Objects that were replaced by a new instance with the same identifier (e.g. placeholders from the
+			// StartupSnapshot or after reloading a Container) are reported as updates. The diff works on handles,
+			// so it does not materialize any Objects.
+			
+			let batch = oldObjects.batch(to:newObjects)
+			self.displayedObjects = newObjects
+			
+			// Showing a different Container or changing the sort order is cheaper as a full reload
+			
+			if oldObjects.isEmpty || newObjects.isEmpty || batch.changeCount > Self.maxBatchChangeCount
+			{
+				collectionView.reloadData()
+				return
+			}
+			
+			if batch.changeCount > 0
+			{
+				do
 				{
-					self.dataSource.apply(snapshot, animatingDifferences:shouldAnimate)
+					try NSException.catch
+					{
+						let target = self.shouldAnimate ? collectionView.animator() : collectionView
+						
+						target.performBatchUpdates(
+						{
+							collectionView.deleteItems(at:Set(batch.deletes.map { IndexPath(item:$0, section:0) }))
+							collectionView.insertItems(at:Set(batch.inserts.map { IndexPath(item:$0, section:0) }))
+							
+							for move in batch.moves
+							{
+								collectionView.moveItem(at:IndexPath(item:move.from, section:0), to:IndexPath(item:move.to, section:0))
+							}
+						},
+						completionHandler:nil)
+					}
+				}
+				catch let error
+				{
+					log.error {"\(Self.self).\(#function) ERROR \(error)"}
+					collectionView.reloadData()
+					return
 				}
 			}
-			catch let error
+			
+			// Updated Objects only need to be assigned to their visible cells
+			
+			let visibleItems = Set(collectionView.indexPathsForVisibleItems().map { $0.item })
+			
+			for i in batch.updates where visibleItems.contains(i)
 			{
-				log.error {"\(Self.self).\(#function) ERROR \(error)"}
+				if let cell = collectionView.item(at:IndexPath(item:i, section:0)) as? ObjectCell
+				{
+					cell.object = newObjects[i]
+				}
 			}
 		}
 
 
+		public func numberOfSections(in collectionView:NSCollectionView) -> Int
+		{
+			1
+		}
+		
+		@MainActor public func collectionView(_ collectionView:NSCollectionView, numberOfItemsInSection section:Int) -> Int
+		{
+			self.displayedObjects.count
+		}
+		
+		@MainActor public func collectionView(_ collectionView:NSCollectionView, itemForRepresentedObjectAt indexPath:IndexPath) -> NSCollectionViewItem
+		{
+			let object = self.displayedObjects[indexPath.item]
+			return self.cell(for:collectionView, indexPath:indexPath, identifier:object)
+		}
+		
+
 		/// Returns a cell for the specified Object
 		
-		@MainActor func cell(for collectionView:NSCollectionView, indexPath:IndexPath, identifier:Object) -> NSCollectionViewItem?
+		@MainActor func cell(for collectionView:NSCollectionView, indexPath:IndexPath, identifier:Object) -> NSCollectionViewItem
 		{
-			// Check if indexPath is valid
-			
-			let n = self.container?.objects.count ?? 0
-			let i = indexPath.item
-			guard i>=0 && i<n else { return nil }
-			
-			// Get the object - Please note that the dataSource uses Object directly, because it is Hashable and Equatable
-			
 			let object = identifier
 			
 			// Reuse (or create) a cell
@@ -573,7 +660,7 @@ extension ObjectCollectionView
 		@MainActor public func collectionView(_ collectionView:NSCollectionView, willDisplay item:NSCollectionViewItem, forRepresentedObjectAt indexPath:IndexPath)
 		{
 			guard let container = self.container else { return }
-			let n = container.objects.count
+			let n = self.displayedObjects.count
 			guard n > 0 else { return }
 			
 			let i = indexPath.item
@@ -740,6 +827,25 @@ extension ObjectCollectionView
 			{
 				collectionView.item(at:indexPath)?.view.isHidden = false
 			}
+			
+			if let container = self.container, let recorder = container.library?.sessionRecorder
+			{
+				let objects = indexPaths.sorted().compactMap { self.object(for:$0) }
+				recorder.recordDrag(of:objects, from:container)
+			}
+		}
+
+		/// Records the range of visible Objects if a session is being recorded
+		
+		@MainActor func recordVisibleRange()
+		{
+			guard let container = self.container else { return }
+			guard let recorder = container.library?.sessionRecorder else { return }
+			guard let collectionView = self.collectionView else { return }
+			
+			let items = collectionView.indexPathsForVisibleItems().map { $0.item }
+			guard let first = items.min(), let last = items.max() else { return }
+			recorder.recordVisibleRange(first...last, in:container)
 		}
 
 		/// Returns the Object for the specified IndexPath
@@ -747,7 +853,7 @@ extension ObjectCollectionView
 		@MainActor func object(for indexPath:IndexPath) -> Object?
 		{
 			let i = indexPath.item
-			guard let objects = self.container?.objects else { return nil }
+			let objects = self.displayedObjects
 			guard i>=0 && i<objects.count else { return nil }
 			return objects[i]
 		}
@@ -0,0 +1,203 @@
+//----------------------------------------------------------------------------------------------------------------------
+//
+//  Copyright ©2026 Peter Baumgartner. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//----------------------------------------------------------------------------------------------------------------------
+
+
+import BXSwiftUtils
+import Foundation
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+/// A CancellationScope collects Tasks that belong together, e.g. all the work that was started on behalf of the
+/// currently selected Container. When the scope is cancelled, all Tasks that are still running are cancelled too.
+///
+///		let task = Task { ... }
+///		scope.attach(task)
+///		...
+///		scope.cancel()
+	
+public final class CancellationScope
+{
+	/// Counters that measure how much work was started, finished normally, or dropped by cancelling a scope
+	
+	public struct Statistics
+	{
+		public var started = 0
+		public var completed = 0
+		public var dropped = 0
+	}
+	
+	/// A name for debugging purposes, e.g. the identifier of a Container
+	
+	public let name:String
+	
+	/// The cancel handlers of the Tasks that are currently running in this scope
+	
+	private var cancelHandlers:[Int:()->Void] = [:]
+	
+	/// Used to create unique ids for the cancel handlers
+	
+	private var nextID = 0
+	
+	/// Set to true once the scope has been cancelled
+	
+	private var _isCancelled = false
+	
+	/// This lock is used to ensure thread-safe access to the properties above
+	
+	private let lock = NSLock()
+	
+	/// The accumulated statistics of all scopes
+	
+	private static var _statistics = Statistics()
+	
+	/// This lock is used to ensure thread-safe access to the statistics
+	
+	private static let statisticsLock = NSLock()
+	
+	
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	public init(name:String)
+	{
+		self.name = name
+	}
+	
+	/// Returns true if this scope has been cancelled
+	
+	public var isCancelled:Bool
+	{
+		lock.lock()
+		defer { lock.unlock() }
+		return _isCancelled
+	}
+	
+	/// Returns the number of Tasks that are currently running in this scope
+	
+	public var count:Int
+	{
+		lock.lock()
+		defer { lock.unlock() }
+		return cancelHandlers.count
+	}
+	
+	/// Returns the accumulated statistics of all scopes
+	
+	public static var statistics:Statistics
+	{
+		statisticsLock.lock()
+		defer { statisticsLock.unlock() }
+		return _statistics
+	}
+	
+	private static func updateStatistics(_ block:(inout Statistics)->Void)
+	{
+		statisticsLock.lock()
+		block(&_statistics)
+		statisticsLock.unlock()
+	}
+	
+	
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	/// Attaches a running Task to this scope. The Task will be cancelled when the scope is cancelled. The optional
+	/// cancelHandler can be used to cancel additional work (like shared loading Tasks) that the Task is waiting for.
+	/// If the scope has already been cancelled, then the Task is cancelled immediately.
+	
+	public func attach<T,E>(_ task:Task<T,E>, cancelHandler:(()->Void)? = nil)
+	{
+		let cancel:()->Void =
+		{
+			task.cancel()
+			cancelHandler?()
+		}
+		
+		lock.lock()
+		
+		if _isCancelled
+		{
+			lock.unlock()
+			cancel()
+			return
+		}
+		
+		let id = nextID
+		nextID += 1
+		cancelHandlers[id] = cancel
+		lock.unlock()
+		
+		Self.updateStatistics { $0.started += 1 }
+		
+		// Once the Task has finished, it no longer needs to be cancelled
+		
+		Task
+		{
+			_ = await task.result
+			self.complete(id)
+		}
+	}
+	
+	/// Removes a finished Task from this scope
+	
+	private func complete(_ id:Int)
+	{
+		lock.lock()
+		let handler = cancelHandlers.removeValue(forKey:id)
+		lock.unlock()
+		
+		if handler != nil
+		{
+			Self.updateStatistics { $0.completed += 1 }
+		}
+	}
+	
+	/// Cancels all Tasks that are still running in this scope and returns their number
+	
+	@discardableResult public func cancel() -> Int
+	{
+		lock.lock()
+		_isCancelled = true
+		let handlers = cancelHandlers.values
+		cancelHandlers = [:]
+		lock.unlock()
+		
+		handlers.forEach { $0() }
+		
+		let n = handlers.count
+		
+		if n > 0
+		{
+			Self.updateStatistics { $0.dropped += n }
+			BXMediaBrowser.logDataModel.debug {"\(Self.self).\(#function) \(name) dropped \(n) tasks"}
+		}
+		
+		return n
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
@@ -111,6 +111,7 @@ public class FolderObserver : NSObject
 
 			let event = source.data
 			BXMediaBrowser.log.debug {"\(Self.self).\(#function) file system event \(event) for \(self.url)"}
+			Metrics.shared.counter(.folderObserverEvents).increment()
 			
 			switch event
 			{
@@ -146,11 +147,13 @@ public class FolderObserver : NSObject
 			close(self.fileDescriptor)
 			self.fileDescriptor = -1
 			self.monitorSource = nil
+			Metrics.shared.gauge(.folderObserversActive).decrement()
 		}
     
 		// Start monitoring the directory via the source
 		
 		monitorSource?.resume()
+		Metrics.shared.gauge(.folderObserversActive).increment()
 	}
     
     
@@ -183,13 +186,17 @@ public class FolderObserver : NSObject
 	{
 		// Create a folder contents snapshot and compare it with the last one
 		
+		let start = Metrics.now
 		let currentSnapshot = self.createSnapshot()
 		defer { self.lastSnapshot = currentSnapshot }
+		Metrics.shared.histogram(.folderSnapshotLatency).record(since:start)
 		
 		// If the contents have really changed, then call the external handler
 		
 		if !isEqual(lastSnapshot,currentSnapshot)
 		{
+			Metrics.shared.counter(.folderObserverChanges).increment()
+
 			DispatchQueue.main.async
 			{
 				BXMediaBrowser.log.debug {"\(Self.self).\(#function) Folder contents have changed -> CALL HANDLER"}
@@ -202,6 +209,7 @@ public class FolderObserver : NSObject
 		else
 		{
 			BXMediaBrowser.log.debug {"\(Self.self).\(#function) No relevant changes detected -> DISCARDING EVENT"}
+			Metrics.shared.counter(.folderObserverDiscarded).increment()
 		}
 	}
 
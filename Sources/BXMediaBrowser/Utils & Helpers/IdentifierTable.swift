@@ -0,0 +1,180 @@
+//----------------------------------------------------------------------------------------------------------------------
+//
+//  Copyright ©2026 Peter Baumgartner. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//----------------------------------------------------------------------------------------------------------------------
+
+
+import Foundation
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+/// An IdentifierHandle is a compact stand-in for a (usually very long) Object or Container identifier string.
+///
+/// Comparing two handles is a single integer comparison and hashing uses a hash value that was computed once
+/// when the identifier was interned. The hash is stable across application launches (FNV-1a), so it can also
+/// be used to distribute identifiers into persistent shards.
+
+public struct IdentifierHandle : Hashable, CustomStringConvertible
+{
+	/// The index of the identifier in the shared IdentifierTable
+	
+	public let index:UInt32
+	
+	/// The precomputed stable hash of the identifier string
+	
+	public let stableHash:UInt64
+	
+	/// Returns the identifier string for this handle
+	
+	public var identifier:String
+	{
+		IdentifierTable.shared.identifier(for:self)
+	}
+	
+	public static func ==(lhs:IdentifierHandle, rhs:IdentifierHandle) -> Bool
+	{
+		lhs.index == rhs.index
+	}
+	
+	public func hash(into hasher:inout Hasher)
+	{
+		hasher.combine(stableHash)
+	}
+	
+	public var description:String
+	{
+		"#\(index) \(identifier)"
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+/// The IdentifierTable interns identifier strings, i.e. it assigns each distinct identifier a unique IdentifierHandle.
+///
+/// There is only a single table per process. Since a handle is just an index into this table, handles from different
+/// tables could not be told apart, so no other instances can be created.
+///
+/// Entries are never removed, so a handle stays valid for the lifetime of the process. Handles are stored in many
+/// places (Objects, Records, the statistics Journal, the ObjectRegistry) without reference counting, so reclaiming
+/// entries would risk resolving a stale handle to a different identifier. The memory cost is the identifier string
+/// plus about 50 bytes per distinct identifier. It grows with the number of Objects that were browsed in a session,
+/// and with the shards of the statistics Journal that were loaded, since loading a shard interns all of its
+/// identifiers. For typical libraries this amounts to a few MB for 100,000 identifiers.
+
+public final class IdentifierTable
+{
+	/// The process-wide shared instance
+	
+	public static let shared = IdentifierTable()
+	
+	/// Use the shared instance instead
+	
+	private init()
+	{
+	
+	}
+	
+	/// Maps identifiers to their handles
+	
+	private var handles:[String:IdentifierHandle] = [:]
+	
+	/// Maps handle indexes back to identifiers
+	
+	private var identifiers:[String] = []
+	
+	/// This lock is used to ensure thread-safe access to the table
+	
+	private let lock = NSLock()
+	
+	
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	/// Returns the handle for the specified identifier, creating a new one if the identifier wasn't seen before
+	
+	public func handle(for identifier:String) -> IdentifierHandle
+	{
+		lock.lock()
+		defer { lock.unlock() }
+		
+		if let handle = handles[identifier]
+		{
+			return handle
+		}
+		
+		let handle = IdentifierHandle(
+			index: UInt32(identifiers.count),
+			stableHash: Self.stableHash(for:identifier))
+			
+		self.handles[identifier] = handle
+		self.identifiers.append(identifier)
+		return handle
+	}
+	
+	/// Returns the handle for the specified identifier if it was already interned
+	
+	public func existingHandle(for identifier:String) -> IdentifierHandle?
+	{
+		lock.lock()
+		defer { lock.unlock() }
+		return handles[identifier]
+	}
+	
+	/// Returns the identifier string for the specified handle
+	
+	public func identifier(for handle:IdentifierHandle) -> String
+	{
+		lock.lock()
+		defer { lock.unlock() }
+		return identifiers[Int(handle.index)]
+	}
+	
+	/// Returns the number of interned identifiers
+	
+	public var count:Int
+	{
+		lock.lock()
+		defer { lock.unlock() }
+		return identifiers.count
+	}
+	
+	/// Computes the FNV-1a hash of the UTF8 bytes. Unlike String.hashValue this is stable across launches.
+	
+	public static func stableHash(for identifier:String) -> UInt64
+	{
+		var hash:UInt64 = 0xcbf29ce484222325
+
+		for byte in identifier.utf8
+		{
+			hash = (hash ^ UInt64(byte)) &* 0x100000001b3
+		}
+
+		return hash
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,647 @@
+//----------------------------------------------------------------------------------------------------------------------
+//
+//  Copyright ©2026 Peter Baumgartner. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//----------------------------------------------------------------------------------------------------------------------
+
+
+import Foundation
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+/// Metrics is a lightweight in-process registry of counters, gauges and latency histograms. Unlike signposts, which
+/// are only visible in Instruments, the recorded values can be read at any time by taking a Snapshot, e.g. to check
+/// the p99 thumbnail latency of a source in a test or to display diagnostics in the host application.
+///
+/// Metrics are identified by name and an optional source label, which is usually derived from the identifier of
+/// a Container or Object (see source(for:)). Looking up a metric takes the registry lock, but recording a value
+/// does not. Counters and histograms are striped by thread, so concurrent recording from different threads does
+/// not contend on shared state. The stripes are only merged when a Snapshot is taken.
+
+public final class Metrics
+{
+	/// The shared registry that is used by the BXMediaBrowser framework
+
+	public static let shared = Metrics()
+
+	/// Set to false to disable recording. Values that were already recorded are kept.
+
+	public static var isEnabled = true
+
+	/// The name of a metric
+
+	public typealias Name = String
+
+	/// Identifies a metric in the registry
+
+	public struct Key : Hashable, Codable, CustomStringConvertible
+	{
+		public let name:Name
+		public let source:String?
+
+		public init(_ name:Name, source:String? = nil)
+		{
+			self.name = name
+			self.source = source
+		}
+
+		public var description:String
+		{
+			guard let source = source else { return name }
+			return "\(name)[\(source)]"
+		}
+	}
+
+	private var counters:[Key:Counter] = [:]
+	private var gauges:[Key:Gauge] = [:]
+	private var histograms:[Key:Histogram] = [:]
+	private var loaderInstruments:[String:LoaderInstruments] = [:]
+	private let lock = NSLock()
+
+	/// Creates a new registry. Most clients will use the shared registry instead.
+
+	public init()
+	{
+
+	}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	// MARK: - Registry
+
+	/// Returns the Counter with the specified name and source. The Counter is created when first requested.
+
+	public func counter(_ name:Name, source:String? = nil) -> Counter
+	{
+		lock.lock()
+		defer { lock.unlock() }
+
+		let key = Key(name, source:source)
+		if let counter = counters[key] { return counter }
+		let counter = Counter()
+		counters[key] = counter
+		return counter
+	}
+
+	/// Returns the Gauge with the specified name and source. The Gauge is created when first requested.
+
+	public func gauge(_ name:Name, source:String? = nil) -> Gauge
+	{
+		lock.lock()
+		defer { lock.unlock() }
+
+		let key = Key(name, source:source)
+		if let gauge = gauges[key] { return gauge }
+		let gauge = Gauge()
+		gauges[key] = gauge
+		return gauge
+	}
+
+	/// Returns the Histogram with the specified name and source. The Histogram is created when first requested.
+
+	public func histogram(_ name:Name, source:String? = nil) -> Histogram
+	{
+		lock.lock()
+		defer { lock.unlock() }
+
+		let key = Key(name, source:source)
+		if let histogram = histograms[key] { return histogram }
+		let histogram = Histogram()
+		histograms[key] = histogram
+		return histogram
+	}
+
+	/// Returns the instruments of Object.Loader for the specified source. They are created once per source, so
+	/// that Loaders can record events through the cached instruments without looking them up for every event.
+
+	public func loaderInstruments(for source:String) -> LoaderInstruments
+	{
+		lock.lock()
+		let instruments = self.loaderInstruments[source]
+		lock.unlock()
+
+		if let instruments = instruments { return instruments }
+
+		let newInstruments = LoaderInstruments(metrics:self, source:source)
+
+		lock.lock()
+		defer { lock.unlock() }
+		if let instruments = self.loaderInstruments[source] { return instruments }
+		self.loaderInstruments[source] = newInstruments
+		return newInstruments
+	}
+
+	/// Resets all metrics to zero
+
+	public func reset()
+	{
+		lock.lock()
+		let instruments:[Resettable] = Array(counters.values) + Array(gauges.values) + Array(histograms.values)
+		lock.unlock()
+
+		instruments.forEach { $0.reset() }
+	}
+
+
+	/// Returns the source label for the identifier of a Container or Object, e.g. "FolderSource" for
+	/// "FolderSource:file:///Users/peter/Pictures/"
+
+	public static func source(for identifier:String) -> String
+	{
+		guard let i = identifier.firstIndex(of:":") else { return identifier }
+		return String(identifier[..<i])
+	}
+
+	/// The current time in nanoseconds, for measuring latencies with Histogram.record(since:)
+
+	public static var now:UInt64
+	{
+		DispatchTime.now().uptimeNanoseconds
+	}
+
+
+	/// Measures the duration of the body closure and records it in the specified Histogram. If the body throws,
+	/// the failures Counter is incremented instead.
+
+	public func time<T>(_ name:Name, failures:Name? = nil, source:String? = nil, _ body:() async throws -> T) async rethrows -> T
+	{
+		let histogram = self.histogram(name, source:source)
+		let failures = failures.map { self.counter($0, source:source) }
+		return try await histogram.time(failures:failures, body)
+	}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	// MARK: - Snapshots
+
+	/// A Snapshot contains the values of all metrics at a specific point in time
+
+	public struct Snapshot : Codable
+	{
+		public var date = Date()
+		public var counters:[Key:Int64] = [:]
+		public var gauges:[Key:Double] = [:]
+		public var histograms:[Key:Histogram.Snapshot] = [:]
+
+		/// Returns the value of a Counter, or 0 if nothing was recorded yet
+
+		public func counter(_ name:Name, source:String? = nil) -> Int64
+		{
+			counters[Key(name, source:source)] ?? 0
+		}
+
+		/// Returns the value of a Gauge, or 0 if nothing was recorded yet
+
+		public func gauge(_ name:Name, source:String? = nil) -> Double
+		{
+			gauges[Key(name, source:source)] ?? 0
+		}
+
+		/// Returns the Snapshot of a Histogram, or nil if nothing was recorded yet
+
+		public func histogram(_ name:Name, source:String? = nil) -> Histogram.Snapshot?
+		{
+			histograms[Key(name, source:source)]
+		}
+
+		/// Returns the sources for which the specified metric has been recorded
+
+		public func sources(for name:Name) -> [String]
+		{
+			let keys = Array(counters.keys) + Array(gauges.keys) + Array(histograms.keys)
+			return Set(keys.filter { $0.name == name }.compactMap { $0.source }).sorted()
+		}
+	}
+
+
+	/// Returns a Snapshot of all metrics
+
+	public func snapshot() -> Snapshot
+	{
+		lock.lock()
+		let counters = self.counters
+		let gauges = self.gauges
+		let histograms = self.histograms
+		lock.unlock()
+
+		var snapshot = Snapshot()
+		snapshot.counters = counters.mapValues { $0.value }
+		snapshot.gauges = gauges.mapValues { $0.value }
+		snapshot.histograms = histograms.mapValues { $0.snapshot() }
+		return snapshot
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+// MARK: - Instruments
+
+private protocol Resettable
+{
+	func reset()
+}
+
+
+extension Metrics
+{
+	/// The number of stripes per Counter or Histogram. Must be a power of two.
+
+	static let stripeCount = 8
+
+	/// Returns the stripe for the current thread. Different threads usually map to different stripes, so that
+	/// their stripe locks are never contended.
+
+	static var stripeIndex:Int
+	{
+		#if canImport(Darwin)
+		let thread = UInt(bitPattern:pthread_self())
+		#else
+		let thread = UInt(pthread_self())
+		#endif
+
+		return Int(truncatingIfNeeded:(thread >> 12) ^ (thread >> 4)) & (stripeCount-1)
+	}
+
+
+	/// A Counter is a monotonically increasing value, e.g. the number of failed loads
+
+	public final class Counter : Resettable
+	{
+		private final class Stripe
+		{
+			let lock = NSLock()
+			var value:Int64 = 0
+		}
+
+		private let stripes = (0 ..< Metrics.stripeCount).map { _ in Stripe() }
+
+		/// Adds the specified amount to the Counter
+
+		public func increment(by amount:Int64 = 1)
+		{
+			guard Metrics.isEnabled else { return }
+			let stripe = stripes[Metrics.stripeIndex]
+			stripe.lock.lock()
+			stripe.value += amount
+			stripe.lock.unlock()
+		}
+
+		/// The current value
+
+		public var value:Int64
+		{
+			stripes.reduce(0)
+			{
+				sum,stripe in
+				stripe.lock.lock()
+				defer { stripe.lock.unlock() }
+				return sum + stripe.value
+			}
+		}
+
+		func reset()
+		{
+			for stripe in stripes
+			{
+				stripe.lock.lock()
+				stripe.value = 0
+				stripe.lock.unlock()
+			}
+		}
+	}
+
+
+	/// A Gauge is a value that can go up and down, e.g. the number of currently running loads. Gauges change far
+	/// less often than Counters, so they are not striped.
+
+	public final class Gauge : Resettable
+	{
+		private var _value:Double = 0
+		private let lock = NSLock()
+
+		/// Sets the Gauge to the specified value
+
+		public func set(_ value:Double)
+		{
+			guard Metrics.isEnabled else { return }
+			lock.lock()
+			_value = value
+			lock.unlock()
+		}
+
+		/// Adds the specified amount to the Gauge
+
+		public func increment(by amount:Double = 1)
+		{
+			guard Metrics.isEnabled else { return }
+			lock.lock()
+			_value += amount
+			lock.unlock()
+		}
+
+		/// Subtracts the specified amount from the Gauge
+
+		public func decrement(by amount:Double = 1)
+		{
+			self.increment(by:-amount)
+		}
+
+		/// The current value
+
+		public var value:Double
+		{
+			lock.lock()
+			defer { lock.unlock() }
+			return _value
+		}
+
+		func reset()
+		{
+			lock.lock()
+			_value = 0
+			lock.unlock()
+		}
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+extension Metrics
+{
+	/// A Histogram records the distribution of latencies. Values are sorted into logarithmic buckets with four
+	/// buckets per power of two (between 1µs and about 4 minutes), so percentiles are accurate to about 19%.
+
+	public final class Histogram : Resettable
+	{
+		/// Bucket 0 contains values below 1µs, bucket i contains values up to 2^((i-1)/4) µs
+
+		static let bucketsPerOctave = 4
+		static let bucketCount = 28 * bucketsPerOctave + 2
+
+		private final class Stripe
+		{
+			let lock = NSLock()
+			var buckets = [Int64](repeating:0, count:Histogram.bucketCount)
+			var count:Int64 = 0
+			var sum:Double = 0
+			var max:Double = 0
+		}
+
+		private let stripes = (0 ..< Metrics.stripeCount).map { _ in Stripe() }
+
+		/// Records a duration in seconds
+
+		public func record(_ seconds:Double)
+		{
+			guard Metrics.isEnabled else { return }
+			let bucket = Self.bucket(for:seconds)
+			let stripe = stripes[Metrics.stripeIndex]
+
+			stripe.lock.lock()
+			stripe.buckets[bucket] += 1
+			stripe.count += 1
+			stripe.sum += seconds
+			if seconds > stripe.max { stripe.max = seconds }
+			stripe.lock.unlock()
+		}
+
+		/// Records the duration since the specified start time (as returned by Metrics.now)
+
+		public func record(since start:UInt64)
+		{
+			let end = Metrics.now
+			self.record(Double(end > start ? end-start : 0) / 1_000_000_000)
+		}
+
+		/// Measures the duration of the body closure and records it. If the body throws, the failures Counter is
+		/// incremented instead.
+
+		public func time<T>(failures:Counter? = nil, _ body:() async throws -> T) async rethrows -> T
+		{
+			let start = Metrics.now
+
+			do
+			{
+				let value = try await body()
+				self.record(since:start)
+				return value
+			}
+			catch
+			{
+				failures?.increment()
+				throw error
+			}
+		}
+
+		/// Returns the bucket index for the specified duration
+
+		static func bucket(for seconds:Double) -> Int
+		{
+			let microseconds = seconds * 1_000_000
+			guard microseconds >= 1 else { return 0 }
+			let bucket = Int((log2(microseconds) * Double(bucketsPerOctave)).rounded(.up)) + 1
+			return Swift.min(bucket, bucketCount-1)
+		}
+
+		/// Returns the upper bound of the specified bucket in seconds
+
+		static func upperBound(of bucket:Int) -> Double
+		{
+			guard bucket > 0 else { return 0.000_001 }
+			return pow(2.0, Double(bucket-1) / Double(bucketsPerOctave)) / 1_000_000
+		}
+
+		/// Merges all stripes into a Snapshot
+
+		public func snapshot() -> Snapshot
+		{
+			var snapshot = Snapshot()
+
+			for stripe in stripes
+			{
+				stripe.lock.lock()
+				for (i,n) in stripe.buckets.enumerated() where n > 0 { snapshot.buckets[i, default:0] += n }
+				snapshot.count += stripe.count
+				snapshot.sum += stripe.sum
+				snapshot.max = Swift.max(snapshot.max, stripe.max)
+				stripe.lock.unlock()
+			}
+
+			return snapshot
+		}
+
+		func reset()
+		{
+			for stripe in stripes
+			{
+				stripe.lock.lock()
+				stripe.buckets = [Int64](repeating:0, count:Self.bucketCount)
+				stripe.count = 0
+				stripe.sum = 0
+				stripe.max = 0
+				stripe.lock.unlock()
+			}
+		}
+
+
+		/// The merged values of a Histogram. All durations are in seconds.
+
+		public struct Snapshot : Codable
+		{
+			/// The number of values per bucket. Empty buckets are omitted.
+
+			public var buckets:[Int:Int64] = [:]
+			public var count:Int64 = 0
+			public var sum:Double = 0
+			public var max:Double = 0
+
+			public var mean:Double
+			{
+				count > 0 ? sum / Double(count) : 0
+			}
+
+			/// Returns the specified percentile (between 0 and 1), e.g. 0.99 for the p99 latency
+
+			public func percentile(_ p:Double) -> Double
+			{
+				guard count > 0 else { return 0 }
+				let rank = Swift.max(1, Int64((p * Double(count)).rounded(.up)))
+				var total:Int64 = 0
+
+				for bucket in buckets.keys.sorted()
+				{
+					total += buckets[bucket] ?? 0
+					if total >= rank { return Swift.min(Histogram.upperBound(of:bucket), max) }
+				}
+
+				return max
+			}
+
+			public var p50:Double { percentile(0.50) }
+			public var p90:Double { percentile(0.90) }
+			public var p99:Double { percentile(0.99) }
+		}
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+// MARK: - Instruments
+
+extension Metrics
+{
+	/// The instruments that Object.Loader records for a single source
+
+	public final class LoaderInstruments
+	{
+		public let thumbnailCacheHits:Counter
+		public let thumbnailLatency:Histogram
+		public let thumbnailFailures:Counter
+		public let metadataLatency:Histogram
+		public let metadataFailures:Counter
+		public let downloadLatency:Histogram
+		public let downloadFailures:Counter
+
+		init(metrics:Metrics, source:String)
+		{
+			self.thumbnailCacheHits = metrics.counter(.thumbnailCacheHits, source:source)
+			self.thumbnailLatency = metrics.histogram(.thumbnailLatency, source:source)
+			self.thumbnailFailures = metrics.counter(.thumbnailFailures, source:source)
+			self.metadataLatency = metrics.histogram(.metadataLatency, source:source)
+			self.metadataFailures = metrics.counter(.metadataFailures, source:source)
+			self.downloadLatency = metrics.histogram(.downloadLatency, source:source)
+			self.downloadFailures = metrics.counter(.downloadFailures, source:source)
+		}
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+// MARK: - Names
+
+/// The metrics that are recorded by the BXMediaBrowser framework. Most of them are recorded per source.
+
+extension Metrics.Name
+{
+	// Container.Loader
+
+	public static let containerLoadLatency = "container.load.latency"
+	public static let containerLoadFailures = "container.load.failures"
+	public static let containerLoadsActive = "container.load.active"
+
+	// Object.Loader
+
+	public static let thumbnailLatency = "object.thumbnail.latency"
+	public static let thumbnailFailures = "object.thumbnail.failures"
+	public static let thumbnailCacheHits = "object.thumbnail.hits"
+	public static let metadataLatency = "object.metadata.latency"
+	public static let metadataFailures = "object.metadata.failures"
+	public static let downloadLatency = "object.download.latency"
+	public static let downloadFailures = "object.download.failures"
+
+	// ObjectRegistry
+
+	public static let objectRegistryHits = "object.registry.hits"
+	public static let objectRegistryMisses = "object.registry.misses"
+
+	// FolderObserver
+
+	public static let folderObserversActive = "folder.observer.active"
+	public static let folderObserverEvents = "folder.observer.events"
+	public static let folderObserverChanges = "folder.observer.changes"
+	public static let folderObserverDiscarded = "folder.observer.discarded"
+	public static let folderSnapshotLatency = "folder.observer.snapshot.latency"
+
+	// URLSession (per host)
+
+	public static let networkLatency = "network.latency"
+	public static let networkFailures = "network.failures"
+	public static let networkBytes = "network.bytes"
+
+	// StatisticsController
+
+	public static let statisticsChangeSets = "statistics.changesets"
+	public static let statisticsChangedObjects = "statistics.changed.objects"
+	public static let statisticsJournalRecords = "statistics.journal.records"
+	public static let statisticsJournalFlushLatency = "statistics.journal.flush.latency"
+
+	// Library.Preloader
+
+	public static let containerPreloads = "container.preload.count"
+	public static let containerPreloadHits = "container.preload.hits"
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
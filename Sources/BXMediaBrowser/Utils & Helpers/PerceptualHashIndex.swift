@@ -0,0 +1,597 @@
+//----------------------------------------------------------------------------------------------------------------------
+//
+//  Copyright ©2026 Peter Baumgartner. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//----------------------------------------------------------------------------------------------------------------------
+
+
+import Foundation
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+/// PerceptualHashIndex finds near duplicate images by the Hamming distance of their 64 bit perceptual hashes.
+///
+/// It uses multi-index hashing: each hash is split into 4 chunks of 16 bits and every chunk is indexed in its own
+/// table. If two hashes differ in at most r bits, then by the pigeonhole principle at least one of their chunks
+/// differs in at most r/4 bits. A query therefore only has to look at the buckets of the chunk values within
+/// that small radius, instead of comparing against every hash. The tables are stored as flat arrays (offsets
+/// and items sorted by chunk value). Hashes that are inserted after the tables were built are kept in a short
+/// pending list that queries scan in addition to the tables, so the tables are only rebuilt in O(n) once this
+/// list has grown to a fraction of the index.
+
+public final class PerceptualHashIndex
+{
+	/// A Match is an indexed identifier with its distance to the query hash
+
+	public struct Match : Equatable
+	{
+		public let identifier:String
+		public let distance:Int
+	}
+
+	/// The largest supported query distance. Larger distances would need to enumerate too many chunk variants
+	/// and are not meaningful for 64 bit hashes anyway.
+
+	public static let maxDistance = 11
+
+	/// The identifiers in insertion order
+
+	private var identifiers:[String] = []
+
+	/// The hashes, at the same positions as identifiers
+
+	private var hashes:[UInt64] = []
+
+	/// Maps identifiers to their positions, so that hashes can be replaced
+
+	private var positions:[String:Int32] = [:]
+
+	/// The lookup tables for the 4 chunks, or nil if they need to be rebuilt
+
+	private var tables:[Table]? = nil
+
+	/// The positions of hashes that were added or changed after the tables were built. The tables may still
+	/// contain outdated entries for changed positions, but these are harmless, since candidates are always
+	/// checked against their current hash.
+
+	private var pending:[Int32] = []
+
+	/// The tables are rebuilt once the number of pending positions exceeds this fraction of all hashes
+
+	private static let pendingFraction = 8
+
+	/// The tables are never rebuilt for fewer pending positions than this
+
+	private static let minPendingCount = 256
+
+	/// Buckets with more hashes than this are not compared pairwise by duplicateGroups(), since the cost grows
+	/// quadratically with the bucket size (e.g. thousands of blank images that all have the same hash)
+
+	static var maxPairwiseBucketSize = 256
+
+	/// This lock is used to ensure thread-safe access to all properties
+
+	private let lock = NSLock()
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	// MARK: - Building
+
+	/// Creates an empty index
+
+	public init()
+	{
+
+	}
+
+	/// Creates an index for the specified identifiers and hashes
+
+	public convenience init<S:Sequence>(_ entries:S) where S.Element == (String,UInt64)
+	{
+		self.init()
+
+		for (identifier,hash) in entries
+		{
+			self.positions[identifier] = Int32(identifiers.count)
+			self.identifiers.append(identifier)
+			self.hashes.append(hash)
+		}
+	}
+
+	/// Adds a hash to the index or replaces the hash of an identifier that is already indexed
+
+	public func insert(_ hash:UInt64, for identifier:String)
+	{
+		lock.lock()
+		defer { lock.unlock() }
+
+		let i:Int32
+
+		if let position = positions[identifier]
+		{
+			guard hashes[Int(position)] != hash else { return }
+			i = position
+			hashes[Int(i)] = hash
+		}
+		else
+		{
+			i = Int32(identifiers.count)
+			positions[identifier] = i
+			identifiers.append(identifier)
+			hashes.append(hash)
+		}
+
+		// If the tables exist, remember the position until there are too many changes to scan them linearly
+
+		guard tables != nil else { return }
+		pending.append(i)
+
+		if pending.count > max(Self.minPendingCount, hashes.count / Self.pendingFraction)
+		{
+			tables = nil
+			pending = []
+		}
+	}
+
+	/// The number of positions that queries need to scan in addition to the tables
+
+	var pendingCount:Int
+	{
+		lock.lock()
+		defer { lock.unlock() }
+		return pending.count
+	}
+
+	/// The number of indexed hashes
+
+	public var count:Int
+	{
+		lock.lock()
+		defer { lock.unlock() }
+		return hashes.count
+	}
+
+	/// Returns the indexed hash for the specified identifier
+
+	public func hash(for identifier:String) -> UInt64?
+	{
+		lock.lock()
+		defer { lock.unlock() }
+		guard let i = positions[identifier] else { return nil }
+		return hashes[Int(i)]
+	}
+
+	/// Returns the number of differing bits
+
+	@inline(__always) public static func distance(_ hash1:UInt64, _ hash2:UInt64) -> Int
+	{
+		(hash1 ^ hash2).nonzeroBitCount
+	}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	// MARK: - Queries
+
+	/// Returns all indexed identifiers whose hashes are within maxDistance of the specified hash, ordered by distance
+
+	public func similar(to hash:UInt64, maxDistance:Int = 8) -> [Match]
+	{
+		lock.lock()
+		defer { lock.unlock() }
+
+		let maxDistance = min(maxDistance, Self.maxDistance)
+		let tables = self.loadedTables()
+		var visited = VisitedSet(count:hashes.count)
+		var matches:[Match] = []
+
+		self.forEachCandidate(of:hash, maxDistance:maxDistance, in:tables, visited:&visited)
+		{
+			i in
+
+			let distance = Self.distance(hash,hashes[i])
+
+			if distance <= maxDistance
+			{
+				matches.append(Match(identifier:identifiers[i], distance:distance))
+			}
+		}
+
+		return matches.sorted { $0.distance < $1.distance }
+	}
+
+	/// Returns all other indexed identifiers whose hashes are within maxDistance of the specified identifier
+
+	public func similar(to identifier:String, maxDistance:Int = 8) -> [Match]
+	{
+		guard let hash = self.hash(for:identifier) else { return [] }
+		return self.similar(to:hash, maxDistance:maxDistance).filter { $0.identifier != identifier }
+	}
+
+	/// Collapses near duplicates into groups. Hashes within maxDistance of each other end up in the same group
+	/// (transitively). Only groups with at least 2 members are returned, in the order of their first member.
+
+	public func duplicateGroups(maxDistance:Int = 3) -> [[String]]
+	{
+		lock.lock()
+		defer { lock.unlock() }
+
+		let maxDistance = min(maxDistance, Self.maxDistance)
+		let tables = self.loadedTables()
+		var groups = UnionFind(count:hashes.count)
+
+		// For small distances two near duplicates must share at least one identical chunk, so it is sufficient
+		// to compare the members of each bucket with each other.
+
+		if maxDistance < Table.count
+		{
+			for table in tables
+			{
+				for bucket in 0 ..< Table.bucketCount
+				{
+					let start = Int(table.offsets[bucket])
+					let end = Int(table.offsets[bucket+1])
+					guard end - start > 1 else { continue }
+
+					if end - start <= Self.maxPairwiseBucketSize
+					{
+						self.unionPairs(table.items[start ..< end], maxDistance:maxDistance, into:&groups)
+					}
+					else
+					{
+						self.unionCrowdedBucket(table.items[start ..< end], maxDistance:maxDistance, into:&groups)
+					}
+				}
+			}
+
+			// Hashes that were added after the tables were built are not in the buckets yet, so query them
+
+			var visited = VisitedSet(count:hashes.count)
+
+			for p in pending
+			{
+				let i = Int(p)
+				visited.removeAll()
+
+				self.forEachCandidate(of:hashes[i], maxDistance:maxDistance, in:tables, visited:&visited)
+				{
+					j in
+
+					if j != i && Self.distance(hashes[i],hashes[j]) <= maxDistance
+					{
+						groups.union(i,j)
+					}
+				}
+			}
+		}
+
+		// For larger distances query each hash
+
+		else
+		{
+			var visited = VisitedSet(count:hashes.count)
+
+			for i in hashes.indices
+			{
+				visited.removeAll()
+
+				self.forEachCandidate(of:hashes[i], maxDistance:maxDistance, in:tables, visited:&visited)
+				{
+					j in
+
+					if j > i && Self.distance(hashes[i],hashes[j]) <= maxDistance
+					{
+						groups.union(i,j)
+					}
+				}
+			}
+		}
+
+		// Collect the members of each group
+
+		var members:[Int:[String]] = [:]
+		var order:[Int] = []
+
+		for i in hashes.indices
+		{
+			let root = groups.find(i)
+			if members[root] == nil { order.append(root) }
+			members[root, default:[]].append(identifiers[i])
+		}
+
+		return order.compactMap
+		{
+			let group = members[$0] ?? []
+			return group.count > 1 ? group : nil
+		}
+	}
+
+
+	/// Compares all items of a bucket with each other
+
+	private func unionPairs(_ items:ArraySlice<Int32>, maxDistance:Int, into groups:inout UnionFind)
+	{
+		for a in items.indices.dropLast()
+		{
+			let i = Int(items[a])
+
+			for b in a+1 ..< items.endIndex
+			{
+				let j = Int(items[b])
+
+				if Self.distance(hashes[i],hashes[j]) <= maxDistance
+				{
+					groups.union(i,j)
+				}
+			}
+		}
+	}
+
+	/// Crowded buckets usually consist of many identical hashes, which are grouped in linear time. The remaining
+	/// distinct hashes are sorted and each one is only compared with its next maxPairwiseBucketSize neighbors,
+	/// which share the most leading bits. Near duplicates in very crowded buckets may therefore be missed if they
+	/// don't share any other chunk.
+
+	private func unionCrowdedBucket(_ items:ArraySlice<Int32>, maxDistance:Int, into groups:inout UnionFind)
+	{
+		var representatives:[UInt64:Int] = [:]
+
+		for item in items
+		{
+			let i = Int(item)
+
+			if let r = representatives[hashes[i]]
+			{
+				groups.union(r,i)
+			}
+			else
+			{
+				representatives[hashes[i]] = i
+			}
+		}
+
+		let distinct = representatives.sorted { $0.key < $1.key }.map { $0.value }
+		let window = Self.maxPairwiseBucketSize
+
+		for a in distinct.indices
+		{
+			let i = distinct[a]
+
+			for b in a+1 ..< min(a+1+window, distinct.count)
+			{
+				let j = distinct[b]
+
+				if Self.distance(hashes[i],hashes[j]) <= maxDistance
+				{
+					groups.union(i,j)
+				}
+			}
+		}
+	}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	// MARK: - Multi-Index Hashing
+
+	/// A Table indexes one 16 bit chunk of all hashes. The items of bucket b are items[offsets[b] ..< offsets[b+1]].
+
+	private struct Table
+	{
+		static let count = 4
+		static let bucketCount = 1 << 16
+
+		var offsets:[Int32]
+		var items:[Int32]
+
+		/// Builds the table for the specified chunk with a counting sort
+
+		init(chunk:Int, hashes:[UInt64])
+		{
+			var offsets = [Int32](repeating:0, count:Self.bucketCount+1)
+
+			for hash in hashes
+			{
+				offsets[Self.bucket(of:hash, chunk:chunk) + 1] += 1
+			}
+
+			for b in 0 ..< Self.bucketCount
+			{
+				offsets[b+1] += offsets[b]
+			}
+
+			var next = offsets
+			var items = [Int32](repeating:0, count:hashes.count)
+
+			for (i,hash) in hashes.enumerated()
+			{
+				let b = Self.bucket(of:hash, chunk:chunk)
+				items[Int(next[b])] = Int32(i)
+				next[b] += 1
+			}
+
+			self.offsets = offsets
+			self.items = items
+		}
+
+		@inline(__always) static func bucket(of hash:UInt64, chunk:Int) -> Int
+		{
+			Int((hash >> UInt64(chunk * 16)) & 0xFFFF)
+		}
+	}
+
+	/// Returns the tables, rebuilding them if hashes were added. Must be called while holding the lock.
+
+	private func loadedTables() -> [Table]
+	{
+		if let tables = self.tables
+		{
+			return tables
+		}
+
+		let hashes = self.hashes
+		let tables = (0 ..< Table.count).map { Table(chunk:$0, hashes:hashes) }
+		self.tables = tables
+		self.pending = []
+		return tables
+	}
+
+	/// Calls body once for every hash that shares a chunk within radius maxDistance/4 with the specified hash,
+	/// and for every pending hash. The result is a superset of all hashes within maxDistance.
+
+	private func forEachCandidate(of hash:UInt64, maxDistance:Int, in tables:[Table], visited:inout VisitedSet, _ body:(Int)->Void)
+	{
+		let radius = maxDistance / Table.count
+
+		for (chunk,table) in tables.enumerated()
+		{
+			let value = Table.bucket(of:hash, chunk:chunk)
+
+			Self.forEachVariant(of:value, radius:radius)
+			{
+				bucket in
+
+				for a in Int(table.offsets[bucket]) ..< Int(table.offsets[bucket+1])
+				{
+					let i = Int(table.items[a])
+					guard visited.insert(i) else { continue }
+					body(i)
+				}
+			}
+		}
+
+		for p in pending
+		{
+			let i = Int(p)
+			guard visited.insert(i) else { continue }
+			body(i)
+		}
+	}
+
+	/// Enumerates all 16 bit values that differ from value in at most radius bits (radius 0-2)
+
+	private static func forEachVariant(of value:Int, radius:Int, _ body:(Int)->Void)
+	{
+		body(value)
+		guard radius > 0 else { return }
+
+		for bit1 in 0 ..< 16
+		{
+			let value1 = value ^ (1 << bit1)
+			body(value1)
+			guard radius > 1 else { continue }
+
+			for bit2 in bit1+1 ..< 16
+			{
+				body(value1 ^ (1 << bit2))
+			}
+		}
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+// MARK: - Helpers
+
+extension PerceptualHashIndex
+{
+	/// A set of item positions that can be cleared in O(1) by advancing a generation counter, so that it can be
+	/// reused for many queries in a row
+
+	fileprivate struct VisitedSet
+	{
+		private var stamps:[UInt32]
+		private var generation:UInt32 = 1
+
+		init(count:Int)
+		{
+			self.stamps = [UInt32](repeating:0, count:count)
+		}
+
+		/// Inserts i and returns true if it wasn't contained yet
+
+		@inline(__always) mutating func insert(_ i:Int) -> Bool
+		{
+			guard stamps[i] != generation else { return false }
+			stamps[i] = generation
+			return true
+		}
+
+		mutating func removeAll()
+		{
+			generation &+= 1
+
+			if generation == 0
+			{
+				for i in stamps.indices { stamps[i] = 0 }
+				generation = 1
+			}
+		}
+	}
+
+	/// A disjoint set forest with path halving and union by size
+
+	fileprivate struct UnionFind
+	{
+		private var parents:[Int32]
+		private var sizes:[Int32]
+
+		init(count:Int)
+		{
+			self.parents = (0 ..< count).map { Int32($0) }
+			self.sizes = [Int32](repeating:1, count:count)
+		}
+
+		mutating func find(_ i:Int) -> Int
+		{
+			var i = i
+
+			while Int(parents[i]) != i
+			{
+				parents[i] = parents[Int(parents[i])]
+				i = Int(parents[i])
+			}
+
+			return i
+		}
+
+		mutating func union(_ i:Int, _ j:Int)
+		{
+			var a = find(i)
+			var b = find(j)
+			guard a != b else { return }
+			if sizes[a] < sizes[b] { swap(&a,&b) }
+			parents[b] = Int32(a)
+			sizes[a] += sizes[b]
+		}
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,403 @@
+//----------------------------------------------------------------------------------------------------------------------
+//
+//  Copyright ©2026 Peter Baumgartner. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//----------------------------------------------------------------------------------------------------------------------
+
+
+import BXSwiftUtils
+import Foundation
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+extension PixelAnalysis
+{
+	/// The Store keeps the PixelAnalysis of each thumbnail, keyed by Object identifier. The analysis is created
+	/// once when a thumbnail is loaded and persisted, so that the color filter also works for Objects whose
+	/// thumbnails have not been loaded in the current session.
+	///
+	/// The identifiers are distributed over several shards, which are stored in separate files. A shard is only
+	/// read when one of its identifiers is accessed, and only changed shards are written to disk. Each shard keeps
+	/// a limited number of analyses - when exceeded, the analyses that haven't been used for the longest time
+	/// are evicted.
+
+	public final class Store
+	{
+		/// The shared instance that is used by Object.Loader and the color filter
+
+		public static let shared = Store(directoryURL:Store.defaultDirectoryURL)
+
+		/// The directory that contains the files of all shards
+
+		public let directoryURL:URL
+
+		/// The number of shards. Changing this value invalidates existing files, so it is stored in the directory name.
+
+		public let shardCount:Int
+
+		/// The maximum number of analyses per shard. When exceeded, the least recently used analyses are evicted.
+
+		public var maxCountPerShard = 4096
+
+		/// Changes are written to disk after this many seconds
+
+		public var saveDelay:Double = 5.0
+
+		/// The in-memory state of all shards
+
+		private var shards:[Shard]
+
+		/// The index of all perceptual hashes. It is created when first needed and then kept up to date.
+
+		private var _perceptualHashIndex:PerceptualHashIndex? = nil
+
+		/// True if a save has already been scheduled
+
+		private var isSavePending = false
+
+		/// This lock is used to ensure thread-safe access to the shards
+
+		private let lock = NSLock()
+
+		/// All file access is serialized on this queue
+
+		private let queue = DispatchQueue(label:"com.boinx.BXMediaBrowser.PixelAnalysis.Store")
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+		/// A stored PixelAnalysis and the day it was last used, which decides the order of eviction
+
+		struct Entry : Codable
+		{
+			var analysis:PixelAnalysis
+			var lastUse:Int32
+		}
+
+		/// The in-memory state of a shard. The entries are nil until the shard has been loaded from disk.
+
+		final class Shard
+		{
+			var entries:[String:Entry]? = nil
+			var isDirty = false
+		}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+		// MARK: - Setup
+
+		/// Creates a Store that keeps its files in the specified directory
+
+		public init(directoryURL:URL, shardCount:Int = 16)
+		{
+			self.shardCount = max(1,shardCount)
+			self.directoryURL = directoryURL.appendingPathComponent("shards-\(self.shardCount)", isDirectory:true)
+			self.shards = (0 ..< self.shardCount).map { _ in Shard() }
+		}
+
+		/// The default location is inside the Application Support folder of the host application
+
+		public static var defaultDirectoryURL:URL
+		{
+			let appSupportURL = FileManager.default.urls(for:.applicationSupportDirectory, in:.userDomainMask).first ?? FileManager.default.temporaryDirectory
+			let bundleIdentifier = Bundle.main.bundleIdentifier ?? "BXMediaBrowser"
+
+			return appSupportURL
+				.appendingPathComponent(bundleIdentifier, isDirectory:true)
+				.appendingPathComponent("BXMediaBrowser.PixelAnalysis", isDirectory:true)
+		}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+		// MARK: - Accessing
+
+		/// Returns the PixelAnalysis for the specified Object identifier, or nil if its thumbnail was never analyzed
+
+		public func analysis(for identifier:String) -> PixelAnalysis?
+		{
+			let index = self.shardIndex(for:identifier)
+			let today = Self.today
+
+			lock.lock()
+			defer { lock.unlock() }
+
+			let shard = self.loadedShard(at:index)
+			guard let entry = shard.entries?[identifier] else { return nil }
+
+			// Mark the analysis as used. This only dirties the shard once per day and analysis, and the new date is
+			// written along with the next change.
+
+			if entry.lastUse != today
+			{
+				shard.entries?[identifier]?.lastUse = today
+				shard.isDirty = true
+			}
+
+			return entry.analysis
+		}
+
+		/// Stores the PixelAnalysis for the specified Object identifier and schedules a save
+
+		public func setAnalysis(_ analysis:PixelAnalysis, for identifier:String)
+		{
+			let index = self.shardIndex(for:identifier)
+			let today = Self.today
+
+			lock.lock()
+
+			// Mutate the shard dictionary in place, so that no copy-on-write is triggered
+
+			let shard = self.loadedShard(at:index)
+			let didChange = shard.entries?[identifier]?.analysis != analysis
+			shard.entries?[identifier] = Entry(analysis:analysis, lastUse:today)
+
+			if didChange
+			{
+				shard.isDirty = true
+				self.evictIfNeeded(shard)
+			}
+
+			let hashIndex = self._perceptualHashIndex
+			lock.unlock()
+
+			if let hashIndex = hashIndex, let hash = analysis.perceptualHash
+			{
+				hashIndex.insert(hash, for:identifier)
+			}
+
+			if didChange { self.setNeedsSave() }
+		}
+
+		/// Returns an index of the perceptual hashes of all analyzed thumbnails, which can be used to find similar
+		/// images or to collapse near duplicates. Please note that this loads all shards from disk.
+
+		public var perceptualHashIndex:PerceptualHashIndex
+		{
+			lock.lock()
+			defer { lock.unlock() }
+
+			if let index = self._perceptualHashIndex
+			{
+				return index
+			}
+
+			var hashes:[(String,UInt64)] = []
+
+			for i in 0 ..< shardCount
+			{
+				for (identifier,entry) in self.loadedShard(at:i).entries ?? [:]
+				{
+					if let hash = entry.analysis.perceptualHash { hashes.append((identifier,hash)) }
+				}
+			}
+
+			let index = PerceptualHashIndex(hashes)
+			self._perceptualHashIndex = index
+			return index
+		}
+
+		/// Returns the number of analyses. Please note that this loads all shards from disk.
+
+		public var count:Int
+		{
+			lock.lock()
+			defer { lock.unlock() }
+			return (0 ..< shardCount).reduce(0) { $0 + (self.loadedShard(at:$1).entries?.count ?? 0) }
+		}
+
+		/// Removes all stored analyses, e.g. when the user wants to reset the cache
+
+		public func removeAll()
+		{
+			lock.lock()
+
+			for shard in shards
+			{
+				shard.entries = [:]
+				shard.isDirty = true
+			}
+
+			self._perceptualHashIndex = nil
+			lock.unlock()
+
+			self.setNeedsSave()
+		}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+		// MARK: - Eviction
+
+		/// Removes the least recently used analyses once a shard has grown beyond its maximum size. A bit more than
+		/// necessary is removed, so that this doesn't happen again for every new analysis. Must be called while
+		/// holding the lock.
+
+		private func evictIfNeeded(_ shard:Shard)
+		{
+			guard let entries = shard.entries, entries.count > maxCountPerShard else { return }
+
+			let removeCount = entries.count - maxCountPerShard * 9 / 10
+			let evicted = entries.sorted { $0.value.lastUse < $1.value.lastUse }.prefix(removeCount)
+
+			for (identifier,_) in evicted
+			{
+				shard.entries?[identifier] = nil
+			}
+
+			// The PerceptualHashIndex doesn't support removal, so it is rebuilt the next time it is needed
+
+			self._perceptualHashIndex = nil
+		}
+
+		/// The current day, which is used to timestamp the usage of analyses
+
+		static var today:Int32
+		{
+			Int32(Date().timeIntervalSinceReferenceDate / 86400.0)
+		}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+		// MARK: - Loading
+
+		/// Returns the specified shard, reading it from disk if necessary. Must be called while holding the lock.
+
+		private func loadedShard(at index:Int) -> Shard
+		{
+			let shard = self.shards[index]
+			guard shard.entries == nil else { return shard }
+
+			var entries:[String:Entry] = [:]
+
+			if let data = try? Data(contentsOf:self.fileURL(forShard:index))
+			{
+				do
+				{
+					entries = try PropertyListDecoder().decode([String:Entry].self, from:data)
+				}
+				catch
+				{
+					BXMediaBrowser.logDataModel.error {"\(Self.self).\(#function) ERROR \(error)"}
+				}
+			}
+
+			shard.entries = entries
+			return shard
+		}
+
+		/// Distributes identifiers evenly across the shards. A stable hash is used, because String.hashValue is
+		/// not stable across launches.
+
+		func shardIndex(for identifier:String) -> Int
+		{
+			Int(IdentifierTable.stableHash(for:identifier) % UInt64(shardCount))
+		}
+
+		private func fileURL(forShard index:Int) -> URL
+		{
+			directoryURL.appendingPathComponent("\(index).plist")
+		}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+		// MARK: - Saving
+
+		/// Coalesces many changes (e.g. while scrolling through a large folder) into a single write a few seconds later
+
+		private func setNeedsSave()
+		{
+			lock.lock()
+			let isSavePending = self.isSavePending
+			self.isSavePending = true
+			lock.unlock()
+
+			guard !isSavePending else { return }
+
+			queue.asyncAfter(deadline:.now() + saveDelay)
+			{
+				[weak self] in self?._save()
+			}
+		}
+
+		/// Writes all pending changes to disk immediately. Call this function before the application terminates.
+
+		public func synchronize()
+		{
+			queue.sync { self._save() }
+		}
+
+		/// Writes the changed shards to disk with atomic replacement. This is called on the background queue.
+
+		private func _save()
+		{
+			var changes:[(Int,[String:Entry])] = []
+
+			// Grab the changed shards while holding the lock, but perform the actual file access without it
+
+			lock.lock()
+
+			self.isSavePending = false
+
+			for (index,shard) in shards.enumerated() where shard.isDirty
+			{
+				shard.isDirty = false
+				changes.append((index,shard.entries ?? [:]))
+			}
+
+			lock.unlock()
+
+			guard !changes.isEmpty else { return }
+
+			do
+			{
+				let encoder = PropertyListEncoder()
+				encoder.outputFormat = .binary
+
+				try FileManager.default.createDirectory(at:directoryURL, withIntermediateDirectories:true, attributes:nil)
+
+				for (index,entries) in changes
+				{
+					let data = try encoder.encode(entries)
+					try data.write(to:self.fileURL(forShard:index), options:.atomic)
+				}
+			}
+			catch
+			{
+				BXMediaBrowser.logDataModel.error {"\(Self.self).\(#function) ERROR \(error)"}
+			}
+		}
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
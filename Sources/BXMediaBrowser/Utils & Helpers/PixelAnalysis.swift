@@ -0,0 +1,509 @@
+//----------------------------------------------------------------------------------------------------------------------
+//
+//  Copyright ©2026 Peter Baumgartner. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//----------------------------------------------------------------------------------------------------------------------
+
+
+import CoreGraphics
+import Foundation
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+/// PixelAnalysis summarizes the pixels of a thumbnail image in a single vectorized pass.
+///
+/// The thumbnail is rendered into a small RGBA buffer, which is then processed 4 pixels (16 bytes) at a time with
+/// SIMD types. The same pass determines whether the image is all black or has a very low variance (typical for
+/// broken embedded previews), builds a coarse 64 bin color histogram, and accumulates the average color of each
+/// bin, from which the dominant colors are derived. The luminance plane of the pass is then used for a perceptual
+/// hash that allows finding near duplicates. The result is small enough to be persisted alongside the
+/// thumbnail, so that Objects can be filtered by color without decoding the images again.
+
+public struct PixelAnalysis : Equatable
+{
+	/// True if all pixels are (nearly) black
+
+	public var isAllBlack:Bool
+
+	/// True if the luminance barely varies across the image, e.g. for a single colored preview
+
+	public var isLowVariance:Bool
+
+	/// The average luminance in the range 0-255
+
+	public var meanLuminance:UInt8
+
+	/// The standard deviation of the luminance in the range 0-255
+
+	public var luminanceDeviation:UInt8
+
+	/// The color histogram has 64 bins. The bin index is made up of the upper 2 bits of the red, green and blue
+	/// channels (rrggbb). Each value is the share of pixels in that bin, scaled to 0-255.
+
+	public var histogram:[UInt8]
+
+	/// Up to 3 dominant colors, ordered by descending weight
+
+	public var dominantColors:[Swatch]
+
+	/// A 64 bit difference hash (dHash) of the luminance, which is used to find near duplicate images. Analyses
+	/// that were persisted before hashing was added do not have a value.
+
+	public var perceptualHash:UInt64?
+
+	/// A Swatch is the average color of the pixels in one histogram bin
+
+	public struct Swatch : Equatable, Codable
+	{
+		public var red:UInt8
+		public var green:UInt8
+		public var blue:UInt8
+
+		/// The share of pixels that contributed to this Swatch, scaled to 0-255
+
+		public var weight:UInt8
+
+		/// The named color of this Swatch
+
+		public var colorTag:ColorTag
+		{
+			ColorTag(red:red, green:green, blue:blue)
+		}
+	}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	// MARK: - Parameters
+
+	/// Images are scaled down to this size (longest edge) before analysis. This is a constant, because the 32 bit
+	/// luminance accumulators would overflow for sizes above 512.
+
+	public static let sampleSize = 64
+
+	/// Pixels whose channels do not exceed this value are considered black
+
+	public static var blackThreshold:UInt8 = 8
+
+	/// Images with a luminance deviation below this value are considered to have low variance
+
+	public static var lowVarianceThreshold:UInt8 = 2
+
+	/// Histogram bins with less than this share of pixels are not considered as dominant colors
+
+	public static var minimumDominantShare = 0.05
+
+	/// The number of histogram bins
+
+	public static let binCount = 64
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	// MARK: - Analyzing
+
+	/// Analyzes the specified image. Returns nil if the image could not be rendered.
+
+	public init?(_ image:CGImage)
+	{
+		let maxSize = max(image.width,image.height)
+		guard maxSize > 0 else { return nil }
+
+		let scale = min(1.0, Double(Self.sampleSize) / Double(maxSize))
+		let width = max(1, Int((Double(image.width) * scale).rounded()))
+		let height = max(1, Int((Double(image.height) * scale).rounded()))
+
+		// The buffer is padded to a multiple of 4 pixels and aligned, so that it can be read in 16 byte chunks.
+		// The padding pixels are black and will be subtracted again after the pass.
+
+		let count = width * height
+		let paddedCount = (count + 3) & ~3
+		let byteCount = paddedCount * 4
+
+		let buffer = UnsafeMutableRawPointer.allocate(byteCount:byteCount, alignment:16)
+		buffer.initializeMemory(as:UInt8.self, repeating:0, count:byteCount)
+		defer { buffer.deallocate() }
+
+		guard let colorSpace = CGColorSpace(name:CGColorSpace.sRGB) else { return nil }
+
+		guard let context = CGContext(
+			data: buffer,
+			width: width,
+			height: height,
+			bitsPerComponent: 8,
+			bytesPerRow: width * 4,
+			space: colorSpace,
+			bitmapInfo: CGImageAlphaInfo.noneSkipLast.rawValue)
+		else
+		{
+			return nil
+		}
+
+		context.interpolationQuality = .low
+		context.draw(image, in:CGRect(x:0, y:0, width:width, height:height))
+
+		self.init(pixels:UnsafeRawPointer(buffer), width:width, height:height)
+	}
+
+
+	/// Analyzes a buffer of RGBX pixels without row padding. The buffer must be 16 byte aligned and be zero-padded
+	/// to a multiple of 4 pixels.
+
+	init(pixels:UnsafeRawPointer, width:Int, height:Int)
+	{
+		let count = width * height
+		let paddedCount = (count + 3) & ~3
+
+		// Lane patterns for 4 RGBX pixels. The luminance weights are Rec. 709 in units of 1/256, the bin weights
+		// combine the upper 2 bits of each channel into a 6 bit bin index.
+
+		let rgbMask = SIMD16<UInt8>(255,255,255,0, 255,255,255,0, 255,255,255,0, 255,255,255,0)
+		let lumaWeights = SIMD16<UInt16>(54,183,19,0, 54,183,19,0, 54,183,19,0, 54,183,19,0)
+		let binWeights = SIMD16<UInt16>(16,4,1,0, 16,4,1,0, 16,4,1,0, 16,4,1,0)
+
+		var maximum = SIMD16<UInt8>(repeating:0)
+		var lumaSum = SIMD4<UInt32>(repeating:0)
+		var lumaSquares = SIMD4<UInt32>(repeating:0)
+		var counts = [UInt32](repeating:0, count:Self.binCount)
+		var colorSums = [SIMD4<UInt32>](repeating:SIMD4(repeating:0), count:Self.binCount)
+
+		let lumaPlane = UnsafeMutableRawPointer.allocate(byteCount:paddedCount, alignment:16)
+		defer { lumaPlane.deallocate() }
+
+		counts.withUnsafeMutableBufferPointer
+		{
+			counts in
+
+			colorSums.withUnsafeMutableBufferPointer
+			{
+				colorSums in
+
+				for offset in stride(from:0, to:paddedCount*4, by:16)
+				{
+					let quad = pixels.load(fromByteOffset:offset, as:SIMD16<UInt8>.self) & rgbMask
+					maximum = pointwiseMax(maximum,quad)
+
+					// Luminance: weight the channels, then add up the lanes of each pixel (r,g,b,x -> r+g,b+x -> r+g+b+x)
+
+					let weighted = SIMD16<UInt16>(truncatingIfNeeded:quad) &* lumaWeights
+					let weightedPairs = weighted.evenHalf &+ weighted.oddHalf
+					let luma = SIMD4<UInt32>(truncatingIfNeeded:(weightedPairs.evenHalf &+ weightedPairs.oddHalf) &>> 8)
+					lumaSum &+= luma
+					lumaSquares &+= luma &* luma
+					lumaPlane.storeBytes(of:SIMD4<UInt8>(truncatingIfNeeded:luma), toByteOffset:offset/4, as:SIMD4<UInt8>.self)
+
+					// Histogram: compute the bin index of all 4 pixels at once, then scatter
+
+					let bits = SIMD16<UInt16>(truncatingIfNeeded:quad &>> 6) &* binWeights
+					let bitPairs = bits.evenHalf &+ bits.oddHalf
+					let bins = bitPairs.evenHalf &+ bitPairs.oddHalf
+
+					Self.accumulate(quad.lowHalf.lowHalf, in:Int(bins[0]), counts:counts, colorSums:colorSums)
+					Self.accumulate(quad.lowHalf.highHalf, in:Int(bins[1]), counts:counts, colorSums:colorSums)
+					Self.accumulate(quad.highHalf.lowHalf, in:Int(bins[2]), counts:counts, colorSums:colorSums)
+					Self.accumulate(quad.highHalf.highHalf, in:Int(bins[3]), counts:counts, colorSums:colorSums)
+				}
+			}
+		}
+
+		// The padding pixels ended up in the black bin
+
+		counts[0] -= UInt32(paddedCount - count)
+
+		// Luminance statistics. Each lane of lumaSquares adds up to 255² per pixel for a quarter of the pixels, so
+		// the 32 bit accumulators cannot overflow for the 64x64 pixels of sampleSize.
+
+		let n = Double(max(1,count))
+		let mean = Double(lumaSum.wrappedSum()) / n
+		let variance = max(0.0, Double(lumaSquares.wrappedSum()) / n - mean * mean)
+		let deviation = variance.squareRoot()
+
+		self.isAllBlack = maximum.max() <= Self.blackThreshold
+		self.meanLuminance = UInt8(min(255.0, mean.rounded()))
+		self.luminanceDeviation = UInt8(min(255.0, deviation.rounded()))
+		self.isLowVariance = deviation < Double(Self.lowVarianceThreshold)
+
+		// Histogram and dominant colors
+
+		self.histogram = counts.map { UInt8(min(255.0, (Double($0) / n * 255.0).rounded())) }
+
+		self.dominantColors = counts.indices
+			.filter { Double(counts[$0]) / n >= Self.minimumDominantShare }
+			.sorted { counts[$0] > counts[$1] }
+			.prefix(3)
+			.map
+			{
+				bin in
+				let average = colorSums[bin] / SIMD4(repeating:counts[bin])
+
+				return Swatch(
+					red: UInt8(truncatingIfNeeded:average[0]),
+					green: UInt8(truncatingIfNeeded:average[1]),
+					blue: UInt8(truncatingIfNeeded:average[2]),
+					weight: UInt8(min(255.0, (Double(counts[bin]) / n * 255.0).rounded())))
+			}
+
+		// Perceptual hash
+
+		let luma = UnsafePointer(lumaPlane.assumingMemoryBound(to:UInt8.self))
+		self.perceptualHash = Self.differenceHash(luma, width:width, height:height)
+	}
+
+
+	/// Computes the difference hash of a luminance plane. The plane is reduced to 9x8 cells by averaging, then
+	/// each bit tells whether the brightness increases from one cell to its right neighbor. Near duplicates
+	/// (rescaled, recompressed, slightly brightened) end up with hashes that only differ in a few bits.
+
+	static func differenceHash(_ luma:UnsafePointer<UInt8>, width:Int, height:Int) -> UInt64
+	{
+		var cells = [UInt32](repeating:0, count:9*8)
+
+		for row in 0 ..< 8
+		{
+			let y0 = row * height / 8
+			let y1 = max(y0+1, (row+1) * height / 8)
+
+			for column in 0 ..< 9
+			{
+				let x0 = column * width / 9
+				let x1 = max(x0+1, (column+1) * width / 9)
+				var sum:UInt32 = 0
+
+				for y in y0 ..< y1
+				{
+					for x in x0 ..< x1
+					{
+						sum += UInt32(luma[y*width + x])
+					}
+				}
+
+				cells[row*9 + column] = sum * 256 / UInt32((y1-y0) * (x1-x0))
+			}
+		}
+
+		var hash:UInt64 = 0
+
+		for row in 0 ..< 8
+		{
+			for column in 0 ..< 8
+			{
+				hash <<= 1
+				if cells[row*9 + column] < cells[row*9 + column + 1] { hash |= 1 }
+			}
+		}
+
+		return hash
+	}
+
+
+	/// Adds a single pixel to its histogram bin
+
+	@inline(__always) private static func accumulate(_ pixel:SIMD4<UInt8>, in bin:Int, counts:UnsafeMutableBufferPointer<UInt32>, colorSums:UnsafeMutableBufferPointer<SIMD4<UInt32>>)
+	{
+		counts[bin] &+= 1
+		colorSums[bin] &+= SIMD4<UInt32>(truncatingIfNeeded:pixel)
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+// MARK: - Colors
+
+extension PixelAnalysis
+{
+	/// A ColorTag is a named color that can be used for filtering
+
+	public enum ColorTag : String, CaseIterable, Codable
+	{
+		case red
+		case orange
+		case brown
+		case yellow
+		case green
+		case cyan
+		case blue
+		case purple
+		case pink
+		case white
+		case gray
+		case black
+
+		/// Classifies an sRGB color by its hue, saturation and brightness
+
+		public init(red:UInt8, green:UInt8, blue:UInt8)
+		{
+			let r = Double(red) / 255.0
+			let g = Double(green) / 255.0
+			let b = Double(blue) / 255.0
+
+			let maxValue = max(r,g,b)
+			let minValue = min(r,g,b)
+			let delta = maxValue - minValue
+			let saturation = maxValue > 0.0 ? delta / maxValue : 0.0
+
+			if maxValue < 0.2
+			{
+				self = .black
+				return
+			}
+
+			if saturation < 0.2
+			{
+				self = maxValue > 0.85 ? .white : .gray
+				return
+			}
+
+			var hue:Double
+
+			if maxValue == r
+			{
+				hue = 60.0 * ((g - b) / delta)
+			}
+			else if maxValue == g
+			{
+				hue = 60.0 * ((b - r) / delta + 2.0)
+			}
+			else
+			{
+				hue = 60.0 * ((r - g) / delta + 4.0)
+			}
+
+			if hue < 0.0 { hue += 360.0 }
+
+			switch hue
+			{
+				case 15 ..< 45: self = maxValue < 0.6 ? .brown : .orange
+				case 45 ..< 70: self = .yellow
+				case 70 ..< 165: self = .green
+				case 165 ..< 195: self = .cyan
+				case 195 ..< 255: self = .blue
+				case 255 ..< 290: self = .purple
+				case 290 ..< 345: self = .pink
+				default: self = .red
+			}
+		}
+
+		/// Returns a localized string for displaying the color in the user interface
+
+		public var localizedName:String
+		{
+			NSLocalizedString(self.rawValue, tableName:"Object.Filter", bundle:.BXMediaBrowser, comment:"Color Name")
+		}
+	}
+
+
+	/// The ColorTag of the center color of each histogram bin
+
+	static let binColorTags:[ColorTag] = (0 ..< binCount).map
+	{
+		bin in
+
+		let red = UInt8(((bin >> 4) & 3) * 64 + 32)
+		let green = UInt8(((bin >> 2) & 3) * 64 + 32)
+		let blue = UInt8((bin & 3) * 64 + 32)
+		return ColorTag(red:red, green:green, blue:blue)
+	}
+
+	/// Returns the share of pixels (0.0 - 1.0) that have the specified color
+
+	public func share(of colorTag:ColorTag) -> Double
+	{
+		var sum = 0
+
+		for (bin,value) in histogram.enumerated() where Self.binColorTags[bin] == colorTag
+		{
+			sum += Int(value)
+		}
+
+		return Double(sum) / 255.0
+	}
+
+	/// Returns true if the specified color makes up a significant part of the image
+
+	public func contains(_ colorTag:ColorTag, minimumShare:Double = 0.15) -> Bool
+	{
+		if dominantColors.first?.colorTag == colorTag { return true }
+		return share(of:colorTag) >= minimumShare
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+// MARK: - Coding
+
+extension PixelAnalysis : Codable
+{
+	private enum Key : String, CodingKey
+	{
+		case isAllBlack
+		case isLowVariance
+		case meanLuminance
+		case luminanceDeviation
+		case histogram
+		case dominantColors
+		case perceptualHash
+	}
+
+	/// The histogram is encoded as Data to keep the persisted representation compact. The perceptual hash is
+	/// encoded as a signed integer, because property lists do not support the full unsigned 64 bit range.
+
+	public func encode(to encoder:Encoder) throws
+	{
+		var container = encoder.container(keyedBy:Key.self)
+
+		try container.encode(self.isAllBlack, forKey:.isAllBlack)
+		try container.encode(self.isLowVariance, forKey:.isLowVariance)
+		try container.encode(self.meanLuminance, forKey:.meanLuminance)
+		try container.encode(self.luminanceDeviation, forKey:.luminanceDeviation)
+		try container.encode(Data(self.histogram), forKey:.histogram)
+		try container.encode(self.dominantColors, forKey:.dominantColors)
+		try container.encodeIfPresent(self.perceptualHash.map { Int64(bitPattern:$0) }, forKey:.perceptualHash)
+	}
+
+	public init(from decoder:Decoder) throws
+	{
+		let container = try decoder.container(keyedBy:Key.self)
+
+		self.isAllBlack = try container.decode(Bool.self, forKey:.isAllBlack)
+		self.isLowVariance = try container.decode(Bool.self, forKey:.isLowVariance)
+		self.meanLuminance = try container.decode(UInt8.self, forKey:.meanLuminance)
+		self.luminanceDeviation = try container.decode(UInt8.self, forKey:.luminanceDeviation)
+		self.histogram = [UInt8](try container.decode(Data.self, forKey:.histogram))
+		self.dominantColors = try container.decodeIfPresent([Swatch].self, forKey:.dominantColors) ?? []
+		self.perceptualHash = try container.decodeIfPresent(Int64.self, forKey:.perceptualHash).map { UInt64(bitPattern:$0) }
+
+		guard histogram.count == Self.binCount else
+		{
+			throw DecodingError.dataCorruptedError(forKey:.histogram, in:container, debugDescription:"Expected \(Self.binCount) histogram bins")
+		}
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
@@ -23,30 +23,144 @@
 //----------------------------------------------------------------------------------------------------------------------
 
 
-/// This class can be used to suspend all background loading Tasks in BXMediaBrowser. This is useful if the host
+import Foundation
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+/// This class can be used to suspend background loading Tasks in BXMediaBrowser. This is useful if the host
 /// application performs some long running operation that is performance critical and should not be troubled with
 /// unnecessary background work.
+///
+/// Suspended Tasks are parked on continuations and are released immediately when resume() is called.
 	
 public final class Tasks
 {
+	/// Background work is divided into priority classes that can be suspended separately. That way a host
+	/// application can keep visible thumbnails flowing while pausing less important work like indexing.
+	
+	public enum Priority : Int, CaseIterable
+	{
+		/// Loading thumbnails of Objects that are visible on screen
+		
+		case thumbnail
+		
+		/// Loading metadata of Objects
+		
+		case metadata
+		
+		/// Loading the contents of Sources and Containers
+		
+		case contents
+		
+		/// Speculative or long running work like indexing, prefetching and preloading
+		
+		case indexing
+	}
+	
+	/// A parked Task waiting for its priority class to be resumed
+	
+	private struct Waiter
+	{
+		let priority:Priority
+		let continuation:CheckedContinuation<Void,Error>
+	}
+	
+	/// The priority classes that are currently suspended
+	
+	private static var suspendedPriorities:Set<Priority> = []
+	
+	/// All currently parked Tasks, keyed by a unique id
+	
+	private static var waiters:[Int:Waiter] = [:]
+	
+	/// Used to create unique waiter ids
+	
+	private static var nextWaiterID = 0
+	
+	/// This lock is used to ensure thread-safe access to the static properties above
+	
+	private static let lock = NSLock()
+	
+	
+//----------------------------------------------------------------------------------------------------------------------
+
 
 	/// Suspends all background work in BXMediaBrowser until resume() is called again.
 	
 	@MainActor public static func suspend()
 	{
-		Self.isSuspended = true
+		Self.suspend(Set(Priority.allCases))
+	}
+	
+	/// Suspends background work of the specified priority classes until they are resumed again.
+	
+	@MainActor public static func suspend(_ priorities:Set<Priority>)
+	{
+		lock.lock()
+		suspendedPriorities.formUnion(priorities)
+		lock.unlock()
 	}
 	
 	/// Resumes all background work that was previously suspended.
 	
 	@MainActor public static func resume()
 	{
-		Self.isSuspended = false
+		Self.resume(Set(Priority.allCases))
 	}
 
-	/// Returns true if background work is currently suspended.
+	/// Resumes background work of the specified priority classes. Parked Tasks are released immediately.
 	
-	public private(set) static var isSuspended = false
+	@MainActor public static func resume(_ priorities:Set<Priority>)
+	{
+		lock.lock()
+		suspendedPriorities.subtract(priorities)
+		let released = waiters.filter { priorities.contains($0.value.priority) }
+		released.keys.forEach { waiters[$0] = nil }
+		lock.unlock()
+		
+		for waiter in released.values
+		{
+			waiter.continuation.resume()
+		}
+	}
+
+	/// Returns true if any background work is currently suspended.
+	
+	public static var isSuspended:Bool
+	{
+		lock.lock()
+		defer { lock.unlock() }
+		return !suspendedPriorities.isEmpty
+	}
+	
+	/// Returns true if background work of the specified priority class is currently suspended.
+	
+	public static func isSuspended(_ priority:Priority) -> Bool
+	{
+		lock.lock()
+		defer { lock.unlock() }
+		return suspendedPriorities.contains(priority)
+	}
+	
+	/// Returns the number of Tasks that are currently parked
+	
+	public static var parkedCount:Int
+	{
+		lock.lock()
+		defer { lock.unlock() }
+		return waiters.count
+	}
+	
+	/// Returns the number of Tasks of the specified priority class that are currently parked
+	
+	public static func parkedCount(for priority:Priority) -> Int
+	{
+		lock.lock()
+		defer { lock.unlock() }
+		return waiters.values.filter { $0.priority == priority }.count
+	}
 	
 	
 //----------------------------------------------------------------------------------------------------------------------
@@ -60,20 +174,63 @@ public final class Tasks
 	///
 	///			for i in 0...n
 	///			{
-	///				try await Tasks.canContinue()
+	///				try await Tasks.canContinue(.indexing)
 	///
 	///				// Perform expensive background work
 	///			}
 	///		}
+	///
+	/// If the priority class is suspended, the calling Task is parked until it is resumed. If the Task is
+	/// cancelled while it is parked, a CancellationError is thrown.
 	
-	public static func canContinue() async throws
+	public static func canContinue(_ priority:Priority = .contents) async throws
 	{
-		while Self.isSuspended
-		{
-			// Sleep for several seconds before checking again
-			
-			try await Task.sleep(nanoseconds:5_000_000_000)
-		}
+		// Fast path: nothing to wait for
+		
+		guard isSuspended(priority) else { return }
+		
+		lock.lock()
+		let id = nextWaiterID
+		nextWaiterID += 1
+		lock.unlock()
+		
+		try await withTaskCancellationHandler(
+			handler:
+			{
+				lock.lock()
+				let waiter = waiters.removeValue(forKey:id)
+				lock.unlock()
+				
+				waiter?.continuation.resume(throwing:CancellationError())
+			},
+			operation:
+			{
+				try await withCheckedThrowingContinuation
+				{
+					(continuation:CheckedContinuation<Void,Error>) in
+					
+					lock.lock()
+					
+					// If the priority class was resumed in the meantime or the Task was cancelled before we got
+					// here, then there is no need to park it.
+					
+					if !suspendedPriorities.contains(priority)
+					{
+						lock.unlock()
+						continuation.resume()
+					}
+					else if Task.isCancelled
+					{
+						lock.unlock()
+						continuation.resume(throwing:CancellationError())
+					}
+					else
+					{
+						waiters[id] = Waiter(priority:priority, continuation:continuation)
+						lock.unlock()
+					}
+				}
+			})
 	}
 }
 
@@ -0,0 +1,335 @@
+//----------------------------------------------------------------------------------------------------------------------
+//
+//  Copyright ©2026 Peter Baumgartner. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//----------------------------------------------------------------------------------------------------------------------
+
+
+import Foundation
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+/// The TraceRecorder captures the same intervals that are marked with signposts, but keeps them in memory, so that
+/// they can be exported as Chrome trace-event JSON and viewed in Perfetto (https://ui.perfetto.dev) or chrome://tracing
+/// without running Instruments.
+///
+/// Recording is off by default and can be switched on at runtime with isEnabled, or at launch by setting the
+/// environment variable BXMEDIABROWSER_TRACE=1. While disabled, begin() and end() only check a flag. While enabled,
+/// finished intervals are stored in a ring buffer of fixed capacity, so the oldest intervals are discarded when
+/// the buffer is full and memory usage stays bounded.
+
+public final class TraceRecorder
+{
+	/// The shared recorder that is used by the BXMediaBrowser framework
+
+	public static let shared = TraceRecorder()
+
+	/// Switches recording on or off
+
+	public var isEnabled:Bool
+
+	/// The maximum number of intervals that are kept
+
+	public let capacity:Int
+
+	/// The ring buffer of recorded intervals
+
+	private var events:[Event?]
+
+	/// The position where the next interval will be stored
+
+	private var nextIndex = 0
+
+	/// The number of intervals that were recorded since the last reset, including those that were discarded
+
+	private var recordedCount = 0
+
+	/// The time origin for all timestamps
+
+	private let startTime = DispatchTime.now().uptimeNanoseconds
+
+	/// The identifier of this process
+
+	private let processID = ProcessInfo.processInfo.processIdentifier
+
+	/// Protects the ring buffer
+
+	private let lock = NSLock()
+
+	/// Creates a new recorder with the specified capacity. Most clients will use the shared recorder instead.
+
+	public init(capacity:Int = 50_000, isEnabled:Bool = ProcessInfo.processInfo.environment["BXMEDIABROWSER_TRACE"] == "1")
+	{
+		self.capacity = max(capacity,1)
+		self.events = [Event?](repeating:nil, count:max(capacity,1))
+		self.isEnabled = isEnabled
+	}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	// MARK: - Recording
+
+	/// A Span is an interval that has been started, but not finished yet
+
+	public struct Span
+	{
+		fileprivate let category:String
+		fileprivate let name:String
+		fileprivate let start:UInt64
+		fileprivate let threadID:UInt64
+		fileprivate let taskID:Int?
+		fileprivate let arguments:[String:String]
+
+		/// A Span that is returned while recording is disabled. Ending it does nothing.
+
+		fileprivate static let disabled = Span(category:"", name:"", start:0, threadID:0, taskID:nil, arguments:[:])
+
+		fileprivate var isDisabled:Bool { start == 0 }
+	}
+
+
+	/// A finished interval
+
+	public struct Event
+	{
+		public let category:String
+		public let name:String
+		public let start:UInt64
+		public let duration:UInt64
+		public let threadID:UInt64
+		public let endThreadID:UInt64
+		public let taskID:Int?
+		public let arguments:[String:String]
+	}
+
+
+	/// Starts an interval. The arguments are only evaluated if recording is enabled.
+
+	public func begin(_ category:String, _ name:String, _ arguments:@autoclosure ()->[String:String] = [:]) -> Span
+	{
+		guard isEnabled else { return .disabled }
+
+		return Span(
+			category: category,
+			name: name,
+			start: Swift.max(DispatchTime.now().uptimeNanoseconds,1),
+			threadID: Self.currentThreadID,
+			taskID: Self.currentTaskID,
+			arguments: arguments())
+	}
+
+
+	/// Finishes an interval and stores it in the ring buffer
+
+	public func end(_ span:Span)
+	{
+		guard !span.isDisabled else { return }
+
+		let end = DispatchTime.now().uptimeNanoseconds
+
+		let event = Event(
+			category: span.category,
+			name: span.name,
+			start: span.start,
+			duration: end > span.start ? end - span.start : 0,
+			threadID: span.threadID,
+			endThreadID: Self.currentThreadID,
+			taskID: span.taskID,
+			arguments: span.arguments)
+
+		lock.lock()
+		defer { lock.unlock() }
+
+		events[nextIndex] = event
+		nextIndex = (nextIndex + 1) % capacity
+		recordedCount += 1
+	}
+
+
+	/// Convenience functions for the shared recorder
+
+	public static func begin(_ category:String, _ name:String, _ arguments:@autoclosure ()->[String:String] = [:]) -> Span
+	{
+		shared.begin(category, name, arguments())
+	}
+
+	public static func end(_ span:Span)
+	{
+		shared.end(span)
+	}
+
+
+	/// Returns the identifier of the current thread
+
+	static var currentThreadID:UInt64
+	{
+		#if canImport(Darwin)
+		var id:UInt64 = 0
+		pthread_threadid_np(nil,&id)
+		return id
+		#else
+		return UInt64(pthread_self())
+		#endif
+	}
+
+	/// Returns an identifier for the current Swift Task, or nil when not running in a Task
+
+	static var currentTaskID:Int?
+	{
+		withUnsafeCurrentTask { $0?.hashValue }
+	}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	// MARK: - Accessing
+
+	/// Returns the recorded intervals in chronological order of their completion
+
+	public var recordedEvents:[Event]
+	{
+		lock.lock()
+		defer { lock.unlock() }
+
+		let events = self.events[nextIndex...] + self.events[..<nextIndex]
+		return events.compactMap { $0 }
+	}
+
+	/// The number of intervals that were discarded because the ring buffer was full
+
+	public var droppedCount:Int
+	{
+		lock.lock()
+		defer { lock.unlock() }
+		return Swift.max(0, recordedCount - capacity)
+	}
+
+	/// Removes all recorded intervals
+
+	public func reset()
+	{
+		lock.lock()
+		defer { lock.unlock() }
+
+		events = [Event?](repeating:nil, count:capacity)
+		nextIndex = 0
+		recordedCount = 0
+	}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	// MARK: - Exporting
+
+	/// Returns the recorded intervals in the Chrome trace-event JSON format. Intervals that started and ended on the
+	/// same thread become complete events ("X"). Intervals of async code, which may resume on a different thread,
+	/// become async begin/end pairs ("b"/"e"), so that they don't break the nesting of the thread tracks.
+
+	public func chromeTraceData() throws -> Data
+	{
+		let events = self.recordedEvents
+		var traceEvents:[[String:Any]] = []
+		traceEvents.reserveCapacity(events.count * 2 + 1)
+
+		traceEvents.append([
+			"name": "process_name",
+			"ph": "M",
+			"pid": processID,
+			"args": ["name": ProcessInfo.processInfo.processName]])
+
+		for (i,event) in events.enumerated()
+		{
+			var arguments:[String:Any] = event.arguments
+			if let taskID = event.taskID { arguments["task"] = taskID }
+
+			let start = self.microseconds(event.start)
+			let duration = Double(event.duration) / 1000
+
+			if event.threadID == event.endThreadID
+			{
+				traceEvents.append([
+					"name": event.name,
+					"cat": event.category,
+					"ph": "X",
+					"ts": start,
+					"dur": duration,
+					"pid": processID,
+					"tid": event.threadID,
+					"args": arguments])
+			}
+			else
+			{
+				let id = "0x" + String(i, radix:16)
+
+				traceEvents.append([
+					"name": event.name,
+					"cat": event.category,
+					"ph": "b",
+					"id": id,
+					"ts": start,
+					"pid": processID,
+					"tid": event.threadID,
+					"args": arguments])
+
+				traceEvents.append([
+					"name": event.name,
+					"cat": event.category,
+					"ph": "e",
+					"id": id,
+					"ts": start + duration,
+					"pid": processID,
+					"tid": event.endThreadID])
+			}
+		}
+
+		let trace:[String:Any] =
+		[
+			"traceEvents": traceEvents,
+			"displayTimeUnit": "ms",
+			"otherData": ["droppedEvents": droppedCount]
+		]
+
+		return try JSONSerialization.data(withJSONObject:trace, options:[])
+	}
+
+	/// Writes the recorded intervals as Chrome trace-event JSON file
+
+	public func writeChromeTrace(to url:URL) throws
+	{
+		try self.chromeTraceData().write(to:url, options:.atomic)
+	}
+
+	/// Converts an uptime timestamp to microseconds since the creation of this recorder
+
+	private func microseconds(_ time:UInt64) -> Double
+	{
+		Double(time > startTime ? time - startTime : 0) / 1000
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
@@ -23,11 +23,15 @@ extension URLSession
         {
 			continuation in
 
+            let start = Metrics.now
             let task = self.dataTask(with:url)
             {
 				(data,response,err) in
 
-				if let error = self.error(for:data,response,err)
+				let error = self.error(for:data,response,err)
+				self.recordMetrics(for:url, since:start, bytes:data?.count ?? 0, error:error)
+
+				if let error = error
 				{
 					continuation.resume(throwing:error)
 				}
@@ -59,11 +63,15 @@ extension URLSession
         {
 			continuation in
 
+            let start = Metrics.now
             let task = self.dataTask(with:request)
             {
 				(data,response,err) in
 
-				if let error = self.error(for:data,response,err)
+				let error = self.error(for:data,response,err)
+				self.recordMetrics(for:request.url, since:start, bytes:data?.count ?? 0, error:error)
+
+				if let error = error
 				{
 					continuation.resume(throwing:error)
 				}
@@ -125,11 +133,16 @@ extension URLSession
 		
 			// Download the file from remoteURL
 			
+			let start = Metrics.now
 			let task = self.downloadTask(with:remoteURL)
 			{
 				(tmpURL,response,err) in
 
-				if let error = self.error(for:tmpURL,response,err)
+				let error = self.error(for:tmpURL,response,err)
+				let bytes = (try? tmpURL?.resourceValues(forKeys:[.fileSizeKey]))?.fileSize ?? 0
+				self.recordMetrics(for:remoteURL, since:start, bytes:bytes, error:error)
+
+				if let error = error
 				{
 					continuation.resume(throwing:error)
 				}
@@ -176,11 +189,16 @@ extension URLSession
 		
 			// Download the file from remoteURL
 			
+			let start = Metrics.now
 			let task = self.downloadTask(with:request)
 			{
 				(tmpURL,response,err) in
 
-				if let error = self.error(for:tmpURL,response,err)
+				let error = self.error(for:tmpURL,response,err)
+				let bytes = (try? tmpURL?.resourceValues(forKeys:[.fileSizeKey]))?.fileSize ?? 0
+				self.recordMetrics(for:request.url, since:start, bytes:bytes, error:error)
+
+				if let error = error
 				{
 					continuation.resume(throwing:error)
 				}
@@ -238,6 +256,24 @@ extension URLSession
 	}
 	
 	
+	/// Records the latency, transferred bytes and failures of a finished task in the Metrics registry (per host)
+	
+	func recordMetrics(for url:URL?, since start:UInt64, bytes:Int, error:Error?)
+	{
+		let host = url?.host ?? "unknown"
+		
+		if error != nil
+		{
+			Metrics.shared.counter(.networkFailures, source:host).increment()
+		}
+		else
+		{
+			Metrics.shared.histogram(.networkLatency, source:host).record(since:start)
+			Metrics.shared.counter(.networkBytes, source:host).increment(by:Int64(bytes))
+		}
+	}
+	
+	
 	/// Moves the file at tmpURL to a backup location (because tmpURL will be deleted after lifetime of the completionHandler)
 					
 	func localURL(for tmpURL:URL?) -> URL?
@@ -0,0 +1,201 @@
+//----------------------------------------------------------------------------------------------------------------------
+//
+//  Copyright ©2026 Peter Baumgartner. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//----------------------------------------------------------------------------------------------------------------------
+
+
+import BXMediaBrowserFixtures
+import Foundation
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+/// A Benchmark is a named piece of work that is timed repeatedly. The setup closure runs once before the
+/// measurement and returns the work closure, so that preparing input data is not part of the measured time.
+
+struct Benchmark
+{
+	/// The unique name of this Benchmark, e.g. "folder.loadContents"
+
+	let name:String
+
+	/// Prepares the input data and returns the work that is measured
+
+	let setup:() async throws -> (() async throws -> Void)
+
+	/// Runs the Benchmark and returns its timings
+
+	func run(iterations:Int, warmup:Int = 1) async throws -> Result
+	{
+		let work = try await setup()
+
+		for _ in 0 ..< warmup
+		{
+			try await work()
+		}
+
+		var samples:[Double] = []
+		samples.reserveCapacity(iterations)
+
+		for _ in 0 ..< iterations
+		{
+			let start = DispatchTime.now().uptimeNanoseconds
+			try await work()
+			let end = DispatchTime.now().uptimeNanoseconds
+			samples.append(Double(end - start) / 1_000_000)
+		}
+
+		return Result(name:name, samples:samples)
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+extension Benchmark
+{
+	/// The timings of a single Benchmark. All values are in milliseconds.
+
+	struct Result : Codable
+	{
+		var name:String
+		var iterations:Int
+		var min:Double
+		var median:Double
+		var mean:Double
+		var max:Double
+		var standardDeviation:Double
+
+		init(name:String, samples:[Double])
+		{
+			let sorted = samples.sorted()
+			let count = Swift.max(sorted.count,1)
+			let mean = sorted.reduce(0,+) / Double(count)
+			let variance = sorted.reduce(0) { $0 + ($1-mean) * ($1-mean) } / Double(count)
+
+			self.name = name
+			self.iterations = sorted.count
+			self.min = sorted.first ?? 0
+			self.max = sorted.last ?? 0
+			self.mean = mean
+			self.standardDeviation = variance.squareRoot()
+
+			if sorted.isEmpty
+			{
+				self.median = 0
+			}
+			else if sorted.count % 2 == 1
+			{
+				self.median = sorted[sorted.count/2]
+			}
+			else
+			{
+				self.median = (sorted[sorted.count/2-1] + sorted[sorted.count/2]) / 2
+			}
+		}
+	}
+
+
+	/// A Report contains the results of all Benchmarks of a run, along with the fixture configuration. It is
+	/// written as JSON, so that it can be archived by CI and used as baseline for later runs.
+
+	struct Report : Codable
+	{
+		var version = 1
+		var date = Date()
+		var host = ProcessInfo.processInfo.hostName
+		var operatingSystem = ProcessInfo.processInfo.operatingSystemVersionString
+		var configuration:FixtureGenerator.Configuration
+		var results:[Result] = []
+
+		/// Loads a Report from a JSON file
+
+		init(contentsOf url:URL) throws
+		{
+			let decoder = JSONDecoder()
+			decoder.dateDecodingStrategy = .iso8601
+			self = try decoder.decode(Report.self, from:Data(contentsOf:url))
+		}
+
+		init(configuration:FixtureGenerator.Configuration)
+		{
+			self.configuration = configuration
+		}
+
+		/// Writes this Report as JSON file
+
+		func write(to url:URL) throws
+		{
+			let encoder = JSONEncoder()
+			encoder.dateEncodingStrategy = .iso8601
+			encoder.outputFormatting = [.prettyPrinted,.sortedKeys]
+			try encoder.encode(self).write(to:url)
+		}
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+extension Benchmark
+{
+	/// The comparison of a Result with the Result of the same Benchmark in a baseline Report
+
+	struct Comparison
+	{
+		let name:String
+		let baseline:Double?
+		let current:Double
+		let isRegression:Bool
+
+		/// The relative change of the median, e.g. 0.1 for 10% slower
+
+		var change:Double?
+		{
+			guard let baseline = baseline, baseline > 0 else { return nil }
+			return (current - baseline) / baseline
+		}
+	}
+
+
+	/// Compares the medians of all Results with a baseline Report. A Benchmark regressed if its median is more
+	/// than threshold (relative) slower than the baseline.
+
+	static func compare(_ report:Report, with baseline:Report, threshold:Double) -> [Comparison]
+	{
+		let baselineResults = Dictionary(baseline.results.map { ($0.name,$0) }) { first,_ in first }
+
+		return report.results.map
+		{
+			result in
+			let median = baselineResults[result.name]?.median
+			let isRegression = median.map { result.median > $0 * (1 + threshold) } ?? false
+			return Comparison(name:result.name, baseline:median, current:result.median, isRegression:isRegression)
+		}
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
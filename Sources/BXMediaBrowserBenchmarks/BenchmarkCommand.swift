@@ -0,0 +1,212 @@
+//----------------------------------------------------------------------------------------------------------------------
+//
+//  Copyright ©2026 Peter Baumgartner. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//----------------------------------------------------------------------------------------------------------------------
+
+
+import BXMediaBrowserFixtures
+import Foundation
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+/// Generates the fixtures, runs all (or the selected) Benchmarks and prints a summary. Optionally writes the results
+/// as JSON and compares them with a baseline. The process exits with status 1 if any Benchmark regressed.
+///
+///     swift run -c release BXMediaBrowserBenchmarks --output results.json --baseline baseline.json
+
+@main struct BenchmarkCommand
+{
+	struct Options
+	{
+		var configuration = FixtureGenerator.Configuration()
+		var iterations = 10
+		var fixturesURL = FileManager.default.temporaryDirectory.appendingPathComponent("BXMediaBrowserBenchmarks", isDirectory:true)
+		var keepFixtures = false
+		var outputURL:URL? = nil
+		var baselineURL:URL? = nil
+		var threshold = 0.1
+		var only:String? = nil
+	}
+
+	static let usage = """
+		Usage: BXMediaBrowserBenchmarks [options]
+
+		  --files <n>               Number of media files in the root folder (default 2000)
+		  --folders <n>             Number of subfolders (default 20)
+		  --files-per-folder <n>    Number of media files in each subfolder (default 10)
+		  --pages <n>               Number of JSON pages per web service (default 10)
+		  --page-size <n>           Number of assets per JSON page (default 80)
+		  --iterations <n>          Number of measured iterations per benchmark (default 10)
+		  --fixtures <path>         Where to generate the fixtures (default: temporary directory)
+		  --keep-fixtures           Don't delete the fixtures when done
+		  --only <text>             Only run benchmarks whose name contains text
+		  --output <path>           Write the results as JSON
+		  --baseline <path>         Compare the results with an earlier JSON report
+		  --threshold <percent>     Slowdown that counts as regression (default 10)
+		"""
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	static func main() async
+	{
+		var hasRegressions = false
+
+		do
+		{
+			let options = try Self.parse(Array(CommandLine.arguments.dropFirst()))
+			let fixtures = FixtureGenerator(configuration:options.configuration, rootURL:options.fixturesURL)
+
+			print("Generating fixtures in \(fixtures.rootURL.path)")
+			try fixtures.generate()
+			defer { if !options.keepFixtures { try? FileManager.default.removeItem(at:fixtures.rootURL) } }
+
+			// Run the benchmarks
+
+			var report = Benchmark.Report(configuration:options.configuration)
+
+			for benchmark in Benchmark.all(for:fixtures)
+			{
+				if let only = options.only, !benchmark.name.contains(only) { continue }
+
+				let result = try await benchmark.run(iterations:options.iterations)
+				report.results.append(result)
+				print(String(format:"%-36@ median %10.3f ms   min %10.3f ms   max %10.3f ms", benchmark.name as NSString, result.median, result.min, result.max))
+			}
+
+			if let url = options.outputURL
+			{
+				try report.write(to:url)
+				print("Results written to \(url.path)")
+			}
+
+			// Compare with the baseline
+
+			if let url = options.baselineURL
+			{
+				let baseline = try Benchmark.Report(contentsOf:url)
+
+				if baseline.configuration != report.configuration
+				{
+					print("Warning: the baseline was recorded with a different fixture configuration")
+				}
+
+				let comparisons = Benchmark.compare(report, with:baseline, threshold:options.threshold)
+				print("\nComparison with \(url.lastPathComponent):")
+
+				for comparison in comparisons
+				{
+					let change = comparison.change.map { String(format:"%+7.1f%%", $0 * 100) } ?? "    new"
+					let status = comparison.isRegression ? "  REGRESSION" : ""
+					print(String(format:"%-36@ %@%@", comparison.name as NSString, change as NSString, status as NSString))
+				}
+
+				hasRegressions = comparisons.contains { $0.isRegression }
+			}
+		}
+		catch let error as Error
+		{
+			print(error.description)
+			print(usage)
+			exit(2)
+		}
+		catch
+		{
+			print("Benchmark failed: \(error)")
+			exit(2)
+		}
+
+		exit(hasRegressions ? 1 : 0)
+	}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	// MARK: - Arguments
+
+	static func parse(_ arguments:[String]) throws -> Options
+	{
+		var options = Options()
+		var arguments = arguments[...]
+
+		func value() throws -> String
+		{
+			guard let value = arguments.popFirst() else { throw Error.missingValue }
+			return value
+		}
+
+		func number() throws -> Int
+		{
+			let string = try value()
+			guard let number = Int(string), number >= 0 else { throw Error.invalidValue(string) }
+			return number
+		}
+
+		while let argument = arguments.popFirst()
+		{
+			switch argument
+			{
+				case "--files": options.configuration.fileCount = try number()
+				case "--folders": options.configuration.folderCount = try number()
+				case "--files-per-folder": options.configuration.filesPerFolder = try number()
+				case "--pages": options.configuration.pageCount = try number()
+				case "--page-size": options.configuration.pageSize = try number()
+				case "--iterations": options.iterations = max(try number(),1)
+				case "--fixtures": options.fixturesURL = URL(fileURLWithPath:try value(), isDirectory:true)
+				case "--keep-fixtures": options.keepFixtures = true
+				case "--only": options.only = try value()
+				case "--output": options.outputURL = URL(fileURLWithPath:try value())
+				case "--baseline": options.baselineURL = URL(fileURLWithPath:try value())
+				case "--threshold": options.threshold = Double(try number()) / 100
+				case "--help", "-h": print(usage); exit(0)
+				default: throw Error.unknownArgument(argument)
+			}
+		}
+
+		return options
+	}
+
+
+	enum Error : Swift.Error, CustomStringConvertible
+	{
+		case missingValue
+		case invalidValue(String)
+		case unknownArgument(String)
+
+		var description:String
+		{
+			switch self
+			{
+				case .missingValue: return "Missing value for the last option"
+				case .invalidValue(let value): return "Invalid value \(value)"
+				case .unknownArgument(let argument): return "Unknown option \(argument)"
+			}
+		}
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
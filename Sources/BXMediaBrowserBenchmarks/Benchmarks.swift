@@ -0,0 +1,365 @@
+//----------------------------------------------------------------------------------------------------------------------
+//
+//  Copyright ©2026 Peter Baumgartner. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//----------------------------------------------------------------------------------------------------------------------
+
+
+import BXMediaBrowser
+import BXMediaBrowserFixtures
+import Foundation
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+extension Benchmark
+{
+	/// Returns all Benchmarks for the specified fixtures
+
+	static func all(for fixtures:FixtureGenerator) -> [Benchmark]
+	{
+		folderBenchmarks(for:fixtures) +
+		sortBenchmarks(for:fixtures) +
+		filterBenchmarks(for:fixtures) +
+		decodingBenchmarks(for:fixtures) +
+		startupBenchmarks(for:fixtures)
+	}
+
+
+	/// Returns the URLs of all media files in the root folder of the fixtures
+
+	static func fileURLs(in fixtures:FixtureGenerator) throws -> [URL]
+	{
+		try FileManager.default
+			.contentsOfDirectory(at:fixtures.mediaURL, includingPropertiesForKeys:[.isDirectoryKey])
+			.filter { !$0.hasDirectoryPath }
+	}
+
+
+	/// Returns a FolderFilter with the specified sort type
+
+	static func filter(sortType:Object.Filter.SortType, searchString:String = "") -> FolderFilter
+	{
+		let filter = FolderFilter()
+		filter.sortType = sortType
+		filter.searchString = searchString
+		return filter
+	}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	// MARK: - Folders
+
+	/// Loads the root folder of the fixtures, exactly like a FolderContainer does when it is expanded. The loadHandler
+	/// is called directly, so that the Container.Loader doesn't return cached contents.
+
+	static func folderBenchmarks(for fixtures:FixtureGenerator) -> [Benchmark]
+	{
+		[Object.Filter.SortType.alphabetical, .creationDate, .captureDate].map
+		{
+			sortType in
+
+			Benchmark(name:"folder.loadContents.\(sortType)")
+			{
+				let filter = Self.filter(sortType:sortType)
+				let container = FolderContainer(url:fixtures.mediaURL, filter:filter, in:nil)
+				let expectedCount = fixtures.configuration.fileCount
+
+				return
+				{
+					let (_,objects) = try await container.loader.loadHandler(container.identifier, container.data, filter, nil)
+					guard objects.count == expectedCount else { throw Error.unexpectedCount(objects.count, expected:expectedCount) }
+				}
+			}
+		}
+	}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	// MARK: - Sorting
+
+	/// Sorts lazy ObjectLists (by Record) and materialized Object arrays with Object.Filter.sort
+
+	static func sortBenchmarks(for fixtures:FixtureGenerator) -> [Benchmark]
+	{
+		let recordBenchmarks = [Object.Filter.SortType.alphabetical, .creationDate].map
+		{
+			sortType in
+
+			Benchmark(name:"sort.records.\(sortType)")
+			{
+				let filter = Self.filter(sortType:sortType)
+				let records = try Self.fileURLs(in:fixtures).shuffled().map { Object.Record(url:$0, mediaType:.image) }
+				let objects = ObjectList(records:records) { FolderContainer.createObject(for:$0, filter:filter, in:nil) }
+
+				return
+				{
+					var sorted = objects
+					filter.sort(&sorted)
+				}
+			}
+		}
+
+		let objectBenchmark = Benchmark(name:"sort.objects.alphabetical")
+		{
+			let filter = Self.filter(sortType:.alphabetical)
+			let urls = try Self.fileURLs(in:fixtures).shuffled()
+			let objects = urls.map { FolderContainer.createObject(for:Object.Record(url:$0, mediaType:.image), filter:filter, in:nil) }
+
+			return
+			{
+				var sorted = objects
+				filter.sort(&sorted)
+			}
+		}
+
+		return recordBenchmarks + [objectBenchmark]
+	}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	// MARK: - Filtering
+
+	/// Evaluates the search string and rating criteria that FolderContainer.loadContents applies to every file
+
+	static func filterBenchmarks(for fixtures:FixtureGenerator) -> [Benchmark]
+	{
+		let searchBenchmark = Benchmark(name:"filter.searchString")
+		{
+			let filter = Self.filter(sortType:.never, searchString:"IMG_01")
+			let urls = try Self.fileURLs(in:fixtures)
+
+			return
+			{
+				_ = urls.compactMap { FolderContainer.filter($0, with:filter) }
+			}
+		}
+
+		let ratingBenchmark = Benchmark(name:"filter.rating")
+		{
+			let records = try Self.fileURLs(in:fixtures).map { Object.Record(url:$0, mediaType:.image) }
+
+			return
+			{
+				_ = records.filter { StatisticsController.shared.rating(for:$0) >= 3 }
+			}
+		}
+
+		return [searchBenchmark,ratingBenchmark]
+	}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	// MARK: - Decoding
+
+	/// Decodes the recorded JSON pages of the web services. The pages are read from disk before measuring.
+
+	static func decodingBenchmarks(for fixtures:FixtureGenerator) -> [Benchmark]
+	{
+		FixtureGenerator.Service.allCases.map
+		{
+			service in
+
+			Benchmark(name:"decode.\(service.rawValue)")
+			{
+				let pages = try (0 ..< fixtures.configuration.pageCount).map { try Data(contentsOf:fixtures.pageURL($0, for:service)) }
+				let decoder = JSONDecoder()
+
+				return
+				{
+					for page in pages
+					{
+						switch service
+						{
+							case .lightroomCC: _ = try decoder.decode(LightroomCC.AlbumAssets.self, from:page)
+							case .unsplash: _ = try decoder.decode(UnsplashSearchResults.self, from:page)
+							case .pexels: _ = try decoder.decode(Pexels.Photo.SearchResults.self, from:page)
+						}
+					}
+				}
+			}
+		}
+	}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	// MARK: - Startup
+
+	/// Measures the time until the first screen of the previously selected Container can be displayed after launch.
+	/// Both paths restore the selection of "Folder 0" in the fixtures. Without a StartupSnapshot its parent folder
+	/// with all root files has to be loaded first. With a StartupSnapshot the recorded first screen is displayed by
+	/// a placeholder Container right away. The Container tree that keeps loading in the background afterwards is not
+	/// part of the measurement.
+
+	static func startupBenchmarks(for fixtures:FixtureGenerator) -> [Benchmark]
+	{
+		let folderURL = fixtures.mediaURL.appendingPathComponent("Folder 0")
+		let identifier = FolderContainer(url:folderURL, filter:FolderFilter(), in:nil).identifier
+
+		let coldBenchmark = Benchmark(name:"startup.cold")
+		{
+			return
+			{
+				let library = await Self.startupLibrary(selecting:identifier, snapshotURL:nil)
+				let root = FolderContainer(url:fixtures.mediaURL, filter:FolderFilter(), in:library)
+				root.load(in:library)
+				try await Self.loadFirstScreen(of:identifier, in:library)
+			}
+		}
+
+		let snapshotBenchmark = Benchmark(name:"startup.snapshot")
+		{
+			let snapshotURL = FileManager.default.temporaryDirectory.appendingPathComponent("BXMediaBrowserBenchmarks-\(UUID().uuidString).snapshot")
+			try await Self.captureSnapshot(of:identifier, in:fixtures, to:snapshotURL)
+
+			return
+			{
+				let library = await Self.startupLibrary(selecting:identifier, snapshotURL:snapshotURL)
+				try await Self.loadFirstScreen(of:identifier, in:library)
+			}
+		}
+
+		return [coldBenchmark,snapshotBenchmark]
+	}
+
+
+	/// Creates a Library that restores the selection of the specified Container, like a host application does
+	/// at launch
+
+	@MainActor static func startupLibrary(selecting identifier:String, snapshotURL:URL?) -> Library
+	{
+		let library = Library(identifier:"BXMediaBrowserBenchmarks-\(UUID().uuidString)")
+		library.startupSnapshot = snapshotURL.map { Library.StartupSnapshot(fileURL:$0) }
+		library.load(with:[library.selectedContainerIdentifierKey:identifier])
+		return library
+	}
+
+
+	/// Waits until the specified Container (or its placeholder) is selected and loaded, and then loads the
+	/// thumbnails of its first screen of Objects
+
+	static func loadFirstScreen(of identifier:String, in library:Library) async throws
+	{
+		let container = try await Self.wait
+		{
+			() -> Container? in
+			guard let container = library.selectedContainer else { return nil }
+			guard container.identifier == identifier && container.isLoaded else { return nil }
+			return container
+		}
+
+		let objects = await MainActor.run { Array(container.objects.prefix(60)) }
+
+		for object in objects
+		{
+			_ = try? await object.loader.thumbnailImage
+		}
+	}
+
+
+	/// Selects and loads the specified Container like startup.cold does, loads the thumbnails of its first screen,
+	/// and waits until the StartupSnapshot has recorded them in the file at the specified URL
+
+	static func captureSnapshot(of identifier:String, in fixtures:FixtureGenerator, to snapshotURL:URL) async throws
+	{
+		let library = await Self.startupLibrary(selecting:identifier, snapshotURL:snapshotURL)
+		let root = FolderContainer(url:fixtures.mediaURL, filter:FolderFilter(), in:library)
+		root.load(in:library)
+
+		let container = try await Self.wait
+		{
+			() -> Container? in
+			guard let container = library.selectedContainer else { return nil }
+			guard container.identifier == identifier && container.isLoaded else { return nil }
+			return container
+		}
+
+		let objects = await MainActor.run { Array(container.objects.prefix(60)) }
+
+		for object in objects
+		{
+			await withCheckedContinuation { continuation in object.load { continuation.resume() } }
+		}
+
+		let thumbnailCount = await MainActor.run { objects.filter { $0.thumbnailImage != nil }.count }
+
+		_ = try await Self.wait
+		{
+			() -> Bool? in
+			let records = Library.StartupSnapshot(fileURL:snapshotURL).records
+			let recordedCount = records.filter { $0.thumbnailData != nil }.count
+			return records.count == objects.count && recordedCount == thumbnailCount ? true : nil
+		}
+	}
+
+
+	/// Polls the specified condition on the main actor until it returns a value, or throws after the timeout
+
+	static func wait<T>(timeout:TimeInterval = 30.0, for condition:@escaping @MainActor () -> T?) async throws -> T
+	{
+		let deadline = Date().addingTimeInterval(timeout)
+
+		while Date() < deadline
+		{
+			if let value = await MainActor.run(body:condition)
+			{
+				return value
+			}
+
+			try await Task.sleep(nanoseconds:1_000_000)
+		}
+
+		throw Error.timeout
+	}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	enum Error : Swift.Error, CustomStringConvertible
+	{
+		case unexpectedCount(Int, expected:Int)
+		case timeout
+
+		var description:String
+		{
+			switch self
+			{
+				case .unexpectedCount(let count, let expected): return "Expected \(expected) objects, but got \(count)"
+				case .timeout: return "Timed out"
+			}
+		}
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
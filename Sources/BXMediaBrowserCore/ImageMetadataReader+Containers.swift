@@ -0,0 +1,540 @@
+//----------------------------------------------------------------------------------------------------------------------
+//
+//  Copyright ©2026 Peter Baumgartner. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//----------------------------------------------------------------------------------------------------------------------
+
+
+import Foundation
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+extension ImageMetadataReader
+{
+	/// The Parser walks the container structure of a file and collects the requested tags
+	
+	struct Parser
+	{
+		let bytes:Bytes
+		let tags:Set<Tag>
+		var metadata = Metadata()
+		
+		/// Values from the XMP packet and IPTC records are only used if the EXIF data didn't provide them
+		
+		var xmp = Metadata()
+		var iptc = Metadata()
+		
+		/// Offsets of IFDs that were already parsed. This protects against cycles in corrupt files.
+		
+		var visitedIFDs = Set<Int>()
+		
+		/// Candidates for the pixel size of TIFF/DNG files. Reduced resolution IFDs (previews) have lower priority.
+		
+		var tiffSizeCandidates:[(width:Int, height:Int, isReducedResolution:Bool)] = []
+		
+		init(bytes:Bytes, tags:Set<Tag>)
+		{
+			self.bytes = bytes
+			self.tags = tags
+		}
+		
+		var needsEXIF:Bool
+		{
+			!tags.isDisjoint(with:[.make,.model,.orientation,.captureDate,.exposureTime,.fNumber,.isoSpeed,.focalLength,.lensModel])
+		}
+		
+		var needsXMP:Bool
+		{
+			!tags.isDisjoint(with:[.rating,.keywords,.caption,.captureDate])
+		}
+		
+		var needsIPTC:Bool
+		{
+			!tags.isDisjoint(with:[.keywords,.caption])
+		}
+		
+		var needsICC:Bool
+		{
+			tags.contains(.profileName)
+		}
+		
+		var needsSize:Bool
+		{
+			!tags.isDisjoint(with:[.pixelWidth,.pixelHeight])
+		}
+		
+		/// Stores the pixel size of the image
+		
+		mutating func setSize(width:Int?, height:Int?)
+		{
+			if tags.contains(.pixelWidth), metadata.pixelWidth == nil { metadata.pixelWidth = width }
+			if tags.contains(.pixelHeight), metadata.pixelHeight == nil { metadata.pixelHeight = height }
+		}
+		
+		/// Merges the values from secondary sources (XMP, IPTC) that were not provided by EXIF
+		
+		mutating func finish()
+		{
+			if let size = tiffSizeCandidates.first(where:{ !$0.isReducedResolution }) ?? tiffSizeCandidates.first
+			{
+				self.setSize(width:size.width, height:size.height)
+			}
+			
+			if metadata.captureDate == nil { metadata.captureDate = xmp.captureDate }
+			if metadata.rating == nil { metadata.rating = xmp.rating }
+			if metadata.caption == nil { metadata.caption = iptc.caption ?? xmp.caption }
+			if metadata.keywords.isEmpty { metadata.keywords = iptc.keywords.isEmpty ? xmp.keywords : iptc.keywords }
+		}
+		
+		
+//----------------------------------------------------------------------------------------------------------------------
+
+
+		// MARK: - JPEG
+		
+		/// Walks the JPEG segments up to the start of the compressed image data
+		
+		mutating func parseJPEG()
+		{
+			var offset = 2
+			var iccChunks:[Int:(Int,Int)] = [:]
+			
+			while let marker = bytes.u8(offset), marker == 0xFF, let type = bytes.u8(offset+1)
+			{
+				// Skip fill bytes and standalone markers without a length field
+				
+				if type == 0xFF { offset += 1; continue }
+				if type == 0x01 || (0xD0...0xD7).contains(type) { offset += 2; continue }
+				if type == 0xD9 || type == 0xDA { break }
+				
+				guard let length = bytes.u16(at:offset+2, littleEndian:false).map({ Int($0) }), length >= 2 else { break }
+				let start = offset + 4
+				let count = length - 2
+				guard bytes.contains(start, length:count) else { break }
+				
+				switch type
+				{
+					// APP1 contains EXIF or XMP
+					
+					case 0xE1:
+					
+						if bytes.hasPrefix("Exif\0\0", at:start)
+						{
+							if needsEXIF { self.parseTIFF(at:start+6, length:count-6, isContainer:false) }
+						}
+						else if bytes.hasPrefix(Self.xmpSignature, at:start)
+						{
+							let n = Self.xmpSignature.utf8.count
+							if needsXMP { self.parseXMP(at:start+n, length:count-n) }
+						}
+						
+					// APP2 contains the ICC profile, which may be split into multiple chunks
+					
+					case 0xE2:
+					
+						if needsICC && bytes.hasPrefix("ICC_PROFILE\0", at:start), let index = bytes.u8(start+12)
+						{
+							iccChunks[Int(index)] = (start+14, count-14)
+						}
+						
+					// APP13 contains Photoshop image resources, including IPTC
+					
+					case 0xED:
+					
+						if needsIPTC && bytes.hasPrefix("Photoshop 3.0\0", at:start)
+						{
+							self.parsePhotoshopResources(at:start+14, length:count-14)
+						}
+						
+					// SOFn markers contain the image size
+					
+					case 0xC0...0xC3, 0xC5...0xC7, 0xC9...0xCB, 0xCD...0xCF:
+					
+						if needsSize
+						{
+							let height = bytes.u16(at:start+1, littleEndian:false).map { Int($0) }
+							let width = bytes.u16(at:start+3, littleEndian:false).map { Int($0) }
+							self.setSize(width:width, height:height)
+						}
+						
+					default:
+					
+						break
+				}
+				
+				offset = start + count
+			}
+			
+			// Reassemble the ICC profile
+			
+			if !iccChunks.isEmpty
+			{
+				var profile = Data()
+				
+				for index in iccChunks.keys.sorted()
+				{
+					guard let (start,count) = iccChunks[index], let chunk = bytes.data(at:start, length:count) else { continue }
+					profile.append(chunk)
+				}
+				
+				metadata.profileName = Self.iccProfileName(in:profile)
+			}
+		}
+		
+		/// The signature of the XMP packet in JPEG APP1 segments
+		
+		static let xmpSignature = "http://ns.adobe.com/xap/1.0/\0"
+		
+		
+//----------------------------------------------------------------------------------------------------------------------
+
+
+		// MARK: - PNG
+		
+		/// Walks the PNG chunks
+		
+		mutating func parsePNG()
+		{
+			var offset = 8
+			
+			while let length = bytes.u32(at:offset, littleEndian:false).map({ Int($0) }), let type = bytes.string(at:offset+4, length:4)
+			{
+				let start = offset + 8
+				guard bytes.contains(start, length:length) else { break }
+				
+				switch type
+				{
+					case "IHDR":
+					
+						let width = bytes.u32(at:start, littleEndian:false).map { Int($0) }
+						let height = bytes.u32(at:start+4, littleEndian:false).map { Int($0) }
+						self.setSize(width:width, height:height)
+						
+					case "eXIf":
+					
+						if needsEXIF { self.parseTIFF(at:start, length:length, isContainer:false) }
+						
+					case "iTXt":
+					
+						// Only uncompressed XMP packets are supported
+						
+						if needsXMP, let (keyword,next) = bytes.cString(at:start, limit:start+length), keyword == "XML:com.adobe.xmp", bytes.u8(next) == 0
+						{
+							guard let (_,afterLanguage) = bytes.cString(at:next+2, limit:start+length) else { break }
+							guard let (_,textStart) = bytes.cString(at:afterLanguage, limit:start+length) else { break }
+							self.parseXMP(at:textStart, length:start+length-textStart)
+						}
+						
+					case "IEND":
+					
+						return
+						
+					default:
+					
+						break
+				}
+				
+				offset = start + length + 4
+			}
+		}
+		
+		
+//----------------------------------------------------------------------------------------------------------------------
+
+
+		// MARK: - HEIF
+		
+		/// An item in a HEIF file, as described by the iinf and iloc boxes
+		
+		struct HEIFItem
+		{
+			var type:String = ""
+			var contentType:String = ""
+			var extents:[(offset:Int, length:Int)] = []
+		}
+		
+		/// Walks the boxes of a HEIF (HEIC/AVIF) file. Metadata is stored as items inside the meta box.
+		
+		mutating func parseHEIF()
+		{
+			guard let meta = self.boxes(in:0 ..< bytes.count).first(where:{ $0.type == "meta" }) else { return }
+			
+			// The meta box is a full box with 4 bytes of version and flags
+			
+			guard meta.content.count >= 4 else { return }
+			let children = self.boxes(in:meta.content.lowerBound+4 ..< meta.content.upperBound)
+			var items:[Int:HEIFItem] = [:]
+			var primaryItemID:Int? = nil
+			var properties:[Box] = []
+			var associations:[Int:[Int]] = [:]
+			
+			for box in children
+			{
+				switch box.type
+				{
+					case "pitm": primaryItemID = self.parsePrimaryItem(box)
+					case "iinf": self.parseItemInfo(box, into:&items)
+					case "iloc": self.parseItemLocations(box, into:&items)
+					case "iprp": self.parseItemProperties(box, properties:&properties, associations:&associations)
+					default: break
+				}
+			}
+			
+			// Image size and ICC profile are properties of the primary item
+			
+			var primaryProperties = properties
+			
+			if let id = primaryItemID, let indexes = associations[id]
+			{
+				primaryProperties = indexes.compactMap { $0>0 && $0<=properties.count ? properties[$0-1] : nil }
+			}
+			
+			if needsSize, let ispe = primaryProperties.first(where:{ $0.type == "ispe" })
+			{
+				let width = bytes.u32(at:ispe.content.lowerBound+4, littleEndian:false).map { Int($0) }
+				let height = bytes.u32(at:ispe.content.lowerBound+8, littleEndian:false).map { Int($0) }
+				self.setSize(width:width, height:height)
+			}
+			
+			if needsICC, let colr = primaryProperties.first(where:{ $0.type == "colr" }), let colourType = bytes.string(at:colr.content.lowerBound, length:4), colourType == "prof" || colourType == "rICC"
+			{
+				let start = colr.content.lowerBound + 4
+				if let profile = bytes.data(at:start, length:colr.content.upperBound-start) { metadata.profileName = Self.iccProfileName(in:profile) }
+			}
+			
+			// EXIF and XMP are stored as separate items
+			
+			for item in items.values
+			{
+				guard let extent = item.extents.first, item.extents.count == 1 else { continue }
+				
+				// Offsets and lengths come straight from the file, so they are added without trapping on overflow
+				
+				let (end,endOverflow) = extent.offset.addingReportingOverflow(extent.length)
+				guard !endOverflow else { continue }
+				
+				if item.type == "Exif" && needsEXIF, let headerOffset = bytes.u32(at:extent.offset, littleEndian:false).map({ Int($0) })
+				{
+					let (start,startOverflow) = extent.offset.addingReportingOverflow(4 + headerOffset)
+					guard !startOverflow, start <= end else { continue }
+					self.parseTIFF(at:start, length:end-start, isContainer:false)
+				}
+				else if item.type == "mime" && item.contentType == "application/rdf+xml" && needsXMP
+				{
+					self.parseXMP(at:extent.offset, length:extent.length)
+				}
+			}
+		}
+		
+		/// A box in an ISO base media file
+		
+		struct Box
+		{
+			let type:String
+			let content:Range<Int>
+		}
+		
+		/// Returns the boxes in the specified range
+		
+		func boxes(in range:Range<Int>) -> [Box]
+		{
+			var boxes:[Box] = []
+			var offset = range.lowerBound
+			
+			while offset+8 <= range.upperBound, let size32 = bytes.u32(at:offset, littleEndian:false), let type = bytes.string(at:offset+4, length:4)
+			{
+				var size = Int(size32)
+				var headerSize = 8
+				
+				if size == 1
+				{
+					guard let size64 = bytes.uint(at:offset+8, size:8) else { break }
+					size = size64
+					headerSize = 16
+				}
+				else if size == 0
+				{
+					size = range.upperBound - offset
+				}
+				
+				// Compare without adding, since a 64 bit largesize can be big enough to overflow offset+size
+				
+				guard size >= headerSize, size <= range.upperBound - offset else { break }
+				boxes.append(Box(type:type, content:offset+headerSize ..< offset+size))
+				offset += size
+			}
+			
+			return boxes
+		}
+		
+		/// Parses the pitm box, which contains the id of the primary item
+		
+		func parsePrimaryItem(_ box:Box) -> Int?
+		{
+			let version = bytes.u8(box.content.lowerBound) ?? 0
+			return bytes.uint(at:box.content.lowerBound+4, size:version == 0 ? 2 : 4)
+		}
+		
+		/// Parses the iinf box, which contains the type of each item
+		
+		func parseItemInfo(_ box:Box, into items:inout [Int:HEIFItem])
+		{
+			let version = bytes.u8(box.content.lowerBound) ?? 0
+			let entriesStart = box.content.lowerBound + 4 + (version == 0 ? 2 : 4)
+			guard entriesStart <= box.content.upperBound else { return }
+			
+			for infe in self.boxes(in:entriesStart ..< box.content.upperBound) where infe.type == "infe"
+			{
+				let start = infe.content.lowerBound
+				guard let infeVersion = bytes.u8(start), infeVersion >= 2 else { continue }
+				
+				let idSize = infeVersion == 2 ? 2 : 4
+				guard let id = bytes.uint(at:start+4, size:idSize) else { continue }
+				let typeOffset = start + 4 + idSize + 2
+				guard let type = bytes.string(at:typeOffset, length:4) else { continue }
+				
+				items[id, default:HEIFItem()].type = type
+				
+				if type == "mime", let (_,next) = bytes.cString(at:typeOffset+4, limit:infe.content.upperBound), let (contentType,_) = bytes.cString(at:next, limit:infe.content.upperBound)
+				{
+					items[id, default:HEIFItem()].contentType = contentType
+				}
+			}
+		}
+		
+		/// Parses the iloc box, which contains the location of each item in the file
+		
+		func parseItemLocations(_ box:Box, into items:inout [Int:HEIFItem])
+		{
+			var offset = box.content.lowerBound
+			guard let version = bytes.u8(offset) else { return }
+			offset += 4
+			
+			guard let sizes1 = bytes.u8(offset), let sizes2 = bytes.u8(offset+1) else { return }
+			let offsetSize = Int(sizes1 >> 4)
+			let lengthSize = Int(sizes1 & 0x0F)
+			let baseOffsetSize = Int(sizes2 >> 4)
+			let indexSize = version >= 1 ? Int(sizes2 & 0x0F) : 0
+			offset += 2
+			
+			let countSize = version < 2 ? 2 : 4
+			guard let itemCount = bytes.uint(at:offset, size:countSize) else { return }
+			offset += countSize
+			
+			for _ in 0 ..< itemCount
+			{
+				guard let id = bytes.uint(at:offset, size:countSize) else { return }
+				offset += countSize
+				
+				var constructionMethod = 0
+				
+				if version >= 1
+				{
+					constructionMethod = Int(bytes.u16(at:offset, littleEndian:false) ?? 0) & 0x0F
+					offset += 2
+				}
+				
+				offset += 2 // data_reference_index
+				guard let baseOffset = bytes.uint(at:offset, size:baseOffsetSize) else { return }
+				offset += baseOffsetSize
+				guard let extentCount = bytes.uint(at:offset, size:2) else { return }
+				offset += 2
+				
+				var extents:[(offset:Int, length:Int)] = []
+				var isValid = true
+				
+				for _ in 0 ..< extentCount
+				{
+					offset += indexSize
+					guard let extentOffset = bytes.uint(at:offset, size:offsetSize) else { return }
+					offset += offsetSize
+					guard let extentLength = bytes.uint(at:offset, size:lengthSize) else { return }
+					offset += lengthSize
+					
+					// An extent whose location overflows is corrupt, so the whole item is dropped
+					
+					let (extentStart,overflow) = baseOffset.addingReportingOverflow(extentOffset)
+					if overflow { isValid = false } else { extents.append((offset:extentStart, length:extentLength)) }
+				}
+				
+				// Only items that are stored directly in the file (not in the idat box) are supported
+				
+				if constructionMethod == 0 && isValid
+				{
+					items[id, default:HEIFItem()].extents = extents
+				}
+			}
+		}
+		
+		/// Parses the iprp box, which contains the item properties (ipco) and their association with items (ipma)
+		
+		func parseItemProperties(_ box:Box, properties:inout [Box], associations:inout [Int:[Int]])
+		{
+			for child in self.boxes(in:box.content)
+			{
+				if child.type == "ipco"
+				{
+					properties = self.boxes(in:child.content)
+				}
+				else if child.type == "ipma"
+				{
+					var offset = child.content.lowerBound
+					guard let version = bytes.u8(offset), let flags = bytes.u8(offset+3) else { continue }
+					offset += 4
+					guard let entryCount = bytes.uint(at:offset, size:4) else { continue }
+					offset += 4
+					
+					for _ in 0 ..< entryCount
+					{
+						let idSize = version < 1 ? 2 : 4
+						guard let id = bytes.uint(at:offset, size:idSize), let count = bytes.u8(offset+idSize) else { break }
+						offset += idSize + 1
+						
+						var indexes:[Int] = []
+						
+						for _ in 0 ..< count
+						{
+							if flags & 1 != 0
+							{
+								guard let value = bytes.u16(at:offset, littleEndian:false) else { break }
+								indexes.append(Int(value & 0x7FFF))
+								offset += 2
+							}
+							else
+							{
+								guard let value = bytes.u8(offset) else { break }
+								indexes.append(Int(value & 0x7F))
+								offset += 1
+							}
+						}
+						
+						associations[id] = indexes
+					}
+				}
+			}
+		}
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
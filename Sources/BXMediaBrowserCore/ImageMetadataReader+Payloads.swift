@@ -0,0 +1,480 @@
+//----------------------------------------------------------------------------------------------------------------------
+//
+//  Copyright ©2026 Peter Baumgartner. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//----------------------------------------------------------------------------------------------------------------------
+
+
+import Foundation
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+// MARK: - TIFF & EXIF
+
+extension ImageMetadataReader.Parser
+{
+	/// Parses a TIFF structure that starts at the specified offset. Offsets inside the TIFF structure are relative to
+	/// its header. If isContainer is true, the TIFF is the image file itself (TIFF, DNG), so the image size is taken
+	/// from the IFDs. Otherwise it is embedded EXIF data in another container format.
+	
+	mutating func parseTIFF(at base:Int, length:Int, isContainer:Bool)
+	{
+		guard bytes.contains(base, length:8) else { return }
+		
+		let littleEndian:Bool
+		
+		if bytes.hasPrefix("II", at:base) { littleEndian = true }
+		else if bytes.hasPrefix("MM", at:base) { littleEndian = false }
+		else { return }
+		
+		guard bytes.u16(at:base+2, littleEndian:littleEndian) == 42 else { return }
+		guard let ifd0 = bytes.u32(at:base+4, littleEndian:littleEndian).map({ Int($0) }) else { return }
+		
+		let tiff = TIFF(base:base, length:length, littleEndian:littleEndian)
+		self.parseIFD(at:ifd0, in:tiff, kind:.primary, isContainer:isContainer)
+	}
+	
+	/// Describes the location and byte order of a TIFF structure
+	
+	struct TIFF
+	{
+		let base:Int
+		let length:Int
+		let littleEndian:Bool
+	}
+	
+	/// The kind of IFD determines which tags are of interest
+	
+	enum IFDKind
+	{
+		case primary
+		case sub
+		case exif
+	}
+	
+	/// A single IFD entry
+	
+	struct Entry
+	{
+		let tag:UInt16
+		let type:UInt16
+		let count:Int
+		let valueOffset:Int
+	}
+	
+	/// The byte size of the TIFF field types
+	
+	static func size(ofType type:UInt16) -> Int
+	{
+		switch type
+		{
+			case 1,2,6,7: return 1
+			case 3,8: return 2
+			case 4,9,11: return 4
+			case 5,10,12: return 8
+			default: return 0
+		}
+	}
+	
+	/// Parses an IFD and follows the pointers to the EXIF IFD and SubIFDs
+	
+	mutating func parseIFD(at offset:Int, in tiff:TIFF, kind:IFDKind, isContainer:Bool)
+	{
+		let start = tiff.base + offset
+		guard offset > 0, offset < tiff.length, !visitedIFDs.contains(start) else { return }
+		visitedIFDs.insert(start)
+		
+		guard let count = bytes.u16(at:start, littleEndian:tiff.littleEndian).map({ Int($0) }) else { return }
+		guard bytes.contains(start+2, length:count*12) else { return }
+		
+		var width:Int? = nil
+		var height:Int? = nil
+		var isReducedResolution = false
+		var subIFDs:[Int] = []
+		var exifIFD:Int? = nil
+		
+		for i in 0 ..< count
+		{
+			let p = start + 2 + i*12
+			guard let tag = bytes.u16(at:p, littleEndian:tiff.littleEndian) else { continue }
+			guard let type = bytes.u16(at:p+2, littleEndian:tiff.littleEndian) else { continue }
+			guard let n = bytes.u32(at:p+4, littleEndian:tiff.littleEndian).map({ Int($0) }) else { continue }
+			
+			// Values that fit into 4 bytes are stored inline, otherwise the entry contains an offset
+			
+			let size = Self.size(ofType:type) * n
+			let valueOffset:Int
+			
+			if size <= 4
+			{
+				valueOffset = p + 8
+			}
+			else
+			{
+				guard let o = bytes.u32(at:p+8, littleEndian:tiff.littleEndian) else { continue }
+				valueOffset = tiff.base + Int(o)
+			}
+			
+			guard bytes.contains(valueOffset, length:size) else { continue }
+			let entry = Entry(tag:tag, type:type, count:n, valueOffset:valueOffset)
+			
+			switch (kind,tag)
+			{
+				// Pointers to other IFDs
+				
+				case (.primary,0x8769): exifIFD = self.integer(entry, tiff)
+				case (.primary,0x014A): subIFDs = (0 ..< n).compactMap { self.integer(entry, tiff, index:$0) }
+				
+				// Image size of TIFF containers
+				
+				case (.primary,0x00FE), (.sub,0x00FE): isReducedResolution = (self.integer(entry, tiff) ?? 0) & 1 != 0
+				case (.primary,0x0100), (.sub,0x0100): width = self.integer(entry, tiff)
+				case (.primary,0x0101), (.sub,0x0101): height = self.integer(entry, tiff)
+				
+				// IFD0 tags
+				
+				case (.primary,0x010F): self.set(.make, \.make, self.string(entry))
+				case (.primary,0x0110): self.set(.model, \.model, self.string(entry))
+				case (.primary,0x0112): self.set(.orientation, \.orientation, self.integer(entry, tiff))
+				case (.primary,0x02BC): if needsXMP { self.parseXMP(at:entry.valueOffset, length:entry.count * Self.size(ofType:type)) }
+				case (.primary,0x83BB): if needsIPTC { self.parseIPTC(at:entry.valueOffset, length:entry.count * Self.size(ofType:type)) }
+				case (.primary,0x8773): if needsICC, let profile = bytes.data(at:entry.valueOffset, length:entry.count) { metadata.profileName = Self.iccProfileName(in:profile) }
+				
+				// EXIF tags
+				
+				case (.exif,0x9003): self.set(.captureDate, \.captureDate, self.string(entry))
+				case (.exif,0x829A): self.set(.exposureTime, \.exposureTime, self.rational(entry, tiff))
+				case (.exif,0x829D): self.set(.fNumber, \.fNumber, self.rational(entry, tiff))
+				case (.exif,0x8827): self.set(.isoSpeed, \.isoSpeed, self.integer(entry, tiff))
+				case (.exif,0x920A): self.set(.focalLength, \.focalLength, self.rational(entry, tiff))
+				case (.exif,0xA434): self.set(.lensModel, \.lensModel, self.string(entry))
+				
+				default: break
+			}
+		}
+		
+		if isContainer, kind != .exif, let width = width, let height = height
+		{
+			tiffSizeCandidates.append((width:width, height:height, isReducedResolution:isReducedResolution))
+		}
+		
+		if let exifIFD = exifIFD, needsEXIF
+		{
+			self.parseIFD(at:exifIFD, in:tiff, kind:.exif, isContainer:isContainer)
+		}
+		
+		// SubIFDs only matter for the image size of DNG files
+		
+		if isContainer && needsSize
+		{
+			for subIFD in subIFDs
+			{
+				self.parseIFD(at:subIFD, in:tiff, kind:.sub, isContainer:isContainer)
+			}
+		}
+	}
+	
+	/// Stores a value if the tag was requested and it was not set yet
+	
+	mutating func set<T>(_ tag:ImageMetadataReader.Tag, _ keyPath:WritableKeyPath<ImageMetadataReader.Metadata,T?>, _ value:T?)
+	{
+		guard tags.contains(tag), metadata[keyPath:keyPath] == nil else { return }
+		metadata[keyPath:keyPath] = value
+	}
+	
+	/// Reads an ASCII value
+	
+	func string(_ entry:Entry) -> String?
+	{
+		guard entry.type == 2 || entry.type == 7 else { return nil }
+		let string = bytes.string(at:entry.valueOffset, length:entry.count)
+		return string?.isEmpty == false ? string : nil
+	}
+	
+	/// Reads a BYTE, SHORT or LONG value
+	
+	func integer(_ entry:Entry, _ tiff:TIFF, index:Int = 0) -> Int?
+	{
+		guard index < entry.count else { return nil }
+		
+		switch entry.type
+		{
+			case 1: return bytes.u8(entry.valueOffset+index).map { Int($0) }
+			case 3: return bytes.u16(at:entry.valueOffset+2*index, littleEndian:tiff.littleEndian).map { Int($0) }
+			case 4,13: return bytes.u32(at:entry.valueOffset+4*index, littleEndian:tiff.littleEndian).map { Int($0) }
+			default: return nil
+		}
+	}
+	
+	/// Reads a RATIONAL or SRATIONAL value
+	
+	func rational(_ entry:Entry, _ tiff:TIFF) -> Double?
+	{
+		guard let a = bytes.u32(at:entry.valueOffset, littleEndian:tiff.littleEndian) else { return nil }
+		guard let b = bytes.u32(at:entry.valueOffset+4, littleEndian:tiff.littleEndian), b != 0 else { return nil }
+		
+		switch entry.type
+		{
+			case 5: return Double(a) / Double(b)
+			case 10: return Double(Int32(bitPattern:a)) / Double(Int32(bitPattern:b))
+			default: return nil
+		}
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+// MARK: - IPTC
+
+extension ImageMetadataReader.Parser
+{
+	/// Parses Photoshop image resources (8BIM blocks) and looks for the IPTC-NAA resource
+	
+	mutating func parsePhotoshopResources(at start:Int, length:Int)
+	{
+		var offset = start
+		let end = start + length
+		
+		while offset+12 <= end, bytes.hasPrefix("8BIM", at:offset)
+		{
+			guard let id = bytes.u16(at:offset+4, littleEndian:false) else { return }
+			
+			// The resource name is a Pascal string, padded to an even size
+			
+			guard let nameLength = bytes.u8(offset+6).map({ Int($0) }) else { return }
+			var p = offset + 6 + nameLength + 1
+			if (nameLength+1) % 2 != 0 { p += 1 }
+			
+			guard let size = bytes.u32(at:p, littleEndian:false).map({ Int($0) }) else { return }
+			p += 4
+			guard p+size <= end else { return }
+			
+			if id == 0x0404
+			{
+				self.parseIPTC(at:p, length:size)
+			}
+			
+			offset = p + size + size % 2
+		}
+	}
+	
+	/// Parses IIM records and extracts keywords (2:25) and the caption (2:120)
+	
+	mutating func parseIPTC(at start:Int, length:Int)
+	{
+		var offset = start
+		let end = start + length
+		
+		while offset+5 <= end, bytes.u8(offset) == 0x1C
+		{
+			guard let record = bytes.u8(offset+1), let dataset = bytes.u8(offset+2) else { return }
+			guard let size = bytes.u16(at:offset+3, littleEndian:false).map({ Int($0) }), size < 0x8000 else { return }
+			let value = offset + 5
+			guard value+size <= end else { return }
+			
+			if record == 2 && dataset == 25 && tags.contains(.keywords), let keyword = bytes.string(at:value, length:size), !keyword.isEmpty
+			{
+				iptc.keywords.append(keyword)
+			}
+			else if record == 2 && dataset == 120 && tags.contains(.caption), let caption = bytes.string(at:value, length:size), !caption.isEmpty
+			{
+				iptc.caption = caption
+			}
+			
+			offset = value + size
+		}
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+// MARK: - XMP
+
+extension ImageMetadataReader.Parser
+{
+	/// Extracts the requested tags from an XMP packet. Only the handful of properties that are needed are looked up,
+	/// so a simple text scan is used instead of a full XML parser.
+	
+	mutating func parseXMP(at start:Int, length:Int)
+	{
+		guard let data = bytes.data(at:start, length:length) else { return }
+		let xml = String(decoding:data, as:UTF8.self)
+		
+		if tags.contains(.rating), let value = Self.xmpProperty("xmp:Rating", in:xml), let rating = Int(value)
+		{
+			xmp.rating = rating
+		}
+		
+		if tags.contains(.captureDate), let value = Self.xmpProperty("exif:DateTimeOriginal", in:xml) ?? Self.xmpProperty("photoshop:DateCreated", in:xml)
+		{
+			xmp.captureDate = Self.exifDate(fromISO8601:value)
+		}
+		
+		if tags.contains(.keywords), let bag = Self.xmpElement("dc:subject", in:xml)
+		{
+			xmp.keywords = Self.xmpListItems(in:bag)
+		}
+		
+		if tags.contains(.caption), let alt = Self.xmpElement("dc:description", in:xml)
+		{
+			xmp.caption = Self.xmpListItems(in:alt).first
+		}
+	}
+	
+	/// Returns the value of a simple property, which can be written as an attribute or as an element
+	
+	static func xmpProperty(_ name:String, in xml:String) -> String?
+	{
+		if let range = xml.range(of:"\(name)=\"")
+		{
+			let rest = xml[range.upperBound...]
+			guard let end = rest.firstIndex(of:"\"") else { return nil }
+			return self.unescape(String(rest[..<end]))
+		}
+		
+		if let element = self.xmpElement(name, in:xml), !element.contains("<")
+		{
+			return self.unescape(element.trimmingCharacters(in:.whitespacesAndNewlines))
+		}
+		
+		return nil
+	}
+	
+	/// Returns the content of the first element with the specified name
+	
+	static func xmpElement(_ name:String, in xml:String) -> String?
+	{
+		guard let open = xml.range(of:"<\(name)") else { return nil }
+		guard let openEnd = xml[open.upperBound...].firstIndex(of:">") else { return nil }
+		if xml[xml.index(before:openEnd)] == "/" { return nil }
+		
+		let contentStart = xml.index(after:openEnd)
+		guard let close = xml[contentStart...].range(of:"</\(name)>") else { return nil }
+		return String(xml[contentStart ..< close.lowerBound])
+	}
+	
+	/// Returns the values of all rdf:li elements
+	
+	static func xmpListItems(in xml:String) -> [String]
+	{
+		var items:[String] = []
+		var rest = xml[...]
+		
+		while let open = rest.range(of:"<rdf:li")
+		{
+			guard let openEnd = rest[open.upperBound...].firstIndex(of:">") else { break }
+			let contentStart = rest.index(after:openEnd)
+			guard let close = rest[contentStart...].range(of:"</rdf:li>") else { break }
+			
+			let value = self.unescape(String(rest[contentStart ..< close.lowerBound]).trimmingCharacters(in:.whitespacesAndNewlines))
+			if !value.isEmpty { items.append(value) }
+			rest = rest[close.upperBound...]
+		}
+		
+		return items
+	}
+	
+	/// Replaces the predefined XML entities
+	
+	static func unescape(_ string:String) -> String
+	{
+		guard string.contains("&") else { return string }
+		
+		return string
+			.replacingOccurrences(of:"&lt;", with:"<")
+			.replacingOccurrences(of:"&gt;", with:">")
+			.replacingOccurrences(of:"&quot;", with:"\"")
+			.replacingOccurrences(of:"&apos;", with:"'")
+			.replacingOccurrences(of:"&amp;", with:"&")
+	}
+	
+	/// Converts an XMP date like "2024-05-01T10:20:30+02:00" to EXIF notation "2024:05:01 10:20:30"
+	
+	static func exifDate(fromISO8601 string:String) -> String?
+	{
+		let chars = Array(string)
+		guard chars.count >= 10 else { return nil }
+		
+		let date = String(chars[0..<10]).replacingOccurrences(of:"-", with:":")
+		let time = chars.count >= 19 && chars[10] == "T" ? String(chars[11..<19]) : "00:00:00"
+		return "\(date) \(time)"
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+// MARK: - ICC
+
+extension ImageMetadataReader.Parser
+{
+	/// Returns the description of an ICC profile, e.g. "Display P3"
+	
+	static func iccProfileName(in profile:Data) -> String?
+	{
+		profile.withUnsafeBytes
+		{
+			(buffer:UnsafeRawBufferPointer) -> String? in
+			
+			let bytes = ImageMetadataReader.Bytes(buffer)
+			guard let tagCount = bytes.u32(at:128, littleEndian:false).map({ Int($0) }) else { return nil }
+			
+			for i in 0 ..< min(tagCount,256)
+			{
+				let p = 132 + i*12
+				guard bytes.hasPrefix("desc", at:p) else { continue }
+				guard let offset = bytes.u32(at:p+4, littleEndian:false).map({ Int($0) }) else { return nil }
+				
+				// ICC v2 profiles use the textDescriptionType
+				
+				if bytes.hasPrefix("desc", at:offset)
+				{
+					guard let count = bytes.u32(at:offset+8, littleEndian:false).map({ Int($0) }) else { return nil }
+					return bytes.string(at:offset+12, length:count)
+				}
+				
+				// ICC v4 profiles use the multiLocalizedUnicodeType. The first record is used.
+				
+				if bytes.hasPrefix("mluc", at:offset)
+				{
+					guard let length = bytes.u32(at:offset+20, littleEndian:false).map({ Int($0) }) else { return nil }
+					guard let stringOffset = bytes.u32(at:offset+24, littleEndian:false).map({ Int($0) }) else { return nil }
+					guard let data = bytes.data(at:offset+stringOffset, length:length) else { return nil }
+					return String(data:data, encoding:.utf16BigEndian)
+				}
+				
+				return nil
+			}
+			
+			return nil
+		}
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,356 @@
+//----------------------------------------------------------------------------------------------------------------------
+//
+//  Copyright ©2026 Peter Baumgartner. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//----------------------------------------------------------------------------------------------------------------------
+
+
+import Foundation
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+/// ImageMetadataReader extracts a small, configurable set of tags from image files. Instead of parsing everything
+/// like ImageIO does, it memory-maps the file and only walks the container structure (JPEG segments, PNG chunks,
+/// HEIF boxes or TIFF/DNG IFDs) to the EXIF IFDs, the XMP packet, the IPTC records and the ICC profile.
+///
+/// This file and its extensions only depend on Foundation, so that the reader is not tied to Apple platforms.
+
+public struct ImageMetadataReader
+{
+	/// The tags that can be extracted
+	
+	public enum Tag : String, CaseIterable
+	{
+		case make
+		case model
+		case orientation
+		case captureDate
+		case exposureTime
+		case fNumber
+		case isoSpeed
+		case focalLength
+		case lensModel
+		case pixelWidth
+		case pixelHeight
+		case profileName
+		case rating
+		case keywords
+		case caption
+	}
+	
+	/// The supported container formats
+	
+	public enum Format : String
+	{
+		case jpeg
+		case tiff
+		case png
+		case heif
+	}
+	
+	/// The tags that will be extracted. Unneeded parts of a file (e.g. the XMP packet) are skipped entirely.
+	
+	public var tags:Set<Tag>
+	
+	/// A shared reader that extracts all supported tags
+	
+	public static let shared = ImageMetadataReader()
+	
+	
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	public init(tags:Set<Tag> = Set(Tag.allCases))
+	{
+		self.tags = tags
+	}
+	
+	/// Reads the metadata of the image file at the specified URL. The file is memory-mapped, so only the pages that
+	/// are actually touched are read from disk. Returns nil if the file format is not supported.
+	
+	public func metadata(for url:URL) throws -> Metadata?
+	{
+		let data = try Data(contentsOf:url, options:.alwaysMapped)
+		return self.metadata(from:data)
+	}
+	
+	/// Reads the metadata from the specified image data. Returns nil if the format is not supported.
+	
+	public func metadata(from data:Data) -> Metadata?
+	{
+		data.withUnsafeBytes
+		{
+			(buffer:UnsafeRawBufferPointer) -> Metadata? in
+			
+			let bytes = Bytes(buffer)
+			guard let format = Self.format(of:bytes) else { return nil }
+			
+			var parser = Parser(bytes:bytes, tags:tags)
+			parser.metadata.format = format
+			
+			switch format
+			{
+				case .jpeg: parser.parseJPEG()
+				case .tiff: parser.parseTIFF(at:0, length:bytes.count, isContainer:true)
+				case .png: parser.parsePNG()
+				case .heif: parser.parseHEIF()
+			}
+			
+			parser.finish()
+			return parser.metadata
+		}
+	}
+	
+	/// Detects the container format by looking at the file signature
+	
+	static func format(of bytes:Bytes) -> Format?
+	{
+		if bytes.u8(0) == 0xFF && bytes.u8(1) == 0xD8
+		{
+			return .jpeg
+		}
+		
+		if bytes.string(at:0, length:2) == "II" && bytes.u16(at:2, littleEndian:true) == 42
+		{
+			return .tiff
+		}
+		
+		if bytes.string(at:0, length:2) == "MM" && bytes.u16(at:2, littleEndian:false) == 42
+		{
+			return .tiff
+		}
+		
+		if bytes.u32(at:0, littleEndian:false) == 0x89504E47 && bytes.u32(at:4, littleEndian:false) == 0x0D0A1A0A
+		{
+			return .png
+		}
+		
+		if bytes.string(at:4, length:4) == "ftyp", let brand = bytes.string(at:8, length:4), Self.heifBrands.contains(brand)
+		{
+			return .heif
+		}
+		
+		return nil
+	}
+	
+	/// The ftyp major brands of HEIF based formats (HEIC, AVIF)
+	
+	static let heifBrands:Set<String> = ["heic","heix","heim","heis","hevc","hevx","mif1","msf1","avif","avis"]
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+// MARK: - Metadata
+
+extension ImageMetadataReader
+{
+	/// The extracted metadata. Only those tags that were requested and present in the file are non-nil.
+	
+	public struct Metadata : Equatable
+	{
+		public var format:Format? = nil
+		public var make:String? = nil
+		public var model:String? = nil
+		public var orientation:Int? = nil
+		
+		/// The capture date in EXIF notation, i.e. "yyyy:MM:dd HH:mm:ss"
+		
+		public var captureDate:String? = nil
+		public var exposureTime:Double? = nil
+		public var fNumber:Double? = nil
+		public var isoSpeed:Int? = nil
+		public var focalLength:Double? = nil
+		public var lensModel:String? = nil
+		public var pixelWidth:Int? = nil
+		public var pixelHeight:Int? = nil
+		public var profileName:String? = nil
+		
+		/// The XMP rating (0-5)
+		
+		public var rating:Int? = nil
+		public var keywords:[String] = []
+		public var caption:String? = nil
+		
+		/// Returns the metadata in the same dictionary layout as CGImageSourceCopyPropertiesAtIndex, so that
+		/// existing code that reads ImageIO properties keeps working.
+		
+		public var dictionary:[String:Any]
+		{
+			var dict:[String:Any] = [:]
+			var tiff:[String:Any] = [:]
+			var exif:[String:Any] = [:]
+			var iptc:[String:Any] = [:]
+			
+			dict["PixelWidth"] = pixelWidth.map { NSNumber(value:$0) }
+			dict["PixelHeight"] = pixelHeight.map { NSNumber(value:$0) }
+			dict["Orientation"] = orientation.map { NSNumber(value:$0) }
+			dict["ProfileName"] = profileName
+			
+			tiff["Make"] = make
+			tiff["Model"] = model
+			tiff["Orientation"] = orientation.map { NSNumber(value:$0) }
+			
+			exif["DateTimeOriginal"] = captureDate
+			exif["ExposureTime"] = exposureTime.map { NSNumber(value:$0) }
+			exif["FNumber"] = fNumber.map { NSNumber(value:$0) }
+			exif["ISOSpeedRatings"] = isoSpeed.map { [NSNumber(value:$0)] }
+			exif["FocalLength"] = focalLength.map { NSNumber(value:$0) }
+			exif["LensModel"] = lensModel
+			
+			iptc["Keywords"] = keywords.isEmpty ? nil : keywords
+			iptc["Caption/Abstract"] = caption
+			
+			if !tiff.isEmpty { dict["{TIFF}"] = tiff }
+			if !exif.isEmpty { dict["{Exif}"] = exif }
+			if !iptc.isEmpty { dict["{IPTC}"] = iptc }
+			
+			return dict
+		}
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+// MARK: - Bytes
+
+extension ImageMetadataReader
+{
+	/// Bounds-checked access to the raw bytes of a file. All reads return nil when they would go out of bounds,
+	/// so that truncated or corrupt files never cause a crash.
+	
+	struct Bytes
+	{
+		let buffer:UnsafeRawBufferPointer
+		
+		init(_ buffer:UnsafeRawBufferPointer)
+		{
+			self.buffer = buffer
+		}
+		
+		var count:Int
+		{
+			buffer.count
+		}
+		
+		func contains(_ offset:Int, length:Int) -> Bool
+		{
+			offset >= 0 && length >= 0 && offset <= count - length
+		}
+		
+		func u8(_ offset:Int) -> UInt8?
+		{
+			guard contains(offset, length:1) else { return nil }
+			return buffer[offset]
+		}
+		
+		func u16(at offset:Int, littleEndian:Bool) -> UInt16?
+		{
+			guard contains(offset, length:2) else { return nil }
+			let b0 = UInt16(buffer[offset])
+			let b1 = UInt16(buffer[offset+1])
+			return littleEndian ? b0 | b1<<8 : b0<<8 | b1
+		}
+		
+		func u32(at offset:Int, littleEndian:Bool) -> UInt32?
+		{
+			guard let a = u16(at:offset, littleEndian:littleEndian), let b = u16(at:offset+2, littleEndian:littleEndian) else { return nil }
+			return littleEndian ? UInt32(a) | UInt32(b)<<16 : UInt32(a)<<16 | UInt32(b)
+		}
+		
+		func u64(at offset:Int, littleEndian:Bool) -> UInt64?
+		{
+			guard let a = u32(at:offset, littleEndian:littleEndian), let b = u32(at:offset+4, littleEndian:littleEndian) else { return nil }
+			return littleEndian ? UInt64(a) | UInt64(b)<<32 : UInt64(a)<<32 | UInt64(b)
+		}
+		
+		/// Reads an unsigned big endian integer of 0, 4 or 8 bytes, as used by HEIF boxes
+		
+		func uint(at offset:Int, size:Int) -> Int?
+		{
+			switch size
+			{
+				case 0: return 0
+				case 2: return u16(at:offset, littleEndian:false).map { Int($0) }
+				case 4: return u32(at:offset, littleEndian:false).map { Int($0) }
+				case 8: return u64(at:offset, littleEndian:false).flatMap { Int(exactly:$0) }
+				default: return nil
+			}
+		}
+		
+		/// Reads a string of the specified length. Trailing NUL characters and whitespace are removed.
+		
+		func string(at offset:Int, length:Int) -> String?
+		{
+			guard contains(offset, length:length) else { return nil }
+			let slice = UnsafeRawBufferPointer(rebasing:buffer[offset ..< offset+length])
+			let string = String(decoding:slice, as:UTF8.self)
+			return string.trimmingCharacters(in:CharacterSet(charactersIn:"\0").union(.whitespaces))
+		}
+		
+		/// Reads a NUL terminated string starting at offset. Returns the string and the offset behind the terminator.
+		
+		func cString(at offset:Int, limit:Int) -> (String,Int)?
+		{
+			var end = offset
+			
+			while end < limit, let byte = u8(end), byte != 0
+			{
+				end += 1
+			}
+			
+			guard end < limit else { return nil }
+			let slice = UnsafeRawBufferPointer(rebasing:buffer[offset ..< end])
+			return (String(decoding:slice, as:UTF8.self), end+1)
+		}
+		
+		/// Returns true if the bytes at offset match the specified ASCII signature
+		
+		func hasPrefix(_ signature:String, at offset:Int) -> Bool
+		{
+			let utf8 = Array(signature.utf8)
+			guard contains(offset, length:utf8.count) else { return false }
+			
+			for (i,byte) in utf8.enumerated()
+			{
+				if buffer[offset+i] != byte { return false }
+			}
+			
+			return true
+		}
+		
+		/// Copies a range of bytes
+		
+		func data(at offset:Int, length:Int) -> Data?
+		{
+			guard contains(offset, length:length) else { return nil }
+			return Data(buffer[offset ..< offset+length])
+		}
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,277 @@
+//----------------------------------------------------------------------------------------------------------------------
+//
+//  Copyright ©2026 Peter Baumgartner. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//----------------------------------------------------------------------------------------------------------------------
+
+
+import Foundation
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+/// ListDiff turns two successive versions of a list (e.g. the Objects or Containers of a Container) into a compact
+/// Batch of deletes, inserts, moves and updates that views can apply incrementally.
+///
+/// The algorithm follows Heckel: a symbol table of identifiers matches the elements of both lists in linear time.
+/// A common prefix and suffix is skipped first, so a change of a single element in a large list only needs to
+/// hash the elements in between. Among the matched elements, the longest increasing subsequence of old positions
+/// stays in place and only the remaining elements are reported as moves, which keeps the number of moves minimal.
+///
+/// The Batch uses the same index conventions as batch updates of NSCollectionView and UICollectionView: deletes
+/// and the source of moves refer to the old list, inserts, updates and the destination of moves to the new list.
+
+public enum ListDiff
+{
+	/// A Move relocates an element from an index in the old list to an index in the new list
+
+	public struct Move : Equatable
+	{
+		public let from:Int
+		public let to:Int
+
+		public init(from:Int, to:Int)
+		{
+			self.from = from
+			self.to = to
+		}
+	}
+
+	/// A Batch describes all changes between two lists
+
+	public struct Batch : Equatable
+	{
+		/// Indexes of removed elements in the old list, in ascending order
+
+		public var deletes:[Int] = []
+
+		/// Indexes of added elements in the new list, in ascending order
+
+		public var inserts:[Int] = []
+
+		/// Elements that changed their position relative to the other elements
+
+		public var moves:[Move] = []
+
+		/// Indexes of matched elements in the new list whose content changed, in ascending order
+
+		public var updates:[Int] = []
+
+		public init()
+		{
+
+		}
+
+		/// Returns true if both lists are equal
+
+		public var isEmpty:Bool
+		{
+			deletes.isEmpty && inserts.isEmpty && moves.isEmpty && updates.isEmpty
+		}
+
+		/// The number of structural changes, i.e. everything except updates
+
+		public var changeCount:Int
+		{
+			deletes.count + inserts.count + moves.count
+		}
+	}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	// MARK: - Diffing
+
+	/// Computes the Batch that transforms the old list into the new list. Elements are matched by their identifier.
+	/// Matched elements for which isUpdated returns true are reported as updates. Duplicate identifiers are
+	/// matched in order of appearance.
+
+	public static func batch<Element,ID:Hashable>(from old:[Element], to new:[Element], identifiedBy id:(Element)->ID, isUpdated:(Element,Element)->Bool = { _,_ in false }) -> Batch
+	{
+		var batch = Batch()
+
+		// Skip the common prefix and suffix, where elements keep their positions
+
+		let minCount = min(old.count,new.count)
+		var start = 0
+
+		while start < minCount && id(old[start]) == id(new[start])
+		{
+			if isUpdated(old[start],new[start]) { batch.updates.append(start) }
+			start += 1
+		}
+
+		var oldEnd = old.count
+		var newEnd = new.count
+		var suffixUpdates:[Int] = []
+
+		while oldEnd > start && newEnd > start && id(old[oldEnd-1]) == id(new[newEnd-1])
+		{
+			oldEnd -= 1
+			newEnd -= 1
+			if isUpdated(old[oldEnd],new[newEnd]) { suffixUpdates.append(newEnd) }
+		}
+
+		// Symbol table: maps each identifier to its first unmatched position in the old list. Further occurrences
+		// of the same identifier are chained via nextOld.
+
+		var table:[ID:Int] = [:]
+		table.reserveCapacity(oldEnd - start)
+		var nextOld = [Int](repeating:-1, count:oldEnd - start)
+
+		for i in (start ..< oldEnd).reversed()
+		{
+			let key = id(old[i])
+			if let next = table[key] { nextOld[i-start] = next }
+			table[key] = i
+		}
+
+		// Match the elements of the new list
+
+		var oldForNew = [Int](repeating:-1, count:newEnd - start)
+		var isMatched = [Bool](repeating:false, count:oldEnd - start)
+
+		for j in start ..< newEnd
+		{
+			let key = id(new[j])
+
+			if let i = table[key]
+			{
+				let next = nextOld[i-start]
+				if next >= 0 { table[key] = next } else { table[key] = nil }
+				oldForNew[j-start] = i
+				isMatched[i-start] = true
+			}
+			else
+			{
+				batch.inserts.append(j)
+			}
+		}
+
+		for i in start ..< oldEnd where !isMatched[i-start]
+		{
+			batch.deletes.append(i)
+		}
+
+		// Matched elements that are not part of the longest increasing subsequence of old positions have moved
+
+		let matched = (start ..< newEnd).filter { oldForNew[$0-start] >= 0 }
+		let isStable = Self.longestIncreasingSubsequence(of:matched.map { oldForNew[$0-start] })
+
+		for (k,j) in matched.enumerated()
+		{
+			let i = oldForNew[j-start]
+			if !isStable[k] { batch.moves.append(Move(from:i, to:j)) }
+			if isUpdated(old[i],new[j]) { batch.updates.append(j) }
+		}
+
+		batch.updates += suffixUpdates.reversed()
+		return batch
+	}
+
+
+	/// Returns flags for the values that are part of a longest strictly increasing subsequence (patience sorting)
+
+	static func longestIncreasingSubsequence(of values:[Int]) -> [Bool]
+	{
+		var tails:[Int] = []
+		var previous = [Int](repeating:-1, count:values.count)
+
+		for (k,value) in values.enumerated()
+		{
+			var lower = 0
+			var upper = tails.count
+
+			while lower < upper
+			{
+				let mid = (lower + upper) / 2
+				if values[tails[mid]] < value { lower = mid + 1 } else { upper = mid }
+			}
+
+			if lower > 0 { previous[k] = tails[lower-1] }
+			if lower == tails.count { tails.append(k) } else { tails[lower] = k }
+		}
+
+		var isPart = [Bool](repeating:false, count:values.count)
+		var k = tails.last ?? -1
+
+		while k >= 0
+		{
+			isPart[k] = true
+			k = previous[k]
+		}
+
+		return isPart
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+// MARK: - Applying
+
+extension ListDiff.Batch
+{
+	/// Applies this Batch to the old list, the same way a collection view would. Inserted and updated elements
+	/// are taken from the new list, all other elements are the instances from the old list. This can be used to
+	/// keep existing instances (and their state) when a list is reloaded.
+
+	public func applied<Element>(to old:[Element], new:[Element]) -> [Element]
+	{
+		var result = new
+		var isFilled = [Bool](repeating:false, count:new.count)
+		var isRemoved = [Bool](repeating:false, count:old.count)
+
+		for i in deletes { isRemoved[i] = true }
+		for j in inserts { isFilled[j] = true }
+
+		for move in moves
+		{
+			isRemoved[move.from] = true
+			result[move.to] = old[move.from]
+			isFilled[move.to] = true
+		}
+
+		// The remaining old elements keep their relative order and fill the gaps
+
+		var i = 0
+
+		for j in result.indices where !isFilled[j]
+		{
+			while isRemoved[i] { i += 1 }
+			result[j] = old[i]
+			i += 1
+		}
+
+		for j in updates
+		{
+			result[j] = new[j]
+		}
+
+		return result
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,238 @@
+//----------------------------------------------------------------------------------------------------------------------
+//
+//  Copyright ©2026 Peter Baumgartner. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//----------------------------------------------------------------------------------------------------------------------
+
+
+import Foundation
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+/// A MusicLibraryFingerprint summarizes the state of a music library: the number of tracks, the latest modification
+/// date and an order independent checksum of the persistent identifiers and modification dates of all tracks and
+/// playlists. Comparing two fingerprints is cheap, so the MusicSource can skip reloading when nothing changed. If
+/// something did change, the fingerprints can list the tracks and playlists that were added, removed or modified.
+
+public struct MusicLibraryFingerprint : Equatable
+{
+	/// The number of tracks
+
+	public let itemCount:Int
+
+	/// The latest modification date of any track
+
+	public let modificationToken:Date?
+
+	/// The combined checksum of all tracks
+
+	public let itemChecksum:UInt64
+
+	/// The combined checksum of all playlists
+
+	public let playlistChecksum:UInt64
+
+	/// The token of each track, sorted by identifier
+
+	private let items:ContiguousArray<Entry>
+
+	/// The token of each playlist, sorted by identifier
+
+	private let playlists:ContiguousArray<Entry>
+
+	/// A token for a track or playlist, which changes when the track or playlist is modified
+
+	private struct Entry
+	{
+		let id:UInt64
+		let token:UInt64
+	}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	/// Creates the fingerprint for the specified tracks and playlists
+
+	public init<Item:MusicLibraryItem,Playlist:MusicLibraryPlaylist>(items:[Item], playlists:[Playlist])
+	{
+		var itemEntries = ContiguousArray<Entry>()
+		var itemChecksum:UInt64 = 0
+		var modificationToken:Date? = nil
+
+		itemEntries.reserveCapacity(items.count)
+
+		for item in items
+		{
+			let date = item.libraryModifiedDate
+			let token = Self.mix(item.libraryItemID, date?.timeIntervalSinceReferenceDate.bitPattern ?? 0)
+			itemEntries.append(Entry(id:item.libraryItemID, token:token))
+			itemChecksum = itemChecksum &+ token
+
+			if let date = date, date > modificationToken ?? .distantPast
+			{
+				modificationToken = date
+			}
+		}
+
+		var playlistEntries = ContiguousArray<Entry>()
+		var playlistChecksum:UInt64 = 0
+
+		playlistEntries.reserveCapacity(playlists.count)
+
+		for playlist in playlists
+		{
+			var token = Self.mix(playlist.libraryPlaylistID, playlist.libraryParentID ?? 0)
+			token = Self.mix(token, Self.hash(playlist.name))
+
+			for item in playlist.libraryItems
+			{
+				token = Self.mix(token, item.libraryItemID)
+			}
+
+			playlistEntries.append(Entry(id:playlist.libraryPlaylistID, token:token))
+			playlistChecksum = playlistChecksum &+ token
+		}
+
+		self.itemCount = items.count
+		self.modificationToken = modificationToken
+		self.itemChecksum = itemChecksum
+		self.playlistChecksum = playlistChecksum
+		self.items = ContiguousArray(itemEntries.sorted { $0.id < $1.id })
+		self.playlists = ContiguousArray(playlistEntries.sorted { $0.id < $1.id })
+	}
+
+
+	/// Two fingerprints are considered equal if their counts, modification tokens and checksums are equal
+
+	public static func == (lhs:Self, rhs:Self) -> Bool
+	{
+		lhs.itemCount == rhs.itemCount &&
+		lhs.modificationToken == rhs.modificationToken &&
+		lhs.itemChecksum == rhs.itemChecksum &&
+		lhs.playlistChecksum == rhs.playlistChecksum &&
+		lhs.playlists.count == rhs.playlists.count
+	}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	// MARK: - Changes
+
+	/// The differences between two fingerprints
+
+	public struct Changes
+	{
+		public var addedItems:Set<UInt64> = []
+		public var removedItems:Set<UInt64> = []
+		public var modifiedItems:Set<UInt64> = []
+		public var changedPlaylists:Set<UInt64> = []
+
+		public var isEmpty:Bool
+		{
+			addedItems.isEmpty && removedItems.isEmpty && modifiedItems.isEmpty && changedPlaylists.isEmpty
+		}
+	}
+
+	/// Returns the tracks and playlists that changed since the older fingerprint was created
+
+	public func changes(since old:MusicLibraryFingerprint) -> Changes
+	{
+		var changes = Changes()
+
+		Self.merge(old.items, items,
+			added: { changes.addedItems.insert($0) },
+			removed: { changes.removedItems.insert($0) },
+			modified: { changes.modifiedItems.insert($0) })
+
+		Self.merge(old.playlists, playlists,
+			added: { changes.changedPlaylists.insert($0) },
+			removed: { changes.changedPlaylists.insert($0) },
+			modified: { changes.changedPlaylists.insert($0) })
+
+		return changes
+	}
+
+
+	/// Walks two sorted entry arrays in parallel and reports the differences
+
+	private static func merge(_ old:ContiguousArray<Entry>, _ new:ContiguousArray<Entry>, added:(UInt64)->Void, removed:(UInt64)->Void, modified:(UInt64)->Void)
+	{
+		var i = 0
+		var j = 0
+
+		while i < old.count || j < new.count
+		{
+			if j == new.count || i < old.count && old[i].id < new[j].id
+			{
+				removed(old[i].id)
+				i += 1
+			}
+			else if i == old.count || new[j].id < old[i].id
+			{
+				added(new[j].id)
+				j += 1
+			}
+			else
+			{
+				if old[i].token != new[j].token { modified(new[j].id) }
+				i += 1
+				j += 1
+			}
+		}
+	}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	// MARK: - Hashing
+
+	/// Combines two values into a well distributed 64 bit value (based on the SplitMix64 finalizer)
+
+	static func mix(_ a:UInt64, _ b:UInt64) -> UInt64
+	{
+		var x = (a ^ (b &* 0x9E3779B97F4A7C15)) &+ 0x9E3779B97F4A7C15
+		x = (x ^ (x >> 30)) &* 0xBF58476D1CE4E5B9
+		x = (x ^ (x >> 27)) &* 0x94D049BB133111EB
+		return x ^ (x >> 31)
+	}
+
+	/// A stable FNV-1a hash of a string. Unlike Hasher, this doesn't change between launches.
+
+	static func hash(_ string:String) -> UInt64
+	{
+		var hash:UInt64 = 0xCBF29CE484222325
+
+		for byte in string.utf8
+		{
+			hash = (hash ^ UInt64(byte)) &* 0x100000001B3
+		}
+
+		return hash
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
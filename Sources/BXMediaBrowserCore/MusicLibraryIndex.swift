@@ -0,0 +1,390 @@
+//----------------------------------------------------------------------------------------------------------------------
+//
+//  Copyright ©2026 Peter Baumgartner. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//----------------------------------------------------------------------------------------------------------------------
+
+
+import Foundation
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+/// A MusicLibraryItem is a track in a music library. The MusicLibraryIndex only depends on this protocol, so it can
+/// be built from ITLibMediaItems as well as from fixture data in tests.
+
+public protocol MusicLibraryItem
+{
+	/// The persistent identifier of the track
+
+	var libraryItemID:UInt64 { get }
+
+	/// The title of the track
+
+	var title:String { get }
+
+	/// The persistent identifier of the artist, or nil if the track has no artist
+
+	var libraryArtistID:UInt64? { get }
+
+	/// The name of the artist
+
+	var libraryArtistName:String? { get }
+
+	/// The persistent identifier of the album
+
+	var libraryAlbumID:UInt64 { get }
+
+	/// The title of the album
+
+	var libraryAlbumTitle:String? { get }
+
+	/// The genre of the track. An empty string means no genre.
+
+	var genre:String { get }
+
+	/// The track number on the album
+
+	var trackNumber:Int { get }
+
+	/// The composer of the track. An empty string means no composer.
+
+	var composer:String { get }
+
+	/// The date when the track was last modified, if known
+
+	var libraryModifiedDate:Date? { get }
+}
+
+
+/// A MusicLibraryPlaylist is a playlist (or playlist folder) in a music library
+
+public protocol MusicLibraryPlaylist
+{
+	associatedtype Item:MusicLibraryItem
+
+	/// The persistent identifier of the playlist
+
+	var libraryPlaylistID:UInt64 { get }
+
+	/// The name of the playlist
+
+	var name:String { get }
+
+	/// The persistent identifier of the parent folder, or nil for top-level playlists
+
+	var libraryParentID:UInt64? { get }
+
+	/// The tracks of the playlist in playlist order
+
+	var libraryItems:[Item] { get }
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+/// The MusicLibraryIndex groups the tracks of a music library by artist, album and genre in a single pass. The
+/// tracks of each grouping are stored contiguously, so every artist, album or genre is just a range into a flat
+/// array. Expanding the "Artists" folder or loading a single album therefore no longer needs to scan (and sort)
+/// the whole library.
+
+public final class MusicLibraryIndex<Item:MusicLibraryItem,Playlist:MusicLibraryPlaylist> where Playlist.Item == Item
+{
+	/// The different ways tracks are grouped
+
+	public enum Grouping : CaseIterable
+	{
+		case artist
+		case album
+		case genre
+	}
+
+	/// A Group is an artist, album or genre with the range of its tracks in the grouped track array
+
+	public struct Group
+	{
+		/// The key is the persistent identifier of the artist or album, or the name of the genre
+
+		public let key:String
+
+		/// The name for UI display purposes
+
+		public let name:String
+
+		/// The range of the tracks in the grouped array
+
+		public let range:Range<Int>
+
+		/// The number of tracks in this Group
+
+		public var count:Int
+		{
+			range.count
+		}
+	}
+
+	/// All tracks of the library, sorted by title
+
+	public let songs:[Item]
+
+	/// All playlists of the library
+
+	public let playlists:[Playlist]
+
+	/// The artist, album and genre Groups, each sorted by name
+
+	private var sortedGroups:[Grouping:[Group]] = [:]
+
+	/// The tracks of each Grouping, stored contiguously per Group
+
+	private var groupedItems:[Grouping:[Item]] = [:]
+
+	/// Maps the key of a Group to its position in the groups array
+
+	private var groupIndexes:[Grouping:[String:Int]] = [:]
+
+	/// The tracks of all playlists, stored contiguously per playlist
+
+	private var playlistItems:[Item] = []
+
+	/// Maps the identifier of a playlist to the range of its tracks
+
+	private var playlistRanges:[UInt64:Range<Int>] = [:]
+
+	/// Maps the identifier of a playlist folder (or nil for the top level) to the positions of its children
+
+	private var childPlaylistIndexes:[UInt64?:[Int]] = [:]
+
+	/// The folded search text is built on first use, since many sessions never search the music library
+
+	private var _searchText:MusicSearchText? = nil
+	private let searchTextLock = NSLock()
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	// MARK: - Building
+
+	/// Builds the index for the specified tracks and playlists
+
+	public init(items:[Item], playlists:[Playlist])
+	{
+		self.songs = items.sorted { $0.title < $1.title }
+		self.playlists = playlists
+
+		// Distribute the tracks into buckets in a single pass
+
+		var artists:[UInt64:(name:String,items:[Item])] = [:]
+		var albums:[UInt64:(name:String,items:[Item])] = [:]
+		var genres:[String:[Item]] = [:]
+
+		for item in items
+		{
+			if let id = item.libraryArtistID, let name = item.libraryArtistName, !name.isEmpty
+			{
+				artists[id, default:(name:name, items:[])].items.append(item)
+			}
+
+			if let title = item.libraryAlbumTitle, !title.isEmpty
+			{
+				albums[item.libraryAlbumID, default:(name:title, items:[])].items.append(item)
+			}
+
+			if !item.genre.isEmpty
+			{
+				genres[item.genre, default:[]].append(item)
+			}
+		}
+
+		// Sort the buckets and store them contiguously. Artist tracks are sorted by title, album tracks by track
+		// number and genre tracks keep the library order.
+
+		self.store(artists.map { (key:String($0.key), name:$0.value.name, items:$0.value.items.sorted { $0.title < $1.title }) }, for:.artist)
+		self.store(albums.map { (key:String($0.key), name:$0.value.name, items:$0.value.items.sorted { $0.trackNumber < $1.trackNumber }) }, for:.album)
+		self.store(genres.map { (key:$0.key, name:$0.key, items:$0.value) }, for:.genre)
+
+		// Playlists
+
+		for (i,playlist) in playlists.enumerated()
+		{
+			let start = playlistItems.count
+			playlistItems.append(contentsOf:playlist.libraryItems)
+			playlistRanges[playlist.libraryPlaylistID] = start ..< playlistItems.count
+			childPlaylistIndexes[playlist.libraryParentID, default:[]].append(i)
+		}
+	}
+
+
+	/// Sorts the buckets by name and concatenates their tracks
+
+	private func store(_ buckets:[(key:String,name:String,items:[Item])], for grouping:Grouping)
+	{
+		let buckets = buckets.sorted { $0.name < $1.name }
+		var groups:[Group] = []
+		var items:[Item] = []
+		var indexes:[String:Int] = [:]
+
+		groups.reserveCapacity(buckets.count)
+		items.reserveCapacity(buckets.reduce(0) { $0 + $1.items.count })
+		indexes.reserveCapacity(buckets.count)
+
+		for bucket in buckets
+		{
+			let start = items.count
+			items.append(contentsOf:bucket.items)
+			indexes[bucket.key] = groups.count
+			groups.append(Group(key:bucket.key, name:bucket.name, range:start ..< items.count))
+		}
+
+		self.sortedGroups[grouping] = groups
+		self.groupedItems[grouping] = items
+		self.groupIndexes[grouping] = indexes
+	}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	// MARK: - Accessing
+
+	/// Returns the sorted Groups for the specified Grouping
+
+	public func groups(for grouping:Grouping) -> [Group]
+	{
+		sortedGroups[grouping] ?? []
+	}
+
+	/// Returns the Group with the specified key
+
+	public func group(for grouping:Grouping, key:String) -> Group?
+	{
+		guard let i = groupIndexes[grouping]?[key] else { return nil }
+		return sortedGroups[grouping]?[i]
+	}
+
+	/// Returns the tracks of the specified Group
+
+	public func items(in group:Group, for grouping:Grouping) -> ArraySlice<Item>
+	{
+		guard let items = groupedItems[grouping], group.range.upperBound <= items.count else { return [] }
+		return items[group.range]
+	}
+
+	/// Returns the tracks of the specified playlist
+
+	public func items(in playlist:Playlist) -> ArraySlice<Item>
+	{
+		guard let range = playlistRanges[playlist.libraryPlaylistID] else { return [] }
+		return playlistItems[range]
+	}
+
+	/// Returns the child playlists of the specified playlist folder, or the top-level playlists if parentID is nil
+
+	public func childPlaylists(of parentID:UInt64?) -> [Playlist]
+	{
+		(childPlaylistIndexes[parentID] ?? []).map { playlists[$0] }
+	}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	// MARK: - Searching
+
+	/// The folded search text of all tracks, including tracks that are only part of playlists
+
+	public var searchText:MusicSearchText
+	{
+		searchTextLock.lock()
+		defer { searchTextLock.unlock() }
+
+		if let searchText = _searchText
+		{
+			return searchText
+		}
+
+		let searchText = MusicSearchText(items:songs + playlistItems)
+		_searchText = searchText
+		return searchText
+	}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	// MARK: - Changes
+
+	/// Returns the keys of the artist, album and genre Groups that contain any of the specified tracks
+
+	public func groupKeys(containing itemIDs:Set<UInt64>) -> [Grouping:Set<String>]
+	{
+		var keys:[Grouping:Set<String>] = [:]
+		guard !itemIDs.isEmpty else { return keys }
+
+		for item in songs where itemIDs.contains(item.libraryItemID)
+		{
+			if let id = item.libraryArtistID, let name = item.libraryArtistName, !name.isEmpty
+			{
+				keys[.artist, default:[]].insert(String(id))
+			}
+
+			if let title = item.libraryAlbumTitle, !title.isEmpty
+			{
+				keys[.album, default:[]].insert(String(item.libraryAlbumID))
+			}
+
+			if !item.genre.isEmpty
+			{
+				keys[.genre, default:[]].insert(item.genre)
+			}
+		}
+
+		return keys
+	}
+
+	/// Returns the identifiers of the playlists that contain any of the specified tracks
+
+	public func playlistIDs(containing itemIDs:Set<UInt64>) -> Set<UInt64>
+	{
+		var ids:Set<UInt64> = []
+		guard !itemIDs.isEmpty else { return ids }
+
+		for (id,range) in playlistRanges where playlistItems[range].contains(where:{ itemIDs.contains($0.libraryItemID) })
+		{
+			ids.insert(id)
+		}
+
+		return ids
+	}
+
+	/// Returns the identifier of the parent folder of the specified playlist
+
+	public func parentID(of playlistID:UInt64) -> UInt64?
+	{
+		playlists.first { $0.libraryPlaylistID == playlistID }?.libraryParentID
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
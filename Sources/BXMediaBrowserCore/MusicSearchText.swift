@@ -0,0 +1,187 @@
+//----------------------------------------------------------------------------------------------------------------------
+//
+//  Copyright ©2026 Peter Baumgartner. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//----------------------------------------------------------------------------------------------------------------------
+
+
+import Foundation
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+/// MusicSearchText stores the case and diacritic folded title, artist, composer, album and genre of all tracks of a
+/// library in a single contiguous byte buffer. A search folds the search string once and then scans the buffer in
+/// a single pass, instead of lowercasing five strings per track for every keystroke.
+
+public final class MusicSearchText
+{
+	/// The folded UTF-8 text of all tracks. Fields are terminated by a separator, so that a match cannot span
+	/// multiple fields.
+
+	private var text:[UInt8] = []
+
+	/// The start offset of each track in the text. The last element is the end of the text.
+
+	private var offsets:[Int] = [0]
+
+	/// Maps the persistent identifier of a track to its position
+
+	private var positions:[UInt64:Int] = [:]
+
+	/// The result of the last search, which is reused for all tracks while the search string doesn't change
+
+	private var lastSearch:(searchString:String,matches:[Bool])? = nil
+
+	/// Protects lastSearch
+
+	private let lock = NSLock()
+
+	/// Terminates each field in the text
+
+	static let separator:UInt8 = 0x1F
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	/// Builds the search text for the specified tracks
+
+	public init<Item:MusicLibraryItem>(items:[Item])
+	{
+		text.reserveCapacity(items.count * 64)
+		offsets.reserveCapacity(items.count + 1)
+		positions.reserveCapacity(items.count)
+
+		for item in items where positions[item.libraryItemID] == nil
+		{
+			for field in [item.title, item.libraryArtistName ?? "", item.composer, item.libraryAlbumTitle ?? "", item.genre]
+			{
+				text += Self.fold(field).utf8
+				text.append(Self.separator)
+			}
+
+			positions[item.libraryItemID] = offsets.count - 1
+			offsets.append(text.count)
+		}
+	}
+
+
+	/// The number of tracks
+
+	public var count:Int
+	{
+		offsets.count - 1
+	}
+
+	/// Folds the string for case and diacritic insensitive matching
+
+	public static func fold(_ string:String) -> String
+	{
+		string.folding(options:[.caseInsensitive,.diacriticInsensitive], locale:nil)
+	}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	// MARK: - Searching
+
+	/// Returns true if any field of the specified track contains the searchString. Returns nil if the track is
+	/// not part of this search text.
+
+	public func contains(_ itemID:UInt64, searchString:String) -> Bool?
+	{
+		guard let position = positions[itemID] else { return nil }
+		return matches(for:searchString)[position]
+	}
+
+
+	/// Returns a flag for each track, which is true if the track matches the searchString. The result for the
+	/// last searchString is cached.
+
+	public func matches(for searchString:String) -> [Bool]
+	{
+		lock.lock()
+		defer { lock.unlock() }
+
+		if let lastSearch = lastSearch, lastSearch.searchString == searchString
+		{
+			return lastSearch.matches
+		}
+
+		let matches = self.scan(for:Array(Self.fold(searchString).utf8))
+		lastSearch = (searchString,matches)
+		return matches
+	}
+
+
+	/// Scans the whole text once. After a match the scan continues with the next track, since a track only needs
+	/// to match once.
+
+	private func scan(for pattern:[UInt8]) -> [Bool]
+	{
+		var matches = [Bool](repeating:pattern.isEmpty, count:count)
+		guard !pattern.isEmpty, pattern.count <= text.count else { return matches }
+
+		text.withUnsafeBufferPointer
+		{
+			text in
+
+			pattern.withUnsafeBufferPointer
+			{
+				pattern in
+
+				guard let base = text.baseAddress, let first = pattern.first else { return }
+				let last = text.count - pattern.count
+				var position = 0
+				var i = 0
+
+				while i <= last
+				{
+					// Jump to the next occurrence of the first byte
+
+					guard let found = memchr(base + i, Int32(first), last - i + 1) else { break }
+					i = UnsafeRawPointer(base).distance(to:UnsafeRawPointer(found))
+
+					if memcmp(base + i, pattern.baseAddress!, pattern.count) == 0
+					{
+						// Find the track that contains this offset and continue with the next track
+
+						while offsets[position+1] <= i { position += 1 }
+						matches[position] = true
+						i = offsets[position+1]
+					}
+					else
+					{
+						i += 1
+					}
+				}
+			}
+		}
+
+		return matches
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,425 @@
+//----------------------------------------------------------------------------------------------------------------------
+//
+//  Copyright ©2026 Peter Baumgartner. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//----------------------------------------------------------------------------------------------------------------------
+
+
+import Foundation
+import CoreGraphics
+import ImageIO
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+/// The FixtureGenerator creates a synthetic media library on disk. Folders are populated with small, but valid JPEG,
+/// PNG, MP3 and MP4 files, so that UTI detection and metadata reading behave like they do for real files. In addition
+/// it writes JSON pages in the format of the Lightroom CC, Unsplash and Pexels web APIs.
+
+public struct FixtureGenerator
+{
+	/// The size of the generated fixtures
+
+	public struct Configuration : Codable, Equatable
+	{
+		/// The number of media files in the root folder
+
+		public var fileCount = 2000
+
+		/// The number of subfolders in the root folder
+
+		public var folderCount = 20
+
+		/// The number of media files in each subfolder
+
+		public var filesPerFolder = 10
+
+		/// The number of JSON pages per web service
+
+		public var pageCount = 10
+
+		/// The number of assets on each JSON page
+
+		public var pageSize = 80
+
+		public init()
+		{
+
+		}
+	}
+
+	/// The configuration that is used for generating the fixtures
+
+	public let configuration:Configuration
+
+	/// The root folder of the fixtures
+
+	public let rootURL:URL
+
+	/// Creates a FixtureGenerator that writes the fixtures to the specified folder
+
+	public init(configuration:Configuration = Configuration(), rootURL:URL)
+	{
+		self.configuration = configuration
+		self.rootURL = rootURL
+	}
+
+	/// The folder that contains the media files
+
+	public var mediaURL:URL
+	{
+		rootURL.appendingPathComponent("Media", isDirectory:true)
+	}
+
+	/// The folder that contains the JSON pages
+
+	public var pagesURL:URL
+	{
+		rootURL.appendingPathComponent("Pages", isDirectory:true)
+	}
+
+	/// The web services for which JSON pages are generated
+
+	public enum Service : String, CaseIterable
+	{
+		case lightroomCC
+		case unsplash
+		case pexels
+	}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	// MARK: - Generating
+
+	/// Creates all fixtures. Existing fixtures at rootURL are deleted first.
+
+	public func generate() throws
+	{
+		let fileManager = FileManager.default
+		try? fileManager.removeItem(at:rootURL)
+		try fileManager.createDirectory(at:mediaURL, withIntermediateDirectories:true)
+		try fileManager.createDirectory(at:pagesURL, withIntermediateDirectories:true)
+
+		try self.generateFiles(count:configuration.fileCount, in:mediaURL)
+
+		for i in 0 ..< configuration.folderCount
+		{
+			let folderURL = mediaURL.appendingPathComponent("Folder \(i)", isDirectory:true)
+			try fileManager.createDirectory(at:folderURL, withIntermediateDirectories:true)
+			try self.generateFiles(count:configuration.filesPerFolder, in:folderURL)
+		}
+
+		for service in Service.allCases
+		{
+			for page in 0 ..< configuration.pageCount
+			{
+				let json = Self.page(page, size:configuration.pageSize, for:service)
+				try Data(json.utf8).write(to:self.pageURL(page, for:service))
+			}
+		}
+	}
+
+
+	/// Writes count media files to the specified folder. The file types are mixed in a fixed ratio, so that every
+	/// run creates the same tree.
+
+	private func generateFiles(count:Int, in folderURL:URL) throws
+	{
+		let png = try Self.image(index:0, type:"public.png" as CFString)
+
+		for i in 0 ..< count
+		{
+			switch i % 10
+			{
+				case 0 ... 5:
+					let url = folderURL.appendingPathComponent(String(format:"IMG_%05d.jpg", i))
+					try Self.image(index:i, type:"public.jpeg" as CFString).write(to:url)
+
+				case 6 ... 7:
+					let url = folderURL.appendingPathComponent(String(format:"Graphic_%05d.png", i))
+					try png.write(to:url)
+
+				case 8:
+					let url = folderURL.appendingPathComponent(String(format:"Track_%05d.mp3", i))
+					try Self.mp3(title:"Track \(i)").write(to:url)
+
+				default:
+					let url = folderURL.appendingPathComponent(String(format:"MOV_%05d.mp4", i))
+					try Self.mp4(duration:i % 600 + 1).write(to:url)
+			}
+		}
+	}
+
+
+	/// Returns the URL of a JSON page
+
+	public func pageURL(_ page:Int, for service:Service) -> URL
+	{
+		pagesURL.appendingPathComponent("\(service.rawValue)-\(page).json")
+	}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	// MARK: - Media Files
+
+	/// Encodes a small image with an EXIF capture date, so that sorting by capture date has real data to work with
+
+	static func image(index:Int, type:CFString) throws -> Data
+	{
+		let width = 64
+		let height = 48
+
+		guard let context = CGContext(data:nil, width:width, height:height, bitsPerComponent:8, bytesPerRow:0, space:CGColorSpaceCreateDeviceRGB(), bitmapInfo:CGImageAlphaInfo.premultipliedLast.rawValue) else { throw Error.encodingFailed }
+
+		let hue = CGFloat(index % 32) / 32.0
+		context.setFillColor(CGColor(red:hue, green:1.0-hue, blue:0.5, alpha:1.0))
+		context.fill(CGRect(x:0, y:0, width:width, height:height))
+
+		guard let image = context.makeImage() else { throw Error.encodingFailed }
+
+		let captureDate = Date(timeIntervalSinceReferenceDate:Double(index * 7919 % 100_000) * 3600)
+
+		let properties:[CFString:Any] =
+		[
+			kCGImagePropertyExifDictionary : [ kCGImagePropertyExifDateTimeOriginal : exifDateFormatter.string(from:captureDate) ]
+		]
+
+		let data = NSMutableData()
+		guard let destination = CGImageDestinationCreateWithData(data, type, 1, nil) else { throw Error.encodingFailed }
+		CGImageDestinationAddImage(destination, image, properties as CFDictionary)
+		guard CGImageDestinationFinalize(destination) else { throw Error.encodingFailed }
+
+		return data as Data
+	}
+
+
+	/// Formats dates like EXIF does
+
+	private static let exifDateFormatter:DateFormatter =
+	{
+		let formatter = DateFormatter()
+		formatter.locale = Locale(identifier:"en_US_POSIX")
+		formatter.dateFormat = "yyyy:MM:dd HH:mm:ss"
+		return formatter
+	}()
+
+
+	/// Returns an MP3 file with an ID3v2.3 tag and a few silent MPEG-1 Layer III frames
+
+	static func mp3(title:String) -> Data
+	{
+		var data = Data()
+
+		// TIT2 frame with an ISO-8859-1 title
+
+		var frame = Data("TIT2".utf8)
+		let text = Data([0x00]) + Data(title.utf8)
+		frame += Self.bigEndian(UInt32(text.count))
+		frame += Data([0x00,0x00])
+		frame += text
+
+		// ID3v2.3 header. The tag size is a 28 bit synchsafe integer.
+
+		let size = frame.count
+		data += Data("ID3".utf8)
+		data += Data([0x03,0x00,0x00])
+		data += Data([UInt8(size >> 21 & 0x7F), UInt8(size >> 14 & 0x7F), UInt8(size >> 7 & 0x7F), UInt8(size & 0x7F)])
+		data += frame
+
+		// MPEG-1 Layer III, 128 kbit/s, 44.1 kHz, stereo. Each frame is 417 bytes long.
+
+		for _ in 0 ..< 8
+		{
+			data += Data([0xFF,0xFB,0x90,0x64])
+			data += Data(count:413)
+		}
+
+		return data
+	}
+
+
+	/// Returns an MP4 file with an ftyp box, a movie header with the specified duration (in seconds) and an mdat box
+
+	static func mp4(duration:Int) -> Data
+	{
+		var data = Data()
+
+		// File type
+
+		data += Self.bigEndian(UInt32(24))
+		data += Data("ftypisom".utf8)
+		data += Self.bigEndian(UInt32(0x200))
+		data += Data("isommp41".utf8)
+
+		// Movie header (version 0)
+
+		var mvhd = Data()
+		mvhd += Data(count:4)										// version & flags
+		mvhd += Data(count:8)										// creation & modification time
+		mvhd += Self.bigEndian(UInt32(600))							// timescale
+		mvhd += Self.bigEndian(UInt32(duration * 600))				// duration
+		mvhd += Self.bigEndian(UInt32(0x00010000))					// rate
+		mvhd += Data([0x01,0x00])									// volume
+		mvhd += Data(count:10)										// reserved
+
+		for value:UInt32 in [0x00010000,0,0, 0,0x00010000,0, 0,0,0x40000000]
+		{
+			mvhd += Self.bigEndian(value)							// matrix
+		}
+
+		mvhd += Data(count:24)										// pre-defined
+		mvhd += Self.bigEndian(UInt32(1))							// next track ID
+
+		data += Self.bigEndian(UInt32(8 + 8 + mvhd.count))
+		data += Data("moov".utf8)
+		data += Self.bigEndian(UInt32(8 + mvhd.count))
+		data += Data("mvhd".utf8)
+		data += mvhd
+
+		// Media data
+
+		data += Self.bigEndian(UInt32(8 + 1024))
+		data += Data("mdat".utf8)
+		data += Data(count:1024)
+
+		return data
+	}
+
+
+	private static func bigEndian(_ value:UInt32) -> Data
+	{
+		withUnsafeBytes(of:value.bigEndian) { Data($0) }
+	}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	// MARK: - JSON Pages
+
+	/// Returns a JSON page in the format of the specified web service
+
+	static func page(_ page:Int, size:Int, for service:Service) -> String
+	{
+		let ids = (page * size ..< (page+1) * size)
+
+		switch service
+		{
+			case .lightroomCC:
+
+				let resources = ids.map
+				{
+					id in
+
+					"""
+					{
+						"asset": {
+							"base": "https://lr.adobe.io/v2/catalogs/0/",
+							"id": "\(String(format:"%032x", id))",
+							"subtype": "\(id % 10 == 9 ? "video" : "image")",
+							"updated": "2022-05-01T12:00:00.000Z",
+							"payload": {
+								"captureDate": "2021-\(String(format:"%02d", id % 12 + 1))-01T10:00:00",
+								"importSource": { "fileName": "IMG_\(id).JPG", "fileSize": \(1_000_000 + id), "originalWidth": 6000, "originalHeight": 4000, "contentType": "image/jpeg" },
+								"xmp": { "tiff": { "Make": "Canon", "Model": "EOS R5" }, "exif": { "FNumber": [28,10], "ExposureTime": [1,250], "ISOSpeedRatings": 100, "FocalLengthIn35mmFilm": 50 } },
+								"ratings": { "\(id)": { "date": "2022-05-01T12:00:00.000Z", "rating": \(id % 6) } }
+							}
+						},
+						"payload": { "order": "\(id)", "key": "\(id)" }
+					}
+					"""
+				}
+
+				return """
+				{
+					"base": "https://lr.adobe.io/v2/catalogs/0/",
+					"resources": [\(resources.joined(separator:","))]
+				}
+				"""
+
+			case .unsplash:
+
+				let results = ids.map
+				{
+					id in
+
+					"""
+					{
+						"id": "\(id)", "created_at": "2022-05-01T12:00:00Z", "width": 4000, "height": 3000, "description": "Photo \(id)", "public_domain": false,
+						"urls": { "raw": "https://images.unsplash.com/photo-\(id)", "full": "https://images.unsplash.com/photo-\(id)?q=85", "regular": "https://images.unsplash.com/photo-\(id)?w=1080", "small": "https://images.unsplash.com/photo-\(id)?w=400", "thumb": "https://images.unsplash.com/photo-\(id)?w=200" },
+						"user": { "id": "\(id % 100)", "username": "photographer\(id % 100)", "name": "Photographer \(id % 100)", "first_name": "Photographer", "last_name": "\(id % 100)" },
+						"links": { "html": "https://unsplash.com/photos/\(id)", "download": "https://unsplash.com/photos/\(id)/download", "download_location": "https://api.unsplash.com/photos/\(id)/download" }
+					}
+					"""
+				}
+
+				return """
+				{
+					"total": 10000, "total_pages": \(10000 / max(size,1)),
+					"results": [\(results.joined(separator:","))]
+				}
+				"""
+
+			case .pexels:
+
+				let photos = ids.map
+				{
+					id -> String in
+					let src = "https://images.pexels.com/photos/\(id)/pexels-photo-\(id).jpeg"
+
+					return """
+					{
+						"id": \(id), "width": 4000, "height": 3000, "url": "https://www.pexels.com/photo/\(id)/",
+						"photographer": "Photographer \(id % 100)", "photographer_url": "https://www.pexels.com/@photographer\(id % 100)", "photographer_id": \(id % 100),
+						"avg_color": "#7E7E7E", "alt": "Photo \(id)",
+						"src": { "original": "\(src)", "large2x": "\(src)?h=1300", "large": "\(src)?h=650", "medium": "\(src)?h=350",
+						"small": "\(src)?h=130", "portrait": "\(src)?h=1200", "landscape": "\(src)?h=627", "tiny": "\(src)?h=200" }
+					}
+					"""
+				}
+
+				return """
+				{
+					"page": \(page + 1), "per_page": \(size), "total_results": 10000,
+					"next_page": "https://api.pexels.com/v1/search/?page=\(page + 2)&per_page=\(size)&query=nature",
+					"photos": [\(photos.joined(separator:","))]
+				}
+				"""
+		}
+	}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	public enum Error : Swift.Error
+	{
+		case encodingFailed
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,131 @@
+//----------------------------------------------------------------------------------------------------------------------
+//
+//  Copyright ©2026 Peter Baumgartner. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//----------------------------------------------------------------------------------------------------------------------
+
+
+import BXMediaBrowser
+import Foundation
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+/// The FixtureSource stands in for the web services. It has one Container per service, which decodes the JSON pages
+/// written by a FixtureGenerator and creates the same Object subclasses as the real Sources. That way decoding,
+/// Object creation, filtering and sorting can be exercised without network access or accounts. Please note that
+/// loading thumbnails, metadata or files of these Objects would still contact the web service.
+
+open class FixtureSource : Source
+{
+	/// The unique identifier of this Source
+
+	public static let identifier = "FixtureSource:"
+
+	/// The fixtures that are served by this Source
+
+	public let fixtures:FixtureGenerator
+
+	/// Creates a FixtureSource for fixtures that have already been generated
+
+	public init(fixtures:FixtureGenerator, filter:FolderFilter = FolderFilter(), in library:Library?)
+	{
+		self.fixtures = fixtures
+
+		super.init(identifier:Self.identifier, name:"Fixtures", filter:filter, in:library)
+
+		self.loader = Loader
+		{
+			_,filter,library in
+
+			FixtureGenerator.Service.allCases.map
+			{
+				FixtureSource.container(for:$0, fixtures:fixtures, filter:filter, in:library)
+			}
+		}
+	}
+
+
+	/// Creates the Container for the specified web service
+
+	open class func container(for service:FixtureGenerator.Service, fixtures:FixtureGenerator, filter:Object.Filter, in library:Library?) -> Container
+	{
+		Container(
+			identifier: "\(Self.identifier)\(service.rawValue)",
+			icon: "globe",
+			name: service.rawValue,
+			data: service.rawValue,
+			filter: filter,
+			loadHandler: { _,_,filter,library in try Self.loadContents(for:service, fixtures:fixtures, filter:filter, in:library) },
+			in: library)
+	}
+
+
+	/// Decodes all pages of the specified web service, then filters the Objects by name and sorts them
+
+	open class func loadContents(for service:FixtureGenerator.Service, fixtures:FixtureGenerator, filter:Object.Filter, in library:Library?) throws -> Container.Loader.Contents
+	{
+		let decoder = JSONDecoder()
+		var objects:[Object] = []
+
+		for page in 0 ..< fixtures.configuration.pageCount
+		{
+			guard !Task.isCancelled else { throw Container.Error.loadContentsCancelled }
+
+			let data = try Data(contentsOf:fixtures.pageURL(page, for:service))
+
+			switch service
+			{
+				case .lightroomCC:
+
+					for resource in try decoder.decode(LightroomCC.AlbumAssets.self, from:data).resources
+					{
+						let asset = resource.asset
+						let object:Object = asset.subtype == "video" ? LightroomCCVideoObject(with:asset, in:library) : LightroomCCImageObject(with:asset, in:library)
+						objects.append(object)
+					}
+
+				case .unsplash:
+
+					objects += try decoder.decode(UnsplashSearchResults.self, from:data).results.map { UnsplashObject(with:$0, in:library) }
+
+				case .pexels:
+
+					objects += try decoder.decode(Pexels.Photo.SearchResults.self, from:data).photos.map { PexelsPhotoObject(with:$0, in:library) }
+			}
+		}
+
+		let searchString = filter.searchString.lowercased()
+
+		if !searchString.isEmpty
+		{
+			objects = objects.filter { $0.name.lowercased().contains(searchString) }
+		}
+
+		filter.sort(&objects)
+
+		return ([],ObjectList(objects))
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,170 @@
+//----------------------------------------------------------------------------------------------------------------------
+//
+//  Copyright ©2026 Peter Baumgartner. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//----------------------------------------------------------------------------------------------------------------------
+
+
+import Foundation
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+/// A Phase is one step of a scan, e.g. loading all Containers. It records the wall clock time, the CPU time and the
+/// memory usage of the process, so that phases can be compared with each other and across runs.
+
+struct Phase
+{
+	/// The name of this Phase
+
+	let name:String
+
+	/// The number of items that were processed, e.g. the number of loaded Containers
+
+	var itemCount = 0
+
+	/// The number of items that failed
+
+	var failureCount = 0
+
+	/// The elapsed wall clock time in seconds
+
+	private(set) var wallTime:Double = 0
+
+	/// The CPU time (user and system) in seconds that was used by all threads of the process
+
+	private(set) var cpuTime:Double = 0
+
+	/// The resident memory in bytes at the end of the Phase
+
+	private(set) var residentSize:UInt64 = 0
+
+	/// The change of the resident memory in bytes during the Phase
+
+	private(set) var residentSizeDelta:Int64 = 0
+
+	/// The peak resident memory in bytes of the process so far
+
+	private(set) var peakResidentSize:UInt64 = 0
+
+	/// Runs the work and measures it. The work returns the number of processed and failed items.
+
+	static func measure(_ name:String, _ work:() async throws -> (items:Int, failures:Int)) async rethrows -> Phase
+	{
+		var phase = Phase(name:name)
+
+		let startWallTime = DispatchTime.now().uptimeNanoseconds
+		let startCPUTime = Self.currentCPUTime
+		let startResidentSize = Self.currentResidentSize
+
+		let (items,failures) = try await work()
+
+		phase.wallTime = Double(DispatchTime.now().uptimeNanoseconds - startWallTime) / 1_000_000_000
+		phase.cpuTime = Self.currentCPUTime - startCPUTime
+		phase.residentSize = Self.currentResidentSize
+		phase.residentSizeDelta = Int64(phase.residentSize) - Int64(startResidentSize)
+		phase.peakResidentSize = Self.peakResidentSize
+		phase.itemCount = items
+		phase.failureCount = failures
+		return phase
+	}
+
+
+	/// Returns a single line for the summary table
+
+	var summary:String
+	{
+		let mb = 1024.0 * 1024.0
+
+		return String(format:"%-22@ %10.1f ms %10.1f ms %9.1f MB %+9.1f MB %9.1f MB %8ld %8ld",
+			name as NSString,
+			wallTime * 1000,
+			cpuTime * 1000,
+			Double(residentSize) / mb,
+			Double(residentSizeDelta) / mb,
+			Double(peakResidentSize) / mb,
+			itemCount,
+			failureCount)
+	}
+
+	/// The header line for the summary table
+
+	static var header:String
+	{
+		String(format:"%-22@ %13@ %13@ %12@ %12@ %12@ %8@ %8@",
+			"Phase" as NSString,
+			"Wall" as NSString,
+			"CPU" as NSString,
+			"Resident" as NSString,
+			"Delta" as NSString,
+			"Peak" as NSString,
+			"Items" as NSString,
+			"Failed" as NSString)
+	}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	// MARK: - Process Statistics
+
+	/// Returns the CPU time in seconds that was used by the process so far
+
+	static var currentCPUTime:Double
+	{
+		var usage = rusage()
+		getrusage(RUSAGE_SELF, &usage)
+		let user = Double(usage.ru_utime.tv_sec) + Double(usage.ru_utime.tv_usec) / 1_000_000
+		let system = Double(usage.ru_stime.tv_sec) + Double(usage.ru_stime.tv_usec) / 1_000_000
+		return user + system
+	}
+
+	/// Returns the current resident memory of the process in bytes
+
+	static var currentResidentSize:UInt64
+	{
+		var info = mach_task_basic_info()
+		var count = mach_msg_type_number_t(MemoryLayout<mach_task_basic_info>.size / MemoryLayout<natural_t>.size)
+
+		let result = withUnsafeMutablePointer(to:&info)
+		{
+			$0.withMemoryRebound(to:integer_t.self, capacity:Int(count))
+			{
+				task_info(mach_task_self_, task_flavor_t(MACH_TASK_BASIC_INFO), $0, &count)
+			}
+		}
+
+		return result == KERN_SUCCESS ? info.resident_size : 0
+	}
+
+	/// Returns the peak resident memory of the process in bytes. On macOS ru_maxrss is measured in bytes.
+
+	static var peakResidentSize:UInt64
+	{
+		var usage = rusage()
+		getrusage(RUSAGE_SELF, &usage)
+		return UInt64(usage.ru_maxrss)
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,359 @@
+//----------------------------------------------------------------------------------------------------------------------
+//
+//  Copyright ©2026 Peter Baumgartner. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//----------------------------------------------------------------------------------------------------------------------
+
+
+import BXMediaBrowser
+import BXMediaBrowserFixtures
+import Combine
+import Foundation
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+/// The Scanner builds a Library without any user interface and drives it through the same phases as a user would:
+/// loading the Sources, expanding Containers down to a given depth, changing the Filter and sorting, and finally
+/// loading thumbnails and metadata. Each phase is measured separately.
+
+@MainActor final class Scanner
+{
+	/// The settings of a scan
+
+	struct Options
+	{
+		var folderURLs:[URL] = []
+		var fixtures:FixtureGenerator? = nil
+		var depth = 2
+		var searchString = ""
+		var sortType:Object.Filter.SortType = .alphabetical
+		var sortDirection:Object.Filter.SortDirection = .ascending
+		var loadThumbnails = false
+		var loadMetadata = false
+		var concurrency = 8
+		var timeout:TimeInterval = 60
+	}
+
+	let options:Options
+
+	/// The Library that is scanned
+
+	let library:Library
+
+	/// The Sources of the Library
+
+	private(set) var sources:[Source] = []
+
+	/// All Containers that were loaded so far
+
+	private(set) var loadedContainers:[Container] = []
+
+	/// The measured phases
+
+	private(set) var phases:[Phase] = []
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	/// Creates a Library with a Source for the specified folders and a FixtureSource for the fixtures
+
+	init(options:Options)
+	{
+		self.options = options
+		self.library = Library(identifier:"BXMediaBrowserScanner-\(UUID().uuidString)")
+		self.library.startupSnapshot = nil
+
+		let section = Section(identifier:"Scanner", name:nil, in:library)
+		var folderURLs = options.folderURLs
+		if let fixtures = options.fixtures { folderURLs.append(fixtures.mediaURL) }
+
+		if !folderURLs.isEmpty
+		{
+			section.addSource(ScannerFolderSource(folderURLs:folderURLs, in:library))
+		}
+
+		if let fixtures = options.fixtures
+		{
+			section.addSource(FixtureSource(fixtures:fixtures, in:library))
+		}
+
+		self.library.addSection(section)
+		self.sources = section.sources
+	}
+
+
+	/// Runs all phases and returns their measurements
+
+	func run() async throws -> [Phase]
+	{
+		try await measure("load sources")
+		{
+			var failures = 0
+
+			for source in self.sources
+			{
+				if try await !self.load(source) { failures += 1 }
+			}
+
+			return (self.sources.count,failures)
+		}
+
+		var containers = sources.flatMap { $0.containers }
+
+		for level in 1 ... max(options.depth,1)
+		{
+			guard !containers.isEmpty else { break }
+			let (loaded,phase) = try await self.loadContainers(containers, level:level)
+			phases.append(phase)
+			containers = loaded.flatMap { $0.containers }
+		}
+
+		try await measure("filter & sort")
+		{
+			try await self.filterAndSort()
+		}
+
+		if options.loadThumbnails
+		{
+			try await measure("thumbnails")
+			{
+				await self.loadObjects { _ = try await $0.loader.thumbnailImage }
+			}
+		}
+
+		if options.loadMetadata
+		{
+			try await measure("metadata")
+			{
+				await self.loadObjects { _ = try await $0.loader.metadata }
+			}
+		}
+
+		return phases
+	}
+
+
+	/// Measures a phase and appends it to the list of phases
+
+	private func measure(_ name:String, _ work:() async throws -> (items:Int, failures:Int)) async throws
+	{
+		let phase = try await Phase.measure(name, work)
+		phases.append(phase)
+	}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	// MARK: - Phases
+
+	/// Loads all Containers of one level of the hierarchy concurrently. Returns the Containers that were loaded
+	/// successfully, so that their subcontainers can be loaded in the next level.
+
+	private func loadContainers(_ containers:[Container], level:Int) async throws -> ([Container],Phase)
+	{
+		var loaded:[Container] = []
+
+		let phase = try await Phase.measure("containers level \(level)")
+		{
+			let observers = containers.map
+			{
+				container -> LoadingObserver in
+				let observer = LoadingObserver(container.$isLoading)
+				container.isExpanded = true
+				container.load(in:library)
+				return observer
+			}
+
+			for (container,observer) in zip(containers,observers)
+			{
+				if try await self.poll({ observer.didFinish }), container.isLoaded { loaded.append(container) }
+			}
+
+			return (containers.count, containers.count - loaded.count)
+		}
+
+		loadedContainers += loaded
+		return (loaded,phase)
+	}
+
+
+	/// Applies the search string and sort order to the Filters of all Sources, then loads the contents of all
+	/// previously loaded Containers again. The load handlers are called directly, so that the Container.Loader
+	/// doesn't return cached contents.
+
+	private func filterAndSort() async throws -> (items:Int, failures:Int)
+	{
+		for source in sources
+		{
+			source.filter.searchString = options.searchString
+			source.filter.sortType = options.sortType
+			source.filter.sortDirection = options.sortDirection
+		}
+
+		var objectCount = 0
+		var failures = 0
+
+		for container in loadedContainers
+		{
+			do
+			{
+				let (_,objects) = try await container.loader.loadHandler(container.identifier, container.data, container.filter, library)
+				objectCount += objects.count
+			}
+			catch
+			{
+				failures += 1
+			}
+		}
+
+		return (objectCount,failures)
+	}
+
+
+	/// Calls the handler for all Objects of the loaded folder Containers, running up to options.concurrency handlers
+	/// at the same time. Objects of the FixtureSource are skipped, since their thumbnails and metadata would be
+	/// downloaded from the web services.
+
+	private func loadObjects(_ handler:@escaping (Object) async throws -> Void) async -> (items:Int, failures:Int)
+	{
+		let objects = loadedContainers
+			.filter { !$0.identifier.hasPrefix(FixtureSource.identifier) }
+			.flatMap { container in container.objects.indices.map { container.objects[$0] } }
+
+		let concurrency = max(options.concurrency,1)
+		var failures = 0
+
+		await withTaskGroup(of:Bool.self)
+		{
+			group in
+
+			var iterator = objects.makeIterator()
+
+			for _ in 0 ..< concurrency
+			{
+				guard let object = iterator.next() else { break }
+				group.addTask { (try? await handler(object)) != nil }
+			}
+
+			while let success = await group.next()
+			{
+				if !success { failures += 1 }
+
+				if let object = iterator.next()
+				{
+					group.addTask { (try? await handler(object)) != nil }
+				}
+			}
+		}
+
+		return (objects.count,failures)
+	}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	// MARK: - Waiting
+
+	/// Loads a Source and waits until it has finished. Returns false if loading failed or timed out.
+
+	private func load(_ source:Source) async throws -> Bool
+	{
+		let observer = LoadingObserver(source.$isLoading)
+		source.load(in:library)
+		return try await self.poll { observer.didFinish } && source.isLoaded
+	}
+
+	/// Polls the condition until it becomes true or the timeout expires. Returns false in case of a timeout.
+
+	private func poll(_ condition:@MainActor ()->Bool) async throws -> Bool
+	{
+		let deadline = DispatchTime.now().uptimeNanoseconds + UInt64(options.timeout * 1_000_000_000)
+
+		while !condition()
+		{
+			guard DispatchTime.now().uptimeNanoseconds < deadline else { return false }
+			try await Task.sleep(nanoseconds:1_000_000)
+		}
+
+		return true
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+/// Observes the isLoading property of a Source or Container. Since loading is asynchronous, the observer must be
+/// created before loading is started, so that a quick load isn't missed.
+
+final class LoadingObserver
+{
+	private(set) var didFinish = false
+	private var didStart = false
+	private var observer:AnyCancellable? = nil
+
+	init(_ isLoading:Published<Bool>.Publisher)
+	{
+		self.observer = isLoading.sink
+		{
+			[unowned self] isLoading in
+
+			if isLoading
+			{
+				self.didStart = true
+			}
+			else if self.didStart
+			{
+				self.didFinish = true
+			}
+		}
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+/// A FolderSource for the folders that were specified on the command line
+
+final class ScannerFolderSource : FolderSource
+{
+	let folderURLs:[URL]
+
+	init(folderURLs:[URL], in library:Library?)
+	{
+		self.folderURLs = folderURLs
+		super.init(filter:FolderFilter(), in:library)
+	}
+
+	override func defaultContainers(with filter:FolderFilter) async throws -> [Container]
+	{
+		try folderURLs.compactMap { try self.createContainer(for:$0, filter:filter, in:library) }
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,243 @@
+//----------------------------------------------------------------------------------------------------------------------
+//
+//  Copyright ©2026 Peter Baumgartner. All rights reserved.
+//
+//  Permission is hereby granted, free of charge, to any person obtaining a copy
+//  of this software and associated documentation files (the "Software"), to deal
+//  in the Software without restriction, including without limitation the rights
+//  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+//  copies of the Software, and to permit persons to whom the Software is
+//  furnished to do so, subject to the following conditions:
+//
+//  The above copyright notice and this permission notice shall be included in
+//  all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+//  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+//  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+//  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+//  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+//  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+//  THE SOFTWARE.
+//
+//----------------------------------------------------------------------------------------------------------------------
+
+
+import BXMediaBrowser
+import BXMediaBrowserFixtures
+import Foundation
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+/// Scans folders (and optionally synthetic fixtures) with a headless Library and prints timing and memory statistics
+/// for each phase. This makes it possible to profile scanning with Instruments or to run stress tests without the
+/// SwiftUI front end.
+///
+///     swift run -c release BXMediaBrowserScanner --depth 3 --thumbnails --metadata ~/Pictures
+
+@main struct ScannerCommand
+{
+	struct Options
+	{
+		var scanner = Scanner.Options()
+		var generateFixtures = false
+		var configuration = FixtureGenerator.Configuration()
+		var fixturesURL = FileManager.default.temporaryDirectory.appendingPathComponent("BXMediaBrowserScanner", isDirectory:true)
+		var keepFixtures = false
+		var repetitions = 1
+		var traceURL:URL? = nil
+	}
+
+	static let usage = """
+		Usage: BXMediaBrowserScanner [options] [folder ...]
+
+		  --fixtures                Generate and scan synthetic fixtures (default if no folder is specified)
+		  --files <n>               Number of media files in the fixture root folder (default 2000)
+		  --folders <n>             Number of fixture subfolders (default 20)
+		  --files-per-folder <n>    Number of media files in each fixture subfolder (default 10)
+		  --pages <n>               Number of JSON pages per web service fixture (default 10)
+		  --page-size <n>           Number of assets per JSON page (default 80)
+		  --keep-fixtures           Don't delete the fixtures when done
+		  --depth <n>               Number of Container levels to load (default 2)
+		  --search <text>           Search string that is applied in the filter phase
+		  --sort <type>             alphabetical, creationDate, captureDate, rating or useCount (default alphabetical)
+		  --descending              Sort in descending order
+		  --thumbnails              Load the thumbnails of all Objects
+		  --metadata                Load the metadata of all Objects
+		  --concurrency <n>         Number of Objects that are loaded at the same time (default 8)
+		  --timeout <seconds>       Time after which loading a Container counts as failed (default 60)
+		  --repeat <n>              Repeat the scan with a new Library (default 1)
+		  --trace <path>            Write the recorded intervals as Chrome trace JSON
+		"""
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	static func main() async
+	{
+		do
+		{
+			var options = try Self.parse(Array(CommandLine.arguments.dropFirst()))
+
+			if options.scanner.folderURLs.isEmpty
+			{
+				options.generateFixtures = true
+			}
+
+			if options.traceURL != nil
+			{
+				TraceRecorder.shared.isEnabled = true
+			}
+
+			// Generate the fixtures
+
+			if options.generateFixtures
+			{
+				let fixtures = FixtureGenerator(configuration:options.configuration, rootURL:options.fixturesURL)
+
+				let phase = try await Phase.measure("generate fixtures")
+				{
+					try fixtures.generate()
+					return (options.configuration.fileCount + options.configuration.folderCount * options.configuration.filesPerFolder, 0)
+				}
+
+				print(Phase.header)
+				print(phase.summary)
+				options.scanner.fixtures = fixtures
+			}
+
+			defer
+			{
+				if let fixtures = options.scanner.fixtures, !options.keepFixtures
+				{
+					try? FileManager.default.removeItem(at:fixtures.rootURL)
+				}
+			}
+
+			// Run the scans
+
+			for i in 0 ..< options.repetitions
+			{
+				let scanner = await Scanner(options:options.scanner)
+				let phases = try await scanner.run()
+
+				print(options.repetitions > 1 ? "\nScan \(i+1) of \(options.repetitions)" : "")
+				print(Phase.header)
+				phases.forEach { print($0.summary) }
+			}
+
+			if let url = options.traceURL
+			{
+				try TraceRecorder.shared.writeChromeTrace(to:url)
+				print("\nTrace written to \(url.path)")
+			}
+		}
+		catch let error as Error
+		{
+			print(error.description)
+			print(usage)
+			exit(2)
+		}
+		catch
+		{
+			print("Scan failed: \(error)")
+			exit(1)
+		}
+
+		exit(0)
+	}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	// MARK: - Arguments
+
+	static func parse(_ arguments:[String]) throws -> Options
+	{
+		var options = Options()
+		var arguments = arguments[...]
+
+		func value() throws -> String
+		{
+			guard let value = arguments.popFirst() else { throw Error.missingValue }
+			return value
+		}
+
+		func number() throws -> Int
+		{
+			let string = try value()
+			guard let number = Int(string), number >= 0 else { throw Error.invalidValue(string) }
+			return number
+		}
+
+		func sortType() throws -> Object.Filter.SortType
+		{
+			let string = try value()
+			let sortTypes:[Object.Filter.SortType] = [.alphabetical, .creationDate, .captureDate, .rating, .useCount]
+			guard sortTypes.contains(string) else { throw Error.invalidValue(string) }
+			return string
+		}
+
+		while let argument = arguments.popFirst()
+		{
+			switch argument
+			{
+				case "--fixtures": options.generateFixtures = true
+				case "--files": options.configuration.fileCount = try number()
+				case "--folders": options.configuration.folderCount = try number()
+				case "--files-per-folder": options.configuration.filesPerFolder = try number()
+				case "--pages": options.configuration.pageCount = try number()
+				case "--page-size": options.configuration.pageSize = try number()
+				case "--keep-fixtures": options.keepFixtures = true
+				case "--depth": options.scanner.depth = max(try number(),1)
+				case "--search": options.scanner.searchString = try value()
+				case "--sort": options.scanner.sortType = try sortType()
+				case "--descending": options.scanner.sortDirection = .descending
+				case "--thumbnails": options.scanner.loadThumbnails = true
+				case "--metadata": options.scanner.loadMetadata = true
+				case "--concurrency": options.scanner.concurrency = max(try number(),1)
+				case "--timeout": options.scanner.timeout = TimeInterval(max(try number(),1))
+				case "--repeat": options.repetitions = max(try number(),1)
+				case "--trace": options.traceURL = URL(fileURLWithPath:try value())
+				case "--help", "-h": print(usage); exit(0)
+
+				default:
+
+					guard !argument.hasPrefix("-") else { throw Error.unknownArgument(argument) }
+					let url = URL(fileURLWithPath:(argument as NSString).expandingTildeInPath, isDirectory:true)
+					var isDirectory:ObjCBool = false
+					guard FileManager.default.fileExists(atPath:url.path, isDirectory:&isDirectory), isDirectory.boolValue else { throw Error.notAFolder(argument) }
+					options.scanner.folderURLs.append(url)
+			}
+		}
+
+		return options
+	}
+
+
+	enum Error : Swift.Error, CustomStringConvertible
+	{
+		case missingValue
+		case invalidValue(String)
+		case unknownArgument(String)
+		case notAFolder(String)
+
+		var description:String
+		{
+			switch self
+			{
+				case .missingValue: return "Missing value for argument"
+				case .invalidValue(let value): return "Invalid value \(value)"
+				case .unknownArgument(let argument): return "Unknown argument \(argument)"
+				case .notAFolder(let path): return "\(path) is not a folder"
+			}
+		}
+	}
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
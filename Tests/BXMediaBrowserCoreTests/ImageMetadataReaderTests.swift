@@ -0,0 +1,625 @@
+import XCTest
+@testable import BXMediaBrowserCore
+
+#if canImport(ImageIO)
+import ImageIO
+#endif
+
+final class ImageMetadataReaderTests: XCTestCase
+{
+	typealias Metadata = ImageMetadataReader.Metadata
+	
+	let reader = ImageMetadataReader()
+	
+	// MARK: - Conformance
+	
+	func testJPEG() throws
+	{
+		let metadata = try XCTUnwrap(reader.metadata(from:Fixtures.jpeg()))
+		
+		XCTAssertEqual(metadata.format, .jpeg)
+		XCTAssertEqual(metadata.pixelWidth, 4000)
+		XCTAssertEqual(metadata.pixelHeight, 3000)
+		XCTAssertEqual(metadata.profileName, "Display P3")
+		XCTAssertEqual(metadata.rating, 4)
+		XCTAssertEqual(metadata.keywords, ["Beach","Sunset"])
+		XCTAssertEqual(metadata.caption, "Evening at the beach")
+		Self.assertEXIF(metadata)
+	}
+	
+	func testPNG() throws
+	{
+		let metadata = try XCTUnwrap(reader.metadata(from:Fixtures.png()))
+		
+		XCTAssertEqual(metadata.format, .png)
+		XCTAssertEqual(metadata.pixelWidth, 640)
+		XCTAssertEqual(metadata.pixelHeight, 480)
+		XCTAssertEqual(metadata.rating, 4)
+		XCTAssertEqual(metadata.keywords, ["Beach","Sunset"])
+		Self.assertEXIF(metadata)
+	}
+	
+	func testTIFF() throws
+	{
+		let metadata = try XCTUnwrap(reader.metadata(from:Fixtures.tiff(littleEndian:false, isDNG:false)))
+		
+		XCTAssertEqual(metadata.format, .tiff)
+		XCTAssertEqual(metadata.pixelWidth, 1200)
+		XCTAssertEqual(metadata.pixelHeight, 800)
+		XCTAssertEqual(metadata.rating, 4)
+		Self.assertEXIF(metadata)
+	}
+	
+	func testDNG() throws
+	{
+		// The DNG has a reduced resolution preview in IFD0 and the full resolution image in a SubIFD
+		
+		let metadata = try XCTUnwrap(reader.metadata(from:Fixtures.tiff(littleEndian:true, isDNG:true)))
+		
+		XCTAssertEqual(metadata.format, .tiff)
+		XCTAssertEqual(metadata.pixelWidth, 6000)
+		XCTAssertEqual(metadata.pixelHeight, 4000)
+		Self.assertEXIF(metadata)
+	}
+	
+	func testHEIF() throws
+	{
+		let metadata = try XCTUnwrap(reader.metadata(from:Fixtures.heif()))
+		
+		XCTAssertEqual(metadata.format, .heif)
+		XCTAssertEqual(metadata.pixelWidth, 4032)
+		XCTAssertEqual(metadata.pixelHeight, 3024)
+		Self.assertEXIF(metadata)
+	}
+	
+	func testTagSelection() throws
+	{
+		let reader = ImageMetadataReader(tags:[.captureDate])
+		let metadata = try XCTUnwrap(reader.metadata(from:Fixtures.jpeg()))
+		
+		XCTAssertEqual(metadata.captureDate, "2024:05:01 18:42:07")
+		XCTAssertNil(metadata.make)
+		XCTAssertNil(metadata.pixelWidth)
+		XCTAssertNil(metadata.rating)
+		XCTAssertEqual(metadata.keywords, [])
+	}
+	
+	func testDictionaryLayout() throws
+	{
+		let dict = try XCTUnwrap(reader.metadata(from:Fixtures.jpeg())).dictionary
+		let exif = try XCTUnwrap(dict["{Exif}"] as? [String:Any])
+		let tiff = try XCTUnwrap(dict["{TIFF}"] as? [String:Any])
+		
+		XCTAssertEqual(dict["PixelWidth"] as? Int, 4000)
+		XCTAssertEqual(exif["DateTimeOriginal"] as? String, "2024:05:01 18:42:07")
+		XCTAssertEqual(exif["FocalLength"] as? Int, 50)
+		XCTAssertEqual(exif["FNumber"] as? Double, 2.8)
+		XCTAssertEqual(tiff["Model"] as? String, "X100V")
+	}
+	
+	func testUnsupportedAndCorruptFiles() throws
+	{
+		XCTAssertNil(reader.metadata(from:Data("GIF89a".utf8)))
+		XCTAssertNil(reader.metadata(from:Data()))
+		
+		// Truncated files must never crash, no matter where they are cut off
+		
+		for fixture in [Fixtures.jpeg(), Fixtures.png(), Fixtures.tiff(littleEndian:true, isDNG:true), Fixtures.heif()]
+		{
+			for length in stride(from:0, to:fixture.count, by:7)
+			{
+				_ = reader.metadata(from:fixture.prefix(length))
+			}
+		}
+	}
+	
+	/// A HEIF box with a 64 bit largesize that doesn't fit the file (or even overflows Int) must be ignored
+	
+	func testHEIFLargesizeOverflow() throws
+	{
+		for largesize:UInt64 in [UInt64.max, UInt64(Int.max), UInt64(Int.max) - 4]
+		{
+			var w = Fixtures.Writer()
+			w.u32(20); w.ascii("ftyp"); w.ascii("heic"); w.u32(0); w.ascii("mif1")
+			w.u32(1); w.ascii("meta"); w.u32(UInt32(largesize >> 32)); w.u32(UInt32(largesize & 0xFFFFFFFF))
+			w.append(Data(count:32))
+			
+			let metadata = try XCTUnwrap(reader.metadata(from:w.data))
+			XCTAssertEqual(metadata.format, .heif)
+			XCTAssertNil(metadata.pixelWidth)
+		}
+	}
+	
+	/// An iloc extent whose base offset plus extent offset overflows must be dropped
+	
+	func testHEIFExtentOverflow() throws
+	{
+		func box(_ type:String, _ payload:Data) -> Data
+		{
+			var w = Fixtures.Writer()
+			w.u32(UInt32(payload.count + 8)); w.ascii(type); w.append(payload)
+			return w.data
+		}
+		
+		var infe = Fixtures.Writer(); infe.u8(2); infe.u8(0); infe.u16(0); infe.u16(1); infe.u16(0); infe.ascii("Exif\0")
+		var iinf = Fixtures.Writer(); iinf.u32(0); iinf.u16(1); iinf.append(box("infe", infe.data))
+		
+		// Version 0, 8 byte offsets, lengths and base offsets, one item with one extent
+		
+		var iloc = Fixtures.Writer(); iloc.u32(0); iloc.u8(0x88); iloc.u8(0x80); iloc.u16(1)
+		iloc.u16(1); iloc.u16(0)
+		iloc.u32(0x7FFFFFFF); iloc.u32(0xFFFFFFF0)
+		iloc.u16(1)
+		iloc.u32(0x7FFFFFFF); iloc.u32(0xFFFFFFF0)
+		iloc.u32(0); iloc.u32(16)
+		
+		var meta = Fixtures.Writer(); meta.u32(0); meta.append(box("iinf", iinf.data)); meta.append(box("iloc", iloc.data))
+		
+		var w = Fixtures.Writer()
+		w.u32(20); w.ascii("ftyp"); w.ascii("heic"); w.u32(0); w.ascii("mif1")
+		w.append(box("meta", meta.data))
+		
+		let metadata = try XCTUnwrap(reader.metadata(from:w.data))
+		XCTAssertNil(metadata.make)
+	}
+	
+	static func assertEXIF(_ metadata:Metadata, file:StaticString = #filePath, line:UInt = #line)
+	{
+		XCTAssertEqual(metadata.make, "FUJIFILM", file:file, line:line)
+		XCTAssertEqual(metadata.model, "X100V", file:file, line:line)
+		XCTAssertEqual(metadata.orientation, 6, file:file, line:line)
+		XCTAssertEqual(metadata.captureDate, "2024:05:01 18:42:07", file:file, line:line)
+		XCTAssertEqual(metadata.exposureTime, 1.0/125.0, file:file, line:line)
+		XCTAssertEqual(metadata.fNumber, 2.8, file:file, line:line)
+		XCTAssertEqual(metadata.isoSpeed, 400, file:file, line:line)
+		XCTAssertEqual(metadata.focalLength, 50, file:file, line:line)
+		XCTAssertEqual(metadata.lensModel, "23mm F2", file:file, line:line)
+	}
+	
+	// MARK: - Comparison with ImageIO
+	
+	#if canImport(ImageIO)
+	
+	/// Writes a real JPEG file with ImageIO and checks that both readers agree on the shared tags
+	
+	func testConformanceWithImageIO() throws
+	{
+		let url = try Fixtures.imageIOJPEG()
+		defer { try? FileManager.default.removeItem(at:url) }
+		
+		let dict = try XCTUnwrap(reader.metadata(for:url)).dictionary
+		let source = try XCTUnwrap(CGImageSourceCreateWithURL(url as CFURL,nil))
+		let reference = try XCTUnwrap(CGImageSourceCopyPropertiesAtIndex(source,0,nil) as? [String:Any])
+		
+		XCTAssertEqual(dict["PixelWidth"] as? Int, reference["PixelWidth"] as? Int)
+		XCTAssertEqual(dict["PixelHeight"] as? Int, reference["PixelHeight"] as? Int)
+		
+		let exif = try XCTUnwrap(dict["{Exif}"] as? [String:Any])
+		let referenceExif = try XCTUnwrap(reference["{Exif}"] as? [String:Any])
+		
+		for key in ["DateTimeOriginal","LensModel"]
+		{
+			XCTAssertEqual(exif[key] as? String, referenceExif[key] as? String, key)
+		}
+		
+		for key in ["FNumber","ExposureTime","FocalLength"]
+		{
+			let value = try XCTUnwrap(exif[key] as? Double, key)
+			let referenceValue = try XCTUnwrap(referenceExif[key] as? Double, key)
+			XCTAssertEqual(value, referenceValue, accuracy:0.0001, key)
+		}
+		
+		XCTAssertEqual(exif["ISOSpeedRatings"] as? [Int], referenceExif["ISOSpeedRatings"] as? [Int])
+		
+		let tiff = try XCTUnwrap(dict["{TIFF}"] as? [String:Any])
+		let referenceTIFF = try XCTUnwrap(reference["{TIFF}"] as? [String:Any])
+		XCTAssertEqual(tiff["Make"] as? String, referenceTIFF["Make"] as? String)
+		XCTAssertEqual(tiff["Model"] as? String, referenceTIFF["Model"] as? String)
+	}
+	
+	// MARK: - Benchmarks
+	
+	/// The current path: CGImageSourceCopyPropertiesAtIndex
+	
+	func testPerformanceImageIO() throws
+	{
+		let url = try Fixtures.imageIOJPEG()
+		defer { try? FileManager.default.removeItem(at:url) }
+		
+		measure
+		{
+			for _ in 0 ..< 200
+			{
+				let source = CGImageSourceCreateWithURL(url as CFURL,nil)!
+				let properties = CGImageSourceCopyPropertiesAtIndex(source,0,nil) as? [String:Any]
+				XCTAssertNotNil(properties)
+			}
+		}
+	}
+	
+	/// The same files with the ImageMetadataReader
+	
+	func testPerformanceImageMetadataReader() throws
+	{
+		let url = try Fixtures.imageIOJPEG()
+		defer { try? FileManager.default.removeItem(at:url) }
+		
+		measure
+		{
+			for _ in 0 ..< 200
+			{
+				let dict = try? reader.metadata(for:url)?.dictionary
+				XCTAssertNotNil(dict)
+			}
+		}
+	}
+	
+	#endif
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+/// Builds a small corpus of image files with known metadata values
+
+enum Fixtures
+{
+	/// A TIFF IFD value
+	
+	enum Value
+	{
+		case ascii(String)
+		case short(UInt16)
+		case long(UInt32)
+		case rational(UInt32,UInt32)
+		case undefined(Data)
+		case pointer(Int)
+		case pointers([Int])
+	}
+	
+	typealias IFD = [(tag:UInt16, value:Value)]
+	
+	/// A little helper for writing binary data
+	
+	struct Writer
+	{
+		var data = Data()
+		var littleEndian = false
+		
+		mutating func u8(_ value:UInt8) { data.append(value) }
+		
+		mutating func u16(_ value:UInt16)
+		{
+			let bytes = [UInt8(value >> 8), UInt8(value & 0xFF)]
+			data.append(contentsOf:littleEndian ? bytes.reversed() : bytes)
+		}
+		
+		mutating func u32(_ value:UInt32)
+		{
+			let bytes = [UInt8(value >> 24), UInt8((value >> 16) & 0xFF), UInt8((value >> 8) & 0xFF), UInt8(value & 0xFF)]
+			data.append(contentsOf:littleEndian ? bytes.reversed() : bytes)
+		}
+		
+		mutating func ascii(_ string:String) { data.append(contentsOf:Array(string.utf8)) }
+		mutating func append(_ other:Data) { data.append(other) }
+	}
+	
+	// MARK: TIFF
+	
+	static let exifIFD:IFD =
+	[
+		(0x829A, .rational(1,125)),
+		(0x829D, .rational(28,10)),
+		(0x8827, .short(400)),
+		(0x9003, .ascii("2024:05:01 18:42:07")),
+		(0x920A, .rational(50,1)),
+		(0xA434, .ascii("23mm F2")),
+	]
+	
+	/// Returns a TIFF structure. The first IFD is IFD0, pointer values refer to the index of other IFDs.
+	
+	static func tiff(_ ifds:[IFD], littleEndian:Bool) -> Data
+	{
+		func payload(_ value:Value, _ offsets:[Int]) -> (type:UInt16, count:Int, bytes:Data)
+		{
+			var w = Writer(littleEndian:littleEndian)
+			
+			switch value
+			{
+				case .ascii(let string): w.ascii(string); w.u8(0); return (2, w.data.count, w.data)
+				case .short(let value): w.u16(value); return (3, 1, w.data)
+				case .long(let value): w.u32(value); return (4, 1, w.data)
+				case .rational(let a, let b): w.u32(a); w.u32(b); return (5, 1, w.data)
+				case .undefined(let data): w.append(data); return (7, data.count, w.data)
+				case .pointer(let index): w.u32(UInt32(offsets[index])); return (4, 1, w.data)
+				case .pointers(let indexes): indexes.forEach { w.u32(UInt32(offsets[$0])) }; return (4, indexes.count, w.data)
+			}
+		}
+		
+		// First pass: compute the offset of each IFD
+		
+		let dummyOffsets = [Int](repeating:0, count:ifds.count)
+		var offsets:[Int] = []
+		var offset = 8
+		
+		for ifd in ifds
+		{
+			offsets.append(offset)
+			offset += 2 + 12*ifd.count + 4
+			
+			for entry in ifd
+			{
+				let n = payload(entry.value, dummyOffsets).bytes.count
+				if n > 4 { offset += n + n%2 }
+			}
+		}
+		
+		// Second pass: write the IFDs, each followed by its out-of-line values
+		
+		var w = Writer(littleEndian:littleEndian)
+		w.ascii(littleEndian ? "II" : "MM")
+		w.u16(42)
+		w.u32(8)
+		
+		for (i,ifd) in ifds.enumerated()
+		{
+			var dataOffset = offsets[i] + 2 + 12*ifd.count + 4
+			var extra = Data()
+			
+			w.u16(UInt16(ifd.count))
+			
+			for entry in ifd
+			{
+				let (type,count,bytes) = payload(entry.value, offsets)
+				w.u16(entry.tag)
+				w.u16(type)
+				w.u32(UInt32(count))
+				
+				if bytes.count <= 4
+				{
+					w.append(bytes + Data(count:4-bytes.count))
+				}
+				else
+				{
+					w.u32(UInt32(dataOffset))
+					extra.append(bytes)
+					if bytes.count % 2 != 0 { extra.append(0) }
+					dataOffset += bytes.count + bytes.count%2
+				}
+			}
+			
+			w.u32(0)
+			w.append(extra)
+		}
+		
+		return w.data
+	}
+	
+	/// The EXIF block that is embedded in JPEG, PNG and HEIF files
+	
+	static func exif(littleEndian:Bool) -> Data
+	{
+		let ifd0:IFD =
+		[
+			(0x010F, .ascii("FUJIFILM")),
+			(0x0110, .ascii("X100V")),
+			(0x0112, .short(6)),
+			(0x8769, .pointer(1)),
+		]
+		
+		return tiff([ifd0,exifIFD], littleEndian:littleEndian)
+	}
+	
+	/// A standalone TIFF or DNG file
+	
+	static func tiff(littleEndian:Bool, isDNG:Bool) -> Data
+	{
+		var ifd0:IFD =
+		[
+			(0x00FE, .long(isDNG ? 1 : 0)),
+			(0x0100, .long(isDNG ? 256 : 1200)),
+			(0x0101, .long(isDNG ? 171 : 800)),
+			(0x010F, .ascii("FUJIFILM")),
+			(0x0110, .ascii("X100V")),
+			(0x0112, .short(6)),
+			(0x02BC, .undefined(Data(xmp.utf8))),
+			(0x8769, .pointer(1)),
+		]
+		
+		if isDNG
+		{
+			ifd0.append((0x014A, .pointers([2])))
+			
+			let subIFD:IFD =
+			[
+				(0x00FE, .long(0)),
+				(0x0100, .long(6000)),
+				(0x0101, .long(4000)),
+			]
+			
+			return tiff([ifd0,exifIFD,subIFD], littleEndian:littleEndian)
+		}
+		
+		return tiff([ifd0,exifIFD], littleEndian:littleEndian)
+	}
+	
+	// MARK: XMP, IPTC, ICC
+	
+	static let xmp = """
+		<?xpacket begin="" id="W5M0MpCehiHzreSzNTczkc9d"?>
+		<x:xmpmeta xmlns:x="adobe:ns:meta/">
+		<rdf:RDF xmlns:rdf="http://www.w3.org/1999/02/22-rdf-syntax-ns#">
+		<rdf:Description rdf:about="" xmlns:xmp="http://ns.adobe.com/xap/1.0/" xmlns:dc="http://purl.org/dc/elements/1.1/" xmp:Rating="4">
+		<dc:subject><rdf:Bag><rdf:li>Beach</rdf:li><rdf:li>Sunset</rdf:li></rdf:Bag></dc:subject>
+		<dc:description><rdf:Alt><rdf:li xml:lang="x-default">Evening at the beach</rdf:li></rdf:Alt></dc:description>
+		</rdf:Description>
+		</rdf:RDF>
+		</x:xmpmeta>
+		<?xpacket end="w"?>
+		"""
+	
+	static func iptc() -> Data
+	{
+		var iim = Writer()
+		
+		for keyword in ["Beach","Sunset"]
+		{
+			iim.u8(0x1C); iim.u8(2); iim.u8(25); iim.u16(UInt16(keyword.utf8.count)); iim.ascii(keyword)
+		}
+		
+		var w = Writer()
+		w.ascii("Photoshop 3.0\0")
+		w.ascii("8BIM")
+		w.u16(0x0404)
+		w.u8(0); w.u8(0)
+		w.u32(UInt32(iim.data.count))
+		w.append(iim.data)
+		if iim.data.count % 2 != 0 { w.u8(0) }
+		return w.data
+	}
+	
+	static func icc(name:String) -> Data
+	{
+		var w = Writer()
+		w.append(Data(count:128))
+		w.u32(1)
+		w.ascii("desc"); w.u32(144); w.u32(UInt32(12 + name.utf8.count + 1))
+		w.ascii("desc"); w.u32(0); w.u32(UInt32(name.utf8.count + 1)); w.ascii(name); w.u8(0)
+		return w.data
+	}
+	
+	// MARK: Containers
+	
+	static func jpeg() -> Data
+	{
+		var w = Writer()
+		
+		func segment(_ marker:UInt8, _ payload:Data)
+		{
+			w.u8(0xFF); w.u8(marker); w.u16(UInt16(payload.count + 2)); w.append(payload)
+		}
+		
+		w.u8(0xFF); w.u8(0xD8)
+		segment(0xE0, Data("JFIF\0".utf8) + Data([1,1,0,0,1,0,1,0,0]))
+		segment(0xE1, Data("Exif\0\0".utf8) + exif(littleEndian:true))
+		segment(0xE1, Data("http://ns.adobe.com/xap/1.0/\0".utf8) + Data(xmp.utf8))
+		segment(0xE2, Data("ICC_PROFILE\0".utf8) + Data([1,1]) + icc(name:"Display P3"))
+		segment(0xED, iptc())
+		segment(0xC0, Data([8, 0x0B,0xB8, 0x0F,0xA0, 3]))
+		segment(0xDA, Data([0]))
+		w.append(Data([0x12,0x34,0x56]))
+		w.u8(0xFF); w.u8(0xD9)
+		return w.data
+	}
+	
+	static func png() -> Data
+	{
+		var w = Writer()
+		
+		func chunk(_ type:String, _ payload:Data)
+		{
+			w.u32(UInt32(payload.count)); w.ascii(type); w.append(payload); w.u32(0)
+		}
+		
+		var ihdr = Writer()
+		ihdr.u32(640); ihdr.u32(480); ihdr.append(Data([8,6,0,0,0]))
+		
+		w.append(Data([0x89,0x50,0x4E,0x47,0x0D,0x0A,0x1A,0x0A]))
+		chunk("IHDR", ihdr.data)
+		chunk("eXIf", exif(littleEndian:false))
+		chunk("IDAT", Data([0,1,2,3]))
+		chunk("iTXt", Data("XML:com.adobe.xmp\0\0\0\0\0".utf8) + Data(xmp.utf8))
+		chunk("IEND", Data())
+		return w.data
+	}
+	
+	static func heif() -> Data
+	{
+		func box(_ type:String, _ payload:Data) -> Data
+		{
+			var w = Writer()
+			w.u32(UInt32(payload.count + 8)); w.ascii(type); w.append(payload)
+			return w.data
+		}
+		
+		func fullBox(_ type:String, version:UInt8 = 0, flags:UInt8 = 0, _ payload:Data) -> Data
+		{
+			box(type, Data([version,0,0,flags]) + payload)
+		}
+		
+		func meta(exifOffset:Int, exifLength:Int) -> Data
+		{
+			var pitm = Writer(); pitm.u16(1)
+			
+			var infe1 = Writer(); infe1.u16(1); infe1.u16(0); infe1.ascii("hvc1\0")
+			var infe2 = Writer(); infe2.u16(2); infe2.u16(0); infe2.ascii("Exif\0")
+			var iinf = Writer(); iinf.u16(2)
+			iinf.append(fullBox("infe", version:2, infe1.data))
+			iinf.append(fullBox("infe", version:2, infe2.data))
+			
+			var iloc = Writer(); iloc.u8(0x44); iloc.u8(0x00); iloc.u16(1)
+			iloc.u16(2); iloc.u16(0); iloc.u16(1); iloc.u32(UInt32(exifOffset)); iloc.u32(UInt32(exifLength))
+			
+			var ispe = Writer(); ispe.u32(4032); ispe.u32(3024)
+			var ipma = Writer(); ipma.u32(1); ipma.u16(1); ipma.u8(1); ipma.u8(0x81)
+			let iprp = box("iprp", box("ipco", fullBox("ispe", ispe.data)) + fullBox("ipma", ipma.data))
+			
+			var hdlr = Writer(); hdlr.u32(0); hdlr.ascii("pict"); hdlr.append(Data(count:13))
+			
+			return fullBox("meta",
+				fullBox("hdlr", hdlr.data) +
+				fullBox("pitm", pitm.data) +
+				fullBox("iinf", iinf.data) +
+				fullBox("iloc", iloc.data) +
+				iprp)
+		}
+		
+		var exifPayload = Writer(); exifPayload.u32(0)
+		exifPayload.append(exif(littleEndian:false))
+		
+		let ftyp = box("ftyp", Data("heic\0\0\0\0mif1heic".utf8))
+		let metaLength = meta(exifOffset:0, exifLength:0).count
+		let exifOffset = ftyp.count + metaLength + 8
+		
+		return ftyp + meta(exifOffset:exifOffset, exifLength:exifPayload.data.count) + box("mdat", exifPayload.data)
+	}
+	
+	#if canImport(ImageIO)
+	
+	/// Writes a real JPEG file with EXIF properties using ImageIO
+	
+	static func imageIOJPEG() throws -> URL
+	{
+		let url = FileManager.default.temporaryDirectory.appendingPathComponent("ImageMetadataReaderTests-\(UUID().uuidString).jpg")
+		let context = CGContext(data:nil, width:1600, height:1200, bitsPerComponent:8, bytesPerRow:0, space:CGColorSpaceCreateDeviceRGB(), bitmapInfo:CGImageAlphaInfo.premultipliedLast.rawValue)!
+		context.setFillColor(CGColor(red:0.8, green:0.4, blue:0.2, alpha:1.0))
+		context.fill(CGRect(x:0, y:0, width:1600, height:1200))
+		let image = context.makeImage()!
+		
+		let properties:[String:Any] =
+		[
+			kCGImagePropertyExifDictionary as String :
+			[
+				kCGImagePropertyExifDateTimeOriginal as String : "2024:05:01 18:42:07",
+				kCGImagePropertyExifFNumber as String : 2.8,
+				kCGImagePropertyExifExposureTime as String : 0.008,
+				kCGImagePropertyExifISOSpeedRatings as String : [400],
+				kCGImagePropertyExifFocalLength as String : 50,
+				kCGImagePropertyExifLensModel as String : "23mm F2",
+			],
+			kCGImagePropertyTIFFDictionary as String :
+			[
+				kCGImagePropertyTIFFMake as String : "FUJIFILM",
+				kCGImagePropertyTIFFModel as String : "X100V",
+			]
+		]
+		
+		let destination = CGImageDestinationCreateWithURL(url as CFURL, "public.jpeg" as CFString, 1, nil)!
+		CGImageDestinationAddImage(destination, image, properties as CFDictionary)
+		guard CGImageDestinationFinalize(destination) else { throw CocoaError(.fileWriteUnknown) }
+		return url
+	}
+	
+	#endif
+}
@@ -0,0 +1,160 @@
+import XCTest
+@testable import BXMediaBrowserCore
+
+final class ListDiffTests: XCTestCase
+{
+	/// A list element with a stable identifier and mutable content
+	
+	struct Item : Equatable
+	{
+		var id:Int
+		var version = 0
+	}
+	
+	static func batch(_ old:[Item], _ new:[Item]) -> ListDiff.Batch
+	{
+		ListDiff.batch(from:old, to:new, identifiedBy:{ $0.id }, isUpdated:{ $0.version != $1.version })
+	}
+	
+	/// Applies random edits to a list
+	
+	static func mutate(_ items:[Item], edits:Int, using random:inout SystemRandomNumberGenerator, nextID:inout Int) -> [Item]
+	{
+		var items = items
+		
+		for _ in 0 ..< edits
+		{
+			switch Int.random(in:0..<4, using:&random)
+			{
+				case 0 where !items.isEmpty:
+					items.remove(at:Int.random(in:items.indices, using:&random))
+				
+				case 1:
+					items.insert(Item(id:nextID), at:Int.random(in:0...items.count, using:&random))
+					nextID += 1
+				
+				case 2 where !items.isEmpty:
+					let item = items.remove(at:Int.random(in:items.indices, using:&random))
+					items.insert(item, at:Int.random(in:0...items.count, using:&random))
+				
+				case 3 where !items.isEmpty:
+					items[Int.random(in:items.indices, using:&random)].version += 1
+				
+				default:
+					break
+			}
+		}
+		
+		return items
+	}
+	
+	// MARK: - Correctness
+	
+	func testRandomEditsRoundtrip() throws
+	{
+		var random = SystemRandomNumberGenerator()
+		
+		for _ in 0 ..< 2000
+		{
+			var nextID = 1000
+			let old = (0 ..< Int.random(in:0...40, using:&random)).map { Item(id:$0) }
+			let new = Self.mutate(old, edits:Int.random(in:0...8, using:&random), using:&random, nextID:&nextID)
+			let batch = Self.batch(old,new)
+			
+			XCTAssertEqual(batch.applied(to:old, new:new), new)
+			XCTAssertEqual(batch.deletes, batch.deletes.sorted())
+			XCTAssertEqual(batch.inserts, batch.inserts.sorted())
+			XCTAssertEqual(batch.updates, batch.updates.sorted())
+		}
+	}
+	
+	func testDuplicateIdentifiers() throws
+	{
+		let old = [1,2,1,3,1].map { Item(id:$0) }
+		let new = [1,3,1,2].map { Item(id:$0) }
+		let batch = Self.batch(old,new)
+		
+		XCTAssertEqual(batch.applied(to:old, new:new), new)
+		XCTAssertEqual(batch.deletes.count, 1)
+		XCTAssertEqual(batch.inserts, [])
+	}
+	
+	func testSingleMoveIsMinimal() throws
+	{
+		let old = (0 ..< 1000).map { Item(id:$0) }
+		var new = old
+		new.insert(new.remove(at:10), at:900)
+		
+		let batch = Self.batch(old,new)
+		XCTAssertEqual(batch.moves, [ListDiff.Move(from:10, to:900)])
+		XCTAssertEqual(batch.changeCount, 1)
+	}
+	
+	func testUpdatesInPrefixAndSuffix() throws
+	{
+		let old = (0 ..< 10).map { Item(id:$0) }
+		var new = old
+		new[0].version = 1
+		new[9].version = 1
+		new.remove(at:5)
+		
+		let batch = Self.batch(old,new)
+		XCTAssertEqual(batch.deletes, [5])
+		XCTAssertEqual(batch.updates, [0,8])
+		XCTAssertTrue(batch.moves.isEmpty)
+	}
+	
+	func testEqualListsProduceEmptyBatch() throws
+	{
+		let items = (0 ..< 100).map { Item(id:$0) }
+		XCTAssertTrue(Self.batch(items,items).isEmpty)
+		XCTAssertTrue(Self.batch([],[]).isEmpty)
+	}
+	
+	// MARK: - Benchmarks
+	
+	static let items100k = (0 ..< 100_000).map { Item(id:$0) }
+	
+	/// A single Object changed its rating and moved to a different position
+	
+	func testPerformanceSingleMove100k() throws
+	{
+		let old = Self.items100k
+		var new = old
+		new.insert(new.remove(at:50_000), at:10)
+		
+		measure
+		{
+			XCTAssertEqual(Self.batch(old,new).changeCount, 1)
+		}
+	}
+	
+	/// A few percent of the Objects were added, removed or moved, e.g. after a folder changed on disk
+	
+	func testPerformanceScatteredEdits100k() throws
+	{
+		var random = SystemRandomNumberGenerator()
+		var nextID = 1_000_000
+		let old = Self.items100k
+		let new = Self.mutate(old, edits:3000, using:&random, nextID:&nextID)
+		
+		measure
+		{
+			let batch = Self.batch(old,new)
+			XCTAssertFalse(batch.isEmpty)
+		}
+	}
+	
+	/// Reversing the sort direction moves every element
+	
+	func testPerformanceReversed100k() throws
+	{
+		let old = Self.items100k
+		let new = Array(old.reversed())
+		
+		measure
+		{
+			XCTAssertEqual(Self.batch(old,new).moves.count, 99_999)
+		}
+	}
+}
@@ -0,0 +1,286 @@
+import XCTest
+@testable import BXMediaBrowserCore
+
+final class MusicLibraryIndexTests: XCTestCase
+{
+	/// A track of the fixture library
+
+	struct Track : MusicLibraryItem
+	{
+		var libraryItemID:UInt64
+		var title:String
+		var libraryArtistID:UInt64?
+		var libraryArtistName:String?
+		var libraryAlbumID:UInt64
+		var libraryAlbumTitle:String?
+		var genre:String
+		var trackNumber:Int
+		var composer:String = ""
+		var libraryModifiedDate:Date? = nil
+	}
+
+	/// A playlist of the fixture library
+
+	struct Playlist : MusicLibraryPlaylist
+	{
+		var libraryPlaylistID:UInt64
+		var name:String = ""
+		var libraryParentID:UInt64?
+		var libraryItems:[Track]
+	}
+
+	typealias Index = MusicLibraryIndex<Track,Playlist>
+
+	/// Creates a fixture library with the specified number of tracks. Every album has 10 tracks, every artist
+	/// 3 albums and there are 12 genres.
+
+	static func tracks(count:Int) -> [Track]
+	{
+		(0 ..< count).map
+		{
+			let album = $0 / 10
+			let artist = album / 3
+
+			return Track(
+				libraryItemID: UInt64($0),
+				title: "Track \($0)",
+				libraryArtistID: UInt64(1_000_000 + artist),
+				libraryArtistName: "Artist \(artist)",
+				libraryAlbumID: UInt64(2_000_000 + album),
+				libraryAlbumTitle: "Album \(album)",
+				genre: "Genre \($0 % 12)",
+				trackNumber: 10 - $0 % 10)
+		}
+	}
+
+	static let largeLibrary = tracks(count:200_000)
+
+	// MARK: - Grouping
+
+	func testGroups() throws
+	{
+		var tracks = Self.tracks(count:60)
+		tracks[0].libraryArtistName = ""
+		tracks[1].libraryAlbumTitle = nil
+		tracks[2].genre = ""
+
+		let index = Index(items:tracks, playlists:[])
+
+		XCTAssertEqual(index.songs.count, 60)
+		XCTAssertEqual(index.songs.map { $0.title }, tracks.map { $0.title }.sorted())
+		XCTAssertEqual(index.groups(for:.artist).count, 2)
+		XCTAssertEqual(index.groups(for:.album).count, 6)
+		XCTAssertEqual(index.groups(for:.genre).count, 12)
+
+		// Tracks without artist, album or genre are not part of the respective grouping
+
+		let artist = try XCTUnwrap(index.group(for:.artist, key:"1000000"))
+		XCTAssertEqual(artist.name, "Artist 0")
+		XCTAssertEqual(artist.count, 29)
+
+		let album = try XCTUnwrap(index.group(for:.album, key:"2000000"))
+		XCTAssertEqual(index.items(in:album, for:.album).count, 9)
+
+		let genre = try XCTUnwrap(index.group(for:.genre, key:"Genre 2"))
+		XCTAssertEqual(index.items(in:genre, for:.genre).count, 4)
+	}
+
+	func testSorting() throws
+	{
+		let index = Index(items:Self.tracks(count:60).shuffled(), playlists:[])
+
+		XCTAssertEqual(index.groups(for:.album).map { $0.name }, (0 ..< 6).map { "Album \($0)" })
+
+		// Album tracks are sorted by track number, artist tracks by title
+
+		let album = index.groups(for:.album)[1]
+		XCTAssertEqual(index.items(in:album, for:.album).map { $0.trackNumber }, Array(1 ... 10))
+
+		let artist = index.groups(for:.artist)[0]
+		let titles = index.items(in:artist, for:.artist).map { $0.title }
+		XCTAssertEqual(titles, titles.sorted())
+	}
+
+	func testPlaylists() throws
+	{
+		let tracks = Self.tracks(count:20)
+
+		let playlists =
+		[
+			Playlist(libraryPlaylistID:1, libraryParentID:nil, libraryItems:[]),
+			Playlist(libraryPlaylistID:2, libraryParentID:1, libraryItems:[tracks[5], tracks[3]]),
+			Playlist(libraryPlaylistID:3, libraryParentID:1, libraryItems:Array(tracks[10 ..< 20])),
+			Playlist(libraryPlaylistID:4, libraryParentID:nil, libraryItems:[tracks[0]]),
+		]
+
+		let index = Index(items:tracks, playlists:playlists)
+
+		XCTAssertEqual(index.childPlaylists(of:nil).map { $0.libraryPlaylistID }, [1,4])
+		XCTAssertEqual(index.childPlaylists(of:1).map { $0.libraryPlaylistID }, [2,3])
+		XCTAssertEqual(index.childPlaylists(of:2).count, 0)
+		XCTAssertEqual(index.items(in:playlists[1]).map { $0.libraryItemID }, [5,3])
+		XCTAssertEqual(index.items(in:playlists[2]).count, 10)
+	}
+
+	// MARK: - Change Detection
+
+	func testFingerprint() throws
+	{
+		var tracks = Self.tracks(count:100)
+		let playlists = [Playlist(libraryPlaylistID:1, libraryParentID:nil, libraryItems:[tracks[5]])]
+		let fingerprint = MusicLibraryFingerprint(items:tracks, playlists:playlists)
+
+		// The order of the tracks doesn't matter
+
+		XCTAssertEqual(fingerprint, MusicLibraryFingerprint(items:tracks.reversed(), playlists:playlists))
+		XCTAssertTrue(fingerprint.changes(since:fingerprint).isEmpty)
+
+		// Modify, remove and add tracks
+
+		tracks[3].libraryModifiedDate = Date()
+		tracks.remove(at:7)
+		tracks.append(Self.tracks(count:101)[100])
+
+		let changed = MusicLibraryFingerprint(items:tracks, playlists:playlists + [Playlist(libraryPlaylistID:2, libraryParentID:1, libraryItems:[])])
+		let changes = changed.changes(since:fingerprint)
+
+		XCTAssertNotEqual(fingerprint, changed)
+		XCTAssertEqual(changes.modifiedItems, [3])
+		XCTAssertEqual(changes.removedItems, [7])
+		XCTAssertEqual(changes.addedItems, [100])
+		XCTAssertEqual(changes.changedPlaylists, [2])
+	}
+
+	func testChangedGroups() throws
+	{
+		let tracks = Self.tracks(count:60)
+		let index = Index(items:tracks, playlists:[Playlist(libraryPlaylistID:1, libraryParentID:nil, libraryItems:[tracks[42]])])
+		let keys = index.groupKeys(containing:[42])
+
+		XCTAssertEqual(keys[.artist], ["1000001"])
+		XCTAssertEqual(keys[.album], ["2000004"])
+		XCTAssertEqual(keys[.genre], ["Genre 6"])
+		XCTAssertEqual(index.playlistIDs(containing:[42]), [1])
+		XCTAssertEqual(index.playlistIDs(containing:[43]), [])
+	}
+
+	// MARK: - Searching
+
+	func testSearch() throws
+	{
+		var tracks = Self.tracks(count:30)
+		tracks[4].libraryArtistName = "Beyoncé"
+		tracks[5].composer = "Dvořák"
+		tracks[6].libraryAlbumTitle = "Abbey Road"
+
+		let searchText = MusicSearchText(items:tracks)
+
+		XCTAssertEqual(searchText.count, 30)
+		XCTAssertEqual(searchText.contains(4, searchString:"beyonce"), true)
+		XCTAssertEqual(searchText.contains(5, searchString:"DVORAK"), true)
+		XCTAssertEqual(searchText.contains(6, searchString:"road"), true)
+		XCTAssertEqual(searchText.contains(6, searchString:"beyonce"), false)
+		XCTAssertEqual(searchText.contains(99, searchString:"road"), nil)
+
+		// Matches don't span fields
+
+		XCTAssertEqual(searchText.contains(6, searchString:"road genre"), false)
+
+		// The same track is found once, even if several fields match
+
+		let matches = searchText.matches(for:"genre 1")
+		XCTAssertEqual(matches.filter { $0 }.count, 7)
+		XCTAssertTrue(searchText.matches(for:"").allSatisfy { $0 })
+	}
+
+	func testSearchTextIncludesPlaylistItems() throws
+	{
+		let tracks = Self.tracks(count:10)
+		var extra = Self.tracks(count:11)[10]
+		extra.title = "Only in a playlist"
+
+		let index = Index(items:tracks, playlists:[Playlist(libraryPlaylistID:1, libraryParentID:nil, libraryItems:[tracks[0],extra])])
+
+		XCTAssertEqual(index.searchText.count, 11)
+		XCTAssertEqual(index.searchText.contains(10, searchString:"playlist"), true)
+	}
+
+	// MARK: - Benchmarks
+
+	/// Baseline: lowercasing five strings per track for a search string, like MusicFilter did before
+
+	func testPerformanceSearchLowercased() throws
+	{
+		let tracks = Self.largeLibrary
+
+		measure
+		{
+			let searchString = "album 19999"
+			let count = tracks.filter
+			{
+				$0.title.lowercased().contains(searchString) ||
+				($0.libraryArtistName ?? "").lowercased().contains(searchString) ||
+				$0.composer.lowercased().contains(searchString) ||
+				($0.libraryAlbumTitle ?? "").lowercased().contains(searchString) ||
+				$0.genre.lowercased().contains(searchString)
+			}
+			.count
+
+			XCTAssertEqual(count, 10)
+		}
+	}
+
+	/// Scanning the pre-folded search text for a new search string and looking up every track
+
+	func testPerformanceSearchText() throws
+	{
+		let tracks = Self.largeLibrary
+		let searchText = MusicSearchText(items:tracks)
+		var iteration = 0
+
+		measure
+		{
+			// Append a different number of spaces, so that the cached result of the last search is not used
+
+			iteration += 1
+			let searchString = "album 19999" + String(repeating:" ", count:iteration % 2)
+			let count = tracks.filter { searchText.contains($0.libraryItemID, searchString:searchString) == true }.count
+
+			XCTAssertEqual(count, iteration % 2 == 0 ? 10 : 0)
+		}
+	}
+
+	/// Baseline: expanding "Artists" and loading each artist by scanning the whole library, like before the index
+
+	func testPerformanceScanning() throws
+	{
+		let tracks = Self.largeLibrary
+
+		measure
+		{
+			let artists = Set(tracks.compactMap { $0.libraryArtistID }).sorted()
+
+			for artist in artists.prefix(20)
+			{
+				_ = tracks.filter { $0.libraryArtistID == artist }.sorted { $0.title < $1.title }
+			}
+		}
+	}
+
+	/// Building the index once and loading the same artists from their ranges
+
+	func testPerformanceIndex() throws
+	{
+		let tracks = Self.largeLibrary
+
+		measure
+		{
+			let index = Index(items:tracks, playlists:[])
+
+			for artist in index.groups(for:.artist).prefix(20)
+			{
+				_ = index.items(in:artist, for:.artist)
+			}
+		}
+	}
+}
@@ -0,0 +1,180 @@
+import XCTest
+import CoreGraphics
+@testable import BXMediaBrowser
+
+final class CancellationTests: XCTestCase
+{
+	/// A thread-safe flag that can be set from cancel handlers
+
+	final class Flag
+	{
+		private var _value = false
+		private let lock = NSLock()
+
+		var value:Bool
+		{
+			get { lock.lock(); defer { lock.unlock() }; return _value }
+			set { lock.lock(); _value = newValue; lock.unlock() }
+		}
+	}
+
+	/// A thumbnail handler whose first call runs until it is cancelled, while the following calls run until released
+
+	final class Handler
+	{
+		private var _callCount = 0
+		let isReleased = Flag()
+		private let lock = NSLock()
+
+		var callCount:Int
+		{
+			lock.lock()
+			defer { lock.unlock() }
+			return _callCount
+		}
+
+		func load() async throws -> CGImage
+		{
+			lock.lock()
+			_callCount += 1
+			let call = _callCount
+			lock.unlock()
+
+			if call == 1
+			{
+				while !Task.isCancelled { try? await Task.sleep(nanoseconds:1_000_000) }
+				throw CancellationError()
+			}
+
+			while !isReleased.value { try await Task.sleep(nanoseconds:1_000_000) }
+
+			let context = CGContext(data:nil, width:1, height:1, bitsPerComponent:8, bytesPerRow:0, space:CGColorSpaceCreateDeviceRGB(), bitmapInfo:CGImageAlphaInfo.noneSkipLast.rawValue)
+			return context!.makeImage()!
+		}
+	}
+
+	/// Waits until the condition is met or the timeout has expired
+
+	func wait(timeout:Double = 5.0, until condition:()->Bool) async
+	{
+		let deadline = Date(timeIntervalSinceNow:timeout)
+
+		while !condition() && Date() < deadline
+		{
+			try? await Task.sleep(nanoseconds:1_000_000)
+		}
+	}
+
+	/// Returns a Task that runs until it is cancelled and then returns true
+
+	func longRunningTask() -> Task<Bool,Never>
+	{
+		Task
+		{
+			while !Task.isCancelled { try? await Task.sleep(nanoseconds:1_000_000) }
+			return Task.isCancelled
+		}
+	}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	// MARK: - CancellationScope
+
+	func testCancelScope() async
+	{
+		let scope = CancellationScope(name:"testCancelScope")
+		let dropped = CancellationScope.statistics.dropped
+		let didCallHandler = Flag()
+
+		let task = longRunningTask()
+		scope.attach(task) { didCallHandler.value = true }
+		XCTAssertEqual(scope.count, 1)
+		XCTAssertFalse(scope.isCancelled)
+
+		XCTAssertEqual(scope.cancel(), 1)
+		let wasCancelled = await task.value
+
+		XCTAssertTrue(wasCancelled)
+		XCTAssertTrue(didCallHandler.value)
+		XCTAssertTrue(scope.isCancelled)
+		XCTAssertEqual(scope.count, 0)
+		XCTAssertGreaterThanOrEqual(CancellationScope.statistics.dropped, dropped+1)
+	}
+
+	func testAttachToCancelledScope() async
+	{
+		let scope = CancellationScope(name:"testAttachToCancelledScope")
+		scope.cancel()
+
+		let task = longRunningTask()
+		scope.attach(task)
+		let wasCancelled = await task.value
+
+		XCTAssertTrue(wasCancelled)
+		XCTAssertEqual(scope.count, 0)
+	}
+
+	func testFinishedTasksLeaveScope() async
+	{
+		let scope = CancellationScope(name:"testFinishedTasksLeaveScope")
+		let task = Task { 42 }
+		scope.attach(task)
+
+		_ = await task.value
+		await wait { scope.count == 0 }
+
+		XCTAssertEqual(scope.count, 0)
+		XCTAssertEqual(scope.cancel(), 0)
+	}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	// MARK: - Object.Loader
+
+	func testCancelAndRestartThumbnail() async throws
+	{
+		let handler = Handler()
+
+		let loader = Object.Loader(
+			identifier: "CancellationTests-\(UUID().uuidString)",
+			data: 0,
+			loadThumbnailHandler: { _,_ in try await handler.load() },
+			loadMetadataHandler: { _,_ in [:] },
+			downloadFileHandler: { _,_ in throw Object.Error.downloadFileFailed })
+
+		// Start loading, then cancel and restart while the first task is still running
+
+		let first = Task { try await loader.thumbnailImage }
+		await wait { handler.callCount == 1 }
+
+		await loader.cancel()
+		let second = Task { try await loader.thumbnailImage }
+		await wait { handler.callCount == 2 }
+
+		// When the cancelled task finishes, it must not clear the reference to the new task
+
+		let firstResult = await first.result
+		XCTAssertThrowsError(try firstResult.get())
+
+		let isLoadingAfterCancel = await loader.isLoadingThumbnail
+		XCTAssertTrue(isLoadingAfterCancel)
+
+		// Another request joins the running task instead of starting a third one
+
+		let third = Task { try await loader.thumbnailImage }
+		handler.isReleased.value = true
+
+		let image = try await second.value
+		let joinedImage = try await third.value
+		let isLoadingAfterCompletion = await loader.isLoadingThumbnail
+
+		XCTAssertEqual(image.width, 1)
+		XCTAssertTrue(image === joinedImage)
+		XCTAssertEqual(handler.callCount, 2)
+		XCTAssertFalse(isLoadingAfterCompletion)
+	}
+}
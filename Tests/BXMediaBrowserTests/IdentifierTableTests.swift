@@ -0,0 +1,84 @@
+import XCTest
+@testable import BXMediaBrowser
+
+final class IdentifierTableTests: XCTestCase
+{
+	/// Creates identifiers that look like those of a large FolderSource container
+	
+	static let identifiers:[String] = (0 ..< 100_000).map
+	{
+		"FolderSource:file:///Volumes/Photos/Archive/2024/Imports/IMG_\($0).JPG"
+	}
+	
+	static let objects:[Object] = identifiers.map
+	{
+		Object(
+			identifier: $0,
+			name: $0,
+			data: $0,
+			loadThumbnailHandler: { _,_ in throw Object.Error.loadThumbnailFailed },
+			loadMetadataHandler: { _,_ in [:] },
+			downloadFileHandler: { _,_ in throw Object.Error.downloadFileFailed },
+			in: nil)
+	}
+	
+	func testInterning() throws
+	{
+		let table = IdentifierTable.shared
+		let prefix = UUID().uuidString
+		let count = table.count
+		
+		XCTAssertNil(table.existingHandle(for:"\(prefix)-a"))
+		
+		let a = table.handle(for:"\(prefix)-a")
+		let b = table.handle(for:"\(prefix)-b")
+		
+		XCTAssertEqual(a, table.handle(for:"\(prefix)-a"))
+		XCTAssertEqual(a, table.existingHandle(for:"\(prefix)-a"))
+		XCTAssertNotEqual(a, b)
+		XCTAssertEqual(table.identifier(for:b), "\(prefix)-b")
+		XCTAssertEqual(b.identifier, "\(prefix)-b")
+		XCTAssertEqual(table.count, count+2)
+		XCTAssertEqual(a.stableHash, IdentifierTable.stableHash(for:"\(prefix)-a"))
+	}
+	
+	func testObjectEquality() throws
+	{
+		let objects = Self.objects
+		XCTAssertEqual(objects[7], Self.objects[7])
+		XCTAssertNotEqual(objects[7], objects[8])
+		XCTAssertEqual(objects[7].handle.identifier, objects[7].identifier)
+	}
+	
+	// MARK: - Benchmarks
+	
+	/// Baseline: removing duplicates and building a lookup dictionary keyed by identifier strings
+	
+	func testPerformanceStringKeys() throws
+	{
+		let objects = Self.objects + Self.objects.prefix(1000)
+		
+		measure
+		{
+			var seen = Set<String>()
+			let unique = objects.filter { seen.insert($0.identifier).inserted }
+			let index = Dictionary(unique.enumerated().map { ($1.identifier,$0) }, uniquingKeysWith:{ a,_ in a })
+			XCTAssertEqual(index.count, 100_000)
+		}
+	}
+	
+	/// The same work keyed by interned handles
+	
+	func testPerformanceHandleKeys() throws
+	{
+		let objects = Self.objects + Self.objects.prefix(1000)
+		
+		measure
+		{
+			var seen = Set<IdentifierHandle>()
+			let unique = objects.filter { seen.insert($0.handle).inserted }
+			let index = Dictionary(unique.enumerated().map { ($1.handle,$0) }, uniquingKeysWith:{ a,_ in a })
+			XCTAssertEqual(index.count, 100_000)
+		}
+	}
+}
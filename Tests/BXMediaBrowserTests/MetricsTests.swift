@@ -0,0 +1,141 @@
+import XCTest
+import CoreGraphics
+@testable import BXMediaBrowser
+
+final class MetricsTests: XCTestCase
+{
+	func testCounterFromManyThreads() throws
+	{
+		let metrics = Metrics()
+		let counter = metrics.counter("test.counter", source:"TestSource")
+
+		DispatchQueue.concurrentPerform(iterations:64)
+		{
+			_ in
+			for _ in 0 ..< 1000 { counter.increment() }
+		}
+
+		let snapshot = metrics.snapshot()
+		XCTAssertEqual(snapshot.counter("test.counter", source:"TestSource"), 64_000)
+		XCTAssertEqual(snapshot.counter("test.counter"), 0)
+		XCTAssertEqual(snapshot.sources(for:"test.counter"), ["TestSource"])
+	}
+
+	func testGauge() throws
+	{
+		let metrics = Metrics()
+		let gauge = metrics.gauge("test.gauge")
+
+		gauge.increment()
+		gauge.increment()
+		gauge.decrement()
+		XCTAssertEqual(metrics.snapshot().gauge("test.gauge"), 1)
+
+		gauge.set(42)
+		XCTAssertEqual(metrics.snapshot().gauge("test.gauge"), 42)
+	}
+
+	func testHistogramPercentiles() throws
+	{
+		let metrics = Metrics()
+		let histogram = metrics.histogram("test.latency", source:"FolderSource")
+
+		// 990 fast values of 1ms and 10 slow values of 100ms
+
+		for _ in 0 ..< 990 { histogram.record(0.001) }
+		for _ in 0 ..< 10 { histogram.record(0.1) }
+
+		let snapshot = try XCTUnwrap(metrics.snapshot().histogram("test.latency", source:"FolderSource"))
+
+		XCTAssertEqual(snapshot.count, 1000)
+		XCTAssertEqual(snapshot.max, 0.1, accuracy:0.000_001)
+		XCTAssertEqual(snapshot.mean, 0.00199, accuracy:0.000_001)
+		XCTAssertEqual(snapshot.p50, 0.001, accuracy:0.001 * 0.19)
+		XCTAssertEqual(snapshot.p99, 0.001, accuracy:0.001 * 0.19)
+		XCTAssertEqual(snapshot.percentile(0.995), 0.1, accuracy:0.1 * 0.19)
+	}
+
+	func testHistogramBuckets() throws
+	{
+		XCTAssertEqual(Metrics.Histogram.bucket(for:0), 0)
+		XCTAssertEqual(Metrics.Histogram.bucket(for:0.000_001), 1)
+		XCTAssertEqual(Metrics.Histogram.bucket(for:1_000_000), Metrics.Histogram.bucketCount-1)
+
+		// Every value is less than or equal to the upper bound of its bucket
+
+		for seconds in [0.000_003, 0.000_17, 0.0042, 0.05, 1.3, 12.0]
+		{
+			let bucket = Metrics.Histogram.bucket(for:seconds)
+			XCTAssertLessThanOrEqual(seconds, Metrics.Histogram.upperBound(of:bucket) * 1.000_001)
+			XCTAssertGreaterThan(seconds, Metrics.Histogram.upperBound(of:bucket-1))
+		}
+	}
+
+	func testTimeAndFailures() async throws
+	{
+		let metrics = Metrics()
+
+		let value = await metrics.time("test.load", failures:"test.failures", source:"PexelsSource") { 7 }
+		XCTAssertEqual(value, 7)
+
+		do
+		{
+			try await metrics.time("test.load", failures:"test.failures", source:"PexelsSource") { throw Object.Error.loadThumbnailFailed }
+			XCTFail()
+		}
+		catch
+		{
+
+		}
+
+		let snapshot = metrics.snapshot()
+		XCTAssertEqual(snapshot.histogram("test.load", source:"PexelsSource")?.count, 1)
+		XCTAssertEqual(snapshot.counter("test.failures", source:"PexelsSource"), 1)
+
+		metrics.reset()
+		XCTAssertEqual(metrics.snapshot().histogram("test.load", source:"PexelsSource")?.count, 0)
+	}
+
+	func testLoaderInstrumentsAreCachedPerSource() throws
+	{
+		let metrics = Metrics()
+		let instruments = metrics.loaderInstruments(for:"FolderSource")
+
+		XCTAssertTrue(metrics.loaderInstruments(for:"FolderSource") === instruments)
+		XCTAssertFalse(metrics.loaderInstruments(for:"MusicSource") === instruments)
+		XCTAssertTrue(instruments.thumbnailLatency === metrics.histogram(.thumbnailLatency, source:"FolderSource"))
+
+		instruments.thumbnailCacheHits.increment()
+		XCTAssertEqual(metrics.snapshot().counter(.thumbnailCacheHits, source:"FolderSource"), 1)
+	}
+
+	func testSourceLabel() throws
+	{
+		XCTAssertEqual(Metrics.source(for:"FolderSource:file:///Users/peter/Pictures/"), "FolderSource")
+		XCTAssertEqual(Metrics.source(for:"MusicSource:Playlist:42"), "MusicSource")
+		XCTAssertEqual(Metrics.source(for:"Unknown"), "Unknown")
+	}
+
+	/// Thumbnail latencies are recorded per source by Object.Loader
+
+	func testObjectLoaderRecordsThumbnailLatency() async throws
+	{
+		let source = "MetricsTestSource\(UUID().uuidString)"
+		let image = try XCTUnwrap(CGContext(data:nil, width:4, height:4, bitsPerComponent:8, bytesPerRow:0, space:CGColorSpaceCreateDeviceRGB(), bitmapInfo:CGImageAlphaInfo.premultipliedLast.rawValue)?.makeImage())
+
+		let loader = Object.Loader(
+			identifier: "\(source):1",
+			data: 1,
+			loadThumbnailHandler: { _,_ in image },
+			loadMetadataHandler: { _,_ in [:] },
+			downloadFileHandler: { _,_ in throw Object.Error.downloadFileFailed })
+
+		_ = try await loader.thumbnailImage
+		_ = try await loader.thumbnailImage
+
+		let snapshot = Metrics.shared.snapshot()
+		XCTAssertEqual(snapshot.histogram(.thumbnailLatency, source:source)?.count, 1)
+		XCTAssertEqual(snapshot.counter(.thumbnailCacheHits, source:source), 1)
+		XCTAssertNotNil(snapshot.histogram(.thumbnailLatency, source:source)?.p99)
+	}
+}
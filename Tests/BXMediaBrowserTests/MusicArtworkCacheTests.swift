@@ -0,0 +1,124 @@
+#if os(macOS)
+
+import XCTest
+import CoreGraphics
+@testable import BXMediaBrowser
+
+final class MusicArtworkCacheTests: XCTestCase
+{
+	/// Creates a 1x1 image and counts how often it was called
+
+	final class Decoder
+	{
+		private(set) var count = 0
+
+		func decode() throws -> CGImage
+		{
+			count += 1
+			let context = CGContext(data:nil, width:1, height:1, bitsPerComponent:8, bytesPerRow:0, space:CGColorSpaceCreateDeviceRGB(), bitmapInfo:CGImageAlphaInfo.noneSkipLast.rawValue)
+			return context!.makeImage()!
+		}
+	}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	// MARK: - Keys
+
+	func testAlbumKey()
+	{
+		var didReadData = false
+		let key = MusicArtworkCache.artworkKey(albumID:42, albumTitle:"Album", artworkData:{ didReadData = true; return Data([1]) })
+
+		XCTAssertEqual(key, .album(42))
+		XCTAssertFalse(didReadData)
+	}
+
+	func testContentKeyForUnknownAlbums()
+	{
+		let data1 = Data([1,2,3])
+		let data2 = Data([4,5,6])
+
+		let key1 = MusicArtworkCache.artworkKey(albumID:0, albumTitle:"Album", artworkData:{ data1 })
+		let key2 = MusicArtworkCache.artworkKey(albumID:42, albumTitle:"", artworkData:{ data2 })
+		let key3 = MusicArtworkCache.artworkKey(albumID:7, albumTitle:nil, artworkData:{ data1 })
+
+		XCTAssertNotNil(key1)
+		XCTAssertNotEqual(key1, key2)
+		XCTAssertEqual(key1, key3)
+		XCTAssertNil(MusicArtworkCache.artworkKey(albumID:0, albumTitle:nil, artworkData:{ nil }))
+	}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	// MARK: - Sharing
+
+	func testTracksShareArtwork() throws
+	{
+		let cache = MusicArtworkCache()
+		let decoder = Decoder()
+
+		let image1 = try cache.image(for:.album(1), owner:"A", create:decoder.decode)
+		let image2 = try cache.image(for:.album(1), owner:"B", create:decoder.decode)
+		let image3 = try cache.image(for:.album(2), owner:"C", create:decoder.decode)
+
+		XCTAssertTrue(image1 === image2)
+		XCTAssertFalse(image1 === image3)
+		XCTAssertEqual(decoder.count, 2)
+		XCTAssertEqual(cache.count, 2)
+		XCTAssertEqual(cache.hitRate, 1.0/3.0, accuracy:0.001)
+	}
+
+	func testReleasingLastOwnerRemovesEntry() throws
+	{
+		let cache = MusicArtworkCache()
+		let decoder = Decoder()
+
+		_ = try cache.image(for:.album(1), owner:"A", create:decoder.decode)
+		_ = try cache.image(for:.album(1), owner:"B", create:decoder.decode)
+
+		cache.release(owner:"A")
+		XCTAssertEqual(cache.count, 1)
+
+		cache.release(owner:"B")
+		XCTAssertEqual(cache.count, 0)
+	}
+
+	func testOwnersAreCountedPerInstance() throws
+	{
+		let cache = MusicArtworkCache()
+		let decoder = Decoder()
+
+		// Two instances for the same track, e.g. in different playlists
+
+		cache.retain(owner:"A")
+		cache.retain(owner:"A")
+		_ = try cache.image(for:.album(1), owner:"A", create:decoder.decode)
+
+		cache.release(owner:"A")
+		XCTAssertEqual(cache.count, 1)
+
+		_ = try cache.image(for:.album(1), owner:"A", create:decoder.decode)
+		XCTAssertEqual(decoder.count, 1)
+
+		cache.release(owner:"A")
+		XCTAssertEqual(cache.count, 0)
+	}
+
+	func testChangingKeyReleasesPreviousEntry() throws
+	{
+		let cache = MusicArtworkCache()
+		let decoder = Decoder()
+
+		_ = try cache.image(for:.album(1), owner:"A", create:decoder.decode)
+		_ = try cache.image(for:.type("public.mp3"), owner:"A", create:decoder.decode)
+
+		XCTAssertEqual(cache.count, 1)
+		XCTAssertEqual(decoder.count, 2)
+	}
+}
+
+#endif
@@ -0,0 +1,262 @@
+import XCTest
+@testable import BXMediaBrowser
+
+final class ObjectListTests: XCTestCase
+{
+	/// Counts the Objects that were created by a factory
+
+	final class Factory
+	{
+		private var _count = 0
+		private let lock = NSLock()
+
+		var count:Int
+		{
+			lock.lock()
+			defer { lock.unlock() }
+			return _count
+		}
+
+		func makeObject(for record:Object.Record) -> Object
+		{
+			lock.lock()
+			_count += 1
+			lock.unlock()
+
+			let object = ObjectListTests.makeObject(record.identifier)
+			object.captureDate = record.captureDate
+			return object
+		}
+	}
+
+	static func makeObject(_ identifier:String) -> Object
+	{
+		Object(
+			identifier: identifier,
+			name: identifier,
+			data: 0,
+			loadThumbnailHandler: { _,_ in throw Object.Error.loadThumbnailFailed },
+			loadMetadataHandler: { _,_ in [:] },
+			downloadFileHandler: { _,_ in throw Object.Error.downloadFileFailed },
+			in: nil)
+	}
+
+	/// Returns a lazy list with Records named A, B, C, D, E and capture dates in the same order
+
+	func makeList(_ factory:Factory) -> (ObjectList,[Object.Record])
+	{
+		let prefix = "ObjectListTests-\(UUID().uuidString)-"
+
+		let records = ["A","B","C","D","E"].enumerated().map
+		{
+			Object.Record(identifier:prefix+$1, name:$1, mediaType:.image, captureDate:Date(timeIntervalSinceReferenceDate:Double($0)))
+		}
+
+		return (ObjectList(records:records, factory:factory.makeObject), records)
+	}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	// MARK: - Materializing
+
+	func testAccessorsDoNotMaterialize()
+	{
+		let factory = Factory()
+		let (list,records) = makeList(factory)
+
+		XCTAssertTrue(list.isLazy)
+		XCTAssertEqual(list.count, 5)
+		XCTAssertEqual(list.handles, records.map { $0.handle })
+		XCTAssertEqual(list.handle(at:1), records[1].handle)
+		XCTAssertEqual(list.record(at:2).name, "C")
+		XCTAssertEqual(list.firstIndex(of:records[3].handle), 3)
+		XCTAssertNil(list.materializedObject(at:0))
+		XCTAssertTrue(list.materializedObjects.isEmpty)
+		XCTAssertEqual(factory.count, 0)
+	}
+
+	func testSubscriptMaterializesOnce()
+	{
+		let factory = Factory()
+		let (list,records) = makeList(factory)
+
+		let object = list[2]
+		XCTAssertEqual(factory.count, 1)
+		XCTAssertEqual(object.identifier, records[2].identifier)
+		XCTAssertEqual(object.captureDate, records[2].captureDate)
+
+		XCTAssertTrue(list[2] === object)
+		XCTAssertTrue(list.materializedObject(at:2) === object)
+		XCTAssertEqual(list.materializedObjects.count, 1)
+		XCTAssertEqual(factory.count, 1)
+	}
+
+	func testReleasedObjectsAreMaterializedAgain()
+	{
+		let factory = Factory()
+		let (list,_) = makeList(factory)
+
+		do
+		{
+			let object = list[0]
+			XCTAssertEqual(object.name, "A")
+		}
+
+		XCTAssertNil(list.materializedObject(at:0))
+		XCTAssertEqual(list[0].name, "A")
+		XCTAssertEqual(factory.count, 2)
+	}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	// MARK: - Modifying
+
+	func testSortingAndFilteringRecordsDoesNotMaterialize()
+	{
+		let factory = Factory()
+		var (list,records) = makeList(factory)
+
+		list.sort(records:{ $0.name > $1.name })
+		XCTAssertEqual((0 ..< list.count).map { list.record(at:$0).name }, ["E","D","C","B","A"])
+
+		let filtered = list.filter(records:{ $0.name != "C" })
+		XCTAssertEqual(filtered.count, 4)
+		XCTAssertTrue(filtered.isLazy)
+
+		list.append(contentsOf:[list[0]])
+		XCTAssertEqual(list.count, 6)
+		XCTAssertEqual(list.removingDuplicateHandles().handles, records.reversed().map { $0.handle })
+		XCTAssertEqual(factory.count, 1)
+	}
+
+	func testInsertedObjectsAreAdopted()
+	{
+		let factory = Factory()
+		var (list,_) = makeList(factory)
+
+		let object = Self.makeObject("ObjectListTests-\(UUID().uuidString)-X")
+		list.insert(object, at:0)
+
+		XCTAssertTrue(list.isLazy)
+		XCTAssertEqual(list.count, 6)
+		XCTAssertTrue(list[0] === object)
+		XCTAssertNotNil(object.materializer)
+		XCTAssertEqual(factory.count, 0)
+	}
+
+	func testRepositionMovesAndRemovesChangedObjects()
+	{
+		let factory = Factory()
+		var (list,records) = makeList(factory)
+
+		// Move C to the end and remove B
+
+		let ranks = ["A":0, "B":1, "C":9, "D":3, "E":4]
+		let comparator:Object.Filter.ObjectComparator = { ranks[$0.name]! < ranks[$1.name]! }
+
+		XCTAssertTrue(list.reposition([records[1].identifier,records[2].identifier], comparator:comparator, isIncluded:{ $0.name != "B" }))
+		XCTAssertEqual((0 ..< list.count).map { list.record(at:$0).name }, ["A","D","E","C"])
+		XCTAssertTrue(list.isLazy)
+
+		XCTAssertFalse(list.reposition([], comparator:comparator, isIncluded:{ _ in true }))
+		XCTAssertFalse(list.reposition([records[0].identifier], comparator:nil, isIncluded:{ _ in true }))
+	}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	// MARK: - Comparing
+
+	func testBatchMatchesHandles()
+	{
+		let factory = Factory()
+		let (list,_) = makeList(factory)
+
+		var changed = list.filter(records:{ $0.name != "B" })
+		changed.sort(records:{ $0.name > $1.name })
+
+		XCTAssertTrue(list.isIdentical(to:list))
+		XCTAssertFalse(list.isIdentical(to:changed))
+
+		let batch = list.batch(to:changed)
+		XCTAssertEqual(batch.deletes, [1])
+		XCTAssertTrue(batch.inserts.isEmpty)
+		XCTAssertTrue(batch.updates.isEmpty)
+		XCTAssertFalse(batch.moves.isEmpty)
+		XCTAssertEqual(factory.count, 0)
+
+		// An eager list with the same handles is represented by different instances, so its entries are updates
+
+		let eager = ObjectList(list.map { $0 })
+		XCTAssertEqual(list.batch(to:eager).updates, [0,1,2,3,4])
+	}
+
+	func testNextResolvesThroughMaterializer()
+	{
+		let factory = Factory()
+		let (list,records) = makeList(factory)
+		list.link()
+
+		let object = list[3]
+		XCTAssertEqual(object.next?.identifier, records[4].identifier)
+		XCTAssertNil(list[4].next)
+	}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	// MARK: - Folders
+
+	/// A host subclass that uses the original entry point, but fails for some files
+	
+	final class CustomFolderContainer : FolderContainer
+	{
+		override class func createObject(for url:URL, filter:FolderFilter, in library:Library?) throws -> Object?
+		{
+			guard url.pathExtension == "jpg" else { throw Object.Error.notFound }
+			return ImageFile(url:url, in:library)
+		}
+	}
+
+	func testFolderObjectsAreCreatedByOverride()
+	{
+		let folderURL = FileManager.default.temporaryDirectory
+		let record = Object.Record(url:folderURL.appendingPathComponent("ObjectListTests.jpg"), mediaType:.image)
+		let failingRecord = Object.Record(url:folderURL.appendingPathComponent("ObjectListTests.png"), mediaType:.image)
+
+		let object = CustomFolderContainer.createObject(for:record, filter:FolderFilter(), in:nil)
+		XCTAssertTrue(object is ImageFile)
+		XCTAssertEqual(object.identifier, record.identifier)
+
+		// A failing override doesn't crash the browser, but yields a plain FolderObject
+
+		let fallback = CustomFolderContainer.createObject(for:failingRecord, filter:FolderFilter(), in:nil)
+		XCTAssertFalse(fallback is ImageFile)
+		XCTAssertEqual(fallback.identifier, failingRecord.identifier)
+	}
+
+	func testConcurrentMaterializationYieldsSingleObject()
+	{
+		let factory = Factory()
+		let (list,_) = makeList(factory)
+		var objects = [Object?](repeating:nil, count:16)
+		let lock = NSLock()
+
+		DispatchQueue.concurrentPerform(iterations:objects.count)
+		{
+			i in
+			let object = list[0]
+			lock.lock()
+			objects[i] = object
+			lock.unlock()
+		}
+
+		XCTAssertTrue(objects.allSatisfy { $0 === objects[0] })
+	}
+}
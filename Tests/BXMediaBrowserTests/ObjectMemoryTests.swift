@@ -0,0 +1,222 @@
+import XCTest
+@testable import BXMediaBrowser
+
+final class ObjectMemoryTests: XCTestCase
+{
+	/// The number of Objects that are created per source type
+
+	static let count = 50_000
+
+	/// Returns the number of bytes that are currently allocated on the heap. Unlike the physical footprint this is
+	/// not affected by pages that the allocator keeps around after other tests freed their memory.
+
+	static var allocatedBytes:Int64
+	{
+		var statistics = malloc_statistics_t()
+		malloc_zone_statistics(nil, &statistics)
+		return Int64(statistics.size_in_use)
+	}
+
+	/// Creates count instances and returns how many heap bytes each of them occupies
+
+	func allocatedBytesPerObject<T>(_ label:String, create:(Int)->T) -> Int64
+	{
+		let before = Self.allocatedBytes
+		let instances = (0 ..< Self.count).map(create)
+		let after = Self.allocatedBytes
+
+		let bytes = (after - before) / Int64(Self.count)
+		print("\(label): \(bytes) bytes per object")
+
+		withExtendedLifetime(instances) { }
+		return bytes
+	}
+
+	/// Measures the memory of count instances with XCTMemoryMetric. Input data must be created before calling
+	/// this function, so that it is not part of the measurement.
+
+	func measureMemory<T>(create:@escaping (Int)->T)
+	{
+		measure(metrics:[XCTMemoryMetric()])
+		{
+			let instances = (0 ..< Self.count).map(create)
+			withExtendedLifetime(instances) { }
+		}
+	}
+
+	// MARK: - Payloads
+
+	func testSharedHandlers() throws
+	{
+		// Creating an ImageFile registers the Handlers for its class, so they are not created again
+
+		_ = ImageFile(url:URL(fileURLWithPath:"/tmp/a.jpg"), in:nil)
+		_ = VideoFile(url:URL(fileURLWithPath:"/tmp/b.mov"), in:nil)
+
+		let imageHandlers = Object.Loader.Handlers.shared(for:ImageFile.self) { XCTFail(); fatalError() }
+		let videoHandlers = Object.Loader.Handlers.shared(for:VideoFile.self) { XCTFail(); fatalError() }
+
+		XCTAssertFalse(imageHandlers === videoHandlers)
+	}
+
+	func testDataPayload() throws
+	{
+		let url = URL(fileURLWithPath:"/tmp/a.jpg")
+		let object = ImageFile(url:url, in:nil)
+		XCTAssertEqual(object.data as? URL, url)
+
+		let photo = try Self.pexelsPhoto(id:7)
+		let pexelsObject = PexelsPhotoObject(with:photo, in:nil)
+		XCTAssertEqual((pexelsObject.data as? Pexels.Photo)?.id, 7)
+
+		object.data = "abc"
+		XCTAssertEqual(object.data as? String, "abc")
+
+		let reference = NSObject()
+		object.data = reference
+		XCTAssertTrue(object.data as AnyObject === reference)
+	}
+
+	func testLoaderIsCreatedOnce() throws
+	{
+		let objects = (0 ..< 100).map { ImageFile(url:URL(fileURLWithPath:"/tmp/\($0).jpg"), in:nil) }
+		var loaders = [[ObjectIdentifier]](repeating:[], count:4)
+		let lock = NSLock()
+
+		DispatchQueue.concurrentPerform(iterations:4)
+		{
+			i in
+			let identifiers = objects.map { ObjectIdentifier($0.loader) }
+			lock.lock(); loaders[i] = identifiers; lock.unlock()
+		}
+
+		XCTAssertTrue(loaders.allSatisfy { $0 == loaders[0] })
+	}
+
+	/// Objects that share the Handlers of their class must be smaller than Objects with individual closures,
+	/// which allocate a separate Handlers table each. Both use the same URL payload.
+
+	func testSharedHandlersAreSmallerThanIndividualClosures() throws
+	{
+		let urls = (0 ..< Self.count).map { URL(fileURLWithPath:"/Volumes/Photos/Archive/IMG_\($0).JPG") }
+		let handlers = Object.Loader.Handlers.shared(for:ImageFile.self) { XCTFail(); fatalError() }
+
+		// Intern the identifiers up front, so that growing the IdentifierTable is not attributed to the Objects
+
+		for i in 0 ..< Self.count
+		{
+			_ = IdentifierTable.shared.handle(for:"Individual:\(i)")
+			_ = IdentifierTable.shared.handle(for:"Shared:\(i)")
+			_ = IdentifierTable.shared.handle(for:"Record:\(i)")
+		}
+
+		let individualBytes = allocatedBytesPerObject("Object (individual closures)")
+		{
+			Object(
+				identifier: "Individual:\($0)",
+				name: "\($0)",
+				data: urls[$0],
+				loadThumbnailHandler: { _,_ in throw Object.Error.loadThumbnailFailed },
+				loadMetadataHandler: { _,_ in [:] },
+				downloadFileHandler: { _,_ in throw Object.Error.downloadFileFailed },
+				in: nil)
+		}
+
+		let sharedBytes = allocatedBytesPerObject("Object (shared Handlers)")
+		{
+			Object(identifier:"Shared:\($0)", name:"\($0)", data:urls[$0], handlers:handlers, in:nil)
+		}
+
+		let recordBytes = allocatedBytesPerObject("Folder Record (lazy ObjectList)")
+		{
+			Object.Record(identifier:"Record:\($0)", name:"\($0)", mediaType:.image)
+		}
+
+		XCTAssertLessThan(sharedBytes, individualBytes)
+		XCTAssertLessThan(recordBytes, sharedBytes)
+	}
+
+	// MARK: - Benchmarks
+
+	/// Measures the memory of the Objects of each source type that can be created without a live library
+
+	func testMemoryObjectWithIndividualClosures() throws
+	{
+		measureMemory
+		{
+			Object(
+				identifier: "Object:\($0)",
+				name: "\($0)",
+				data: $0,
+				loadThumbnailHandler: { _,_ in throw Object.Error.loadThumbnailFailed },
+				loadMetadataHandler: { _,_ in [:] },
+				downloadFileHandler: { _,_ in throw Object.Error.downloadFileFailed },
+				in: nil)
+		}
+	}
+
+	func testMemoryImageFile() throws
+	{
+		measureMemory { ImageFile(url:URL(fileURLWithPath:"/Volumes/Photos/Archive/IMG_\($0).JPG"), in:nil) }
+	}
+
+	func testMemoryVideoFile() throws
+	{
+		measureMemory { VideoFile(url:URL(fileURLWithPath:"/Volumes/Movies/Archive/MOV_\($0).mov"), in:nil) }
+	}
+
+	func testMemoryAudioFile() throws
+	{
+		measureMemory { AudioFile(url:URL(fileURLWithPath:"/Volumes/Music/Archive/Track_\($0).m4a"), in:nil) }
+	}
+
+	func testMemoryFolderRecord() throws
+	{
+		measureMemory { Object.Record(identifier:"FolderSource:file:///Volumes/Photos/Lazy/IMG_\($0).JPG", name:"IMG_\($0).JPG", mediaType:.image) }
+	}
+
+	func testMemoryPexelsPhotoObject() throws
+	{
+		let photos = try (0 ..< Self.count).map { try Self.pexelsPhoto(id:$0) }
+		measureMemory { PexelsPhotoObject(with:photos[$0], in:nil) }
+	}
+
+	func testMemoryUnsplashObject() throws
+	{
+		let photos = try (0 ..< Self.count).map { try Self.unsplashPhoto(id:$0) }
+		measureMemory { UnsplashObject(with:photos[$0], in:nil) }
+	}
+
+	// MARK: - Fixtures
+
+	static func pexelsPhoto(id:Int) throws -> Pexels.Photo
+	{
+		let src = "https://images.pexels.com/photos/\(id)/pexels-photo-\(id).jpeg"
+
+		let json = """
+		{
+			"id": \(id), "width": 4000, "height": 3000, "url": "https://www.pexels.com/photo/\(id)/",
+			"photographer": "Photographer", "photographer_url": "https://www.pexels.com/@photographer", "photographer_id": 1,
+			"avg_color": "#7E7E7E", "alt": "Photo \(id)",
+			"src": { "original": "\(src)", "large2x": "\(src)", "large": "\(src)", "medium": "\(src)",
+			"small": "\(src)", "portrait": "\(src)", "landscape": "\(src)", "tiny": "\(src)" }
+		}
+		"""
+
+		return try JSONDecoder().decode(Pexels.Photo.self, from:Data(json.utf8))
+	}
+
+	static func unsplashPhoto(id:Int) throws -> UnsplashPhoto
+	{
+		let json = """
+		{
+			"id": "\(id)", "width": 4000, "height": 3000, "description": "Photo \(id)",
+			"urls": { "thumb": "https://images.unsplash.com/photo-\(id)?w=200", "full": "https://images.unsplash.com/photo-\(id)" },
+			"user": { "id": "1", "username": "photographer", "name": "Photographer" },
+			"links": { "html": "https://unsplash.com/photos/\(id)", "download_location": "https://api.unsplash.com/photos/\(id)/download" }
+		}
+		"""
+
+		return try JSONDecoder().decode(UnsplashPhoto.self, from:Data(json.utf8))
+	}
+}
@@ -0,0 +1,78 @@
+import XCTest
+@testable import BXMediaBrowser
+
+final class ObjectRegistryTests: XCTestCase
+{
+	let identifier = "FolderSource:file:///Volumes/Photos/ObjectRegistryTests/IMG_1.JPG"
+	let date = Date(timeIntervalSinceReferenceDate:700_000_000)
+
+	var createCount = 0
+
+	func makeObject() -> Object
+	{
+		createCount += 1
+
+		return Object(
+			identifier: identifier,
+			name: "IMG_1.JPG",
+			data: identifier,
+			loadThumbnailHandler: { _,_ in throw Object.Error.loadThumbnailFailed },
+			loadMetadataHandler: { _,_ in [:] },
+			downloadFileHandler: { _,_ in throw Object.Error.downloadFileFailed },
+			in: nil)
+	}
+
+	func record(fileSize:Int64 = 1000, modificationDate:Date?) -> Object.Record
+	{
+		Object.Record(identifier:identifier, name:"IMG_1.JPG", mediaType:.image, fileSize:fileSize, modificationDate:modificationDate)
+	}
+
+	func testUnchangedItemIsReused()
+	{
+		let registry = ObjectRegistry()
+		let object1 = registry.object(for:record(modificationDate:date), in:nil) { _ in self.makeObject() }
+		let object2 = registry.object(for:record(modificationDate:date), in:nil) { _ in self.makeObject() }
+
+		XCTAssertTrue(object1 === object2)
+		XCTAssertEqual(createCount, 1)
+	}
+
+	func testChangedItemIsCreatedAgain()
+	{
+		let registry = ObjectRegistry()
+		let object1 = registry.object(for:record(modificationDate:date), in:nil) { _ in self.makeObject() }
+		let object2 = registry.object(for:record(modificationDate:date.addingTimeInterval(1)), in:nil) { _ in self.makeObject() }
+		let object3 = registry.object(for:record(fileSize:2000, modificationDate:date.addingTimeInterval(1)), in:nil) { _ in self.makeObject() }
+
+		XCTAssertFalse(object1 === object2)
+		XCTAssertFalse(object2 === object3)
+		XCTAssertEqual(createCount, 3)
+	}
+
+	func testUnknownVersionIsNeverReused()
+	{
+		let registry = ObjectRegistry()
+		let object1 = registry.object(for:record(modificationDate:nil), in:nil) { _ in self.makeObject() }
+		let object2 = registry.object(for:record(modificationDate:nil), in:nil) { _ in self.makeObject() }
+
+		XCTAssertFalse(object1 === object2)
+	}
+
+	func testUnusedObjectsAreReleased()
+	{
+		let registry = ObjectRegistry()
+		let handle = IdentifierTable.shared.handle(for:identifier)
+		let version = ObjectRegistry.Version(etag:"1")
+		weak var released:Object? = nil
+
+		autoreleasepool
+		{
+			let object = registry.object(for:handle, version:version, in:nil) { self.makeObject() }
+			released = object
+			XCTAssertNotNil(registry.existingObject(for:handle, version:version, in:nil))
+		}
+
+		XCTAssertNil(released)
+		XCTAssertNil(registry.existingObject(for:handle, version:version, in:nil))
+	}
+}
@@ -0,0 +1,278 @@
+import XCTest
+import CoreGraphics
+@testable import BXMediaBrowser
+
+final class PerceptualHashIndexTests: XCTestCase
+{
+	/// A deterministic random number generator, so that the fixtures are the same for every run
+	
+	struct SplitMix64 : RandomNumberGenerator
+	{
+		var state:UInt64
+		
+		mutating func next() -> UInt64
+		{
+			state &+= 0x9E3779B97F4A7C15
+			var z = state
+			z = (z ^ (z >> 30)) &* 0xBF58476D1CE4E5B9
+			z = (z ^ (z >> 27)) &* 0x94D049BB133111EB
+			return z ^ (z >> 31)
+		}
+	}
+	
+	/// Synthetic fixture: groups of 5 near duplicates, each differing from the group original in 1-3 bits
+	
+	static func fixture(groupCount:Int, seed:UInt64 = 42) -> [(String,UInt64)]
+	{
+		var random = SplitMix64(state:seed)
+		var entries:[(String,UInt64)] = []
+		
+		for group in 0 ..< groupCount
+		{
+			let original = random.next()
+			entries.append(("IMG_\(group)_0.JPG",original))
+			
+			for copy in 1 ..< 5
+			{
+				var hash = original
+				
+				for _ in 0 ..< Int.random(in:1...3, using:&random)
+				{
+					hash ^= 1 << UInt64.random(in:0..<64, using:&random)
+				}
+				
+				entries.append(("IMG_\(group)_\(copy).JPG",hash))
+			}
+		}
+		
+		return entries
+	}
+	
+	static let fixture100k = fixture(groupCount:20_000)
+	
+	/// Reference implementation that compares all pairs
+	
+	static func bruteForceGroups(_ entries:[(String,UInt64)], maxDistance:Int) -> Set<Set<String>>
+	{
+		var parents = Array(entries.indices)
+		
+		func find(_ i:Int) -> Int
+		{
+			var i = i
+			while parents[i] != i { i = parents[i] }
+			return i
+		}
+		
+		for i in entries.indices
+		{
+			for j in i+1 ..< entries.count where PerceptualHashIndex.distance(entries[i].1,entries[j].1) <= maxDistance
+			{
+				parents[find(j)] = find(i)
+			}
+		}
+		
+		let groups = Dictionary(grouping:entries.indices, by:find).values
+		return Set(groups.filter { $0.count > 1 }.map { Set($0.map { entries[$0].0 }) })
+	}
+	
+	/// Creates a thumbnail with random gray rectangles. Variants are brightened and rendered at a different size.
+	
+	static func thumbnail(seed:UInt64, brightness:CGFloat = 0.0, size:Int = 256) -> CGImage?
+	{
+		var random = SplitMix64(state:seed)
+		let scale = CGFloat(size) / 256.0
+		let context = CGContext(data:nil, width:size, height:size*2/3, bitsPerComponent:8, bytesPerRow:0, space:CGColorSpaceCreateDeviceRGB(), bitmapInfo:CGImageAlphaInfo.premultipliedLast.rawValue)
+		
+		for _ in 0 ..< 12
+		{
+			let gray = min(1.0, CGFloat.random(in:0.0...0.8, using:&random) + brightness)
+			let x = CGFloat.random(in:0...192, using:&random) * scale
+			let y = CGFloat.random(in:0...120, using:&random) * scale
+			let w = CGFloat.random(in:32...128, using:&random) * scale
+			let h = CGFloat.random(in:24...96, using:&random) * scale
+			context?.setFillColor(CGColor(red:gray, green:gray, blue:gray, alpha:1.0))
+			context?.fill(CGRect(x:x, y:y, width:w, height:h))
+		}
+		
+		return context?.makeImage()
+	}
+	
+	// MARK: - Accuracy
+	
+	func testSimilarMatchesBruteForce() throws
+	{
+		let entries = Self.fixture(groupCount:2_000)
+		let index = PerceptualHashIndex(entries)
+		var random = SplitMix64(state:7)
+		
+		for maxDistance in [0,3,8,11]
+		{
+			for _ in 0 ..< 50
+			{
+				let query = entries[Int.random(in:entries.indices, using:&random)].1
+				let expected = Set(entries.filter { PerceptualHashIndex.distance($0.1,query) <= maxDistance }.map { $0.0 })
+				let matches = index.similar(to:query, maxDistance:maxDistance)
+				
+				XCTAssertEqual(Set(matches.map { $0.identifier }), expected)
+				XCTAssertEqual(matches.map { $0.distance }, matches.map { $0.distance }.sorted())
+			}
+		}
+	}
+	
+	func testDuplicateGroupsMatchBruteForce() throws
+	{
+		let entries = Self.fixture(groupCount:1_000)
+		let index = PerceptualHashIndex(entries)
+		
+		for maxDistance in [3,6]
+		{
+			let groups = Set(index.duplicateGroups(maxDistance:maxDistance).map { Set($0) })
+			XCTAssertEqual(groups, Self.bruteForceGroups(entries, maxDistance:maxDistance))
+		}
+		
+		// With a distance of 6 every copy is within reach of its original
+		
+		XCTAssertEqual(index.duplicateGroups(maxDistance:6).count, 1_000)
+	}
+	
+	func testInsertReplacesHash() throws
+	{
+		let index = PerceptualHashIndex()
+		index.insert(0x00FF, for:"a")
+		index.insert(0x00FE, for:"b")
+		XCTAssertEqual(index.similar(to:"a", maxDistance:1).map { $0.identifier }, ["b"])
+		
+		index.insert(0xFF00_0000, for:"b")
+		XCTAssertEqual(index.count, 2)
+		XCTAssertEqual(index.similar(to:"a", maxDistance:8), [])
+	}
+	
+	func testInsertAfterQueryUpdatesIncrementally() throws
+	{
+		var entries = Self.fixture(groupCount:1_000)
+		let index = PerceptualHashIndex(entries)
+		XCTAssertEqual(index.similar(to:entries[0].1, maxDistance:0).count, 1)
+		
+		// A new near duplicate and a changed hash are found without rebuilding the tables
+		
+		entries.append(("NEW.JPG", entries[0].1 ^ 0b101))
+		entries[5].1 = entries[10].1 ^ 1
+		index.insert(entries.last!.1, for:entries.last!.0)
+		index.insert(entries[5].1, for:entries[5].0)
+		
+		XCTAssertEqual(index.pendingCount, 2)
+		XCTAssertTrue(index.similar(to:entries[0].0, maxDistance:2).contains { $0.identifier == "NEW.JPG" })
+		XCTAssertTrue(index.similar(to:entries[10].0, maxDistance:1).contains { $0.identifier == entries[5].0 })
+		XCTAssertEqual(Set(index.duplicateGroups(maxDistance:3).map { Set($0) }), Self.bruteForceGroups(entries, maxDistance:3))
+		XCTAssertEqual(index.pendingCount, 2)
+		
+		// Once there are too many pending hashes, the tables are rebuilt
+		
+		for i in 0 ..< 1_000
+		{
+			index.insert(UInt64(i) << 20, for:"BULK_\(i).JPG")
+		}
+		
+		XCTAssertLessThan(index.pendingCount, 1_000)
+		XCTAssertEqual(index.count, entries.count + 1_000)
+	}
+	
+	func testCrowdedBucketsAreGrouped() throws
+	{
+		var entries = (0 ..< 2_000).map { ("BLANK_\($0).JPG", UInt64(0x1234)) }
+		entries.append(("NEAR.JPG", 0x1235))
+		entries.append(("FAR.JPG", 0xFFFF_FFFF_0000_0000))
+		
+		let index = PerceptualHashIndex(entries)
+		let groups = index.duplicateGroups(maxDistance:3)
+		
+		XCTAssertEqual(groups.count, 1)
+		XCTAssertEqual(groups.first?.count, 2_001)
+		XCTAssertFalse(groups.first?.contains("FAR.JPG") ?? true)
+	}
+	
+	func testHashAccuracyOnSyntheticImages() throws
+	{
+		var nearDistances:[Int] = []
+		var farDistances:[Int] = []
+		
+		for seed in 1 ... 40 as ClosedRange<UInt64>
+		{
+			let original = try XCTUnwrap(Self.thumbnail(seed:seed).flatMap { PixelAnalysis($0)?.perceptualHash })
+			let variant = try XCTUnwrap(Self.thumbnail(seed:seed, brightness:0.1, size:200).flatMap { PixelAnalysis($0)?.perceptualHash })
+			let other = try XCTUnwrap(Self.thumbnail(seed:seed + 1000).flatMap { PixelAnalysis($0)?.perceptualHash })
+			
+			nearDistances.append(PerceptualHashIndex.distance(original,variant))
+			farDistances.append(PerceptualHashIndex.distance(original,other))
+		}
+		
+		let recall = Double(nearDistances.filter { $0 <= 8 }.count) / Double(nearDistances.count)
+		let falsePositives = Double(farDistances.filter { $0 <= 8 }.count) / Double(farDistances.count)
+		
+		XCTAssertGreaterThanOrEqual(recall, 0.9)
+		XCTAssertLessThanOrEqual(falsePositives, 0.05)
+	}
+	
+	// MARK: - Benchmarks
+	
+	func testPerformanceBuild100k() throws
+	{
+		let entries = Self.fixture100k
+		
+		measure
+		{
+			let index = PerceptualHashIndex(entries)
+			XCTAssertEqual(index.similar(to:entries[0].1, maxDistance:0).count, 1)
+		}
+	}
+	
+	/// 1000 "find similar" queries over 100k hashes
+	
+	func testPerformanceSimilar100k() throws
+	{
+		let entries = Self.fixture100k
+		let index = PerceptualHashIndex(entries)
+		_ = index.similar(to:0)
+		
+		measure
+		{
+			var count = 0
+			
+			for i in stride(from:0, to:entries.count, by:100)
+			{
+				count += index.similar(to:entries[i].1, maxDistance:8).count
+			}
+			
+			XCTAssertGreaterThanOrEqual(count, 1000)
+		}
+	}
+	
+	/// Collapsing 100k hashes into groups of near duplicates
+	
+	func testPerformanceCollapse100k() throws
+	{
+		let index = PerceptualHashIndex(Self.fixture100k)
+		_ = index.similar(to:0)
+		
+		measure
+		{
+			let groups = index.duplicateGroups(maxDistance:3)
+			XCTAssertGreaterThan(groups.count, 19_000)
+		}
+	}
+	
+	/// Analyzing a 256 pixel thumbnail, including the histogram and the perceptual hash
+	
+	func testPerformancePixelAnalysis() throws
+	{
+		let thumbnail = try XCTUnwrap(Self.thumbnail(seed:1))
+		
+		measure
+		{
+			for _ in 0 ..< 100
+			{
+				XCTAssertNotNil(PixelAnalysis(thumbnail))
+			}
+		}
+	}
+}
@@ -0,0 +1,217 @@
+import XCTest
+import CoreGraphics
+@testable import BXMediaBrowser
+
+final class PixelAnalysisTests: XCTestCase
+{
+	/// Runs the analysis kernel on the specified RGB pixels. The buffer is aligned and zero-padded to a multiple
+	/// of 4 pixels, just like the buffer that PixelAnalysis renders images into.
+
+	func analyze(_ pixels:[(UInt8,UInt8,UInt8)], width:Int? = nil) -> PixelAnalysis
+	{
+		let paddedCount = (pixels.count + 3) & ~3
+		let buffer = UnsafeMutableRawPointer.allocate(byteCount:paddedCount*4, alignment:16)
+		buffer.initializeMemory(as:UInt8.self, repeating:0, count:paddedCount*4)
+		defer { buffer.deallocate() }
+
+		let bytes = buffer.assumingMemoryBound(to:UInt8.self)
+
+		for (i,(r,g,b)) in pixels.enumerated()
+		{
+			bytes[4*i+0] = r
+			bytes[4*i+1] = g
+			bytes[4*i+2] = b
+			bytes[4*i+3] = 255
+		}
+
+		let width = width ?? pixels.count
+		return PixelAnalysis(pixels:UnsafeRawPointer(buffer), width:width, height:pixels.count/width)
+	}
+
+	/// Creates a CGImage that is filled with a single color
+
+	func image(red:CGFloat, green:CGFloat, blue:CGFloat, size:Int = 32) -> CGImage?
+	{
+		guard let colorSpace = CGColorSpace(name:CGColorSpace.sRGB) else { return nil }
+		guard let context = CGContext(data:nil, width:size, height:size, bitsPerComponent:8, bytesPerRow:0, space:colorSpace, bitmapInfo:CGImageAlphaInfo.noneSkipLast.rawValue) else { return nil }
+		context.setFillColor(CGColor(colorSpace:colorSpace, components:[red,green,blue,1.0])!)
+		context.fill(CGRect(x:0, y:0, width:size, height:size))
+		return context.makeImage()
+	}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	// MARK: - Kernel
+
+	func testHistogramBins()
+	{
+		// The bin index consists of the upper 2 bits of each channel (rrggbb). 5 pixels are padded to 8.
+
+		let analysis = analyze([(255,0,0), (0,255,0), (0,0,255), (255,255,255), (0,0,0)])
+
+		XCTAssertEqual(analysis.histogram.count, PixelAnalysis.binCount)
+		XCTAssertEqual(analysis.histogram[0b110000], 51)
+		XCTAssertEqual(analysis.histogram[0b001100], 51)
+		XCTAssertEqual(analysis.histogram[0b000011], 51)
+		XCTAssertEqual(analysis.histogram[0b111111], 51)
+		XCTAssertEqual(analysis.histogram[0b000000], 51)
+		XCTAssertEqual(analysis.histogram.reduce(0) { $0 + Int($1) }, 255)
+	}
+
+	func testPaddingIsNotCounted()
+	{
+		// 3 white pixels are padded with a black one, which must not show up in the histogram or luminance
+
+		let analysis = analyze([(255,255,255), (255,255,255), (255,255,255)])
+
+		XCTAssertEqual(analysis.histogram[0], 0)
+		XCTAssertEqual(analysis.histogram[63], 255)
+		XCTAssertEqual(analysis.meanLuminance, 255)
+		XCTAssertEqual(analysis.luminanceDeviation, 0)
+		XCTAssertEqual(analysis.dominantColors.count, 1)
+		XCTAssertEqual(analysis.dominantColors.first?.colorTag, .white)
+	}
+
+	func testLuminanceStatistics()
+	{
+		let gray = analyze(Array(repeating:(128,128,128), count:16), width:4)
+		XCTAssertEqual(gray.meanLuminance, 128)
+		XCTAssertEqual(gray.luminanceDeviation, 0)
+		XCTAssertTrue(gray.isLowVariance)
+
+		let checkerboard = analyze((0 ..< 16).map { $0 % 2 == 0 ? (0,0,0) : (255,255,255) }, width:4)
+		XCTAssertEqual(checkerboard.meanLuminance, 128)
+		XCTAssertEqual(checkerboard.luminanceDeviation, 128)
+		XCTAssertFalse(checkerboard.isLowVariance)
+	}
+
+	func testDominantColors()
+	{
+		let pixels:[(UInt8,UInt8,UInt8)] = Array(repeating:(240,10,10), count:12) + Array(repeating:(10,10,240), count:4)
+		let analysis = analyze(pixels, width:4)
+
+		XCTAssertEqual(analysis.dominantColors.map { $0.colorTag }, [.red,.blue])
+		XCTAssertEqual(analysis.dominantColors.first?.red, 240)
+		XCTAssertEqual(analysis.dominantColors.first?.weight, 191)
+		XCTAssertTrue(analysis.contains(.red))
+		XCTAssertTrue(analysis.contains(.blue))
+		XCTAssertFalse(analysis.contains(.green))
+	}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	// MARK: - Black Thumbnails
+
+	func testBlackThreshold()
+	{
+		let threshold = PixelAnalysis.blackThreshold
+
+		XCTAssertTrue(analyze(Array(repeating:(threshold,threshold,threshold), count:5)).isAllBlack)
+		XCTAssertFalse(analyze(Array(repeating:(0,0,0), count:4) + [(0,threshold+1,0)]).isAllBlack)
+	}
+
+	func testBlackThumbnailIsRejected() throws
+	{
+		// This is the check that ImageFolderSource uses to reject broken embedded thumbnails
+
+		let black = try XCTUnwrap(image(red:0, green:0, blue:0))
+		let dark = try XCTUnwrap(image(red:0.2, green:0.2, blue:0.2))
+
+		XCTAssertEqual(PixelAnalysis(black)?.isAllBlack, true)
+		XCTAssertEqual(PixelAnalysis(dark)?.isAllBlack, false)
+	}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	// MARK: - Colors
+
+	func testColorTags()
+	{
+		typealias ColorTag = PixelAnalysis.ColorTag
+
+		XCTAssertEqual(ColorTag(red:255, green:0, blue:0), .red)
+		XCTAssertEqual(ColorTag(red:255, green:128, blue:0), .orange)
+		XCTAssertEqual(ColorTag(red:128, green:64, blue:0), .brown)
+		XCTAssertEqual(ColorTag(red:255, green:255, blue:0), .yellow)
+		XCTAssertEqual(ColorTag(red:0, green:255, blue:0), .green)
+		XCTAssertEqual(ColorTag(red:0, green:255, blue:255), .cyan)
+		XCTAssertEqual(ColorTag(red:0, green:0, blue:255), .blue)
+		XCTAssertEqual(ColorTag(red:128, green:0, blue:255), .purple)
+		XCTAssertEqual(ColorTag(red:255, green:0, blue:128), .pink)
+		XCTAssertEqual(ColorTag(red:255, green:255, blue:255), .white)
+		XCTAssertEqual(ColorTag(red:128, green:128, blue:128), .gray)
+		XCTAssertEqual(ColorTag(red:10, green:10, blue:10), .black)
+	}
+
+	func testBinColorTags()
+	{
+		XCTAssertEqual(PixelAnalysis.binColorTags.count, PixelAnalysis.binCount)
+		XCTAssertEqual(PixelAnalysis.binColorTags[0b000000], .black)
+		XCTAssertEqual(PixelAnalysis.binColorTags[0b110000], .red)
+		XCTAssertEqual(PixelAnalysis.binColorTags[0b001100], .green)
+		XCTAssertEqual(PixelAnalysis.binColorTags[0b000011], .blue)
+		XCTAssertEqual(PixelAnalysis.binColorTags[0b111111], .white)
+	}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	// MARK: - Store
+
+	func testStorePersistsChangedShards() throws
+	{
+		let directoryURL = FileManager.default.temporaryDirectory.appendingPathComponent("PixelAnalysisTests-\(UUID().uuidString)", isDirectory:true)
+		defer { try? FileManager.default.removeItem(at:directoryURL) }
+
+		let analysis = analyze([(255,0,0)])
+		let store = PixelAnalysis.Store(directoryURL:directoryURL, shardCount:4)
+		store.saveDelay = 0.0
+		store.setAnalysis(analysis, for:"A")
+		store.setAnalysis(analysis, for:"B")
+		store.synchronize()
+
+		let files = try FileManager.default.contentsOfDirectory(atPath:store.directoryURL.path)
+		XCTAssertEqual(files.count, Set([store.shardIndex(for:"A"), store.shardIndex(for:"B")]).count)
+
+		let reloaded = PixelAnalysis.Store(directoryURL:directoryURL, shardCount:4)
+		XCTAssertEqual(reloaded.analysis(for:"A"), analysis)
+		XCTAssertEqual(reloaded.analysis(for:"B"), analysis)
+		XCTAssertNil(reloaded.analysis(for:"C"))
+	}
+
+	func testStoreEvictsLeastRecentlyUsed() throws
+	{
+		let directoryURL = FileManager.default.temporaryDirectory.appendingPathComponent("PixelAnalysisTests-\(UUID().uuidString)", isDirectory:true)
+		defer { try? FileManager.default.removeItem(at:directoryURL) }
+
+		// Prepare a shard with 10 analyses that were last used on consecutive days
+
+		let analysis = analyze([(0,0,255)])
+		let store = PixelAnalysis.Store(directoryURL:directoryURL, shardCount:1)
+		var entries:[String:PixelAnalysis.Store.Entry] = [:]
+		for i in 0 ..< 10 { entries["old-\(i)"] = .init(analysis:analysis, lastUse:Int32(i)) }
+
+		try FileManager.default.createDirectory(at:store.directoryURL, withIntermediateDirectories:true)
+		try PropertyListEncoder().encode(entries).write(to:store.directoryURL.appendingPathComponent("0.plist"))
+
+		// Using an analysis protects it from eviction. Exceeding the maximum evicts the oldest ones.
+
+		store.maxCountPerShard = 10
+		XCTAssertNotNil(store.analysis(for:"old-0"))
+		store.setAnalysis(analysis, for:"new")
+
+		XCTAssertEqual(store.count, 9)
+		XCTAssertNotNil(store.analysis(for:"old-0"))
+		XCTAssertNil(store.analysis(for:"old-1"))
+		XCTAssertNil(store.analysis(for:"old-2"))
+		XCTAssertNotNil(store.analysis(for:"old-3"))
+		XCTAssertNotNil(store.analysis(for:"new"))
+	}
+}
@@ -0,0 +1,113 @@
+import XCTest
+import Combine
+@testable import BXMediaBrowser
+
+final class PreloaderTests: XCTestCase
+{
+	typealias Model = Library.Preloader.Model
+
+	/// Feeds a sequence of selections into a new Model
+
+	func model(_ identifiers:[String], siblings:[String] = []) -> Model
+	{
+		var model = Model()
+		var previous:String? = nil
+
+		for identifier in identifiers
+		{
+			let isSiblingStep = previous.map { siblings.contains($0) && siblings.contains(identifier) } ?? false
+			model.learn(from:previous, to:identifier, isSiblingStep:isSiblingStep)
+			previous = identifier
+		}
+
+		return model
+	}
+
+	func testTransitionFrequency()
+	{
+		let model = self.model(["A","B","A","B","A","B","A","C","A"])
+		let predictions = model.predictions(for:"A", previous:"C", siblings:[])
+
+		XCTAssertEqual(model.transitions["A"]?["B"], 3)
+		XCTAssertEqual(model.transitions["A"]?["C"], 1)
+		XCTAssertEqual(predictions.first?.identifier, "B")
+		XCTAssertFalse(predictions.contains { $0.identifier == "A" })
+	}
+
+	func testSiblingSteps()
+	{
+		let siblings = ["S1","S2","S3","S4","S5"]
+
+		let forward = self.model(["S1","S2","S3"], siblings:siblings)
+		XCTAssertEqual(forward.siblingStepCount, 2)
+		XCTAssertEqual(forward.predictions(for:"S3", previous:"S2", siblings:siblings).first?.identifier, "S4")
+
+		let backward = self.model(["S5","S4","S3"], siblings:siblings)
+		XCTAssertEqual(backward.predictions(for:"S3", previous:"S4", siblings:siblings).first?.identifier, "S2")
+	}
+
+	func testRecentReturns()
+	{
+		let model = self.model(["Overview","X1","Overview","X2","Overview","X3","Overview","X4"])
+		let predictions = model.predictions(for:"X4", previous:"Overview", siblings:[])
+
+		XCTAssertEqual(model.returnCount, 3)
+		XCTAssertEqual(predictions.first?.identifier, "Overview")
+		XCTAssertLessThanOrEqual(model.recentIdentifiers.count, Model.maxRecentCount)
+	}
+
+	func testDecay()
+	{
+		let model = self.model((0 ..< 200).map { $0 % 2 == 0 ? "A" : "B" })
+
+		XCTAssertLessThanOrEqual(model.transitions["A"]?.values.reduce(0,+) ?? 0, Model.maxWeight)
+		XCTAssertLessThanOrEqual(model.transitionCount, Model.maxWeight * 4)
+		XCTAssertTrue(model.predictions(for:"A", previous:"B", siblings:[]).allSatisfy { $0.score <= 1 })
+	}
+
+	func testPersistence() throws
+	{
+		let fileURL = FileManager.default.temporaryDirectory.appendingPathComponent("PreloaderTests-\(UUID().uuidString).navigation")
+		defer { try? FileManager.default.removeItem(at:fileURL) }
+
+		let model = self.model(["A","B","A","C"])
+		try JSONEncoder().encode(model).write(to:fileURL)
+
+		let preloader = Library.Preloader(fileURL:fileURL)
+		XCTAssertEqual(preloader.model.transitions, model.transitions)
+		XCTAssertEqual(preloader.model.recentIdentifiers, ["B","A","C"])
+	}
+
+	func testWaiterReceivesEarlyValues() async throws
+	{
+		let subject = CurrentValueSubject<Int,Never>(0)
+		let waiter = Library.Preloader.Waiter(subject.filter { $0 == 1 })
+		subject.send(1)
+
+		let start = Date()
+		try await waiter.wait(timeout:5)
+		XCTAssertLessThan(Date().timeIntervalSince(start), 1)
+	}
+
+	func testWaiterTimeout() async throws
+	{
+		let subject = PassthroughSubject<Int,Never>()
+		let waiter = Library.Preloader.Waiter(subject)
+
+		let start = Date()
+		try await waiter.wait(timeout:0.05)
+		XCTAssertLessThan(Date().timeIntervalSince(start), 1)
+	}
+
+	func testWaiterCancellation() async
+	{
+		let subject = PassthroughSubject<Int,Never>()
+		let waiter = Library.Preloader.Waiter(subject)
+
+		let task = Task { try await waiter.wait(timeout:30) }
+		task.cancel()
+
+		let result = await task.result
+		XCTAssertThrowsError(try result.get()) { XCTAssertTrue($0 is CancellationError) }
+	}
+}
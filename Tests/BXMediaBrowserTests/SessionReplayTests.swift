@@ -0,0 +1,124 @@
+import XCTest
+@testable import BXMediaBrowser
+
+final class SessionReplayTests: XCTestCase
+{
+	var folderURL:URL!
+	var sessionURL:URL!
+
+	override func setUpWithError() throws
+	{
+		let tmpURL = FileManager.default.temporaryDirectory.resolvingSymlinksInPath()
+		folderURL = tmpURL.appendingPathComponent("SessionReplayTests-\(UUID().uuidString)")
+		sessionURL = tmpURL.appendingPathComponent("SessionReplayTests-\(UUID().uuidString).json")
+
+		let subfolderURL = folderURL.appendingPathComponent("Sub")
+		try FileManager.default.createDirectory(at:subfolderURL, withIntermediateDirectories:true)
+
+		for name in ["a.txt","b.txt","c.txt"]
+		{
+			try Data(name.utf8).write(to:subfolderURL.appendingPathComponent(name))
+		}
+	}
+
+	override func tearDownWithError() throws
+	{
+		try? FileManager.default.removeItem(at:folderURL)
+		try? FileManager.default.removeItem(at:sessionURL)
+	}
+
+	/// Creates a Library with a single Source, whose only top-level Container is the fixture folder
+
+	func makeLibrary() -> Library
+	{
+		let library = Library(identifier:"SessionReplayTests-\(UUID().uuidString)")
+		library.stateStore = nil
+		library.startupSnapshot = nil
+
+		let section = Section(identifier:"Section", name:nil, in:library)
+		let source = Source(identifier:"SessionReplayTests", name:"Test", filter:FolderFilter(), in:library)
+		let folderURL = self.folderURL!
+
+		source.loader = Source.Loader
+		{
+			_,filter,library in
+			[FolderContainer(url:folderURL, filter:filter as? FolderFilter ?? FolderFilter(), in:library)]
+		}
+
+		section.addSource(source)
+		library.addSection(section)
+		return library
+	}
+
+	@MainActor func testRecordingRoundtrip() throws
+	{
+		let library = makeLibrary()
+		let container = Container(identifier:"Test:1", name:"1", data:1, filter:Object.Filter(), loadHandler:{ _,_,_,_ in ([],[]) }, in:library)
+		let recorder = Library.SessionRecorder(for:library, fileURL:sessionURL)
+		library.sessionRecorder = recorder
+
+		library.selectedContainer = container
+		library.selectedContainer = container
+		container.setExpandedByUser(true)
+		container.isExpanded = false
+		container.isExpanded = true
+		recorder.recordVisibleRange(0...9, in:container)
+		recorder.recordFilter(of:container)
+		library.selectedContainer = nil
+		recorder.save()
+
+		let session = try Library.Session(contentsOf:sessionURL)
+		XCTAssertEqual(session.library, library.identifier)
+		XCTAssertEqual(session.steps.map { $0.action }, [.select,.expand,.visibleRange,.filter,.select])
+		XCTAssertEqual(session.steps[2].range, 0...9)
+		XCTAssertEqual(session.steps[3].sortDirection, .ascending)
+		XCTAssertNil(session.steps[4].container)
+		XCTAssertEqual(session.steps.map { $0.time }, session.steps.map { $0.time }.sorted())
+	}
+
+	@MainActor func testReplayAgainstFixtureFolder() async throws
+	{
+		let library = makeLibrary()
+		let replayer = Library.SessionReplayer(library:library)
+		replayer.timeout = 10
+
+		// Expanding the top-level Container loads the Source first
+
+		let rootIdentifier = FolderSource.identifier(for:folderURL)
+		var session = Library.Session(library:library.identifier)
+		session.steps = [Library.Session.Step(time:0, action:.expand, container:rootIdentifier)]
+
+		var report = try await replayer.replay(session)
+		XCTAssertEqual(report.failureCount, 0, report.description)
+
+		let root = try XCTUnwrap(replayer.loadedContainer(with:rootIdentifier))
+		let subfolder = try XCTUnwrap(root.containers.first)
+
+		// Select the subfolder, scroll and search
+
+		var filter = Library.Session.Step(time:0.3, action:.filter, container:subfolder.identifier)
+		filter.searchString = "b"
+		var visibleRange = Library.Session.Step(time:0.2, action:.visibleRange, container:subfolder.identifier)
+		visibleRange.range = 0...2
+
+		session.steps = [Library.Session.Step(time:0.1, action:.select, container:subfolder.identifier), visibleRange, filter]
+
+		report = try await replayer.replay(session)
+		XCTAssertEqual(report.failureCount, 0, report.description)
+		XCTAssertEqual(report.results.map { $0.action }, [.select,.visibleRange,.filter])
+		XCTAssertTrue(library.selectedContainer === subfolder)
+		XCTAssertEqual(subfolder.objects.count, 1)
+
+		// Drag the remaining Object, and a missing one
+
+		var drag = Library.Session.Step(time:0.4, action:.drag, container:subfolder.identifier)
+		drag.objects = [subfolder.objects.record(at:0).identifier]
+		var missing = drag
+		missing.objects = ["SessionReplayTests:missing"]
+		session.steps = [drag,missing]
+
+		report = try await replayer.replay(session)
+		XCTAssertNil(report.results[0].error)
+		XCTAssertNotNil(report.results[1].error)
+	}
+}
@@ -0,0 +1,199 @@
+import XCTest
+import CoreGraphics
+@testable import BXMediaBrowser
+
+final class StartupSnapshotTests: XCTestCase
+{
+	/// A synthetic selected Container with the first screen of Objects and their thumbnails
+	
+	static let containerIdentifier = "FolderSource:file:///Volumes/Photos/Archive/2024/Imports"
+	
+	static let objects:[(identifier:String, handle:IdentifierHandle, name:String, thumbnail:CGImage?)] = (0 ..< 60).map
+	{
+		let identifier = "\(containerIdentifier)/IMG_\($0).JPG"
+		return (identifier, IdentifierTable.shared.handle(for:identifier), "IMG_\($0).JPG", thumbnail(gray:CGFloat($0) / 60.0))
+	}
+	
+	static func thumbnail(gray:CGFloat) -> CGImage?
+	{
+		let context = CGContext(data:nil, width:256, height:171, bitsPerComponent:8, bytesPerRow:0, space:CGColorSpaceCreateDeviceRGB(), bitmapInfo:CGImageAlphaInfo.premultipliedLast.rawValue)
+		context?.setFillColor(CGColor(red:gray, green:0.5, blue:1.0-gray, alpha:1.0))
+		context?.fill(CGRect(x:0, y:0, width:256, height:171))
+		return context?.makeImage()
+	}
+	
+	static let container = Container(
+		identifier: containerIdentifier,
+		name: "Imports",
+		data: containerIdentifier,
+		filter: Object.Filter(),
+		loadHandler: { _,_,_,_ in ([],[]) },
+		in: nil)
+	
+	var fileURL:URL!
+	
+	override func setUp()
+	{
+		fileURL = FileManager.default.temporaryDirectory.appendingPathComponent("StartupSnapshotTests-\(UUID().uuidString).snapshot")
+		StartupSnapshot(fileURL:fileURL).save(selectedContainerIdentifier:Self.containerIdentifier, objects:Self.objects)
+	}
+	
+	override func tearDown()
+	{
+		try? FileManager.default.removeItem(at:fileURL)
+	}
+	
+	func testRoundtrip() async throws
+	{
+		let snapshot = StartupSnapshot(fileURL:fileURL)
+		XCTAssertEqual(snapshot.selectedContainerIdentifier, Self.containerIdentifier)
+		XCTAssertEqual(snapshot.records.count, 60)
+		
+		let placeholders = try XCTUnwrap(snapshot.placeholderObjects(for:Self.container, in:nil))
+		XCTAssertEqual(placeholders.map { $0.identifier }, Self.objects.map { $0.identifier })
+		XCTAssertNil(snapshot.placeholderObjects(for:Self.container, in:nil))
+		
+		let image = try await placeholders[0].loader.thumbnailImage
+		XCTAssertEqual(image.width, 256)
+	}
+	
+	/// Loads a Container that was recorded in the snapshot, but now only contains the first two Objects
+	
+	@MainActor func loadContainer(in library:Library, failing:Bool = false) async throws -> Container
+	{
+		let container = Container(
+			identifier: Self.containerIdentifier,
+			name: "Imports",
+			data: Self.containerIdentifier,
+			filter: Object.Filter(),
+			loadHandler:
+			{
+				_,_,_,library in
+				try await Task.sleep(nanoseconds:200_000_000)
+				if failing { throw Container.Error.loadContentsFailed }
+				
+				let objects = Self.objects.prefix(2).map
+				{
+					object in
+					
+					Object(
+						identifier: object.identifier,
+						name: object.name,
+						data: 0,
+						loadThumbnailHandler: { _,_ in throw Object.Error.loadThumbnailFailed },
+						loadMetadataHandler: { _,_ in [:] },
+						downloadFileHandler: { _,_ in URL(fileURLWithPath:"/tmp/\(object.name)") },
+						in: library)
+				}
+				
+				return ([],ObjectList(objects))
+			},
+			in: library)
+		
+		container.load(in:library)
+		
+		while container.objects.isEmpty
+		{
+			try await Task.sleep(nanoseconds:1_000_000)
+		}
+		
+		return container
+	}
+	
+	@MainActor func testPlaceholderDownloadsAreResolved() async throws
+	{
+		let library = Library(identifier:"StartupSnapshotTests-\(UUID().uuidString)")
+		library.stateStore = nil
+		library.startupSnapshot = StartupSnapshot(fileURL:fileURL)
+		
+		let container = try await loadContainer(in:library)
+		library.selectedContainer = container
+		XCTAssertEqual(container.objects.count, 60)
+		
+		let placeholder = container.objects[0]
+		let removedPlaceholder = container.objects[5]
+		XCTAssertTrue(placeholder is StartupSnapshot.Placeholder)
+		
+		// Downloads wait for the real Objects. Objects that no longer exist cannot be downloaded.
+		
+		let url = try await placeholder.localFileURL
+		XCTAssertEqual(url.lastPathComponent, "IMG_0.JPG")
+		XCTAssertFalse(container.objects[0] is StartupSnapshot.Placeholder)
+		
+		do
+		{
+			_ = try await removedPlaceholder.localFileURL
+			XCTFail("Expected download of removed placeholder to fail")
+		}
+		catch
+		{
+			XCTAssertEqual(error as? Object.Error, .downloadFileFailed)
+		}
+	}
+	
+	@MainActor func testCaptureIsOnlyRequestedForFirstScreen() async throws
+	{
+		let snapshot = StartupSnapshot(fileURL:fileURL)
+		snapshot.maxObjectCount = 1
+		
+		let library = Library(identifier:"StartupSnapshotTests-\(UUID().uuidString)")
+		library.stateStore = nil
+		library.startupSnapshot = snapshot
+		
+		let container = try await loadContainer(in:library)
+		while container.isLoading { try await Task.sleep(nanoseconds:1_000_000) }
+		library.selectedContainer = container
+		
+		let requestCounter = snapshot.requestCounter
+		snapshot.setNeedsCapture(for:container.objects[1])
+		XCTAssertEqual(snapshot.requestCounter, requestCounter)
+		
+		snapshot.setNeedsCapture(for:container.objects[0])
+		XCTAssertEqual(snapshot.requestCounter, requestCounter+1)
+		
+		library.selectedContainer = nil
+		snapshot.setNeedsCapture(for:container.objects[0])
+		XCTAssertEqual(snapshot.requestCounter, requestCounter+1)
+	}
+	
+	@MainActor func testPlaceholderContainerIsSelectedAtLaunch() async throws
+	{
+		let library = Library(identifier:"StartupSnapshotTests-\(UUID().uuidString)")
+		library.stateStore = nil
+		library.startupSnapshot = StartupSnapshot(fileURL:fileURL)
+		library.load(with:[library.selectedContainerIdentifierKey:Self.containerIdentifier])
+		
+		// The first screen is displayed before the real Container even exists
+		
+		let placeholderContainer = try XCTUnwrap(library.selectedContainer)
+		XCTAssertTrue(placeholderContainer is StartupSnapshot.PlaceholderContainer)
+		while !placeholderContainer.isLoaded { try await Task.sleep(nanoseconds:1_000_000) }
+		XCTAssertEqual(placeholderContainer.objects.count, 60)
+		
+		// The real Container takes over the same placeholders until its own Objects have been loaded
+		
+		let container = try await loadContainer(in:library)
+		while library.selectedContainer !== container { try await Task.sleep(nanoseconds:1_000_000) }
+		XCTAssertTrue(container.objects[0] === placeholderContainer.objects[0])
+		
+		while container.isLoading { try await Task.sleep(nanoseconds:1_000_000) }
+		XCTAssertEqual(container.objects.count, 2)
+	}
+	
+	@MainActor func testPlaceholdersAreRemovedWhenLoadFails() async throws
+	{
+		let library = Library(identifier:"StartupSnapshotTests-\(UUID().uuidString)")
+		library.stateStore = nil
+		library.startupSnapshot = StartupSnapshot(fileURL:fileURL)
+		
+		let container = try await loadContainer(in:library, failing:true)
+		XCTAssertEqual(container.objects.count, 60)
+		
+		while container.isLoading { try await Task.sleep(nanoseconds:1_000_000) }
+		XCTAssertTrue(container.objects.isEmpty)
+		XCTAssertEqual(container.objectCount, 0)
+	}
+}
+
+
+fileprivate typealias StartupSnapshot = Library.StartupSnapshot
@@ -0,0 +1,160 @@
+import XCTest
+@testable import BXMediaBrowser
+
+final class StateStoreTests: XCTestCase
+{
+	var fileURL:URL!
+
+	override func setUp()
+	{
+		fileURL = FileManager.default.temporaryDirectory.appendingPathComponent("StateStoreTests-\(UUID().uuidString).plist")
+	}
+
+	override func tearDown()
+	{
+		try? FileManager.default.removeItem(at:fileURL)
+	}
+
+	/// Creates a Library with a single Section and Source
+
+	func makeLibrary() -> (Library,Section,Source)
+	{
+		let library = Library(identifier:"StateStoreTests-\(UUID().uuidString)")
+		library.stateStore = nil
+		library.startupSnapshot = nil
+
+		let section = Section(identifier:"Section", name:nil, in:library)
+		let source = Source(identifier:"com.boinx.Source", name:"Test", filter:FolderFilter(), in:library)
+		section.addSource(source)
+		library.addSection(section)
+
+		return (library,section,source)
+	}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	/// A Library that provides its own storage mechanism
+	
+	final class CustomLibrary : Library
+	{
+		private(set) var savedState:[String:Any]? = nil
+		
+		override func saveState(_ state:[String:Any])
+		{
+			self.savedState = state
+		}
+	}
+	
+	@MainActor func testCustomStorageIsUsedByDefault() async
+	{
+		let library = CustomLibrary(identifier:"StateStoreTests-\(UUID().uuidString)")
+		library.startupSnapshot = nil
+		XCTAssertNil(library.stateStore)
+		
+		library.setNeedsSaveState()
+		
+		let deadline = Date(timeIntervalSinceNow:5.0)
+		
+		while library.savedState == nil && Date() < deadline
+		{
+			try? await Task.sleep(nanoseconds:10_000_000)
+		}
+		
+		XCTAssertNotNil(library.savedState)
+	}
+	
+	func testImportSplitsLegacyState()
+	{
+		let (library,section,source) = makeLibrary()
+
+		let legacyState:[String:Any] =
+		[
+			library.selectedContainerIdentifierKey : "A",
+			section.stateKey :
+			[
+				"isExpanded" : true,
+				source.stateKey :
+				[
+					"isExpanded" : true,
+					"other" : 1,
+					"A" : [ "isExpanded":true, "B":["isExpanded":false] ]
+				]
+			]
+		]
+
+		let store = Library.StateStore(fileURL:fileURL)
+		XCTAssertTrue(store.isEmpty)
+		store.importLegacyState(legacyState, for:library)
+		store.synchronize()
+
+		// Check the split entries, both in memory and after reading the file again
+
+		for store in [store, Library.StateStore(fileURL:fileURL)]
+		{
+			XCTAssertEqual(store.state(forKey:library.stateStoreKey)?[library.selectedContainerIdentifierKey] as? String, "A")
+
+			let sectionState = store.state(forKey:section.stateStoreKey)
+			XCTAssertEqual(sectionState?["isExpanded"] as? Bool, true)
+			XCTAssertNil(sectionState?[source.stateKey])
+
+			let sourceState = store.state(forKey:source.stateStoreKey)
+			XCTAssertEqual(sourceState?["isExpanded"] as? Bool, true)
+			XCTAssertEqual(sourceState?["other"] as? Int, 1)
+			XCTAssertNil(sourceState?["A"])
+
+			let containerState = store.state(forKey:"container/A")
+			XCTAssertEqual(containerState?["isExpanded"] as? Bool, true)
+			XCTAssertNil(containerState?["B"])
+			XCTAssertEqual(store.state(forKey:"container/B")?["isExpanded"] as? Bool, false)
+		}
+	}
+
+	func testSaveAndRestore() async
+	{
+		let store = Library.StateStore(fileURL:fileURL)
+		store.setNeedsSave(forKey:"source/S") { ["isExpanded":false] }
+		store.setNeedsSave(forKey:"container/X") { ["isExpanded":true] }
+		await store.save()
+		store.synchronize()
+
+		let restored = Library.StateStore(fileURL:fileURL)
+		XCTAssertEqual(restored.state(forKey:"source/S")?["isExpanded"] as? Bool, false)
+		XCTAssertEqual(restored.state(forKey:"container/X")?["isExpanded"] as? Bool, true)
+		XCTAssertNil(restored.state(forKey:"container/Y"))
+	}
+
+	func testCollapsedContainersAreNotStored() async
+	{
+		let store = Library.StateStore(fileURL:fileURL)
+		store.setNeedsSave(forKey:"container/X") { ["isExpanded":true] }
+		await store.save()
+
+		store.setNeedsSave(forKey:"container/X") { ["isExpanded":false] }
+		await store.save()
+		store.synchronize()
+
+		XCTAssertNil(store.state(forKey:"container/X"))
+		XCTAssertTrue(Library.StateStore(fileURL:fileURL).isEmpty)
+	}
+
+	func testRemoveState() async
+	{
+		let store = Library.StateStore(fileURL:fileURL)
+		store.setNeedsSave(forKey:"container/X") { ["isExpanded":true] }
+		store.setNeedsSave(forKey:"container/Y") { ["isExpanded":true] }
+		await store.save()
+
+		// Pending changes of removed nodes are discarded too
+
+		store.setNeedsSave(forKey:"container/X") { ["isExpanded":true] }
+		store.removeState(forKeys:["container/X"])
+		await store.save()
+		store.synchronize()
+
+		let restored = Library.StateStore(fileURL:fileURL)
+		XCTAssertNil(restored.state(forKey:"container/X"))
+		XCTAssertNotNil(restored.state(forKey:"container/Y"))
+	}
+}
@@ -0,0 +1,127 @@
+import XCTest
+@testable import BXMediaBrowser
+
+final class StatisticsJournalTests: XCTestCase
+{
+	typealias Journal = StatisticsController.Journal
+
+	var directoryURL:URL!
+
+	override func setUpWithError() throws
+	{
+		directoryURL = FileManager.default.temporaryDirectory.appendingPathComponent("StatisticsJournalTests-\(UUID().uuidString)", isDirectory:true)
+	}
+
+	override func tearDownWithError() throws
+	{
+		try? FileManager.default.removeItem(at:directoryURL)
+	}
+
+	func handle(_ identifier:String) -> IdentifierHandle
+	{
+		IdentifierTable.shared.handle(for:identifier)
+	}
+
+	func fileURL(_ journal:Journal, _ name:String) -> URL
+	{
+		journal.directoryURL.appendingPathComponent(name)
+	}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	func testIncrementIsAtomic()
+	{
+		let journal = Journal(directoryURL:directoryURL, shardCount:1)
+		let handle = self.handle("A")
+
+		DispatchQueue.concurrentPerform(iterations:1000)
+		{
+			_ in journal.increment(.useCount, for:handle)
+		}
+
+		XCTAssertEqual(journal.value(.useCount, for:handle), 1000)
+		XCTAssertEqual(journal.increment(.useCount, by:-1000, for:handle), 0)
+	}
+
+	func testReplayAfterCrashBeforeJournalWasDeleted() throws
+	{
+		let journal = Journal(directoryURL:directoryURL, shardCount:1)
+		journal.setValue(3, .rating, for:"A")
+		journal.setValue(1, .rating, for:"B")
+		journal.increment(.useCount, for:handle("A"))
+		journal.setValue(0, .rating, for:"B")
+		journal.synchronize()
+
+		// Simulate a crash during compaction: the new snapshot was written, but the journal wasn't deleted yet.
+		// The last record was only partially written.
+
+		var journalData = try Data(contentsOf:fileURL(journal,"0.journal"))
+		var values:[IdentifierHandle:Journal.Values] = [:]
+		Journal.replayJournal(journalData, into:&values)
+		try Journal.snapshotData(for:values).write(to:fileURL(journal,"0.snapshot"))
+
+		journalData.append(Journal.journalRecord(kind:.rating, value:5, identifier:"C")!.dropLast(2))
+		try journalData.write(to:fileURL(journal,"0.journal"))
+
+		// Replaying the journal on top of the snapshot yields the same values
+
+		let reloaded = Journal(directoryURL:directoryURL, shardCount:1)
+		XCTAssertEqual(reloaded.value(.rating, for:"A"), 3)
+		XCTAssertEqual(reloaded.value(.useCount, for:"A"), 1)
+		XCTAssertEqual(reloaded.value(.rating, for:"B"), 0)
+		XCTAssertEqual(reloaded.value(.rating, for:"C"), 0)
+	}
+
+	func testCompaction() throws
+	{
+		let journal = Journal(directoryURL:directoryURL, shardCount:1)
+		journal.compactionThreshold = 4
+
+		for i in 0 ..< 10
+		{
+			journal.setValue(i+1, .rating, for:"IMG_\(i).JPG")
+		}
+
+		journal.synchronize()
+
+		XCTAssertTrue(FileManager.default.fileExists(atPath:fileURL(journal,"0.snapshot").path))
+		XCTAssertFalse(FileManager.default.fileExists(atPath:fileURL(journal,"0.journal").path))
+
+		// New changes are appended to a new journal
+
+		journal.setValue(42, .rating, for:"IMG_0.JPG")
+		journal.synchronize()
+
+		XCTAssertTrue(FileManager.default.fileExists(atPath:fileURL(journal,"0.journal").path))
+
+		let reloaded = Journal(directoryURL:directoryURL, shardCount:1)
+		XCTAssertEqual(reloaded.value(.rating, for:"IMG_0.JPG"), 42)
+		XCTAssertEqual(reloaded.value(.rating, for:"IMG_9.JPG"), 10)
+		XCTAssertEqual(reloaded.allValues(.rating).count, 10)
+	}
+
+	func testImportLegacyRatings() throws
+	{
+		let suiteName = "StatisticsJournalTests-\(UUID().uuidString)"
+		let defaults = try XCTUnwrap(UserDefaults(suiteName:suiteName))
+		defer { defaults.removePersistentDomain(forName:suiteName) }
+
+		defaults.set(["A":2, "B":0, "C":5], forKey:"rating")
+
+		let journal = Journal(directoryURL:directoryURL, shardCount:4)
+		journal.importLegacyRatings(from:defaults, forKey:"rating")
+
+		XCTAssertNil(defaults.dictionary(forKey:"rating"))
+
+		let reloaded = Journal(directoryURL:directoryURL, shardCount:4)
+		XCTAssertEqual(reloaded.allValues(.rating), ["A":2, "C":5])
+
+		// A second import doesn't find anything
+
+		journal.setValue(1, .rating, for:"A")
+		journal.importLegacyRatings(from:defaults, forKey:"rating")
+		XCTAssertEqual(journal.value(.rating, for:"A"), 1)
+	}
+}
@@ -0,0 +1,67 @@
+import XCTest
+@testable import BXMediaBrowser
+
+final class SubfolderProbeTests: XCTestCase
+{
+	var rootURL:URL!
+
+	override func setUpWithError() throws
+	{
+		rootURL = FileManager.default.temporaryDirectory.appendingPathComponent("SubfolderProbeTests-\(UUID().uuidString)", isDirectory:true)
+		try FileManager.default.createDirectory(at:rootURL, withIntermediateDirectories:true)
+	}
+
+	override func tearDownWithError() throws
+	{
+		try? FileManager.default.removeItem(at:rootURL)
+	}
+
+	func folder(_ name:String) throws -> URL
+	{
+		let url = rootURL.appendingPathComponent(name, isDirectory:true)
+		try FileManager.default.createDirectory(at:url, withIntermediateDirectories:true)
+		return url
+	}
+
+	func testEmptyFolder() throws
+	{
+		let url = try folder("Empty")
+		XCTAssertFalse(SubfolderProbe().hasSubfolders(at:url))
+	}
+
+	func testFilesOnly() throws
+	{
+		let url = try folder("Files")
+		try Data([1,2,3]).write(to:url.appendingPathComponent("IMG_1.JPG"))
+		try Data([1,2,3]).write(to:url.appendingPathComponent("IMG_2.JPG"))
+		XCTAssertFalse(SubfolderProbe().hasSubfolders(at:url))
+	}
+
+	func testHiddenSubfolder() throws
+	{
+		let url = try folder("Hidden")
+		_ = try folder("Hidden/.thumbnails")
+		XCTAssertFalse(SubfolderProbe().hasSubfolders(at:url))
+	}
+
+	func testSubfolder() throws
+	{
+		let url = try folder("Nested")
+		try Data([1,2,3]).write(to:url.appendingPathComponent("IMG_1.JPG"))
+		_ = try folder("Nested/2024")
+		XCTAssertTrue(SubfolderProbe().hasSubfolders(at:url))
+	}
+
+	func testCacheIsValidatedWithModificationDate() throws
+	{
+		let probe = SubfolderProbe()
+		let url = try folder("Changing")
+		XCTAssertFalse(probe.hasSubfolders(at:url))
+
+		_ = try folder("Changing/New")
+		XCTAssertTrue(probe.hasSubfolders(at:url))
+
+		try FileManager.default.removeItem(at:url.appendingPathComponent("New"))
+		XCTAssertFalse(probe.hasSubfolders(at:url))
+	}
+}
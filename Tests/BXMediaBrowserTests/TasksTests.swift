@@ -0,0 +1,123 @@
+import XCTest
+@testable import BXMediaBrowser
+
+final class TasksTests: XCTestCase
+{
+	override func tearDown() async throws
+	{
+		await MainActor.run { Tasks.resume() }
+	}
+
+	/// Waits until the condition is met or the timeout has expired
+
+	func wait(timeout:Double = 5.0, until condition:()->Bool) async
+	{
+		let deadline = Date(timeIntervalSinceNow:timeout)
+
+		while !condition() && Date() < deadline
+		{
+			try? await Task.sleep(nanoseconds:1_000_000)
+		}
+	}
+
+	/// Returns a Task that returns true once it is allowed to continue
+
+	func parkedTask(_ priority:Tasks.Priority) -> Task<Bool,Error>
+	{
+		Task.detached
+		{
+			try await Tasks.canContinue(priority)
+			return true
+		}
+	}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+
+
+	@MainActor func testParkAndResume() async throws
+	{
+		Tasks.suspend([.indexing])
+		XCTAssertTrue(Tasks.isSuspended)
+		XCTAssertTrue(Tasks.isSuspended(.indexing))
+		XCTAssertFalse(Tasks.isSuspended(.thumbnail))
+
+		let task = parkedTask(.indexing)
+		await wait { Tasks.parkedCount(for:.indexing) == 1 }
+		XCTAssertEqual(Tasks.parkedCount, 1)
+
+		// Other priority classes are not affected
+
+		let didContinue = try await parkedTask(.thumbnail).value
+		XCTAssertTrue(didContinue)
+		XCTAssertEqual(Tasks.parkedCount, 1)
+
+		Tasks.resume([.indexing])
+		let didResume = try await task.value
+
+		XCTAssertTrue(didResume)
+		XCTAssertFalse(Tasks.isSuspended)
+		XCTAssertEqual(Tasks.parkedCount, 0)
+	}
+
+	@MainActor func testCancelWhileParked() async
+	{
+		Tasks.suspend()
+
+		let task = parkedTask(.contents)
+		await wait { Tasks.parkedCount == 1 }
+		XCTAssertEqual(Tasks.parkedCount(for:.contents), 1)
+
+		task.cancel()
+		let result = await task.result
+
+		XCTAssertThrowsError(try result.get()) { XCTAssertTrue($0 is CancellationError) }
+		XCTAssertEqual(Tasks.parkedCount, 0)
+		XCTAssertTrue(Tasks.isSuspended(.contents))
+	}
+
+	@MainActor func testCancelledTaskIsNotParked() async
+	{
+		Tasks.suspend()
+
+		let task = Task.detached
+		{
+			() -> Bool in
+			withUnsafeCurrentTask { $0?.cancel() }
+			try await Tasks.canContinue(.metadata)
+			return true
+		}
+
+		let result = await task.result
+		XCTAssertThrowsError(try result.get())
+		XCTAssertEqual(Tasks.parkedCount, 0)
+	}
+
+	@MainActor func testParkedCountPerPriority() async throws
+	{
+		Tasks.suspend()
+
+		let tasks = [parkedTask(.indexing), parkedTask(.indexing), parkedTask(.metadata)]
+		await wait { Tasks.parkedCount == 3 }
+
+		XCTAssertEqual(Tasks.parkedCount(for:.indexing), 2)
+		XCTAssertEqual(Tasks.parkedCount(for:.metadata), 1)
+		XCTAssertEqual(Tasks.parkedCount(for:.thumbnail), 0)
+
+		Tasks.resume([.metadata])
+		let didResume = try await tasks[2].value
+
+		XCTAssertTrue(didResume)
+		XCTAssertEqual(Tasks.parkedCount, 2)
+
+		Tasks.resume()
+
+		for task in tasks
+		{
+			let didResume = try await task.value
+			XCTAssertTrue(didResume)
+		}
+
+		XCTAssertEqual(Tasks.parkedCount, 0)
+	}
+}
@@ -0,0 +1,62 @@
+import XCTest
+@testable import BXMediaBrowser
+
+final class TraceRecorderTests: XCTestCase
+{
+	func testDisabledRecorderIgnoresSpans() throws
+	{
+		let recorder = TraceRecorder(capacity:10, isEnabled:false)
+		var isEvaluated = false
+
+		let span = recorder.begin("Test","disabled",{ isEvaluated = true; return [:] }())
+		recorder.end(span)
+
+		XCTAssertFalse(isEvaluated)
+		XCTAssertTrue(recorder.recordedEvents.isEmpty)
+	}
+
+	func testRingBufferKeepsNewestEvents() throws
+	{
+		let recorder = TraceRecorder(capacity:3, isEnabled:true)
+
+		for i in 0 ..< 5
+		{
+			recorder.end(recorder.begin("Test","span",["i":String(i)]))
+		}
+
+		XCTAssertEqual(recorder.recordedEvents.map { $0.arguments["i"] }, ["2","3","4"])
+		XCTAssertEqual(recorder.droppedCount, 2)
+
+		recorder.reset()
+		XCTAssertTrue(recorder.recordedEvents.isEmpty)
+		XCTAssertEqual(recorder.droppedCount, 0)
+	}
+
+	func testChromeTraceExport() async throws
+	{
+		let recorder = TraceRecorder(capacity:100, isEnabled:true)
+
+		let outer = recorder.begin("Container","load",["identifier":"FolderSource:file:///tmp/"])
+		recorder.end(recorder.begin("Object.Filter","sort"))
+		try await Task.sleep(nanoseconds:1_000_000)
+		recorder.end(outer)
+
+		let data = try recorder.chromeTraceData()
+		let json = try XCTUnwrap(JSONSerialization.jsonObject(with:data) as? [String:Any])
+		let events = try XCTUnwrap(json["traceEvents"] as? [[String:Any]])
+
+		// One metadata event plus one or two events per interval, depending on whether the async code resumed
+		// on a different thread
+
+		let names = events.compactMap { $0["name"] as? String }
+		XCTAssertEqual(events.first?["ph"] as? String, "M")
+		XCTAssertTrue(names.contains("sort"))
+		XCTAssertTrue(names.contains("load"))
+
+		let load = try XCTUnwrap(events.first { $0["name"] as? String == "load" })
+		let args = try XCTUnwrap(load["args"] as? [String:Any])
+		XCTAssertEqual(args["identifier"] as? String, "FolderSource:file:///tmp/")
+		XCTAssertNotNil(args["task"])
+		XCTAssertNotNil(load["tid"])
+	}
+}